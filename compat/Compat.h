@@ -0,0 +1,156 @@
+
+/** $VER: Compat.h (2026.10.19) P. Stuer - Subset of the Windows API and the Microsoft C runtime that is used by the library and the tools on other platforms **/
+
+#pragma once
+
+#ifndef _WIN32
+
+#include <cerrno>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <cwchar>
+#include <filesystem>
+
+#include <strings.h>
+#include <sys/stat.h>
+
+#pragma region Types
+
+using BYTE  = uint8_t;
+using WORD  = uint16_t;
+using DWORD = uint32_t;
+using UINT  = unsigned int;
+using BOOL  = int;
+
+#ifndef TRUE
+#define TRUE  1
+#define FALSE 0
+#endif
+
+#define CF_TEXT 1
+
+#define mmioFOURCC(ch0, ch1, ch2, ch3) ((DWORD) (BYTE) (ch0) | ((DWORD) (BYTE) (ch1) << 8) | ((DWORD) (BYTE) (ch2) << 16) | ((DWORD) (BYTE) (ch3) << 24))
+
+template <typename T, size_t N>
+char (& __countof_helper(T (&)[N]))[N];
+
+#define _countof(array) (sizeof(__countof_helper(array)))
+
+// SAL annotations
+#define _Printf_format_string_
+
+#pragma endregion
+
+#pragma region Debugging
+
+// The debugger functions do nothing; they are only used as breakpoints during development.
+inline void DebugBreak() noexcept { }
+inline void OutputDebugStringA(const char *) noexcept { }
+inline void OutputDebugStringW(const wchar_t *) noexcept { }
+
+#pragma endregion
+
+#pragma region Strings
+
+inline int _stricmp(const char * a, const char * b) noexcept { return ::strcasecmp(a, b); }
+inline int _strnicmp(const char * a, const char * b, size_t count) noexcept { return ::strncasecmp(a, b, count); }
+inline int _wcsicmp(const wchar_t * a, const wchar_t * b) noexcept { return ::wcscasecmp(a, b); }
+
+inline int sprintf_s(char * buffer, size_t size, const char * format, ...) noexcept
+{
+    va_list Args;
+
+    va_start(Args, format);
+
+    const int Length = ::vsnprintf(buffer, size, format, Args);
+
+    va_end(Args);
+
+    return Length;
+}
+
+/// <summary>
+/// Implements the array overload of _snprintf_s(). Returns -1 if the text was truncated.
+/// </summary>
+template <size_t N>
+inline int _snprintf_s(char (& buffer)[N], size_t count, const char * format, ...) noexcept
+{
+    va_list Args;
+
+    va_start(Args, format);
+
+    const int Length = ::vsnprintf(buffer, (count < N) ? count + 1 : N, format, Args);
+
+    va_end(Args);
+
+    return ((Length < 0) || ((size_t) Length >= N)) ? -1 : Length;
+}
+
+inline int wcscpy_s(wchar_t * dst, size_t size, const wchar_t * src) noexcept
+{
+    if ((dst == nullptr) || (size == 0))
+        return EINVAL;
+
+    const size_t Length = ::wcslen(src);
+
+    if (Length >= size)
+    {
+        dst[0] = L'\0';
+
+        return ERANGE;
+    }
+
+    ::wmemcpy(dst, src, Length + 1);
+
+    return 0;
+}
+
+#pragma endregion
+
+#pragma region Files
+
+#define _S_IREAD  S_IRUSR
+#define _S_IWRITE S_IWUSR
+
+inline int _chmod(const char * filePath, int mode) noexcept { return ::chmod(filePath, (mode_t) mode); }
+
+inline int fopen_s(FILE ** fp, const char * filePath, const char * mode) noexcept
+{
+    *fp = ::fopen(filePath, mode);
+
+    return (*fp != nullptr) ? 0 : errno;
+}
+
+/// <summary>
+/// Opens a file with a wide path. The path is converted to the native (UTF-8) encoding.
+/// </summary>
+inline int _wfopen_s(FILE ** fp, const wchar_t * filePath, const wchar_t * mode) noexcept
+{
+    *fp = nullptr;
+
+    char Mode[8] = { };
+
+    for (size_t i = 0; (mode[i] != L'\0') && (i < _countof(Mode) - 1); ++i)
+        Mode[i] = (char) mode[i];
+
+    try
+    {
+        return fopen_s(fp, std::filesystem::path(filePath).string().c_str(), Mode);
+    }
+    catch (...)
+    {
+        return EINVAL;
+    }
+}
+
+#pragma endregion
+
+inline int localtime_s(tm * tm, const time_t * time) noexcept
+{
+    return (::localtime_r(time, tm) != nullptr) ? 0 : errno;
+}
+
+#endif
@@ -0,0 +1,6 @@
+
+/** $VER: Encoding.h (2026.10.19) P. Stuer - Text encoding functions of libmsc on other platforms **/
+
+#pragma once
+
+#include "libmsc.h"
@@ -0,0 +1,69 @@
+
+/** $VER: Format.h (2026.10.19) P. Stuer - Minimal std::format for standard libraries that do not provide <format> yet (libstdc++ 12 and older) **/
+
+#pragma once
+
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace std
+{
+
+/// <summary>
+/// Replaces each "{}" in the format string with the next argument. Format specifications and "{{" / "}}" escapes are supported only as far as the library uses them.
+/// </summary>
+template<typename... Args>
+inline string format(string_view fmt, Args && ... args)
+{
+    ostringstream Stream;
+
+    auto Write = [&Stream, &fmt]<typename T>(T && arg)
+    {
+        for (;;)
+        {
+            const size_t Index = fmt.find_first_of("{}");
+
+            if (Index == string_view::npos)
+            {
+                Stream << fmt;
+                fmt = { };
+
+                return;
+            }
+
+            Stream << fmt.substr(0, Index);
+
+            if (Index + 1 < fmt.size() && fmt[Index + 1] == fmt[Index])
+            {
+                Stream << fmt[Index];
+                fmt.remove_prefix(Index + 2);
+
+                continue;
+            }
+
+            const size_t End = fmt.find('}', Index);
+
+            fmt.remove_prefix((End != string_view::npos) ? End + 1 : fmt.size());
+
+            Stream << arg;
+
+            return;
+        }
+    };
+
+    (Write(std::forward<Args>(args)), ...);
+
+    // Output the remainder and resolve the escapes in it.
+    for (size_t i = 0; i < fmt.size(); ++i)
+    {
+        Stream << fmt[i];
+
+        if ((fmt[i] == '{' || fmt[i] == '}') && i + 1 < fmt.size() && fmt[i + 1] == fmt[i])
+            ++i;
+    }
+
+    return Stream.str();
+}
+
+}
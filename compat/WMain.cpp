@@ -0,0 +1,27 @@
+
+/** $VER: WMain.cpp (2026.10.19) P. Stuer - Calls wmain() with the command line arguments converted to wide strings on other platforms **/
+
+#include "libmsc.h"
+
+#include <vector>
+
+int wmain(int argc, wchar_t * argv[]);
+
+int main(int argc, char * argv[])
+{
+    std::vector<std::wstring> Args;
+
+    Args.reserve((size_t) argc);
+
+    for (int i = 0; i < argc; ++i)
+        Args.push_back(msc::UTF8ToWide(argv[i]));
+
+    std::vector<wchar_t *> ArgV;
+
+    for (auto & Arg : Args)
+        ArgV.push_back(Arg.data());
+
+    ArgV.push_back(nullptr);
+
+    return wmain(argc, ArgV.data());
+}
@@ -0,0 +1,357 @@
+
+/** $VER: libmsc.cpp (2026.10.19) P. Stuer - Subset of libmsc that is used by the library and the tools on other platforms **/
+
+#include "libmsc.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <iconv.h>
+
+namespace msc
+{
+
+/// <summary>
+/// Formats a text using a printf-style format string.
+/// </summary>
+std::string FormatText(const char * format, ...)
+{
+    va_list Args;
+
+    va_start(Args, format);
+
+    char Text[512];
+
+    int Length = ::vsnprintf(Text, sizeof(Text), format, Args);
+
+    va_end(Args);
+
+    if (Length < 0)
+        return std::string();
+
+    if ((size_t) Length < sizeof(Text))
+        return std::string(Text, (size_t) Length);
+
+    // Long texts are formatted again in a heap buffer.
+    std::string Result((size_t) Length, '\0');
+
+    va_start(Args, format);
+
+    ::vsnprintf(Result.data(), Result.size() + 1, format, Args);
+
+    va_end(Args);
+
+    return Result;
+}
+
+/// <summary>
+/// Converts a wide text (UTF-32) to UTF-8. Invalid code points are replaced by U+FFFD.
+/// </summary>
+std::string WideToUTF8(const std::wstring & text)
+{
+    std::string Result;
+
+    Result.reserve(text.size());
+
+    for (const wchar_t c : text)
+    {
+        uint32_t CodePoint = (uint32_t) c;
+
+        if ((CodePoint > 0x10FFFF) || ((CodePoint >= 0xD800) && (CodePoint <= 0xDFFF)))
+            CodePoint = 0xFFFD;
+
+        if (CodePoint < 0x80)
+            Result += (char) CodePoint;
+        else
+        if (CodePoint < 0x800)
+        {
+            Result += (char) (0xC0 | (CodePoint >> 6));
+            Result += (char) (0x80 | (CodePoint & 0x3F));
+        }
+        else
+        if (CodePoint < 0x10000)
+        {
+            Result += (char) (0xE0 | (CodePoint >> 12));
+            Result += (char) (0x80 | ((CodePoint >> 6) & 0x3F));
+            Result += (char) (0x80 | (CodePoint & 0x3F));
+        }
+        else
+        {
+            Result += (char) (0xF0 | (CodePoint >> 18));
+            Result += (char) (0x80 | ((CodePoint >> 12) & 0x3F));
+            Result += (char) (0x80 | ((CodePoint >> 6) & 0x3F));
+            Result += (char) (0x80 | (CodePoint & 0x3F));
+        }
+    }
+
+    return Result;
+}
+
+/// <summary>
+/// Decodes the UTF-8 sequence at the specified position. Returns false if the sequence is invalid.
+/// </summary>
+static bool DecodeUTF8(const uint8_t * data, size_t size, size_t & i, uint32_t & codePoint) noexcept
+{
+    const uint8_t c = data[i];
+
+    size_t Count;
+
+    if (c < 0x80) { codePoint = c; Count = 0; }
+    else
+    if ((c & 0xE0) == 0xC0) { codePoint = c & 0x1Fu; Count = 1; }
+    else
+    if ((c & 0xF0) == 0xE0) { codePoint = c & 0x0Fu; Count = 2; }
+    else
+    if ((c & 0xF8) == 0xF0) { codePoint = c & 0x07u; Count = 3; }
+    else
+        return false;
+
+    if (Count > size - i - 1)
+        return false;
+
+    for (size_t j = 1; j <= Count; ++j)
+    {
+        if ((data[i + j] & 0xC0) != 0x80)
+            return false;
+
+        codePoint = (codePoint << 6) | (data[i + j] & 0x3Fu);
+    }
+
+    static const uint32_t MinCodePoints[] = { 0, 0x80, 0x800, 0x10000 };
+
+    // Reject overlong encodings, surrogates and code points beyond U+10FFFF.
+    if ((codePoint < MinCodePoints[Count]) || (codePoint > 0x10FFFF) || ((codePoint >= 0xD800) && (codePoint <= 0xDFFF)))
+        return false;
+
+    i += Count + 1;
+
+    return true;
+}
+
+/// <summary>
+/// Converts a UTF-8 text to a wide text (UTF-32). Invalid sequences are replaced by U+FFFD.
+/// </summary>
+std::wstring UTF8ToWide(const std::string & text)
+{
+    std::wstring Result;
+
+    Result.reserve(text.size());
+
+    const uint8_t * Data = (const uint8_t *) text.data();
+
+    for (size_t i = 0; i < text.size(); )
+    {
+        uint32_t CodePoint;
+
+        if (!DecodeUTF8(Data, text.size(), i, CodePoint))
+        {
+            CodePoint = 0xFFFD;
+            ++i;
+        }
+
+        Result += (wchar_t) CodePoint;
+    }
+
+    return Result;
+}
+
+/// <summary>
+/// Returns true if the text is valid UTF-8.
+/// </summary>
+static bool IsUTF8(const char * text, size_t size) noexcept
+{
+    for (size_t i = 0; i < size; )
+    {
+        uint32_t CodePoint;
+
+        if (!DecodeUTF8((const uint8_t *) text, size, i, CodePoint))
+            return false;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Converts a text with iconv. Returns false if the encoding is not supported or the text contains invalid sequences.
+/// </summary>
+static bool Convert(const char * encoding, const char * text, size_t size, std::string & result)
+{
+    iconv_t cd = ::iconv_open("UTF-8", encoding);
+
+    if (cd == (iconv_t) -1)
+        return false;
+
+    std::vector<char> Buffer(size * 4 + 4);
+
+    char * Src = (char *) text;
+    size_t SrcSize = size;
+
+    char * Dst = Buffer.data();
+    size_t DstSize = Buffer.size();
+
+    const bool Success = (::iconv(cd, &Src, &SrcSize, &Dst, &DstSize) != (size_t) -1) && (SrcSize == 0);
+
+    ::iconv_close(cd);
+
+    if (Success)
+        result.assign(Buffer.data(), (size_t) (Dst - Buffer.data()));
+
+    return Success;
+}
+
+/// <summary>
+/// Converts a text in an unknown encoding to UTF-8. The size defaults to the length of the zero-terminated text.
+/// The text is used as is if it is valid UTF-8. Otherwise it is decoded as Shift-JIS, the most common encoding of the supported Japanese formats, and as Windows-1252 if that fails.
+/// </summary>
+std::string TextToUTF8(const char * text, size_t size)
+{
+    if (text == nullptr)
+        return std::string();
+
+    if (size == ~(size_t) 0)
+        size = ::strlen(text);
+
+    if (IsUTF8(text, size))
+        return std::string(text, size);
+
+    std::string Result;
+
+    if (Convert("CP932", text, size, Result) || Convert("CP1252", text, size, Result))
+        return Result;
+
+    // Latin-1 maps every byte to a code point.
+    for (size_t i = 0; i < size; ++i)
+    {
+        const uint8_t c = (uint8_t) text[i];
+
+        if (c < 0x80)
+            Result += (char) c;
+        else
+        {
+            Result += (char) (0xC0 | (c >> 6));
+            Result += (char) (0x80 | (c & 0x3F));
+        }
+    }
+
+    return Result;
+}
+
+/// <summary>
+/// Converts a text in the specified Windows code page to UTF-8.
+/// </summary>
+std::string CodePageToUTF8(uint32_t codePage, const char * text, size_t size)
+{
+    std::string Encoding;
+
+    switch (codePage)
+    {
+        case 65001: return std::string(text, size);
+
+        case  1200: Encoding = "UTF-16LE"; break;
+        case  1201: Encoding = "UTF-16BE"; break;
+        case 20127: Encoding = "ASCII"; break;
+        case 20866: Encoding = "KOI8-R"; break;
+        case 20932:
+        case 51932: Encoding = "EUC-JP"; break;
+        case 50220: Encoding = "ISO-2022-JP"; break;
+        case 51949: Encoding = "EUC-KR"; break;
+
+        default:
+        {
+            if ((codePage >= 28591) && (codePage <= 28605))
+                Encoding = "ISO-8859-" + std::to_string(codePage - 28590);
+            else
+                Encoding = "CP" + std::to_string(codePage);
+        }
+    }
+
+    std::string Result;
+
+    if (Convert(Encoding.c_str(), text, size, Result))
+        return Result;
+
+    return TextToUTF8(text, size);
+}
+
+/// <summary>
+/// Gets the Windows code page of an IANA character set name, e.g. the IENC chunk of a RIFF file.
+/// </summary>
+bool GetCodePageFromEncoding(const std::string & encoding, uint32_t & codePage) noexcept
+{
+    static const struct { const char * Name; uint32_t CodePage; } Encodings[] =
+    {
+        { "utf-8",          65001 },
+        { "utf8",           65001 },
+        { "utf-16",          1200 },
+        { "utf-16le",        1200 },
+        { "utf-16be",        1201 },
+        { "us-ascii",       20127 },
+        { "ascii",          20127 },
+        { "shift_jis",        932 },
+        { "shift-jis",        932 },
+        { "sjis",             932 },
+        { "x-sjis",           932 },
+        { "windows-31j",      932 },
+        { "cp932",            932 },
+        { "euc-jp",         51932 },
+        { "iso-2022-jp",    50220 },
+        { "gb2312",           936 },
+        { "gbk",              936 },
+        { "big5",             950 },
+        { "euc-kr",         51949 },
+        { "ks_c_5601-1987",   949 },
+        { "koi8-r",         20866 },
+        { "latin1",         28591 },
+    };
+
+    char Name[32];
+    size_t Length = 0;
+
+    // The name is stored as a zero-terminated string, possibly padded.
+    for (const char c : encoding)
+    {
+        if ((c == '\0') || (Length == sizeof(Name) - 1))
+            break;
+
+        Name[Length++] = (char) std::tolower((unsigned char) c);
+    }
+
+    while ((Length > 0) && (Name[Length - 1] == ' '))
+        --Length;
+
+    Name[Length] = '\0';
+
+    for (const auto & Encoding : Encodings)
+    {
+        if (::strcmp(Name, Encoding.Name) == 0)
+        {
+            codePage = Encoding.CodePage;
+
+            return true;
+        }
+    }
+
+    unsigned int n;
+
+    if ((::sscanf(Name, "iso-8859-%u", &n) == 1) && (n >= 1) && (n <= 15))
+    {
+        codePage = 28590 + n;
+
+        return true;
+    }
+
+    if (((::sscanf(Name, "windows-%u", &n) == 1) || (::sscanf(Name, "cp%u", &n) == 1)) && (n > 0))
+    {
+        codePage = n;
+
+        return true;
+    }
+
+    return false;
+}
+
+}
@@ -0,0 +1,34 @@
+
+/** $VER: libmsc.h (2026.10.19) P. Stuer - Subset of libmsc that is used by the library and the tools on other platforms **/
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace fs = std::filesystem;
+
+namespace msc
+{
+
+std::string FormatText(const char * format, ...);
+
+std::string WideToUTF8(const std::wstring & text);
+std::wstring UTF8ToWide(const std::string & text);
+
+std::string TextToUTF8(const char * text, size_t size = ~(size_t) 0);
+std::string CodePageToUTF8(uint32_t codePage, const char * text, size_t size);
+
+bool GetCodePageFromEncoding(const std::string & encoding, uint32_t & codePage) noexcept;
+
+/// <summary>
+/// Returns true if the value is in the range [min, max].
+/// </summary>
+template <typename T>
+inline bool InRange(T value, T min, T max) noexcept
+{
+    return (min <= value) && (value <= max);
+}
+
+}
@@ -1,8 +1,9 @@
 
-/** $VER: libmidi.h (2025.09.05) P. Stuer **/
+/** $VER: libmidi.h (2026.10.19) P. Stuer **/
 
 #pragma once
 
+#ifdef _WIN32
 #include <SDKDDKVer.h>
 
 #define NOMINMAX
@@ -10,6 +11,7 @@
 #include <winsock2.h>
 #include <windows.h>
 #include <wincodec.h>
+#endif
 
 #ifdef __TRACE
 extern uint32_t __TRACE_LEVEL;
@@ -0,0 +1,63 @@
+
+/** $VER: BlockScheduler.cpp (2026.10.19) P. Stuer - Splits a timed message stream into render blocks **/
+
+#include "pch.h"
+
+#include "BlockScheduler.h"
+
+namespace midi
+{
+
+/// <summary>
+/// Sets the stream to schedule and rewinds to the start. The stream must remain valid while the scheduler uses it.
+/// </summary>
+void block_scheduler_t::SetStream(const std::vector<timed_message_t> * stream) noexcept
+{
+    _Stream = stream;
+    _Position = 0;
+    _Time = 0;
+}
+
+/// <summary>
+/// Replaces the messages in the list with the messages of the next block and advances the time by the block size.
+/// </summary>
+void block_scheduler_t::NextBlock(uint32_t blockSize, std::vector<scheduled_message_t> & messages)
+{
+    messages.clear();
+
+    const uint64_t BlockEnd = _Time + blockSize;
+
+    if (_Stream != nullptr)
+    {
+        const auto & Stream = *_Stream;
+
+        while ((_Position < Stream.size()) && (Stream[_Position].Time < BlockEnd))
+        {
+            const timed_message_t & Message = Stream[_Position++];
+
+            // Messages before the block, e.g. after a seek, are sent at the start of the block.
+            const uint32_t Offset = (Message.Time > _Time) ? (uint32_t) (Message.Time - _Time) : 0;
+
+            messages.push_back({ Offset, Message.Data });
+        }
+    }
+
+    _Time = BlockEnd;
+}
+
+/// <summary>
+/// Moves to the specified time (in samples). The next block starts with the first message at or after the time.
+/// </summary>
+void block_scheduler_t::SetTime(uint64_t time) noexcept
+{
+    _Time = time;
+
+    if (_Stream == nullptr)
+        return;
+
+    const auto it = std::lower_bound(_Stream->begin(), _Stream->end(), time, [](const timed_message_t & message, uint64_t t) { return message.Time < t; });
+
+    _Position = (size_t) (it - _Stream->begin());
+}
+
+}
@@ -0,0 +1,48 @@
+
+/** $VER: BlockScheduler.h (2026.10.19) P. Stuer - Splits a timed message stream into render blocks **/
+
+#pragma once
+
+#include "pch.h"
+
+#include "MIDIContainer.h"
+
+namespace midi
+{
+
+/// <summary>
+/// Represents a message in a render block.
+/// </summary>
+struct scheduled_message_t
+{
+    uint32_t Offset;    // Offset of the message in the block (in samples)
+    uint32_t Data;      // See message_t::Data
+};
+
+/// <summary>
+/// Hands out the messages of a stream created by container_t::SerializeAsStream() with sample timestamps, one render block at a time.
+/// The scheduler does not allocate memory once the output vector has grown to the largest block so it can be used on an audio thread.
+/// </summary>
+class block_scheduler_t
+{
+public:
+    block_scheduler_t() noexcept : _Stream(), _Position(), _Time() { }
+
+    void SetStream(const std::vector<timed_message_t> * stream) noexcept;
+
+    void NextBlock(uint32_t blockSize, std::vector<scheduled_message_t> & messages);
+
+    void SetTime(uint64_t time) noexcept;
+    uint64_t GetTime() const noexcept { return _Time; }
+
+    size_t GetPosition() const noexcept { return _Position; }
+
+    bool IsDone() const noexcept { return (_Stream == nullptr) || (_Position >= _Stream->size()); }
+
+private:
+    const std::vector<timed_message_t> * _Stream;
+    size_t _Position;       // Index of the next message in the stream
+    uint64_t _Time;         // Start of the next block (in samples)
+};
+
+}
@@ -0,0 +1,95 @@
+
+/** $VER: Diagnostics.cpp (2026.10.19) P. Stuer - Reports diagnostic messages to an optional, caller-supplied sink **/
+
+#include "pch.h"
+
+#include "Diagnostics.h"
+
+#include <cstdarg>
+
+namespace midi
+{
+
+thread_local diagnostics_t Diagnostics = { nullptr, nullptr, severity_t::Warning };
+
+/// <summary>
+/// Formats a message and passes it to the sink of the current thread. Failures are ignored; diagnostics never interrupt a conversion.
+/// </summary>
+void Report(severity_t severity, const char * source, std::string_view chunkId, size_t offset, size_t size, const char * format, ...) noexcept
+{
+    const diagnostics_t Sink = Diagnostics;
+
+    if (!Sink.IsEnabled(severity))
+        return;
+
+    char Text[512];
+
+    va_list Args;
+
+    va_start(Args, format);
+
+    int Length = ::vsnprintf(Text, sizeof(Text), format, Args);
+
+    va_end(Args);
+
+    if (Length < 0)
+        return;
+
+    try
+    {
+        if ((size_t) Length < sizeof(Text))
+        {
+            Sink.Sink({ severity, source, chunkId, offset, size, std::string_view(Text, (size_t) Length) }, Sink.Context);
+
+            return;
+        }
+
+        // Long messages are formatted again in a heap buffer.
+        std::string Message((size_t) Length, '\0');
+
+        va_start(Args, format);
+
+        ::vsnprintf(Message.data(), Message.size() + 1, format, Args);
+
+        va_end(Args);
+
+        Sink.Sink({ severity, source, chunkId, offset, size, Message }, Sink.Context);
+    }
+    catch (...)
+    {
+    }
+}
+
+/// <summary>
+/// Stores a copy of the diagnostic. Use as the sink of a diagnostics_scope_t with the buffer as context.
+/// </summary>
+void diagnostics_buffer_t::Write(const diagnostic_t & diagnostic, void * context)
+{
+    auto * Buffer = (diagnostics_buffer_t *) context;
+
+    Buffer->_Entries.push_back({ diagnostic.Severity, diagnostic.Source, std::string(diagnostic.ChunkId), diagnostic.Offset, diagnostic.Size, std::string(diagnostic.Message) });
+}
+
+/// <summary>
+/// Passes the stored diagnostics to the sink of the current thread.
+/// </summary>
+void diagnostics_buffer_t::Replay() const noexcept
+{
+    const diagnostics_t Sink = Diagnostics;
+
+    for (const auto & Entry : _Entries)
+    {
+        if (!Sink.IsEnabled(Entry.Severity))
+            continue;
+
+        try
+        {
+            Sink.Sink({ Entry.Severity, Entry.Source, Entry.ChunkId, Entry.Offset, Entry.Size, Entry.Message }, Sink.Context);
+        }
+        catch (...)
+        {
+        }
+    }
+}
+
+}
@@ -0,0 +1,113 @@
+
+/** $VER: Diagnostics.h (2026.10.19) P. Stuer - Reports diagnostic messages to an optional, caller-supplied sink **/
+
+#pragma once
+
+#include "pch.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace midi
+{
+
+enum class severity_t : uint8_t
+{
+    Trace = 0,  // Detailed information about the structure of the data
+    Info,       // Noteworthy information about the conversion
+    Warning,    // Unexpected or unsupported data that was skipped or worked around
+    Error,      // Invalid data that could not be converted
+};
+
+/// <summary>
+/// Represents a diagnostic message. The referenced strings are only valid for the duration of the sink call.
+/// </summary>
+struct diagnostic_t
+{
+    static constexpr size_t None = ~(size_t) 0;
+
+    severity_t Severity;
+    const char * Source;        // Name of the reporting component, e.g. "RCP" or "MMF"
+    std::string_view ChunkId;   // Id of the chunk being processed, if any
+    size_t Offset;              // Offset of the chunk or command in the data or None
+    size_t Size;                // Size of the chunk or None
+    std::string_view Message;   // UTF-8
+};
+
+using diagnostics_sink_t = void (*)(const diagnostic_t & diagnostic, void * context);
+
+/// <summary>
+/// Holds the sink of the current thread.
+/// </summary>
+struct diagnostics_t
+{
+    diagnostics_sink_t Sink;
+    void * Context;
+    severity_t Level;           // Minimum severity that is reported
+
+    bool IsEnabled(severity_t severity) const noexcept { return (Sink != nullptr) && (severity >= Level); }
+};
+
+extern thread_local diagnostics_t Diagnostics;
+
+/// <summary>
+/// Installs a sink for the current thread and restores the previous one when it goes out of scope.
+/// </summary>
+class diagnostics_scope_t
+{
+public:
+    diagnostics_scope_t(diagnostics_sink_t sink, void * context, severity_t level) noexcept : _Previous(Diagnostics)
+    {
+        Diagnostics = { sink, context, level };
+    }
+
+    ~diagnostics_scope_t() noexcept
+    {
+        Diagnostics = _Previous;
+    }
+
+    diagnostics_scope_t(const diagnostics_scope_t &) = delete;
+    diagnostics_scope_t & operator=(const diagnostics_scope_t &) = delete;
+
+private:
+    diagnostics_t _Previous;
+};
+
+/// <summary>
+/// Collects diagnostics, e.g. of a task that runs on another thread, so that they can be reported later in a deterministic order.
+/// </summary>
+class diagnostics_buffer_t
+{
+public:
+    static void Write(const diagnostic_t & diagnostic, void * context);
+
+    void Replay() const noexcept;
+
+private:
+    struct entry_t
+    {
+        severity_t Severity;
+        const char * Source;
+        std::string ChunkId;
+        size_t Offset;
+        size_t Size;
+        std::string Message;
+    };
+
+    std::vector<entry_t> _Entries;
+};
+
+void Report(severity_t severity, const char * source, std::string_view chunkId, size_t offset, size_t size, _Printf_format_string_ const char * format, ...) noexcept;
+
+}
+
+/*
+    Use the macros to report diagnostics. The arguments are only evaluated when a sink is installed that accepts the severity.
+    Define LIBMIDI_NO_DIAGNOSTICS to remove all reporting code from the library. The arguments are still type-checked but never evaluated.
+*/
+#ifndef LIBMIDI_NO_DIAGNOSTICS
+#define MIDI_DIAGNOSTIC(severity, source, chunkId, offset, size, ...) do { if (midi::Diagnostics.IsEnabled(severity)) midi::Report(severity, source, chunkId, offset, size, __VA_ARGS__); } while (0)
+#else
+#define MIDI_DIAGNOSTIC(severity, source, chunkId, offset, size, ...) do { if constexpr (false) midi::Report(severity, source, chunkId, offset, size, __VA_ARGS__); } while (0)
+#endif
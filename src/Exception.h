@@ -1,10 +1,12 @@
 
-/** $VER: Exception.h (2025.03.20) P. Stuer **/
+/** $VER: Exception.h (2026.10.19) P. Stuer **/
 
 #pragma once
 
+#ifdef _WIN32
 #include <Windows.h>
 #include <strsafe.h>
+#endif
 
 #include <stdexcept>
 #include <string>
@@ -1,10 +1,11 @@
 
-/** $VER: IFF.h (2024.05.18) **/
+/** $VER: IFF.h (2026.10.19) **/
 
 #pragma once
 
 #include "pch.h"
 
+#ifdef _WIN32
 #include <SDKDDKVer.h>
 
 #define NOMINMAX
@@ -14,6 +15,7 @@
 #include <wincodec.h>
 
 #include <mmreg.h>
+#endif
 
 const DWORD FOURCC_FORM = mmioFOURCC('F', 'O', 'R', 'M');
 const DWORD FOURCC_CAT  = mmioFOURCC('C', 'A', 'T', ' ');
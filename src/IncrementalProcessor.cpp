@@ -0,0 +1,382 @@
+
+/** $VER: IncrementalProcessor.cpp (2026.10.19) P. Stuer - Processes SMF and RMI data while it arrives **/
+
+#include "pch.h"
+
+#include "IncrementalProcessor.h"
+
+#include "Exception.h"
+
+namespace midi
+{
+
+static inline uint32_t toInt32LE(const uint8_t * data)
+{
+    return static_cast<uint32_t>(data[0]) | static_cast<uint32_t>(data[1] << 8) | static_cast<uint32_t>(data[2] << 16) | static_cast<uint32_t>(data[3] << 24);
+}
+
+static inline uint32_t toInt32BE(const uint8_t * data)
+{
+    return static_cast<uint32_t>(data[0] << 24) | static_cast<uint32_t>(data[1] << 16) | static_cast<uint32_t>(data[2] << 8) | static_cast<uint32_t>(data[3]);
+}
+
+/// <summary>
+/// Initializes a new instance. Set takeEvents to receive the events of a format 0 file with TakeEvents() while it is being decoded.
+/// </summary>
+incremental_processor_t::incremental_processor_t(container_t & container, const processor_options_t & options, bool takeEvents) : _Container(container), _Options(options),
+    _State(state_t::Signature), _NextState(state_t::Signature), _Offset(), _RIFFTail(), _DataTail(~(uint64_t) 0), _DataChunkTail(), _ChunkTail(), _IsRMI(), _HasDataChunk(),
+    _TrackCount(), _ChunkIndex(), _CompletedTrackCount(), _IsFormat0(), _TakeEvents(takeEvents)
+{
+}
+
+/// <summary>
+/// Processes the next part of the data. Returns false if the data is not an SMF or RMI file. Throws if the data is invalid.
+/// </summary>
+bool incremental_processor_t::Write(const uint8_t * data, size_t size)
+{
+    if (_State == state_t::Rejected)
+        return false;
+
+    if (_State == state_t::Complete)
+        return true;
+
+    diagnostics_scope_t DiagnosticsScope(_Options.DiagnosticsSink, _Options.DiagnosticsContext, _Options.DiagnosticsLevel);
+    stats_scope_t StatsScope((_Options.Stats != nullptr) ? _Options.Stats : Stats);
+
+    MIDI_TIME_PHASE(Parsing);
+
+    try
+    {
+        // Process the data in place when nothing is buffered and keep only the part that could not be processed yet.
+        if (_Buffer.empty())
+        {
+            const size_t Size = Process(data, size);
+
+            _Buffer.assign(data + Size, data + size);
+        }
+        else
+        {
+            _Buffer.insert(_Buffer.end(), data, data + size);
+
+            const size_t Size = Process(_Buffer.data(), _Buffer.size());
+
+            _Buffer.erase(_Buffer.begin(), _Buffer.begin() + (ptrdiff_t) Size);
+        }
+    }
+    catch (...)
+    {
+        _State = state_t::Rejected;
+
+        throw;
+    }
+
+    return (_State != state_t::Rejected);
+}
+
+/// <summary>
+/// Signals the end of the data. Throws if the data ended before the last track or, for an RMI file, before the end of the RIFF chunk.
+/// </summary>
+void incremental_processor_t::Close()
+{
+    if ((_State == state_t::Complete) || (_State == state_t::Rejected))
+        return;
+
+    _State = state_t::Rejected;
+
+    throw midi::exception(_IsRMI ? "Insufficient RIFF data" : "Insufficient SMF data");
+}
+
+/// <summary>
+/// Moves the events of a format 0 file that were decoded since the last call to the end of the specified vector. Returns the number of events.
+/// The events are in the order in which they were decoded. A few events that belong at the start of the track (e.g. MIDI Port events) can follow events with a later timestamp.
+/// The events are kept until they are taken, in addition to the track that is being decoded, so call this function after each Write().
+/// </summary>
+size_t incremental_processor_t::TakeEvents(std::vector<event_t> & events)
+{
+    const size_t Count = _Events.size();
+
+    if (events.empty())
+        events.swap(_Events);
+    else
+        events.insert(events.end(), std::make_move_iterator(_Events.begin()), std::make_move_iterator(_Events.end()));
+
+    _Events.clear();
+
+    return Count;
+}
+
+/// <summary>
+/// Processes as much of the data as possible. Returns the number of bytes that were processed.
+/// </summary>
+size_t incremental_processor_t::Process(const uint8_t * data, size_t size)
+{
+    const uint8_t * Head = data;
+    const uint8_t * Tail = data + size;
+
+    auto Advance = [this, &Head](size_t size) noexcept
+    {
+        Head    += size;
+        _Offset += size;
+    };
+
+    for (;;)
+    {
+        const size_t Available = (size_t) (Tail - Head);
+
+        switch (_State)
+        {
+            case state_t::Signature:
+            {
+                if (Available < 12)
+                    return (size_t) (Head - data);
+
+                if (::memcmp(Head, "MThd", 4) == 0)
+                {
+                    _State = state_t::SMFHeader;
+                    break;
+                }
+
+                if ((::memcmp(Head, "RIFF", 4) != 0) || (::memcmp(Head + 8, "RMID", 4) != 0))
+                {
+                    _State = state_t::Rejected;
+                    break;
+                }
+
+                if (Available < 20)
+                    return (size_t) (Head - data);
+
+                // Apply the same checks as processor_t::IsRMI(): the data chunk has to be the first chunk.
+                const uint32_t Size = toInt32LE(Head + 4);
+                const uint32_t DataSize = toInt32LE(Head + 16);
+
+                if ((Size < 12) || (::memcmp(Head + 12, "data", 4) != 0) || (DataSize < 18) || (Size < DataSize + 12))
+                {
+                    _State = state_t::Rejected;
+                    break;
+                }
+
+                _IsRMI = true;
+                _RIFFTail = (uint64_t) Size + 8;
+
+                _RIFF.assign(Head, Head + 12);
+
+                Advance(12);
+
+                _State = state_t::RIFFChunkHeader;
+                break;
+            }
+
+            case state_t::RIFFChunkHeader:
+            {
+                if (_RIFFTail - _Offset < 8)
+                {
+                    CompleteRMI();
+
+                    _State = state_t::Complete;
+                    break;
+                }
+
+                if (Available < 8)
+                    return (size_t) (Head - data);
+
+                const uint64_t ChunkSize = toInt32LE(Head + 4);
+
+                if (_RIFFTail - _Offset - 8 < ChunkSize)
+                    throw midi::exception("Insufficient RIFF data");
+
+                const uint64_t ChunkTail = _Offset + 8 + ChunkSize;
+
+                // Odd-sized chunks are followed by a pad byte unless they end the RIFF chunk.
+                const uint64_t PaddedChunkTail = ((ChunkSize & 1) && (ChunkTail < _RIFFTail)) ? ChunkTail + 1 : ChunkTail;
+
+                if (::memcmp(Head, "data", 4) == 0)
+                {
+                    if (_HasDataChunk)
+                        throw midi::exception("Multiple RIFF data chunks found");
+
+                    _HasDataChunk = true;
+
+                    Advance(8);
+
+                    _DataTail      = ChunkTail;
+                    _DataChunkTail = PaddedChunkTail;
+
+                    _State = state_t::SMFHeader;
+                }
+                else
+                {
+                    _RIFF.insert(_RIFF.end(), Head, Head + 8);
+
+                    Advance(8);
+
+                    _ChunkTail = PaddedChunkTail;
+
+                    _State = state_t::RIFFChunk;
+                }
+                break;
+            }
+
+            case state_t::RIFFChunk:
+            {
+                const size_t Size = (size_t) std::min((uint64_t) Available, _ChunkTail - _Offset);
+
+                _RIFF.insert(_RIFF.end(), Head, Head + Size);
+
+                Advance(Size);
+
+                if (_Offset != _ChunkTail)
+                    return (size_t) (Head - data);
+
+                _State = state_t::RIFFChunkHeader;
+                break;
+            }
+
+            case state_t::SMFHeader:
+            {
+                if (_DataTail - _Offset < 18)
+                    throw midi::exception("Insufficient SMF data");
+
+                if (Available < 18)
+                    return (size_t) (Head - data);
+
+                if (!processor_t::IsSMF(Head, 18))
+                {
+                    _State = state_t::Rejected;
+                    break;
+                }
+
+                _TrackCount = processor_t::ProcessSMFHeader(Head, _Container);
+                _IsFormat0 = (_Container.GetFormat() == 0);
+
+                Advance(14);
+
+                _State = state_t::SMFChunkHeader;
+                break;
+            }
+
+            case state_t::SMFChunkHeader:
+            {
+                if (_ChunkIndex == _TrackCount)
+                {
+                    if (_IsRMI)
+                    {
+                        // Skip the rest of the data chunk.
+                        _ChunkTail = _DataChunkTail;
+
+                        _NextState = state_t::RIFFChunkHeader;
+                        _State = state_t::Skip;
+                    }
+                    else
+                        _State = state_t::Complete;
+                    break;
+                }
+
+                if (_DataTail - _Offset < 8)
+                    throw midi::exception("Insufficient SMF data");
+
+                if (Available < 8)
+                    return (size_t) (Head - data);
+
+                const uint64_t ChunkSize = toInt32BE(Head + 4);
+
+                if (_DataTail - _Offset - 8 < ChunkSize)
+                    throw midi::exception("Insufficient SMF data");
+
+                const bool IsTrack = (::memcmp(Head, "MTrk", 4) == 0);
+
+                Advance(8);
+
+                _ChunkTail = _Offset + ChunkSize;
+
+                if (IsTrack)
+                {
+                    _Decoder.emplace(_Options);
+
+                    if (_IsFormat0 && _TakeEvents)
+                        _Decoder->SetEventSink(&_Events);
+
+                    _State = state_t::SMFTrack;
+                }
+                // Skip unknown chunks in the stream.
+                else
+                {
+                    ++_ChunkIndex;
+
+                    _NextState = state_t::SMFChunkHeader;
+                    _State = state_t::Skip;
+                }
+                break;
+            }
+
+            case state_t::SMFTrack:
+            {
+                const uint64_t Remaining = _ChunkTail - _Offset;
+                const size_t Size = (size_t) std::min((uint64_t) Available, Remaining);
+
+                const uint8_t * p = Head;
+
+                const bool IsComplete = _Decoder->Decode(p, Head + Size, (Size == Remaining), _Container);
+
+                Advance((size_t) (p - Head));
+
+                if (!IsComplete)
+                    return (size_t) (Head - data);
+
+                _Container.AddTrack(_Decoder->GetTrack());
+
+                _Decoder.reset();
+
+                ++_ChunkIndex;
+                ++_CompletedTrackCount;
+
+                // Skip the data after the End of Track event, if any.
+                _NextState = state_t::SMFChunkHeader;
+                _State = state_t::Skip;
+                break;
+            }
+
+            case state_t::Skip:
+            {
+                const size_t Size = (size_t) std::min((uint64_t) Available, _ChunkTail - _Offset);
+
+                Advance(Size);
+
+                if (_Offset != _ChunkTail)
+                    return (size_t) (Head - data);
+
+                _State = _NextState;
+                break;
+            }
+
+            case state_t::Complete:
+            case state_t::Rejected:
+                return (size_t) (Head - data);
+        }
+    }
+}
+
+/// <summary>
+/// Processes the chunks of the RMI file other than the data chunk.
+/// </summary>
+void incremental_processor_t::CompleteRMI()
+{
+    if (_RIFF.size() == 12)
+        return;
+
+    const uint32_t Size = (uint32_t) (_RIFF.size() - 8);
+
+    _RIFF[4] = (uint8_t) (Size);
+    _RIFF[5] = (uint8_t) (Size >>  8);
+    _RIFF[6] = (uint8_t) (Size >> 16);
+    _RIFF[7] = (uint8_t) (Size >> 24);
+
+    processor_t::ProcessRMI(_RIFF, _Container, _Options);
+
+    // Like processor_t::Process(), report the format of the data chunk.
+    _Container.FileFormat = FileFormat::SMF;
+
+    _RIFF.clear();
+    _RIFF.shrink_to_fit();
+}
+
+}
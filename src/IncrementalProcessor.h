@@ -0,0 +1,83 @@
+
+/** $VER: IncrementalProcessor.h (2026.10.19) P. Stuer - Processes SMF and RMI data while it arrives **/
+
+#pragma once
+
+#include "pch.h"
+
+#include "MIDIProcessor.h"
+
+#include <optional>
+
+namespace midi
+{
+
+/// <summary>
+/// Processes SMF and RMI data that arrives in chunks, e.g. while the file is being downloaded. Each track is added to the container as soon as its last byte has arrived.
+/// If takeEvents is set, the events of a format 0 file can be taken while its only track is still being decoded. Only the incomplete chunk header or event at the end of the received data is buffered.
+/// The tracks, metadata, soundfont and file format are the same as the ones processor_t::Process() produces from the complete data.
+/// </summary>
+class incremental_processor_t
+{
+public:
+    incremental_processor_t(container_t & container, const processor_options_t & options = DefaultOptions, bool takeEvents = false);
+
+    bool Write(const uint8_t * data, size_t size);
+    bool Write(std::vector<uint8_t> const & data) { return Write(data.data(), data.size()); }
+
+    void Close();
+
+    size_t TakeEvents(std::vector<event_t> & events);
+
+    bool IsComplete() const noexcept { return _State == state_t::Complete; }
+
+    size_t GetTrackCount() const noexcept { return _TrackCount; }                   // Number of track chunks declared by the header. 0 until the header has arrived.
+    size_t GetCompletedTrackCount() const noexcept { return _CompletedTrackCount; } // Number of tracks that have been added to the container.
+
+private:
+    enum class state_t
+    {
+        Signature,
+        RIFFChunkHeader,
+        RIFFChunk,
+        SMFHeader,
+        SMFChunkHeader,
+        SMFTrack,
+        Skip,
+        Complete,
+        Rejected,
+    };
+
+    size_t Process(const uint8_t * data, size_t size);
+    void CompleteRMI();
+
+private:
+    container_t & _Container;
+    processor_options_t _Options;
+
+    state_t _State;
+    state_t _NextState;                 // State after the Skip state
+
+    std::vector<uint8_t> _Buffer;       // Received data that has not been processed yet
+
+    uint64_t _Offset;                   // Offset in the file of the first unprocessed byte
+    uint64_t _RIFFTail;                 // Offset of the end of the RIFF chunk
+    uint64_t _DataTail;                 // Offset of the end of the SMF data
+    uint64_t _DataChunkTail;            // Offset of the end of the RMI data chunk, including the pad byte
+    uint64_t _ChunkTail;                // Offset of the end of the current chunk
+
+    std::vector<uint8_t> _RIFF;         // The chunks of an RMI file except the data chunk. Processed by processor_t::ProcessRMI() once the RIFF chunk is complete.
+    bool _IsRMI;
+    bool _HasDataChunk;
+
+    size_t _TrackCount;
+    size_t _ChunkIndex;
+    size_t _CompletedTrackCount;
+    bool _IsFormat0;
+    bool _TakeEvents;
+
+    std::optional<smf_track_decoder_t> _Decoder;
+    std::vector<event_t> _Events;       // Copies of the events of a format 0 track that have been decoded but not taken yet. Only filled if takeEvents is set.
+};
+
+}
@@ -0,0 +1,25 @@
+
+/** $VER: Instrumentation.cpp (2026.10.19) P. Stuer - Optional counters and phase timers for the hot paths of the library **/
+
+#include "pch.h"
+
+#include "Instrumentation.h"
+
+namespace midi
+{
+
+thread_local stats_t * Stats = nullptr;
+
+/// <summary>
+/// Gets the name of a phase.
+/// </summary>
+const char * stats_t::GetPhaseName(phase_t phase) noexcept
+{
+    static const char * Names[] = { "Detection", "Decompression", "Parsing", "AddTrack", "LoopDetection", "Serialization" };
+
+    static_assert(_countof(Names) == (size_t) phase_t::Count);
+
+    return ((size_t) phase < _countof(Names)) ? Names[(size_t) phase] : "";
+}
+
+}
@@ -0,0 +1,134 @@
+
+/** $VER: Instrumentation.h (2026.10.19) P. Stuer - Optional counters and phase timers for the hot paths of the library **/
+
+#pragma once
+
+#include "pch.h"
+
+#include <chrono>
+
+namespace midi
+{
+
+enum class phase_t : uint8_t
+{
+    Detection = 0,  // processor_t::Detect()
+    Decompression,  // zlib (XMF) and Huffman (SMAF) decompression
+    Parsing,        // Conversion of the data to tracks, including the nested phases
+    AddTrack,       // container_t::AddTrack() and the rescan of the track summaries
+    LoopDetection,  // container_t::DetectLoops()
+    Serialization,  // container_t::SerializeAsStream() and SerializeAsSMF()
+
+    Count
+};
+
+/// <summary>
+/// Holds the counters and phase times collected while a sink is installed. The values are accumulated; call Reset() to start a new measurement.
+/// Nested phases are included in the time of the enclosing phase. The phase times of tasks that run on multiple threads are summed.
+/// </summary>
+struct stats_t
+{
+    uint64_t PhaseTimes[(size_t) phase_t::Count];   // in ns
+    uint32_t PhaseCounts[(size_t) phase_t::Count];  // Number of times each phase was entered
+
+    uint64_t EventsParsed;          // Events added to a track
+    uint64_t TrackInserts;          // Events that were inserted before the last event of a track instead of appended
+    uint64_t BytesInflated;         // Size of the decompressed data
+    uint64_t SysExDedupHits;        // SysEx messages that were found in the SysEx table
+    uint64_t SysExDedupMisses;      // SysEx messages that were added to the SysEx table
+    uint64_t TempoLookups;          // Conversions of a timestamp using a tempo map
+
+    void Reset() noexcept { *this = { }; }
+
+    void Add(const stats_t & other) noexcept
+    {
+        for (size_t i = 0; i < (size_t) phase_t::Count; ++i)
+        {
+            PhaseTimes[i] += other.PhaseTimes[i];
+            PhaseCounts[i] += other.PhaseCounts[i];
+        }
+
+        EventsParsed += other.EventsParsed;
+        TrackInserts += other.TrackInserts;
+        BytesInflated += other.BytesInflated;
+        SysExDedupHits += other.SysExDedupHits;
+        SysExDedupMisses += other.SysExDedupMisses;
+        TempoLookups += other.TempoLookups;
+    }
+
+    static const char * GetPhaseName(phase_t phase) noexcept;
+};
+
+/// <summary>
+/// Receives the statistics of the current thread. Null when no sink is installed.
+/// </summary>
+extern thread_local stats_t * Stats;
+
+/// <summary>
+/// Installs a statistics sink for the current thread and restores the previous one when it goes out of scope.
+/// </summary>
+class stats_scope_t
+{
+public:
+    stats_scope_t(stats_t * stats) noexcept : _Previous(Stats)
+    {
+        Stats = stats;
+    }
+
+    ~stats_scope_t() noexcept
+    {
+        Stats = _Previous;
+    }
+
+    stats_scope_t(const stats_scope_t &) = delete;
+    stats_scope_t & operator=(const stats_scope_t &) = delete;
+
+private:
+    stats_t * _Previous;
+};
+
+/// <summary>
+/// Adds the time between its construction and its destruction to a phase of the statistics of the current thread.
+/// </summary>
+class phase_timer_t
+{
+public:
+    phase_timer_t(phase_t phase) noexcept : _Stats(Stats), _Phase(phase)
+    {
+        if (_Stats != nullptr)
+            _Start = std::chrono::steady_clock::now();
+    }
+
+    ~phase_timer_t() noexcept
+    {
+        if (_Stats == nullptr)
+            return;
+
+        _Stats->PhaseTimes[(size_t) _Phase] += (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _Start).count();
+        _Stats->PhaseCounts[(size_t) _Phase]++;
+    }
+
+    phase_timer_t(const phase_timer_t &) = delete;
+    phase_timer_t & operator=(const phase_timer_t &) = delete;
+
+private:
+    stats_t * _Stats;
+    phase_t _Phase;
+    std::chrono::steady_clock::time_point _Start;
+};
+
+}
+
+/*
+    Use the macros to instrument the code. Define LIBMIDI_INSTRUMENTATION to include the instrumentation in the library.
+    By default the macros expand to nothing and their arguments are not evaluated. The stats_t type remains available so that the interface does not depend on the build.
+*/
+#ifdef LIBMIDI_INSTRUMENTATION
+#define MIDI_STATS_CONCAT_IMPL(a, b) a##b
+#define MIDI_STATS_CONCAT(a, b) MIDI_STATS_CONCAT_IMPL(a, b)
+#define MIDI_COUNT(counter, value) do { if (midi::Stats != nullptr) midi::Stats->counter += (value); } while (0)
+#define MIDI_TIME_PHASE(phase) const midi::phase_timer_t MIDI_STATS_CONCAT(PhaseTimer, __LINE__)(midi::phase_t::phase)
+#else
+#define MIDI_COUNT(counter, value) do { } while (0)
+#define MIDI_TIME_PHASE(phase) do { } while (0)
+#endif
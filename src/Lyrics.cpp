@@ -0,0 +1,161 @@
+/** $VER: Lyrics.cpp (2026.10.19) P. Stuer **/
+
+#include "pch.h"
+
+#include "Lyrics.h"
+
+namespace midi
+{
+
+/// <summary>
+/// Removes all syllables.
+/// </summary>
+void lyrics_t::Clear() noexcept
+{
+    _Type = lyrics_type_t::None;
+    _Flags = 0;
+
+    _Syllables.clear();
+    _Lines.clear();
+}
+
+/// <summary>
+/// Adds the text of a Soft Karaoke text event or a Tune 1000 lyrics event. The layout characters are removed from the text and converted to flags.
+/// </summary>
+void lyrics_t::Add(uint32_t time, const char * text, size_t size, lyrics_type_t type)
+{
+    if (_Type == lyrics_type_t::None)
+        _Type = type;
+
+    std::string Text;
+
+    auto Flush = [this, time, &Text]()
+    {
+        if (Text.empty())
+            return;
+
+        _Syllables.push_back({ time, _Flags, Text });
+
+        _Flags = 0;
+        Text.clear();
+    };
+
+    for (size_t i = 0; (i < size) && (text[i] != '\0'); ++i)
+    {
+        const char c = text[i];
+
+        if ((c == '\\') && (type == lyrics_type_t::SoftKaraoke))
+        {
+            Flush();
+            _Flags |= syllable_t::FlagNewParagraph;
+        }
+        else
+        if ((c == '/') && (type == lyrics_type_t::SoftKaraoke))
+        {
+            Flush();
+            _Flags |= syllable_t::FlagNewLine;
+        }
+        else
+        if (c == '\r')
+        {
+            Flush();
+            _Flags |= syllable_t::FlagNewLine;
+        }
+        else
+        if (c == '\n')
+        {
+            Flush();
+            _Flags |= syllable_t::FlagNewParagraph;
+        }
+        else
+            Text += c;
+    }
+
+    Flush();
+}
+
+/// <summary>
+/// Sorts the syllables by time and builds the line index. Call this after the last syllable has been added.
+/// </summary>
+void lyrics_t::Finalize()
+{
+    std::stable_sort(_Syllables.begin(), _Syllables.end(), [](const syllable_t & a, const syllable_t & b) { return a.Time < b.Time; });
+
+    _Lines.clear();
+
+    for (size_t i = 0; i < _Syllables.size(); ++i)
+    {
+        if ((i == 0) || _Syllables[i].IsNewLine())
+            _Lines.push_back(i);
+    }
+}
+
+/// <summary>
+/// Returns the index of the last syllable that starts at or before the specified time (in ms), or NotFound if there is none.
+/// </summary>
+size_t lyrics_t::Find(uint32_t time) const noexcept
+{
+    auto it = std::upper_bound(_Syllables.begin(), _Syllables.end(), time, [](uint32_t t, const syllable_t & s) { return t < s.Time; });
+
+    if (it == _Syllables.begin())
+        return NotFound;
+
+    return (size_t) (it - _Syllables.begin()) - 1;
+}
+
+/// <summary>
+/// Returns the index of the last syllable that starts at or before the specified time (in ms), or NotFound if there is none.
+/// The hint is the result of a previous call and makes the lookup O(1) when playback moves forward at a steady pace.
+/// </summary>
+size_t lyrics_t::Find(uint32_t time, size_t hint) const noexcept
+{
+    const size_t Count = _Syllables.size();
+
+    if (hint == NotFound)
+    {
+        if ((Count == 0) || (time < _Syllables[0].Time))
+            return NotFound;
+
+        hint = 0;
+    }
+
+    if ((hint < Count) && (_Syllables[hint].Time <= time))
+    {
+        // Check the hint and the next two syllables before falling back to a binary search.
+        for (size_t i = hint; (i < hint + 3) && (i < Count); ++i)
+        {
+            if ((i + 1 == Count) || (time < _Syllables[i + 1].Time))
+                return i;
+        }
+    }
+
+    return Find(time);
+}
+
+/// <summary>
+/// Returns the index of the first syllable of the line that contains the specified syllable.
+/// </summary>
+size_t lyrics_t::GetLineStart(size_t index) const noexcept
+{
+    if (index >= _Syllables.size())
+        return NotFound;
+
+    auto it = std::upper_bound(_Lines.begin(), _Lines.end(), index);
+
+    return *(it - 1);
+}
+
+/// <summary>
+/// Returns the index of the syllable after the last syllable of the line that contains the specified syllable.
+/// </summary>
+size_t lyrics_t::GetLineEnd(size_t index) const noexcept
+{
+    if (index >= _Syllables.size())
+        return NotFound;
+
+    auto it = std::upper_bound(_Lines.begin(), _Lines.end(), index);
+
+    return (it != _Lines.end()) ? *it : _Syllables.size();
+}
+
+}
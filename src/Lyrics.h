@@ -0,0 +1,84 @@
+/** $VER: Lyrics.h (2026.10.19) P. Stuer **/
+
+#pragma once
+
+#include "pch.h"
+
+#pragma warning(disable: 4820) // x bytes padding added after data member 'y'
+
+namespace midi
+{
+
+/// <summary>
+/// Represents a lyric syllable.
+/// </summary>
+struct syllable_t
+{
+    uint32_t Time;              // in ms
+    uint32_t Flags;
+    std::string Text;           // Raw text without the layout characters. Use msc::TextToUTF8() to convert it.
+
+    enum
+    {
+        FlagNewLine = 1 << 0,       // The syllable starts a new line.
+        FlagNewParagraph = 1 << 1,  // The syllable starts a new paragraph (and a new line).
+    };
+
+    bool IsNewLine() const noexcept { return (Flags & (FlagNewLine | FlagNewParagraph)) != 0; }
+    bool IsNewParagraph() const noexcept { return (Flags & FlagNewParagraph) != 0; }
+};
+
+/// <summary>
+/// Implements a time-indexed lyrics timeline.
+/// </summary>
+class lyrics_t
+{
+public:
+    enum lyrics_type_t
+    {
+        None = 0,
+        SoftKaraoke,                // Text events in a .KAR file. '\' starts a new paragraph, '/' starts a new line.
+        Tune1000,                   // Lyrics events. CR ends a line, LF ends a paragraph.
+    };
+
+    lyrics_t() noexcept : _Type(lyrics_type_t::None), _Flags() { }
+
+    void Clear() noexcept;
+
+    void Add(uint32_t time, const char * text, size_t size, lyrics_type_t type);
+    void Finalize();
+
+    size_t Find(uint32_t time) const noexcept;
+    size_t Find(uint32_t time, size_t hint) const noexcept;
+
+    size_t GetLineStart(size_t index) const noexcept;
+    size_t GetLineEnd(size_t index) const noexcept;
+
+    lyrics_type_t GetType() const noexcept { return _Type; }
+    size_t GetCount() const noexcept { return _Syllables.size(); }
+    bool IsEmpty() const noexcept { return _Syllables.empty(); }
+
+    const syllable_t & operator[](size_t index) const noexcept { return _Syllables[index]; }
+
+    static constexpr size_t NotFound = ~(size_t) 0;
+
+public:
+    using syllables_t = std::vector<syllable_t>;
+
+    using const_iterator = syllables_t::const_iterator;
+
+    const_iterator begin() const { return _Syllables.begin(); }
+    const_iterator end() const { return _Syllables.end(); }
+
+    const_iterator cbegin() const { return _Syllables.cbegin(); }
+    const_iterator cend() const { return _Syllables.cend(); }
+
+private:
+    lyrics_type_t _Type;
+    uint32_t _Flags;                    // Layout flags that apply to the next syllable.
+
+    std::vector<syllable_t> _Syllables;
+    std::vector<size_t> _Lines;         // Index of the first syllable of each line.
+};
+
+}
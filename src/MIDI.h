@@ -49,9 +49,16 @@ enum Controller : uint8_t
 
     // LSB for CC 0 to 31
     BankSelectLSB           = 0x20, // CC  32
+    DataEntryLSB            = 0x26, // CC  38, Sets the LSB of the value for NRPN or RPN parameters.
 
+    SustainPedal            = 0x40, // CC  64
+
+    DataIncrement           = 0x60, // CC  96, Increments the value of the selected NRPN or RPN parameter.
+    DataDecrement           = 0x61, // CC  97, Decrements the value of the selected NRPN or RPN parameter.
     NRPNLSB                 = 0x62, // CC  98, Select NRPN parameter (LSB)
     NRPNMSB                 = 0x63, // CC  99, Select NRPN parameter (MSB)
+    RPNLSB                  = 0x64, // CC 100, Select RPN parameter (LSB)
+    RPNMSB                  = 0x65, // CC 101, Select RPN parameter (MSB)
 
     // Channel Mode messages
     AllSoundsOff            = 0x78, // CC 120, Silences all notes current sounding on the specified MIDI channel. Upon receiving the message, all notes should be turned off, and the output set to zero as quickly as possible.
@@ -1,9 +1,11 @@
 
-/** $VER: MIDIContainer.cpp (2025.09.06) **/
+/** $VER: MIDIContainer.cpp (2026.10.19) **/
 
 #include "pch.h"
 
 #include "MIDIContainer.h"
+#include "Instrumentation.h"
+#include "SeekIndex.h"
 #include "SysEx.h"
 
 namespace midi
@@ -40,6 +42,9 @@ void track_t::AddEvent(const event_t & newEvent)
         }
     }
 
+    MIDI_COUNT(EventsParsed, 1);
+    MIDI_COUNT(TrackInserts, ((it != _Events.end()) && ((_Events.end() - it) > (_Events.back().IsEndOfTrack() ? 1 : 0))) ? 1 : 0);
+
     _Events.insert(it, newEvent);
 
     if (!_IsPortSet && newEvent.IsPort())
@@ -51,6 +56,9 @@ void track_t::AddEvent(const event_t & newEvent)
 /// </summary>
 void track_t::AddEventToStart(const event_t & newEvent)
 {
+    MIDI_COUNT(EventsParsed, 1);
+    MIDI_COUNT(TrackInserts, !_Events.empty() ? 1 : 0);
+
     _Events.insert(_Events.begin(), newEvent);
 
     if (!_IsPortSet && newEvent.IsPort())
@@ -98,6 +106,8 @@ void tempo_map_t::Add(uint32_t tempo, uint32_t time)
 /// </summary>
 uint32_t tempo_map_t::TimestampToMS(uint32_t timestamp, uint32_t timeDivision) const
 {
+    MIDI_COUNT(TempoLookups, 1);
+
     uint32_t TimestampInMS = 0;
     uint32_t Time = 0;
     uint32_t Tempo = 500000; // Default: 500000 μs per beat / 120 beats per minute
@@ -150,9 +160,15 @@ size_t sysex_table_t::AddItem(const uint8_t * data, std::size_t size, uint8_t po
         const sysex_item_t & Item = *it;
 
         if ((portNumber == Item.PortNumber) && (size == Item.Size) && (::memcmp(data, &_Data[Item.Offset], size) == 0))
+        {
+            MIDI_COUNT(SysExDedupHits, 1);
+
             return ((uint32_t) (it - _Items.begin()));
+        }
     }
 
+    MIDI_COUNT(SysExDedupMisses, 1);
+
     sysex_item_t Item(portNumber, _Data.size(), size);
 
     _Data.insert(_Data.end(), data, data + size);
@@ -232,6 +248,116 @@ const metadata_item_t & metadata_table_t::operator [] (std::size_t p_index) cons
 
 #pragma endregion
 
+#pragma region Event Filter
+
+/// <summary>
+/// Removes the event types in the mask. Bit n corresponds to event_t::event_type_t n.
+/// </summary>
+event_filter_t & event_filter_t::RemoveEventTypes(uint32_t eventTypeMask) noexcept
+{
+    _EventTypes |= eventTypeMask & ~(1u << event_t::Extended);
+
+    return *this;
+}
+
+/// <summary>
+/// Removes the channels in the mask. Bit n corresponds to channel n (0-based).
+/// </summary>
+event_filter_t & event_filter_t::RemoveChannels(uint32_t channelMask) noexcept
+{
+    _Channels |= channelMask;
+
+    return *this;
+}
+
+/// <summary>
+/// Removes the channel events sent to the normalized ports in the mask.
+/// </summary>
+event_filter_t & event_filter_t::RemovePorts(uint64_t portMask) noexcept
+{
+    _Ports |= portMask;
+
+    return *this;
+}
+
+/// <summary>
+/// Removes the control changes in the specified range of controllers (inclusive).
+/// </summary>
+event_filter_t & event_filter_t::RemoveControllers(uint8_t first, uint8_t last) noexcept
+{
+    for (uint32_t i = first; (i <= last) && (i < 128); ++i)
+        _Controllers[i >> 6] |= 1ULL << (i & 0x3F);
+
+    return *this;
+}
+
+/// <summary>
+/// Removes the channel events in the specified time range (in ticks, end exclusive).
+/// </summary>
+event_filter_t & event_filter_t::RemoveTimeRange(uint32_t begin, uint32_t end)
+{
+    if (begin < end)
+        _TimeRanges.push_back({ begin, end });
+
+    return *this;
+}
+
+/// <summary>
+/// Removes the Apogee Expanded MIDI (EMIDI) API v1.1 tracks that are not designated for General MIDI or the Roland Sound Canvas.
+/// </summary>
+event_filter_t & event_filter_t::RemoveEMIDITracks() noexcept
+{
+    _RemoveEMIDITracks = true;
+
+    return *this;
+}
+
+/// <summary>
+/// Creates a filter from the container clean flags.
+/// </summary>
+event_filter_t event_filter_t::FromCleanFlags(uint32_t cleanFlags)
+{
+    event_filter_t Filter;
+
+    if (cleanFlags & container_t::CleanFlagEMIDI)
+        Filter.RemoveEMIDITracks();
+
+    if (cleanFlags & container_t::CleanFlagInstruments)
+        Filter.RemoveEventTypes(1u << event_t::ProgramChange);
+
+    if (cleanFlags & container_t::CleanFlagBanks)
+    {
+        Filter.RemoveControllers(Controller::BankSelect, Controller::BankSelect);
+        Filter.RemoveControllers(Controller::BankSelectLSB, Controller::BankSelectLSB);
+    }
+
+    return Filter;
+}
+
+/// <summary>
+/// Returns true if the whole track should be removed.
+/// </summary>
+bool event_filter_t::MatchesTrack(const track_t & track) const noexcept
+{
+    if (!_RemoveEMIDITracks)
+        return false;
+
+    for (const auto & Event : track)
+    {
+        // Is it an EMIDI Track Designation control change?
+        if ((Event.Type == event_t::ControlChange) && (Event.Data[0] == 110))
+        {
+            // 0 = General MIDI, 1 = Roland Sound Canvas (GM only), 0x7F = All instruments (https://moddingwiki.shikadi.net/wiki/Apogee_Expanded_MIDI)
+            if ((Event.Data[1] != 0) && (Event.Data[1] != 1) && (Event.Data[1] != 0x7F))
+                return true;
+        }
+    }
+
+    return false;
+}
+
+#pragma endregion
+
 #pragma region MIDI Container
 
 void container_t::Initialize(uint32_t format, uint32_t timeDivision)
@@ -249,27 +375,131 @@ void container_t::Initialize(uint32_t format, uint32_t timeDivision)
         _EndTimestamps[0] = 0;
     }
 
+    _SubSongs.clear();
+
+    for (size_t i = 0; i < _ChannelMask.size(); ++i)
+    {
+        if (_ChannelMask[i] != 0)
+            _SubSongs.push_back(i);
+    }
+
     _Loop.resize(1);
 
     // Initialize the port number map.
     uint8_t PortNumber = 0; NormalizePortNumber(PortNumber);
 }
 
+/// <summary>
+/// Gets the id of a device name, adding the name if necessary. Device names are compared case-insensitively. Returns NoDeviceName for an empty name.
+/// </summary>
+uint32_t container_t::InternDeviceName(std::vector<uint8_t>::const_iterator begin, std::vector<uint8_t>::const_iterator end, std::string & name)
+{
+    const uint32_t Id = FindDeviceName(begin, end, name);
+
+    if (Id != UnknownDeviceName)
+        return Id;
+
+    return _DeviceNameIds.emplace(name, (uint32_t) _DeviceNameIds.size()).first->second;
+}
+
+/// <summary>
+/// Gets the id of a device name. Returns NoDeviceName for an empty name and UnknownDeviceName if the name was never added. The name buffer receives the lower-case name.
+/// </summary>
+uint32_t container_t::FindDeviceName(std::vector<uint8_t>::const_iterator begin, std::vector<uint8_t>::const_iterator end, std::string & name) const
+{
+    if (begin == end)
+        return NoDeviceName;
+
+    name.assign(begin, end);
+
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+
+    const auto it = _DeviceNameIds.find(name);
+
+    return (it != _DeviceNameIds.end()) ? it->second : UnknownDeviceName;
+}
+
+/// <summary>
+/// Gets the order in which the device name was first used on the channel. Returns the number of device names used on the channel if the name was not used on it.
+/// </summary>
+size_t container_t::GetDeviceIndex(uint32_t channelNumber, uint32_t nameId) const noexcept
+{
+    const auto & Indexes = _DeviceIndexes[channelNumber];
+
+    if ((nameId < Indexes.size()) && (Indexes[nameId] != 0))
+        return (size_t) Indexes[nameId] - 1;
+
+    return _DeviceCounts[channelNumber];
+}
+
 /// <summary>
 /// Adds a track to the container.
 /// </summary>
 void container_t::AddTrack(const track_t & track)
 {
+    MIDI_TIME_PHASE(AddTrack);
+
     _Tracks.push_back(track);
+    _IsTrackDirty.push_back(false);
 
+    size_t SummaryIndex = 0;
+
+    if (_Format == 2)
+    {
+        SummaryIndex = _Tracks.size() - 1;
+
+        _ChannelMask.resize(_Tracks.size(), 0);
+        _TempoMaps.resize(_Tracks.size());
+        _EndTimestamps.resize(_Tracks.size(), 0);
+
+        ScanTrack(SummaryIndex, _ChannelMask[SummaryIndex], _TempoMaps[SummaryIndex], _EndTimestamps[SummaryIndex]);
+    }
+    else
+    {
+        _TrackSummaries.resize(_Tracks.size());
+
+        track_summary_t & Summary = _TrackSummaries.back();
+
+        ScanTrack(_Tracks.size() - 1, Summary.ChannelMask, Summary.TempoMap, Summary.EndTimestamp);
+
+        MergeTrackSummary(Summary);
+    }
+
+    UpdateSubSong(SummaryIndex);
+}
+
+/// <summary>
+/// Adds the channels, tempo changes and end timestamp of a track of a format 0 or 1 file to the one and only summary.
+/// </summary>
+void container_t::MergeTrackSummary(const track_summary_t & summary)
+{
+    _ChannelMask[0] |= summary.ChannelMask;
+
+    for (size_t i = 0; i < summary.TempoMap.Size(); ++i)
+        _TempoMaps[0].Add(summary.TempoMap[i].Tempo, summary.TempoMap[i].Time);
+
+    if (summary.EndTimestamp > _EndTimestamps[0])
+        _EndTimestamps[0] = summary.EndTimestamp;
+}
+
+/// <summary>
+/// Adds the channels, tempo changes and end timestamp of a track to the specified summary. Loop regions are scanned as they are played.
+/// </summary>
+void container_t::ScanTrack(size_t trackIndex, uint64_t & channelMask, tempo_map_t & tempoMap, uint32_t & endTimestamp)
+{
     std::string DeviceName;
+    uint32_t DeviceNameId = NoDeviceName;
     uint8_t PortNumber = 0;
 
-    size_t EventIndex;
+    bool HasEvents = false;
+    uint32_t Time = 0;
 
-    for (EventIndex = 0; EventIndex < track.GetLength(); ++EventIndex)
+    for (track_cursor_t Cursor = GetTrackCursor(trackIndex); !Cursor.IsAtEnd(); Cursor.Next())
     {
-        const event_t & Event = track[EventIndex];
+        const event_t & Event = Cursor.GetEvent();
+
+        HasEvents = true;
+        Time = Cursor.GetTime();
 
         if (Event.Type == event_t::Extended)
         {
@@ -277,23 +507,14 @@ void container_t::AddTrack(const track_t & track)
             {
                 uint32_t Tempo = (uint32_t) ((Event.Data[2] << 16) | (Event.Data[3] << 8) | Event.Data[4]);
 
-                if (_Format != 2)
-                {
-                    _TempoMaps[0].Add(Tempo, Event.Time);
-                }
-                else
-                {
-                    _TempoMaps.resize(_Tracks.size());
-                    _TempoMaps[_Tracks.size() - 1].Add(Tempo, Event.Time);
-                }
+                tempoMap.Add(Tempo, Time);
             }
             else
             if ((Event.Data.size() >= 3) && (Event.Data[0] == StatusCode::MetaData))
             {
                 if (Event.Data[1] == MetaDataType::InstrumentName || Event.Data[1] == MetaDataType::DeviceName)
                 {
-                    DeviceName.assign(Event.Data.begin() + 2, Event.Data.end());
-                    std::transform(DeviceName.begin(), DeviceName.end(), DeviceName.begin(), ::tolower);
+                    DeviceNameId = InternDeviceName(Event.Data.begin() + 2, Event.Data.end(), DeviceName);
                 }
                 else
                 if (Event.Data[1] == MetaDataType::MIDIPort)
@@ -301,7 +522,7 @@ void container_t::AddTrack(const track_t & track)
                     PortNumber = Event.Data[2];
 
                     NormalizePortNumber(PortNumber);
-                    DeviceName.clear();
+                    DeviceNameId = NoDeviceName;
                 }
             }
         }
@@ -310,54 +531,38 @@ void container_t::AddTrack(const track_t & track)
         {
             uint32_t ChannelNumber = Event.ChannelNumber;
 
-            if (!DeviceName.empty())
+            if (DeviceNameId != NoDeviceName)
             {
-                size_t i;
+                size_t i = GetDeviceIndex(ChannelNumber, DeviceNameId);
 
-                for (i = 0; i < _DeviceNames[ChannelNumber].size(); ++i)
-                {
-                    if (_DeviceNames[ChannelNumber][i] == DeviceName)
-                        break;
-                }
-
-                if (i < _DeviceNames[ChannelNumber].size())
+                if (i < _DeviceCounts[ChannelNumber])
                     PortNumber = (uint8_t) i;
                 else
                 {
-                    _DeviceNames[ChannelNumber].push_back(DeviceName);
-                    PortNumber = (uint8_t) _DeviceNames[ChannelNumber].size();
+                    auto & Indexes = _DeviceIndexes[ChannelNumber];
+
+                    if (Indexes.size() <= DeviceNameId)
+                        Indexes.resize((size_t) DeviceNameId + 1);
+
+                    Indexes[DeviceNameId] = (uint16_t) ++_DeviceCounts[ChannelNumber];
+
+                    PortNumber = (uint8_t) _DeviceCounts[ChannelNumber];
                 }
 
                 NormalizePortNumber(PortNumber);
-                DeviceName.clear();
+                DeviceNameId = NoDeviceName;
             }
 
             ChannelNumber += 16 * PortNumber;
             ChannelNumber %= MaxChannels;
 
-            if (_Format != 2)
-                _ChannelMask[0] |= 1ULL << ChannelNumber;
-            else
-            {
-                _ChannelMask.resize(_Tracks.size(), 0);
-                _ChannelMask[_Tracks.size() - 1] |= 1ULL << ChannelNumber;
-            }
+            channelMask |= 1ULL << ChannelNumber;
         }
     }
 
     // Determine the file duration as the longest track in the file.
-    if ((_Format != 2) && (EventIndex > 0) && (track[EventIndex - 1].Time > _EndTimestamps[0]))
-    {
-        _EndTimestamps[0] = track[EventIndex - 1].Time;
-    }
-    else
-    if (_Format == 2)
-    {
-        if (EventIndex == 0)
-            _EndTimestamps.push_back((uint32_t) 0);
-        else
-            _EndTimestamps.push_back(track[EventIndex - 1].Time);
-    }
+    if (HasEvents && (Time > endTimestamp))
+        endTimestamp = Time;
 }
 
 void container_t::AddEventToTrack(size_t trackNumber, const event_t & event)
@@ -373,11 +578,15 @@ void container_t::AddEventToTrack(size_t trackNumber, const event_t & event)
         if (_Format != 2)
         {
             _TempoMaps[0].Add(Tempo, event.Time);
+            GetTrackSummary(trackNumber).TempoMap.Add(Tempo, event.Time);
         }
         else
         {
             _TempoMaps.resize(_Tracks.size());
             _TempoMaps[trackNumber].Add(Tempo, event.Time);
+            _ChannelMask.resize(_Tracks.size(), 0);
+
+            UpdateSubSong(trackNumber);
         }
     }
     else
@@ -386,17 +595,28 @@ void container_t::AddEventToTrack(size_t trackNumber, const event_t & event)
         if (_Format != 2)
         {
             _ChannelMask[0] |= 1ULL << event.ChannelNumber;
+            GetTrackSummary(trackNumber).ChannelMask |= 1ULL << event.ChannelNumber;
+
+            UpdateSubSong(0);
         }
         else
         {
             _ChannelMask.resize(_Tracks.size(), 0);
             _ChannelMask[trackNumber] |= 1ULL << event.ChannelNumber;
+
+            UpdateSubSong(trackNumber);
         }
     }
 
-    if ((_Format != 2) && (event.Time > _EndTimestamps[0]))
+    if (_Format != 2)
     {
-        _EndTimestamps[0] = event.Time;
+        if (event.Time > _EndTimestamps[0])
+            _EndTimestamps[0] = event.Time;
+
+        track_summary_t & Summary = GetTrackSummary(trackNumber);
+
+        if (event.Time > Summary.EndTimestamp)
+            Summary.EndTimestamp = event.Time;
     }
     else
     if ((_Format == 2) && (event.Time > _EndTimestamps[trackNumber]))
@@ -405,6 +625,17 @@ void container_t::AddEventToTrack(size_t trackNumber, const event_t & event)
     }
 }
 
+/// <summary>
+/// Gets the summary of a track of a format 0 or 1 file.
+/// </summary>
+container_t::track_summary_t & container_t::GetTrackSummary(size_t trackIndex)
+{
+    if (_TrackSummaries.size() < _Tracks.size())
+        _TrackSummaries.resize(_Tracks.size());
+
+    return _TrackSummaries[trackIndex];
+}
+
 void container_t::MergeTracks(const container_t & source)
 {
     for (size_t i = 0; i < source._Tracks.size(); i++)
@@ -414,6 +645,12 @@ void container_t::MergeTracks(const container_t & source)
 void container_t::SetTrackCount(uint32_t count)
 {
     _Tracks.resize(count);
+    _IsTrackDirty.resize(count, false);
+
+    if (_Format != 2)
+        _TrackSummaries.resize(count);
+
+    std::erase_if(_LoopRegions, [count](const loop_region_t & r) { return r.TrackIndex >= count; });
 }
 
 void container_t::SetExtraMetaData(const metadata_table_t & data)
@@ -426,43 +663,459 @@ void container_t::ApplyHack(uint32_t hack)
     switch (hack)
     {
         case 0: // Hack 0: Remove channel 16
-            for (size_t i = 0; i < _Tracks.size(); ++i)
-            {
-                track_t & t = _Tracks[i];
-
-                for (size_t j = 0; j < t.GetLength(); )
-                {
-                    if ((t[j].Type != event_t::Extended) && (t[j].ChannelNumber == 16))
-                    {
-                        t.RemoveEvent(j);
-                    }
-                    else
-                    {
-                        ++j;
-                    }
-                }
-            }
+            ApplyFilter(event_filter_t().RemoveChannels(1u << 15));
             break;
 
         case 1: // Hack 1: Remove channels 11-16
-            for (size_t i = 0; i < _Tracks.size(); ++i)
-            {
-                track_t & t = _Tracks[i];
+            ApplyFilter(event_filter_t().RemoveChannels(0xFC00u));
+            break;
+    }
+}
+
+/// <summary>
+/// Removes the events that match the filter from all tracks in a single pass per track. Returns the number of removed events.
+/// </summary>
+size_t container_t::ApplyFilter(const event_filter_t & filter)
+{
+    if (filter.IsEmpty())
+        return 0;
+
+    size_t Count = 0;
+
+    for (size_t i = 0; i < _Tracks.size(); ++i)
+    {
+        track_t & Track = _Tracks[i];
+
+        size_t n;
+
+        if (filter.MatchesTrack(Track))
+        {
+            n = Track.RemoveEvents([](const event_t & e) { return !e.IsEndOfTrack(); });
+        }
+        else
+        {
+            uint8_t PortNumber = 0;
 
-                for (size_t j = 0; j < t.GetLength(); )
+            n = Track.RemoveEvents([this, &filter, &PortNumber](const event_t & e)
+            {
+                if (e.IsPort() && (e.Data.size() >= 3))
                 {
-                    if (t[j].Type != event_t::Extended && (t[j].ChannelNumber - 10 < 6))
-                    {
-                        t.RemoveEvent(j);
-                    }
-                    else
-                    {
-                        ++j;
-                    }
+                    PortNumber = e.Data[2];
+
+                    NormalizePortNumber(PortNumber);
                 }
+
+                return filter.Matches(e, PortNumber);
+            });
+        }
+
+        if (n != 0)
+        {
+            MarkTrackDirty(i);
+            Count += n;
+        }
+    }
+
+    UpdateSummaries();
+
+    return Count;
+}
+
+/// <summary>
+/// Marks a track as modified. Call this after changing a track through GetTracks() or operator[] and before calling UpdateSummaries().
+/// </summary>
+void container_t::MarkTrackDirty(size_t trackIndex) noexcept
+{
+    if (trackIndex < _IsTrackDirty.size())
+        _IsTrackDirty[trackIndex] = true;
+}
+
+/// <summary>
+/// Recomputes the channel mask, tempo map and end timestamp of the subsongs that contain a modified track.
+/// </summary>
+void container_t::UpdateSummaries()
+{
+    _IsTrackDirty.resize(_Tracks.size(), false);
+
+    if (std::find(_IsTrackDirty.begin(), _IsTrackDirty.end(), true) == _IsTrackDirty.end())
+        return;
+
+    if (_Format != 2)
+    {
+        // Only the modified tracks are scanned again. All track summaries contribute to the one and only summary.
+        _TrackSummaries.resize(_Tracks.size());
+
+        for (size_t i = 0; i < _Tracks.size(); ++i)
+        {
+            if (!_IsTrackDirty[i])
+                continue;
+
+            track_summary_t & Summary = _TrackSummaries[i];
+
+            Summary = track_summary_t();
+
+            ScanTrack(i, Summary.ChannelMask, Summary.TempoMap, Summary.EndTimestamp);
+        }
+
+        _ChannelMask[0] = 0;
+        _TempoMaps[0].Clear();
+        _EndTimestamps[0] = 0;
+
+        for (const auto & Summary : _TrackSummaries)
+            MergeTrackSummary(Summary);
+
+        UpdateSubSong(0);
+
+        if (_Loop[0].HasEnd() && (_Loop[0].End() > _EndTimestamps[0]))
+            _Loop[0].SetEnd(_EndTimestamps[0]);
+    }
+    else
+    {
+        _ChannelMask.resize(_Tracks.size(), 0);
+        _TempoMaps.resize(_Tracks.size());
+        _EndTimestamps.resize(_Tracks.size(), 0);
+
+        std::erase_if(_SubSongs, [this](size_t i) { return i >= _ChannelMask.size(); });
+
+        for (size_t i = 0; i < _Tracks.size(); ++i)
+        {
+            if (!_IsTrackDirty[i])
+                continue;
+
+            _ChannelMask[i] = 0;
+            _TempoMaps[i].Clear();
+            _EndTimestamps[i] = 0;
+
+            ScanTrack(i, _ChannelMask[i], _TempoMaps[i], _EndTimestamps[i]);
+
+            UpdateSubSong(i);
+
+            if ((i < _Loop.size()) && _Loop[i].HasEnd() && (_Loop[i].End() > _EndTimestamps[i]))
+                _Loop[i].SetEnd(_EndTimestamps[i]);
+        }
+    }
+
+    std::fill(_IsTrackDirty.begin(), _IsTrackDirty.end(), false);
+}
+
+/// <summary>
+/// Sets the loops that are stored once in the tracks and repeated on playback. The summaries are recomputed as if the loops were expanded.
+/// </summary>
+void container_t::SetLoopRegions(std::vector<loop_region_t> && regions)
+{
+    for (const auto & Region : _LoopRegions)
+        MarkTrackDirty(Region.TrackIndex);
+
+    _LoopRegions = std::move(regions);
+
+    std::erase_if(_LoopRegions, [this](const loop_region_t & r) { return (r.TrackIndex >= _Tracks.size()) || (r.End <= r.Begin) || (r.Count == 0); });
+
+    std::sort(_LoopRegions.begin(), _LoopRegions.end(), [](const loop_region_t & a, const loop_region_t & b)
+    {
+        if (a.TrackIndex != b.TrackIndex)
+            return a.TrackIndex < b.TrackIndex;
+
+        if (a.Begin != b.Begin)
+            return a.Begin < b.Begin;
+
+        return a.End > b.End;
+    });
+
+    for (const auto & Region : _LoopRegions)
+        MarkTrackDirty(Region.TrackIndex);
+
+    UpdateSummaries();
+}
+
+/// <summary>
+/// Gets the loop regions of the specified track.
+/// </summary>
+std::span<const loop_region_t> container_t::GetLoopRegions(size_t trackIndex) const noexcept
+{
+    auto Head = std::lower_bound(_LoopRegions.begin(), _LoopRegions.end(), trackIndex, [](const loop_region_t & r, size_t index) { return r.TrackIndex < index; });
+    auto Tail = std::upper_bound(Head, _LoopRegions.end(), trackIndex, [](size_t index, const loop_region_t & r) { return index < r.TrackIndex; });
+
+    return std::span<const loop_region_t>(Head, Tail);
+}
+
+/// <summary>
+/// Returns the number of passes through a loop region.
+/// </summary>
+static uint32_t GetPassCount(const loop_region_t & region, uint32_t infiniteCount) noexcept
+{
+    if (region.IsInfinite && (infiniteCount != 0))
+        return infiniteCount;
+
+    return std::max(region.Count, 1u);
+}
+
+/// <summary>
+/// Returns the end of the regions that are nested in the specified region.
+/// </summary>
+static const loop_region_t * GetNextSibling(const loop_region_t * region, const loop_region_t * tail) noexcept
+{
+    const loop_region_t * Next = region + 1;
+
+    while ((Next < tail) && (Next->Begin < region->End))
+        ++Next;
+
+    return Next;
+}
+
+/// <summary>
+/// Returns true if the event ends a note.
+/// </summary>
+static bool IsNoteOff(const event_t & event) noexcept
+{
+    return (event.Type == event_t::NoteOff) || ((event.Type == event_t::NoteOn) && (event.Data.size() >= 2) && (event.Data[1] == 0));
+}
+
+/// <summary>
+/// Returns the first event with a timestamp at or after the specified time.
+/// </summary>
+static track_t::const_iterator FindFirstEvent(const track_t & track, uint32_t time) noexcept
+{
+    return std::lower_bound(track.begin(), track.end(), time, [](const event_t & e, uint32_t time) { return e.Time < time; });
+}
+
+/// <summary>
+/// Copies the events in the time range [begin, end) to the destination track, shifting their timestamps.
+/// </summary>
+static void CopyEvents(const track_t & src, uint32_t begin, uint32_t end, uint32_t shift, bool noteOffsOnly, track_t & dst)
+{
+    auto it = FindFirstEvent(src, begin);
+
+    for (; (it != src.end()) && (it->Time < end); ++it)
+    {
+        if (noteOffsOnly && !IsNoteOff(*it))
+            continue;
+
+        event_t Event(*it);
+
+        Event.Time += shift;
+
+        dst.AddEvent(Event);
+    }
+}
+
+/// <summary>
+/// Adds the segments that play the events in the time range [begin, end), repeating the loop regions. Returns the shift that applies to the events at the end of the range.
+/// </summary>
+static uint32_t AddSegments(const loop_region_t * head, const loop_region_t * tail, uint32_t begin, uint32_t end, uint32_t shift, uint32_t infiniteCount, std::vector<track_cursor_t::segment_t> & segments)
+{
+    auto AddSegment = [&segments](uint32_t begin, uint32_t end, uint32_t shift, bool noteOffsOnly)
+    {
+        if (begin < end)
+            segments.push_back({ begin, end, shift, noteOffsOnly });
+    };
+
+    uint32_t Time = begin;
+
+    for (const loop_region_t * Region = head; Region < tail; )
+    {
+        const loop_region_t * Next = GetNextSibling(Region, tail);
+
+        AddSegment(Time, Region->Begin, shift, false);
+
+        const uint32_t Length = Region->End - Region->Begin;
+        const uint32_t Count = GetPassCount(*Region, infiniteCount);
+
+        uint32_t PassShift = shift;
+
+        for (uint32_t i = 0; i < Count; ++i)
+        {
+            shift = AddSegments(Region + 1, Next, Region->Begin, Region->End, PassShift, infiniteCount, segments);
+
+            // Notes that end exactly at the end of the loop body are stopped before every repetition.
+            if (i + 1 < Count)
+                AddSegment(Region->End, Region->End + 1, shift, true);
+
+            PassShift = shift + Length;
+        }
+
+        Time = Region->End;
+        Region = Next;
+    }
+
+    AddSegment(Time, end, shift, false);
+
+    return shift;
+}
+
+/// <summary>
+/// Returns the shift of an event at the specified time during the first pass through the loop regions.
+/// </summary>
+static uint32_t GetShift(const loop_region_t * head, const loop_region_t * tail, uint32_t time) noexcept
+{
+    uint32_t Shift = 0;
+
+    for (const loop_region_t * Region = head; (Region < tail) && (Region->Begin <= time); )
+    {
+        const loop_region_t * Next = GetNextSibling(Region, tail);
+
+        if (time < Region->End)
+            return Shift + GetShift(Region + 1, Next, time);
+
+        const uint32_t Length = Region->End - Region->Begin;
+        const uint32_t Count = GetPassCount(*Region, 0);
+
+        Shift += (Count - 1) * Length + Count * GetShift(Region + 1, Next, Region->End);
+
+        Region = Next;
+    }
+
+    return Shift;
+}
+
+/// <summary>
+/// Creates a copy of a track with its loop regions expanded. Infinite loops are repeated the specified number of times or, if 0, the number of times chosen by the converter.
+/// </summary>
+void container_t::ExpandTrack(size_t trackIndex, uint32_t infiniteCount, track_t & track) const
+{
+    track = track_t();
+
+    if (trackIndex >= _Tracks.size())
+        return;
+
+    std::vector<track_cursor_t::segment_t> Segments;
+
+    track_cursor_t::GetSegments(GetLoopRegions(trackIndex), infiniteCount, Segments);
+
+    for (const auto & Segment : Segments)
+        CopyEvents(_Tracks[trackIndex], Segment.Begin, Segment.End, Segment.Shift, Segment.NoteOffsOnly, track);
+}
+
+/// <summary>
+/// Replaces the loop regions by their physical expansion. Infinite loops are repeated the specified number of times or, if 0, the number of times chosen by the converter.
+/// </summary>
+void container_t::RenderLoops(uint32_t infiniteCount)
+{
+    if (_LoopRegions.empty())
+        return;
+
+    for (size_t i = 0; i < _Tracks.size(); ++i)
+    {
+        if (GetLoopRegions(i).empty())
+            continue;
+
+        track_t Track;
+
+        ExpandTrack(i, infiniteCount, Track);
+
+        _Tracks[i] = Track;
+
+        MarkTrackDirty(i);
+    }
+
+    _LoopRegions.clear();
+
+    UpdateSummaries();
+}
+
+/// <summary>
+/// Converts the timestamp of an event in a track with loop regions to the timestamp of its first occurrence on playback.
+/// </summary>
+uint32_t container_t::GetExpandedTime(size_t trackIndex, uint32_t time) const noexcept
+{
+    auto Regions = GetLoopRegions(trackIndex);
+
+    return time + GetShift(Regions.data(), Regions.data() + Regions.size(), time);
+}
+
+/// <summary>
+/// Gets the segments of the stored events that are played, in playback order.
+/// </summary>
+void track_cursor_t::GetSegments(std::span<const loop_region_t> regions, uint32_t infiniteCount, std::vector<segment_t> & segments)
+{
+    segments.clear();
+
+    AddSegments(regions.data(), regions.data() + regions.size(), 0, ~0u, 0, infiniteCount, segments);
+}
+
+track_cursor_t::track_cursor_t(const track_t & track, std::span<const loop_region_t> regions, uint32_t infiniteCount) : _Track(&track), _SegmentIndex(), _EventIndex(), _Event(), _Time(), _EndOfTrack(), _EndOfTrackTime()
+{
+    if (!regions.empty())
+    {
+        GetSegments(regions, infiniteCount, _Segments);
+
+        _EventIndex = (size_t) (FindFirstEvent(track, _Segments[0].Begin) - track.begin());
+    }
+
+    Find();
+}
+
+/// <summary>
+/// Moves to the next event.
+/// </summary>
+void track_cursor_t::Next() noexcept
+{
+    if (_Event == nullptr)
+        return;
+
+    ++_EventIndex;
+
+    Find();
+}
+
+/// <summary>
+/// Finds the event at the current position or, if it is not played, the next event that is.
+/// </summary>
+void track_cursor_t::Find() noexcept
+{
+    const track_t & Track = *_Track;
+
+    // A track without loop regions is played as stored.
+    if (_Segments.empty())
+    {
+        if (_EventIndex < Track.GetLength())
+        {
+            _Event = &Track[_EventIndex];
+            _Time  = _Event->Time;
+        }
+        else
+            _Event = nullptr;
+
+        return;
+    }
+
+    while (_SegmentIndex < _Segments.size())
+    {
+        const segment_t & Segment = _Segments[_SegmentIndex];
+
+        for (; (_EventIndex < Track.GetLength()) && (Track[_EventIndex].Time < Segment.End); ++_EventIndex)
+        {
+            const event_t & Event = Track[_EventIndex];
+
+            if (Segment.NoteOffsOnly && !IsNoteOff(Event))
+                continue;
+
+            if ((_EndOfTrack == nullptr) && Event.IsEndOfTrack())
+            {
+                _EndOfTrack     = &Event;
+                _EndOfTrackTime = Event.Time + Segment.Shift;
+                continue;
             }
-            break;
+
+            _Event = &Event;
+            _Time  = Event.Time + Segment.Shift;
+
+            if (_Time > _EndOfTrackTime)
+                _EndOfTrackTime = _Time;
+
+            return;
+        }
+
+        // Move to the first event of the next segment.
+        if (++_SegmentIndex < _Segments.size())
+        {
+            _EventIndex = (size_t) (FindFirstEvent(Track, _Segments[_SegmentIndex].Begin) - Track.begin());
+        }
     }
+
+    _Event = _EndOfTrack;
+    _Time  = _EndOfTrackTime;
+
+    _EndOfTrack = nullptr;
 }
 
 /// <summary>
@@ -470,56 +1123,75 @@ void container_t::ApplyHack(uint32_t hack)
 /// </summary>
 void container_t::SerializeAsStream(size_t subSongIndex, std::vector<message_t> & midiStream, sysex_table_t & sysExTable, std::vector<uint8_t> & portNumbers, uint32_t & loopBegin, uint32_t & loopEnd, uint32_t cleanFlags) const
 {
+    SerializeAsStream(subSongIndex, midiStream, sysExTable, portNumbers, loopBegin, loopEnd, event_filter_t::FromCleanFlags(cleanFlags));
+}
+
+/// <summary>
+/// Serializes the tracks as a stream of MIDI events, skipping the events that match the filter.
+/// </summary>
+void container_t::SerializeAsStream(size_t subSongIndex, std::vector<message_t> & midiStream, sysex_table_t & sysExTable, std::vector<uint8_t> & portNumbers, uint32_t & loopBegin, uint32_t & loopEnd, const event_filter_t & filter) const
+{
+    SerializeEvents(subSongIndex, midiStream, sysExTable, portNumbers, loopBegin, loopEnd, filter, [](tempo_cursor_t & tempoCursor, uint32_t timestamp)
+    {
+        return tempoCursor.TimestampToMS(timestamp);
+    });
+}
+
+/// <summary>
+/// Serializes the tracks as a stream of MIDI events with exact 64-bit timestamps, skipping the events that match the filter.
+/// The timestamps are expressed in units of 1 / unitsPerSecond s, e.g. in μs (TimeUnitMicroseconds) or in samples at a sample rate.
+/// </summary>
+void container_t::SerializeAsStream(size_t subSongIndex, std::vector<timed_message_t> & midiStream, sysex_table_t & sysExTable, std::vector<uint8_t> & portNumbers, uint32_t & loopBegin, uint32_t & loopEnd, const event_filter_t & filter, uint32_t unitsPerSecond) const
+{
+    SerializeEvents(subSongIndex, midiStream, sysExTable, portNumbers, loopBegin, loopEnd, filter, [unitsPerSecond](tempo_cursor_t & tempoCursor, uint32_t timestamp)
+    {
+        return tempoCursor.TimestampToTime(timestamp, unitsPerSecond);
+    });
+}
+
+/// <summary>
+/// Merges the events of the tracks of the subsong into a stream of messages. The function converts the timestamps of the events from ticks.
+/// </summary>
+template <typename T, typename F>
+void container_t::SerializeEvents(size_t subSongIndex, std::vector<T> & midiStream, sysex_table_t & sysExTable, std::vector<uint8_t> & portNumbers, uint32_t & loopBegin, uint32_t & loopEnd, const event_filter_t & filter, F timestampToTime) const
+{
+    MIDI_TIME_PHASE(Serialization);
+
     uint32_t LoopBeginTimestamp = GetLoopBeginTimestamp(subSongIndex);
     uint32_t LoopEndTimestamp = GetLoopEndTimestamp(subSongIndex);
 
     size_t LoopBegin = ~0UL;
     size_t LoopEnd = ~0UL;
 
-    size_t TrackCount = _Tracks.size();
+    // Only the tracks of the subsong are merged.
+    const subsong_view_t SubSong = GetSubSongView(subSongIndex);
 
-    std::vector<std::size_t> TrackPositions(TrackCount, 0);
-    std::vector<uint8_t> PortNumbers(TrackCount, 0);
-    std::vector<std::string> DeviceNames(TrackCount);
+    // The events are merged in time order so the tempo map is only walked once.
+    tempo_cursor_t TempoCursor(SubSong);
 
-    bool CleanEMIDI = (cleanFlags & CleanFlagEMIDI) == CleanFlagEMIDI;
-    bool CleanInstruments = (cleanFlags & CleanFlagInstruments) == CleanFlagInstruments;
-    bool CleanBanks = (cleanFlags & CleanFlagBanks) == CleanFlagBanks;
+    // The loop regions are repeated while the tracks are merged.
+    std::vector<track_cursor_t> Cursors;
 
-    if (CleanEMIDI) // Apogee Expanded MIDI (EMIDI) API v1.1
-    {
-        for (size_t i = 0; i < TrackCount; ++i)
-        {
-            bool SkipTrack = false;
+    Cursors.reserve(SubSong.TrackCount);
 
-            const track_t & Track = _Tracks[i];
+    for (size_t i = 0; i < SubSong.TrackCount; ++i)
+        Cursors.push_back(GetTrackCursor(SubSong.FirstTrack + i));
 
-            for (size_t j = 0; j < Track.GetLength(); ++j)
-            {
-                const event_t & Event = Track[j];
+    size_t TrackCount = Cursors.size();
 
-                // Is it an EMIDI Track Designation control change?
-                if ((Event.Type == event_t::ControlChange) && (Event.Data[0] == 110))
-                {
-                    // 0 = General MIDI, 1 = Roland Sound Canvas (GM only), 0x7F = All instruments (https://moddingwiki.shikadi.net/wiki/Apogee_Expanded_MIDI)
-                    if ((Event.Data[1] != 0) && (Event.Data[1] != 1) && (Event.Data[1] != 0x7F))
-                    {
-                        SkipTrack = true;
-                        break;
-                    }
-                }
-            }
+    std::vector<uint8_t> PortNumbers(TrackCount, 0);
+    std::vector<uint32_t> DeviceNameIds(TrackCount, NoDeviceName);
+    std::string DeviceName;
 
-            if (SkipTrack)
-                TrackPositions[i] = Track.GetLength();
-        }
-    }
+    const bool IsFilterEmpty = filter.IsEmpty();
 
-    if (_Format == 2)
+    if (!IsFilterEmpty)
     {
         for (size_t i = 0; i < TrackCount; ++i)
-            if (i != subSongIndex)
-                TrackPositions[i] = _Tracks[i].GetLength();
+        {
+            if (filter.MatchesTrack(_Tracks[SubSong.FirstTrack + i]))
+                Cursors[i].MoveToEnd();
+        }
     }
 
     std::vector<uint8_t> Data;
@@ -530,63 +1202,43 @@ void container_t::SerializeAsStream(size_t subSongIndex, std::vector<message_t>
 
         // Select which track can provide the next event.
         {
-            uint32_t NextTimestamp = ~0UL;
+            uint32_t NextTimestamp = ~0U;
 
             for (size_t i = 0; i < TrackCount; ++i)
             {
-                if (TrackPositions[i] >= _Tracks[i].GetLength())
+                if (Cursors[i].IsAtEnd())
                     continue;
 
-                if (_Tracks[i][TrackPositions[i]].Time < NextTimestamp)
+                if (Cursors[i].GetTime() < NextTimestamp)
                 {
-                    NextTimestamp = _Tracks[i][TrackPositions[i]].Time;
+                    NextTimestamp = Cursors[i].GetTime();
                     SelectedTrack = i;
                 }
             }
 
-            if (NextTimestamp == ~0UL)
+            if (NextTimestamp == ~0U)
                 break;
         }
 
-        const event_t & Event = _Tracks[SelectedTrack][TrackPositions[SelectedTrack]];
-
-        bool IsEventFiltered = false;
-
-        if (CleanInstruments || CleanBanks)
-        {
-            if (CleanInstruments && (Event.Type == event_t::ProgramChange))
-                IsEventFiltered = true;
-            else
-            if (CleanBanks && (Event.Type == event_t::ControlChange) && (Event.Data[0] == 0x00u || Event.Data[0] == 0x20u))
-                IsEventFiltered = true;
-        }
+        const event_t & Event = Cursors[SelectedTrack].GetEvent();
+        const uint32_t Timestamp = Cursors[SelectedTrack].GetTime();
 
-        if (!IsEventFiltered)
+        if (IsFilterEmpty || !filter.Matches(Event, Timestamp, PortNumbers[SelectedTrack]))
         {
-            if ((LoopBegin == ~0UL) && (Event.Time >= LoopBeginTimestamp))
+            if ((LoopBegin == ~0UL) && (Timestamp >= LoopBeginTimestamp))
                 LoopBegin = midiStream.size();
 
-            if ((LoopEnd == ~0UL) && (Event.Time > LoopEndTimestamp))
+            if ((LoopEnd == ~0UL) && (Timestamp > LoopEndTimestamp))
                 LoopEnd = midiStream.size();
 
-            uint32_t TempoTrackIndex = ((_Format == 2) && (subSongIndex > 0)) ? (uint32_t) subSongIndex : 0;
-
-            uint32_t TimestampInMS = TimestampToMS(Event.Time, TempoTrackIndex);
+            const auto Time = timestampToTime(TempoCursor, Timestamp);
 
             if (Event.Type != event_t::Extended)
             {
-                if (!DeviceNames[SelectedTrack].empty())
+                if (DeviceNameIds[SelectedTrack] != NoDeviceName)
                 {
-                    size_t i;
-
-                    for (i = 0; i < _DeviceNames[Event.ChannelNumber].size(); ++i)
-                    {
-                        if (_DeviceNames[Event.ChannelNumber][i] == DeviceNames[SelectedTrack])
-                            break;
-                    }
-
-                    PortNumbers[SelectedTrack] = (uint8_t) i;
-                    DeviceNames[SelectedTrack].clear();
+                    PortNumbers[SelectedTrack] = (uint8_t) GetDeviceIndex(Event.ChannelNumber, DeviceNameIds[SelectedTrack]);
+                    DeviceNameIds[SelectedTrack] = NoDeviceName;
 
                     NormalizePortNumber(PortNumbers[SelectedTrack]);
                 }
@@ -602,7 +1254,7 @@ void container_t::SerializeAsStream(size_t subSongIndex, std::vector<message_t>
 
                 Message += PortNumbers[SelectedTrack] << 24;
 
-                midiStream.push_back(message_t(TimestampInMS, Message));
+                midiStream.push_back(T(Time, Message));
             }
             else
             {
@@ -610,18 +1262,10 @@ void container_t::SerializeAsStream(size_t subSongIndex, std::vector<message_t>
 
                 if ((DataSize >= 3) && (Event.Data[0] == StatusCode::SysEx))
                 {
-                    if (!DeviceNames[SelectedTrack].empty())
+                    if (DeviceNameIds[SelectedTrack] != NoDeviceName)
                     {
-                        size_t i, j;
-
-                        for (i = 0, j = _DeviceNames[Event.ChannelNumber].size(); i < j; ++i)
-                        {
-                            if (_DeviceNames[Event.ChannelNumber][i] == DeviceNames[SelectedTrack])
-                                break;
-                        }
-
-                        PortNumbers[SelectedTrack] = (uint8_t) i;
-                        DeviceNames[SelectedTrack].clear();
+                        PortNumbers[SelectedTrack] = (uint8_t) GetDeviceIndex(Event.ChannelNumber, DeviceNameIds[SelectedTrack]);
+                        DeviceNameIds[SelectedTrack] = NoDeviceName;
 
                         NormalizePortNumber(PortNumbers[SelectedTrack]);
                     }
@@ -632,7 +1276,7 @@ void container_t::SerializeAsStream(size_t subSongIndex, std::vector<message_t>
                     {
                         uint32_t Index = (uint32_t) sysExTable.AddItem(Data.data(), DataSize, PortNumbers[SelectedTrack]) | 0x80000000u;
 
-                        midiStream.push_back(message_t(TimestampInMS, Index));
+                        midiStream.push_back(T(Time, Index));
                     }
                 }
                 else
@@ -640,15 +1284,13 @@ void container_t::SerializeAsStream(size_t subSongIndex, std::vector<message_t>
                 {
                     if (Event.Data[1] == MetaDataType::InstrumentName || Event.Data[1] == MetaDataType::DeviceName)
                     {
-                        DeviceNames[SelectedTrack].assign(Event.Data.begin() + 2, Event.Data.end());
-
-                        std::transform(DeviceNames[SelectedTrack].begin(), DeviceNames[SelectedTrack].end(), DeviceNames[SelectedTrack].begin(), ::tolower);
+                        DeviceNameIds[SelectedTrack] = FindDeviceName(Event.Data.begin() + 2, Event.Data.end(), DeviceName);
                     }
                     else
                     if (Event.Data[1] == MetaDataType::MIDIPort)
                     {
                         PortNumbers[SelectedTrack] = Event.Data[2];
-                        DeviceNames[SelectedTrack].clear();
+                        DeviceNameIds[SelectedTrack] = NoDeviceName;
 
                         NormalizePortNumber(PortNumbers[SelectedTrack]);
                     }
@@ -656,18 +1298,10 @@ void container_t::SerializeAsStream(size_t subSongIndex, std::vector<message_t>
                 else
                 if ((DataSize == 1) && (Event.Data[0] > StatusCode::SysExEnd))
                 {
-                    if (!DeviceNames[SelectedTrack].empty())
+                    if (DeviceNameIds[SelectedTrack] != NoDeviceName)
                     {
-                        size_t i, j;
-
-                        for (i = 0, j = _DeviceNames[Event.ChannelNumber].size(); i < j; ++i)
-                        {
-                            if (_DeviceNames[Event.ChannelNumber][i] == DeviceNames[SelectedTrack])
-                                break;
-                        }
-
-                        PortNumbers[SelectedTrack] = (uint8_t) i;
-                        DeviceNames[SelectedTrack].clear();
+                        PortNumbers[SelectedTrack] = (uint8_t) GetDeviceIndex(Event.ChannelNumber, DeviceNameIds[SelectedTrack]);
+                        DeviceNameIds[SelectedTrack] = NoDeviceName;
 
                         NormalizePortNumber(PortNumbers[SelectedTrack]);
                     }
@@ -676,12 +1310,12 @@ void container_t::SerializeAsStream(size_t subSongIndex, std::vector<message_t>
 
                     Message += Event.Data[0];
 
-                    midiStream.push_back(message_t(TimestampInMS, Message));
+                    midiStream.push_back(T(Time, Message));
                 }
             }
         }
 
-        TrackPositions[SelectedTrack]++;
+        Cursors[SelectedTrack].Next();
     }
 
     portNumbers = _PortNumbers;
@@ -690,6 +1324,16 @@ void container_t::SerializeAsStream(size_t subSongIndex, std::vector<message_t>
     loopEnd   = (uint32_t) LoopEnd;
 }
 
+/// <summary>
+/// Serializes the tracks as a stream of MIDI events, skipping the events that match the filter, and builds a seek index for the stream.
+/// </summary>
+void container_t::SerializeAsStream(size_t subSongIndex, std::vector<message_t> & midiStream, sysex_table_t & sysExTable, std::vector<uint8_t> & portNumbers, uint32_t & loopBegin, uint32_t & loopEnd, const event_filter_t & filter, seek_index_t & seekIndex) const
+{
+    SerializeAsStream(subSongIndex, midiStream, sysExTable, portNumbers, loopBegin, loopEnd, filter);
+
+    seekIndex.Build(midiStream, sysExTable);
+}
+
 /// <summary>
 /// Serializes the tracks as an SMF file.
 /// </summary>
@@ -698,6 +1342,8 @@ void container_t::SerializeAsSMF(std::vector<uint8_t> & midiStream) const
     if (_Tracks.size() == 0)
         return;
 
+    MIDI_TIME_PHASE(Serialization);
+
     const char Signature[] = "MThd";
 
     midiStream.insert(midiStream.end(), Signature, Signature + 4);
@@ -714,9 +1360,7 @@ void container_t::SerializeAsSMF(std::vector<uint8_t> & midiStream) const
     midiStream.push_back((uint8_t)(_TimeDivision >> 8));
     midiStream.push_back((uint8_t) _TimeDivision);
 
-    std::vector<uint8_t> Data;
-
-    for (const track_t & Track : _Tracks)
+    for (size_t i = 0; i < _Tracks.size(); ++i)
     {
         const char ChunkType[] = "MTrk";
 
@@ -732,11 +1376,14 @@ void container_t::SerializeAsSMF(std::vector<uint8_t> & midiStream) const
         uint32_t RunningTime = 0;
         uint8_t RunningStatus = StatusCode::MetaData;
 
-        for (const event_t & Event : Track)
+        // The loop regions are repeated while the track is written.
+        for (track_cursor_t Cursor = GetTrackCursor(i); !Cursor.IsAtEnd(); Cursor.Next())
         {
-            EncodeVariableLengthQuantity(midiStream, Event.Time - RunningTime);
+            const event_t & Event = Cursor.GetEvent();
 
-            RunningTime = Event.Time;
+            EncodeVariableLengthQuantity(midiStream, Cursor.GetTime() - RunningTime);
+
+            RunningTime = Cursor.GetTime();
 
             if (Event.Type != event_t::Extended)
             {
@@ -815,6 +1462,8 @@ void container_t::PromoteToType1()
     }
 
     _Tracks.resize(0);
+    _IsTrackDirty.clear();
+    _TrackSummaries.clear();
 
     for (std::size_t i = 0; i < original_data_track.GetLength(); ++i)
     {
@@ -852,31 +1501,107 @@ void container_t::PromoteToType1()
 
 size_t container_t::GetSubSongCount() const
 {
-    size_t SubSongCount = 0;
+    return _SubSongs.size();
+}
 
-    for (size_t i = 0; i < _ChannelMask.size(); ++i)
-    {
-        if (_ChannelMask[i])
-            ++SubSongCount;
-    }
+/// <summary>
+/// Returns the index of the n-th subsong that contains channel events.
+/// </summary>
+size_t container_t::GetSubSong(size_t index) const noexcept
+{
+    return (index < _SubSongs.size()) ? _SubSongs[index] : 0;
+}
+
+/// <summary>
+/// Gets the tracks and the timing of the specified subsong.
+/// </summary>
+subsong_view_t container_t::GetSubSongView(size_t subSongIndex) const noexcept
+{
+    if (_Format != 2)
+        return GetSummaryView(0);
+
+    subsong_view_t View = GetSummaryView(subSongIndex);
 
-    return SubSongCount;
+    View.FirstTrack = (std::min)(subSongIndex, _Tracks.size());
+    View.TrackCount = (subSongIndex < _Tracks.size()) ? 1 : 0;
+
+    return View;
 }
 
-size_t container_t::GetSubSong(size_t index) const
+/// <summary>
+/// Gets a view of all tracks with the timing of the specified summary.
+/// </summary>
+subsong_view_t container_t::GetSummaryView(size_t summaryIndex) const noexcept
 {
-    for (size_t i = 0; i < _ChannelMask.size(); ++i)
+    subsong_view_t View = { 0, _Tracks.size(), nullptr, DefaultTempo, _TimeDivision, 0, 0 };
+
+    const size_t TempoMapCount = _TempoMaps.size();
+
+    if (summaryIndex < _StartTempos.size())
+        View.StartTempo = _StartTempos[summaryIndex];
+
+    if (summaryIndex < TempoMapCount)
+        View.TempoMap = &_TempoMaps[summaryIndex];
+
+    if (summaryIndex < _ChannelMask.size())
+        View.ChannelMask = _ChannelMask[summaryIndex];
+
+    if (summaryIndex < _EndTimestamps.size())
+        View.EndTimestamp = _EndTimestamps[summaryIndex];
+
+    return View;
+}
+
+/// <summary>
+/// Adds the summary to or removes it from the list of subsongs and updates the start tempo of the summaries that follow it after its channel mask or tempo map changed.
+/// </summary>
+void container_t::UpdateSubSong(size_t summaryIndex)
+{
+    while (!_SubSongs.empty() && (_SubSongs.back() >= _ChannelMask.size()))
+        _SubSongs.pop_back();
+
+    auto it = std::lower_bound(_SubSongs.begin(), _SubSongs.end(), summaryIndex);
+
+    const bool IsListed = (it != _SubSongs.end()) && (*it == summaryIndex);
+
+    if (_ChannelMask[summaryIndex] != 0)
+    {
+        if (!IsListed)
+            _SubSongs.insert(it, summaryIndex);
+    }
+    else
+    if (IsListed)
+        _SubSongs.erase(it);
+
+    // The summary starts with the last tempo of the preceding summary. The following summaries inherit its last tempo up to and including the next one that changes the tempo.
+    _StartTempos.resize(_TempoMaps.size(), DefaultTempo);
+
+    if (summaryIndex >= _StartTempos.size())
+        return;
+
+    uint32_t Tempo = DefaultTempo;
+
+    if (summaryIndex > 0)
+    {
+        const tempo_map_t & TempoMap = _TempoMaps[summaryIndex - 1];
+
+        Tempo = (TempoMap.Size() > 0) ? TempoMap[TempoMap.Size() - 1].Tempo : _StartTempos[summaryIndex - 1];
+    }
+
+    for (size_t i = summaryIndex; i < _StartTempos.size(); ++i)
     {
-        if (_ChannelMask[i])
+        _StartTempos[i] = Tempo;
+
+        const tempo_map_t & TempoMap = _TempoMaps[i];
+
+        if (TempoMap.Size() > 0)
         {
-            if (index == 0)
-                return i;
+            if (i != summaryIndex)
+                break;
 
-            --index;
+            Tempo = TempoMap[TempoMap.Size() - 1].Tempo;
         }
     }
-
-    return 0;
 }
 
 /// <summary>
@@ -926,16 +1651,16 @@ uint32_t container_t::GetLoopBeginTimestamp(size_t subSongIndex, bool ms /* = fa
     if ((_Format == 2) && (subSongIndex > 0))
     {
         TrackIndex = subSongIndex;
-        Timestamp = _Loop[subSongIndex].Begin();
+        Timestamp = (subSongIndex < _Loop.size()) ? _Loop[subSongIndex].Begin() : ~0U;
     }
 
     if (!ms)
         return Timestamp;
 
-    if (Timestamp != ~0UL)
+    if (Timestamp != ~0U)
         return TimestampToMS(Timestamp, TrackIndex);
 
-    return ~0UL;
+    return ~0U;
 }
 
 uint32_t container_t::GetLoopEndTimestamp(size_t subSongIndex, bool ms /* = false */) const
@@ -947,16 +1672,16 @@ uint32_t container_t::GetLoopEndTimestamp(size_t subSongIndex, bool ms /* = fals
     if ((_Format == 2) && (subSongIndex > 0))
     {
         TrackIndex = subSongIndex;
-        Timestamp = _Loop[subSongIndex].End();
+        Timestamp = (subSongIndex < _Loop.size()) ? _Loop[subSongIndex].End() : ~0U;
     }
 
     if (!ms)
         return Timestamp;
 
-    if (Timestamp != ~0UL)
+    if (Timestamp != ~0U)
         return TimestampToMS(Timestamp, TrackIndex);
 
-    return ~0UL;
+    return ~0U;
 }
 
 void container_t::GetMetaData(size_t subSongIndex, metadata_table_t & metaData)
@@ -966,13 +1691,10 @@ void container_t::GetMetaData(size_t subSongIndex, metadata_table_t & metaData)
 
     bool IsSoftKaraoke = false;
 
-    for (size_t i = 0; i < _Tracks.size(); ++i)
-    {
-        if ((_Format == 2) && (i != subSongIndex))
-            continue;
-
-        size_t TempoTrackIndex = (_Format == 2) ? i : 0;
+    const subsong_view_t SubSong = GetSubSongView(subSongIndex);
 
+    for (size_t i = SubSong.FirstTrack; i < SubSong.FirstTrack + SubSong.TrackCount; ++i)
+    {
         const track_t & Track = _Tracks[i];
 
         for (size_t j = 0; j < Track.GetLength(); ++j)
@@ -988,39 +1710,52 @@ void container_t::GetMetaData(size_t subSongIndex, metadata_table_t & metaData)
 
             if ((DataSize > 0) && (Event.Data[0] == StatusCode::SysEx))
             {
-                if ((DataSize == sizeof(sysex_t::GM1SystemOn)) && (::memcmp(Event.Data.data(), sysex_t::GM1SystemOn, sizeof(sysex_t::GM1SystemOn)) == 0))
-                    NewType = "GM"; // 1991
-                else
-                if ((DataSize == sizeof(sysex_t::GSReset)) && (::memcmp(Event.Data.data(), sysex_t::GSReset, sizeof(sysex_t::GSReset)) == 0))
-                    NewType = "GS"; // 1991
-                else
-                if ((DataSize == sizeof(sysex_t::GM2SystemOn)) && (::memcmp(Event.Data.data(), sysex_t::GM2SystemOn, sizeof(sysex_t::GM2SystemOn)) == 0))
-                    NewType = "GM2"; // 1999, 2003 v1.1, 2007 v1.2
-                else
-                if ((DataSize == sizeof(sysex_t::XGSystemOn)) && (::memcmp(Event.Data.data(), sysex_t::XGSystemOn, sizeof(sysex_t::XGSystemOn)) == 0))
-                    NewType = "XG"; // 1994 Level 1, 1997 Level 2, 1998, Level 3
-                else
-                if ((DataSize == sizeof(sysex_t::XGReset)) && (::memcmp(Event.Data.data(), sysex_t::XGReset, sizeof(sysex_t::XGReset)) == 0))
-                    NewType = "XG"; // 1994 Level 1, 1997 Level 2, 1998, Level 3
-                else
-                if ((DataSize > 1) && (Event.Data[1] == 0x42u))
-                    NewType = "X5"; // 1994 Korg X5
-                else
-                if ((DataSize > 4) && (Event.Data[1] == 0x41u))
+                const sysex_info_t Info = sysex_t::Classify(Event.Data);
+
+                switch (Info.Type)
                 {
-                    switch (Event.Data[3])
+                    case sysex_type_t::GM1SystemOn:
+                        NewType = "GM"; // 1991
+                        break;
+
+                    case sysex_type_t::GSReset:
+                        NewType = "GS"; // 1991
+                        break;
+
+                    case sysex_type_t::GM2SystemOn:
+                        NewType = "GM2"; // 1999, 2003 v1.1, 2007 v1.2
+                        break;
+
+                    case sysex_type_t::XGSystemOn:
+                    case sysex_type_t::XGReset:
+                        NewType = "XG"; // 1994 Level 1, 1997 Level 2, 1998, Level 3
+                        break;
+
+                    default:
                     {
-                        case 0x42u:
-                            NewType = "GS"; // 1991
+                        if (Info.IsExtendedId)
                             break;
 
-                        case 0x16u:
-                            NewType = "MT-32"; // 1987 Roland MT-32
-                            break;
+                        if (Info.Manufacturer == 0x42u)
+                            NewType = "X5"; // 1994 Korg X5
+                        else
+                        if ((DataSize > 4) && (Info.Manufacturer == 0x41u))
+                        {
+                            switch (Info.Model)
+                            {
+                                case 0x42u:
+                                    NewType = "GS"; // 1991
+                                    break;
 
-                        case 0x14u:
-                            NewType = "D-50"; // 1987 Roland D-50
-                            break;
+                                case 0x16u:
+                                    NewType = "MT-32"; // 1987 Roland MT-32
+                                    break;
+
+                                case 0x14u:
+                                    NewType = "D-50"; // 1987 Roland D-50
+                                    break;
+                            }
+                        }
                     }
                 }
             }
@@ -1045,14 +1780,14 @@ void container_t::GetMetaData(size_t subSongIndex, metadata_table_t & metaData)
 
                             if (IsSoftKaraoke)
                             {
-                                metaData.AddItem(metadata_item_t(TimestampToMS(Event.Time, TempoTrackIndex), "lyrics_type", "Soft Karaoke"));
+                                metaData.AddItem(metadata_item_t(SubSong.TimestampToMS(Event.Time), "lyrics_type", "Soft Karaoke"));
                             }
                             else
                             {
                                 ::sprintf_s(Name, _countof(Name), "track_text_%02zd", i);
                                 AssignString((const char *) Event.Data.data() + 2, DataSize, Text);
 
-                                metaData.AddItem(metadata_item_t(TimestampToMS(Event.Time, TempoTrackIndex), Name, Text.c_str()));
+                                metaData.AddItem(metadata_item_t(SubSong.TimestampToMS(Event.Time), Name, Text.c_str()));
                             }
                         }
                         else
@@ -1061,35 +1796,35 @@ void container_t::GetMetaData(size_t subSongIndex, metadata_table_t & metaData)
                             {
                                 AssignString((const char *) Event.Data.data() + 4, DataSize - 2, Text);
 
-                                metaData.AddItem(metadata_item_t(TimestampToMS(Event.Time, TempoTrackIndex), "soft_karaoke_version", Text.c_str()));
+                                metaData.AddItem(metadata_item_t(SubSong.TimestampToMS(Event.Time), "soft_karaoke_version", Text.c_str()));
                             }
                             else
                             if ((DataSize > 2) && (::_strnicmp((const char *) Event.Data.data() + 2, "@L", 2) == 0))
                             {
                                 AssignString((const char *) Event.Data.data() + 4, DataSize - 2, Text);
 
-                                metaData.AddItem(metadata_item_t(TimestampToMS(Event.Time, TempoTrackIndex), "soft_karaoke_language", Text.c_str()));
+                                metaData.AddItem(metadata_item_t(SubSong.TimestampToMS(Event.Time), "soft_karaoke_language", Text.c_str()));
                             }
                             else
                             if ((DataSize > 2) && (::_strnicmp((const char *) Event.Data.data() + 2, "@T", 2) == 0))
                             {
                                 AssignString((const char *) Event.Data.data() + 4, DataSize - 2, Text);
 
-                                metaData.AddItem(metadata_item_t(TimestampToMS(Event.Time, TempoTrackIndex), "soft_karaoke_text", Text.c_str()));
+                                metaData.AddItem(metadata_item_t(SubSong.TimestampToMS(Event.Time), "soft_karaoke_text", Text.c_str()));
                             }
                             else
                             if ((DataSize > 2) && (::_strnicmp((const char *) Event.Data.data() + 2, "@I", 2) == 0))
                             {
                                 AssignString((const char *) Event.Data.data() + 4, DataSize - 2, Text);
 
-                                metaData.AddItem(metadata_item_t(TimestampToMS(Event.Time, TempoTrackIndex), "soft_karaoke_info", Text.c_str()));
+                                metaData.AddItem(metadata_item_t(SubSong.TimestampToMS(Event.Time), "soft_karaoke_info", Text.c_str()));
                             }
                             else
                             if ((DataSize > 2) && (::_strnicmp((const char *) Event.Data.data() + 2, "@W", 2) == 0))
                             {
                                 AssignString((const char *) Event.Data.data() + 4, DataSize - 2, Text);
 
-                                metaData.AddItem(metadata_item_t(TimestampToMS(Event.Time, TempoTrackIndex), "soft_karaoke_words", Text.c_str()));
+                                metaData.AddItem(metadata_item_t(SubSong.TimestampToMS(Event.Time), "soft_karaoke_words", Text.c_str()));
                             }
                             else
                             if ((DataSize > 2) && (Event.Data[2] == '@'))
@@ -1098,13 +1833,13 @@ void container_t::GetMetaData(size_t subSongIndex, metadata_table_t & metaData)
                                 ::sprintf_s(Name, _countof(Name), "track_text_%02zd", i);
                                 AssignString((const char *) Event.Data.data() + 2, DataSize, Text);
 
-                                metaData.AddItem(metadata_item_t(TimestampToMS(Event.Time, TempoTrackIndex), Name, Text.c_str()));
+                                metaData.AddItem(metadata_item_t(SubSong.TimestampToMS(Event.Time), Name, Text.c_str()));
                             }
                             else
                             {
                                 AssignString((const char *) Event.Data.data() + 2, DataSize, Text);
 
-                                metaData.AddItem(metadata_item_t(TimestampToMS(Event.Time, TempoTrackIndex), "soft_karaoke_lyrics", Text.c_str()));
+                                metaData.AddItem(metadata_item_t(SubSong.TimestampToMS(Event.Time), "soft_karaoke_lyrics", Text.c_str()));
                             }
                         }
                         break;
@@ -1114,7 +1849,7 @@ void container_t::GetMetaData(size_t subSongIndex, metadata_table_t & metaData)
                     {
                         AssignString((const char *) Event.Data.data() + 2, DataSize, Text);
 
-                        metaData.AddItem(metadata_item_t(TimestampToMS(Event.Time, TempoTrackIndex), "copyright", Text.c_str()));
+                        metaData.AddItem(metadata_item_t(SubSong.TimestampToMS(Event.Time), "copyright", Text.c_str()));
                         break;
                     }
 
@@ -1124,7 +1859,7 @@ void container_t::GetMetaData(size_t subSongIndex, metadata_table_t & metaData)
                         ::sprintf_s(Name, _countof(Name), "track_name_%02u", (unsigned int)i);
                         AssignString((const char *) Event.Data.data() + 2, DataSize, Text);
 
-                        metaData.AddItem(metadata_item_t(TimestampToMS(Event.Time, TempoTrackIndex), Name, Text.c_str()));
+                        metaData.AddItem(metadata_item_t(SubSong.TimestampToMS(Event.Time), Name, Text.c_str()));
                         break;
                     }
 
@@ -1133,7 +1868,7 @@ void container_t::GetMetaData(size_t subSongIndex, metadata_table_t & metaData)
                     {
                         AssignString((const char *) Event.Data.data() + 2, DataSize, Text);
 
-                        metaData.AddItem(metadata_item_t(TimestampToMS(Event.Time, TempoTrackIndex), "lyrics", Text.c_str()));
+                        metaData.AddItem(metadata_item_t(SubSong.TimestampToMS(Event.Time), "lyrics", Text.c_str()));
                         break;
                     }
 
@@ -1141,7 +1876,7 @@ void container_t::GetMetaData(size_t subSongIndex, metadata_table_t & metaData)
                     {
                         AssignString((const char *) Event.Data.data() + 2, DataSize, Text);
 
-                        metaData.AddItem(metadata_item_t(TimestampToMS(Event.Time, TempoTrackIndex), "track_marker", Text.c_str()));
+                        metaData.AddItem(metadata_item_t(SubSong.TimestampToMS(Event.Time), "track_marker", Text.c_str()));
                         break;
                     }
 
@@ -1149,7 +1884,7 @@ void container_t::GetMetaData(size_t subSongIndex, metadata_table_t & metaData)
                     {
                         AssignString((const char *) Event.Data.data() + 2, DataSize, Text);
 
-                        metaData.AddItem(metadata_item_t(TimestampToMS(Event.Time, TempoTrackIndex), "cue_marker", Text.c_str()));
+                        metaData.AddItem(metadata_item_t(SubSong.TimestampToMS(Event.Time), "cue_marker", Text.c_str()));
                         break;
                     }
 
@@ -1163,7 +1898,7 @@ void container_t::GetMetaData(size_t subSongIndex, metadata_table_t & metaData)
                         if (DataSize == 4)
                         {
                             ::sprintf_s(Name, _countof(Name), "%d/%d", Event.Data[2], (1 << Event.Data[3]));
-                            metaData.AddItem(metadata_item_t(TimestampToMS(Event.Time, TempoTrackIndex), "time_signature", Name));
+                            metaData.AddItem(metadata_item_t(SubSong.TimestampToMS(Event.Time), "time_signature", Name));
                         }
                         break;
                     }
@@ -1180,14 +1915,14 @@ void container_t::GetMetaData(size_t subSongIndex, metadata_table_t & metaData)
                                 {
                                     const char * MajorScales[] = { "Cb", "Gb", "Db", "Ab", "Eb", "Bb", "F", "C", "G", "D", "A", "E", "B", "F#", "C#" };
 
-                                    metaData.AddItem(metadata_item_t(TimestampToMS(Event.Time, TempoTrackIndex), "key_signature", MajorScales[Index]));
+                                    metaData.AddItem(metadata_item_t(SubSong.TimestampToMS(Event.Time), "key_signature", MajorScales[Index]));
                                 }
                                 else
                                 if (Event.Data[3] == 1)
                                 {
                                     const char * MinorScales[] = { "Ab", "Eb", "Bb", "F", "C", "G", "D", "A", "E", "B", "F#", "C#", "G#", "D#", "A#" };
 
-                                    metaData.AddItem(metadata_item_t(TimestampToMS(Event.Time, TempoTrackIndex), "key_signature", MinorScales[Index]));
+                                    metaData.AddItem(metadata_item_t(SubSong.TimestampToMS(Event.Time), "key_signature", MinorScales[Index]));
                                 }
                             }
                         }
@@ -1225,8 +1960,55 @@ void container_t::GetMetaData(size_t subSongIndex, metadata_table_t & metaData)
     metaData.Append(_ExtraMetaData);
 }
 
+/// <summary>
+/// Gets the lyrics timeline of the specified subsong. Soft Karaoke lyrics take precedence over Tune 1000 lyrics.
+/// </summary>
+void container_t::GetLyrics(size_t subSongIndex, lyrics_t & lyrics) const
+{
+    lyrics_t SoftKaraoke;
+    lyrics_t Tune1000;
+
+    bool IsSoftKaraoke = false;
+
+    const subsong_view_t SubSong = GetSubSongView(subSongIndex);
+
+    for (size_t i = SubSong.FirstTrack; i < SubSong.FirstTrack + SubSong.TrackCount; ++i)
+    {
+        for (const event_t & Event : _Tracks[i])
+        {
+            if ((Event.Type != event_t::Extended) || (Event.Data.size() < 2) || (Event.Data[0] != StatusCode::MetaData))
+                continue;
+
+            const char * Text = (const char *) Event.Data.data() + 2;
+            const size_t Size = Event.Data.size() - 2;
+
+            if (Event.Data[1] == MetaDataType::Text)
+            {
+                if (!IsSoftKaraoke)
+                    IsSoftKaraoke = (Size >= 19) && (::_strnicmp(Text, "@KMIDI KARAOKE FILE", 19) == 0);
+                else
+                if ((Size > 0) && (Text[0] != '@'))
+                    SoftKaraoke.Add(SubSong.TimestampToMS(Event.Time), Text, Size, lyrics_t::SoftKaraoke);
+            }
+            else
+            // Tune 1000 Karaoke format (https://www.mixagesoftware.com/en/midikit/help/HTML/karaoke_formats.html)
+            if (Event.Data[1] == MetaDataType::Lyrics)
+                Tune1000.Add(SubSong.TimestampToMS(Event.Time), Text, Size, lyrics_t::Tune1000);
+        }
+    }
+
+    lyrics = !SoftKaraoke.IsEmpty() ? std::move(SoftKaraoke) : std::move(Tune1000);
+
+    lyrics.Finalize();
+}
+
+/// <summary>
+/// Removes the silence before the first note. The loop regions are rendered first because their timestamps would no longer match the trimmed tracks.
+/// </summary>
 void container_t::TrimStart()
 {
+    RenderLoops();
+
     if (_Format == 2)
     {
         for (size_t i = 0, j = _Tracks.size(); i < j; ++i)
@@ -1238,7 +2020,7 @@ void container_t::TrimStart()
 
 void container_t::TrimRange(size_t start, size_t end)
 {
-    uint32_t timestamp_first_note = ~0UL;
+    uint32_t timestamp_first_note = ~0U;
 
     for (size_t i = start; i <= end; ++i)
     {
@@ -1261,7 +2043,7 @@ void container_t::TrimRange(size_t start, size_t end)
         }
     }
 
-    if (timestamp_first_note < ~0UL && timestamp_first_note > 0)
+    if (timestamp_first_note < ~0U && timestamp_first_note > 0)
     {
         for (size_t i = start; i <= end; ++i)
         {
@@ -1280,14 +2062,15 @@ void container_t::TrimRange(size_t start, size_t end)
 
         if (start == end)
         {
-            TrimTempoMap(start, timestamp_first_note);
+            if (start < _TempoMaps.size())
+                TrimTempoMap(_TempoMaps[start], timestamp_first_note);
 
             _EndTimestamps[start] -= timestamp_first_note;
 
-            if (_Loop[start].HasEnd())
+            if ((start < _Loop.size()) && _Loop[start].HasEnd())
                 _Loop[start].SetEnd(_Loop[start].End() - timestamp_first_note);
 
-            if (_Loop[start].HasBegin())
+            if ((start < _Loop.size()) && _Loop[start].HasBegin())
             {
                 if (_Loop[start].Begin() > timestamp_first_note)
                     _Loop[start].SetBegin(_Loop[start].Begin() - timestamp_first_note);
@@ -1297,10 +2080,19 @@ void container_t::TrimRange(size_t start, size_t end)
         }
         else
         {
-            TrimTempoMap(0, timestamp_first_note);
+            TrimTempoMap(_TempoMaps[0], timestamp_first_note);
 
             _EndTimestamps[0] -= timestamp_first_note;
 
+            for (size_t i = start; (i <= end) && (i < _TrackSummaries.size()); ++i)
+            {
+                track_summary_t & Summary = _TrackSummaries[i];
+
+                TrimTempoMap(Summary.TempoMap, timestamp_first_note);
+
+                Summary.EndTimestamp = (Summary.EndTimestamp > timestamp_first_note) ? Summary.EndTimestamp - timestamp_first_note : 0;
+            }
+
             if (_Loop[0].HasEnd())
                 _Loop[0].SetEnd(_Loop[0].End() - timestamp_first_note);
 
@@ -1315,16 +2107,11 @@ void container_t::TrimRange(size_t start, size_t end)
     }
 }
 
-void container_t::TrimTempoMap(size_t index, uint32_t base_timestamp)
+void container_t::TrimTempoMap(tempo_map_t & tempoMap, uint32_t base_timestamp)
 {
-    if (index >= _TempoMaps.size())
-        return;
-
-    tempo_map_t & Map = _TempoMaps[index];
-
-    for (size_t i = 0, j = Map.Size(); i < j; ++i)
+    for (size_t i = 0, j = tempoMap.Size(); i < j; ++i)
     {
-        tempo_item_t & Entry = Map[i];
+        tempo_item_t & Entry = tempoMap[i];
 
         if (Entry.Time >= base_timestamp)
             Entry.Time -= base_timestamp;
@@ -1333,11 +2120,16 @@ void container_t::TrimTempoMap(size_t index, uint32_t base_timestamp)
     }
 }
 
+/// <summary>
+/// Splits the tracks of a format 1 file at each instrument change. The loop regions are rendered first because they belong to the original tracks.
+/// </summary>
 void container_t::SplitByInstrumentChanges(SplitCallback callback)
 {
     if (_Format != 1)
         return;
 
+    RenderLoops();
+
     for (size_t i = 0; i < _Tracks.size(); ++i)
     {
         track_t SrcTrack = _Tracks[0];
@@ -1410,10 +2202,16 @@ void container_t::SplitByInstrumentChanges(SplitCallback callback)
         if (DstTrack.GetLength())
             _Tracks.push_back(DstTrack);
     }
+
+    _IsTrackDirty.assign(_Tracks.size(), true);
+
+    UpdateSummaries();
 }
 
 void container_t::DetectLoops(bool detectXMILoops, bool detectMarkerLoops, bool detectRPGMakerLoops, bool detectTouhouLoops, bool detectLeapFrogLoops)
 {
+    MIDI_TIME_PHASE(LoopDetection);
+
     size_t SubSongCount = (_Format == 2) ? _Tracks.size() : 1;
 
     {
@@ -1487,9 +2285,9 @@ void container_t::DetectLoops(bool detectXMILoops, bool detectMarkerLoops, bool
                 if (Event.Type == event_t::ControlChange)
                 {
                     // Mark the beginning of an RPG Maker loop. The end of the loop is always the end of the song.
-                    if ((Event.Data[0] == 111 /* 0x6F */) && (!_Loop[SubSongIndex].HasBegin() || (Event.Time < _Loop[SubSongIndex].Begin())))
+                    if ((Event.Data[0] == 111 /* 0x6F */) && (!_Loop[SubSongIndex].HasBegin() || (GetExpandedTime(i, Event.Time) < _Loop[SubSongIndex].Begin())))
                     {
-                        _Loop[SubSongIndex].SetBegin(Event.Time);
+                        _Loop[SubSongIndex].SetBegin(GetExpandedTime(i, Event.Time));
                         IsRPGMakerLoop = true;
                     }
                     else
@@ -1631,17 +2429,19 @@ void container_t::DetectLoops(bool detectXMILoops, bool detectMarkerLoops, bool
 
         // Determine the largest time stamp.
         if (_Format == 2)
-            EndOfSongTimestamp = _Tracks[i].back().Time;
+            EndOfSongTimestamp = GetExpandedTime(i, _Tracks[i].back().Time);
         else
         {
             EndOfSongTimestamp = 0;
 
-            for (const auto & Track : _Tracks)
+            for (size_t j = 0; j < _Tracks.size(); ++j)
             {
+                const track_t & Track = _Tracks[j];
+
                 if (Track.GetLength() == 0)
                     continue;
 
-                uint32_t Timestamp = Track.back().Time;
+                uint32_t Timestamp = GetExpandedTime(j, Track.back().Time);
 
                 if (Timestamp > EndOfSongTimestamp)
                     EndOfSongTimestamp = Timestamp;
@@ -1679,53 +2479,117 @@ void container_t::EncodeVariableLengthQuantity(std::vector<uint8_t> & data, uint
 /// </summary>
 uint32_t container_t::TimestampToMS(uint32_t timestamp, size_t subSongIndex) const
 {
-    uint32_t TimestampInMS = 0;
-    uint32_t Time = 0;
-    uint32_t Tempo = 500'000; // Default: 500,000 μs per beat / 120 beats per minute
+    return GetSummaryView(subSongIndex).TimestampToMS(timestamp);
+}
+
+/// <summary>
+/// Converts a timestamp to a time in units of 1 / unitsPerSecond s taking into account any tempo changes during the sequence.
+/// </summary>
+uint64_t container_t::TimestampToTime(uint32_t timestamp, size_t subSongIndex, uint32_t unitsPerSecond) const
+{
+    return GetSummaryView(subSongIndex).TimestampToTime(timestamp, unitsPerSecond);
+}
+
+#pragma endregion
+
+#pragma region Subsong View
+
+/// <summary>
+/// Converts the timestamp (in ticks) to ms.
+/// </summary>
+uint32_t subsong_view_t::TimestampToMS(uint32_t timestamp) const noexcept
+{
+    return tempo_cursor_t(*this).TimestampToMS(timestamp);
+}
+
+/// <summary>
+/// Converts a timestamp to a time in units of 1 / unitsPerSecond s taking into account any tempo changes during the subsong.
+/// Unlike TimestampToMS() the time is only rounded once so the rounding error does not accumulate with each tempo change.
+/// </summary>
+uint64_t subsong_view_t::TimestampToTime(uint32_t timestamp, uint32_t unitsPerSecond) const noexcept
+{
+    return tempo_cursor_t(*this).TimestampToTime(timestamp, unitsPerSecond);
+}
+
+#pragma endregion
 
-    const uint32_t RoundingFactor = _TimeDivision * 500;
+#pragma region Tempo Cursor
+
+/// <summary>
+/// Converts the timestamp (in ticks) to ms.
+/// </summary>
+uint32_t tempo_cursor_t::TimestampToMS(uint32_t timestamp) noexcept
+{
+    MoveTo(timestamp);
+
+    const uint32_t RoundingFactor = _SubSong.TimeDivision * 500;
     const uint32_t TicksPerMS = RoundingFactor * 2;
 
-    size_t TempoMapCount = _TempoMaps.size();
+    return _TimestampInMS + (uint32_t) (((uint64_t) _Tempo * (uint64_t) (timestamp - _Time) + RoundingFactor) / TicksPerMS);
+}
 
-    if ((subSongIndex > 0) && (TempoMapCount > 0))
-    {
-        for (size_t i = (std::min)(subSongIndex, TempoMapCount); --i; )
-        {
-            size_t Count = _TempoMaps[i].Size();
+/// <summary>
+/// Converts a timestamp to a time in units of 1 / unitsPerSecond s.
+/// </summary>
+uint64_t tempo_cursor_t::TimestampToTime(uint32_t timestamp, uint32_t unitsPerSecond) noexcept
+{
+    MoveTo(timestamp);
 
-            if (Count > 0)
-            {
-                Tempo = _TempoMaps[i][Count - 1].Tempo;
-                break;
-            }
-        }
-    }
+    const uint64_t Duration = _Duration + (uint64_t) _Tempo * (uint64_t) (timestamp - _Time);
 
-    if (subSongIndex < TempoMapCount)
-    {
-        const tempo_map_t & TempoEntries = _TempoMaps[subSongIndex];
+    // Split the division to keep the intermediate results within 64 bits.
+    const uint64_t Divisor = (uint64_t) _SubSong.TimeDivision * 1'000'000;
 
-        size_t Index = 0;
-        size_t Count = TempoEntries.Size();
+    if (Divisor == 0)
+        return 0;
 
-        while ((Index < Count) && (Time + timestamp >= TempoEntries[Index].Time))
-        {
-            uint32_t Delta = TempoEntries[Index].Time - Time;
+    return (Duration / Divisor) * unitsPerSecond + ((Duration % Divisor) * unitsPerSecond + Divisor / 2) / Divisor;
+}
+
+/// <summary>
+/// Moves the cursor to the start of the subsong.
+/// </summary>
+void tempo_cursor_t::Reset() noexcept
+{
+    _Index = 0;
+    _Time = 0;
+    _Tempo = _SubSong.StartTempo;
+    _TimestampInMS = 0;
+    _Duration = 0;
+}
 
-            TimestampInMS += ((uint64_t) Tempo * (uint64_t) Delta + RoundingFactor) / TicksPerMS;
+/// <summary>
+/// Moves the cursor past the tempo changes at or before the timestamp.
+/// </summary>
+void tempo_cursor_t::MoveTo(uint32_t timestamp) noexcept
+{
+    MIDI_COUNT(TempoLookups, 1);
 
-            Tempo = TempoEntries[Index].Tempo;
-            ++Index;
+    if (timestamp < _Time)
+        Reset();
 
-            Time += Delta;
-            timestamp -= Delta;
-        }
-    }
+    if (_SubSong.TempoMap == nullptr)
+        return;
 
-    TimestampInMS += ((uint64_t) Tempo * (uint64_t) timestamp + RoundingFactor) / TicksPerMS;
+    const tempo_map_t & TempoEntries = *_SubSong.TempoMap;
 
-    return TimestampInMS;
+    const uint32_t RoundingFactor = _SubSong.TimeDivision * 500;
+    const uint32_t TicksPerMS = RoundingFactor * 2;
+
+    const size_t Count = TempoEntries.Size();
+
+    while ((_Index < Count) && (timestamp >= TempoEntries[_Index].Time))
+    {
+        const uint32_t Delta = TempoEntries[_Index].Time - _Time;
+
+        _TimestampInMS += (uint32_t) (((uint64_t) _Tempo * (uint64_t) Delta + RoundingFactor) / TicksPerMS);
+        _Duration += (uint64_t) _Tempo * (uint64_t) Delta;
+
+        _Tempo = TempoEntries[_Index].Tempo;
+        ++_Index;
+
+        _Time += Delta;
+    }
 }
 
 #pragma endregion
@@ -1,5 +1,5 @@
 
-/** $VER: MIDIContainer.h (2026.05.01) **/
+/** $VER: MIDIContainer.h (2026.10.19) **/
 
 #pragma once
 
@@ -7,6 +7,9 @@
 
 #include "MIDI.h"
 #include "Range.h"
+#include "Lyrics.h"
+
+#include <span>
 
 #pragma warning(disable: 4820) // x bytes padding added after data member 'y'
 
@@ -95,6 +98,23 @@ public:
     void AddEventToStart(const event_t & event);
     void RemoveEvent(size_t index);
 
+    /// <summary>
+    /// Removes all events that match the predicate in a single pass. Returns the number of removed events.
+    /// </summary>
+    template <typename Predicate> size_t RemoveEvents(Predicate predicate)
+    {
+        const size_t Size = _Events.size();
+
+        _Events.erase(std::remove_if(_Events.begin(), _Events.end(), predicate), _Events.end());
+
+        const size_t Count = Size - _Events.size();
+
+        if ((Count != 0) && _IsPortSet)
+            _IsPortSet = std::any_of(_Events.begin(), _Events.end(), [](const event_t & e) { return e.IsPort(); });
+
+        return Count;
+    }
+
     size_t GetLength() const noexcept
     {
         return _Events.size();
@@ -159,6 +179,8 @@ public:
     void Add(uint32_t tempo, uint32_t timestamp);
     uint32_t TimestampToMS(uint32_t timestamp, uint32_t division) const;
 
+    void Clear() noexcept { _Items.clear(); }
+
     size_t Size() const noexcept { return _Items.size(); }
 
     const tempo_item_t & operator[](std::size_t p_index) const
@@ -297,6 +319,136 @@ struct message_t
     bool IsSysEx() const noexcept { return ((Data & 0x80000000u) == 0x80000000u); }
 };
 
+/// <summary>
+/// Implements an MIDI message with an exact timestamp, in μs or in samples.
+/// </summary>
+struct timed_message_t
+{
+    uint64_t Time; // in units of 1 / unitsPerSecond s. See container_t::SerializeAsStream().
+    uint32_t Data;
+
+    bool IsSysEx() const noexcept { return ((Data & 0x80000000u) == 0x80000000u); }
+};
+
+/// <summary>
+/// Implements a composable event filter. The rules are compiled into bit masks so that each event is tested in a single pass; an event is removed if any rule matches.
+/// </summary>
+class event_filter_t
+{
+public:
+    event_filter_t() noexcept : _EventTypes(), _Channels(), _Ports(), _Controllers(), _RemoveEMIDITracks() { }
+
+    event_filter_t & RemoveEventTypes(uint32_t eventTypeMask) noexcept;
+    event_filter_t & RemoveChannels(uint32_t channelMask) noexcept;
+    event_filter_t & RemovePorts(uint64_t portMask) noexcept;
+    event_filter_t & RemoveControllers(uint8_t first, uint8_t last) noexcept;
+    event_filter_t & RemoveTimeRange(uint32_t begin, uint32_t end);
+    event_filter_t & RemoveEMIDITracks() noexcept;
+
+    static event_filter_t FromCleanFlags(uint32_t cleanFlags);
+
+    bool IsEmpty() const noexcept { return (_EventTypes == 0) && (_Channels == 0) && (_Ports == 0) && (_Controllers[0] == 0) && (_Controllers[1] == 0) && _TimeRanges.empty() && !_RemoveEMIDITracks; }
+
+    /// <summary>
+    /// Returns true if the event should be removed. Only channel events are filtered; meta data and SysEx events always pass.
+    /// </summary>
+    bool Matches(const event_t & event, uint8_t portNumber) const noexcept
+    {
+        return Matches(event, event.Time, portNumber);
+    }
+
+    /// <summary>
+    /// Returns true if the event should be removed when it is played at the specified timestamp, e.g. during a repetition of a loop region.
+    /// </summary>
+    bool Matches(const event_t & event, uint32_t time, uint8_t portNumber) const noexcept
+    {
+        if (event.Type == event_t::Extended)
+            return false;
+
+        if ((_EventTypes & (1u << event.Type)) || (_Channels & (1u << (event.ChannelNumber & 0x1F))) || ((portNumber < 64) && (_Ports & (1ULL << portNumber))))
+            return true;
+
+        if ((event.Type == event_t::ControlChange) && !event.Data.empty() && (_Controllers[(event.Data[0] >> 6) & 1] & (1ULL << (event.Data[0] & 0x3F))))
+            return true;
+
+        for (const auto & Range : _TimeRanges)
+        {
+            if ((Range.first <= time) && (time < Range.second))
+                return true;
+        }
+
+        return false;
+    }
+
+    bool MatchesTrack(const track_t & track) const noexcept;
+
+private:
+    uint32_t _EventTypes;               // Bit n is event_t::event_type_t n.
+    uint32_t _Channels;                 // Bit n is channel n (0-based).
+    uint64_t _Ports;                    // Bit n is normalized port n.
+    uint64_t _Controllers[2];           // Bit n is controller n.
+    std::vector<std::pair<uint32_t, uint32_t>> _TimeRanges; // Half-open ranges in ticks.
+    bool _RemoveEMIDITracks;            // Removes tracks designated for devices other than General MIDI and Sound Canvas (Apogee Expanded MIDI).
+};
+
+/// <summary>
+/// Represents a loop that is stored once in a track and repeated on playback.
+/// </summary>
+struct loop_region_t
+{
+    uint32_t TrackIndex;
+    uint32_t Begin;             // Timestamp of the first tick of the loop body (in ticks)
+    uint32_t End;               // Timestamp of the first tick after the loop body (in ticks)
+    uint32_t Count;             // Number of passes through the loop body
+    bool IsInfinite;            // True if the source loops forever. Count is the number of passes chosen by the converter.
+};
+
+/// <summary>
+/// Iterates over the events of a track in playback order and repeats its loop regions on the fly. The events are not copied: the cursor returns the stored event and the timestamp at which it is played.
+/// </summary>
+class track_cursor_t
+{
+public:
+    /// <summary>
+    /// Represents a range of stored events [Begin, End) that is played with its timestamps shifted by Shift ticks.
+    /// </summary>
+    struct segment_t
+    {
+        uint32_t Begin;
+        uint32_t End;
+        uint32_t Shift;
+        bool NoteOffsOnly;      // True for the notes that end at the end of a loop body and are stopped before each repetition.
+    };
+
+    track_cursor_t(const track_t & track, std::span<const loop_region_t> regions, uint32_t infiniteCount = 0);
+
+    bool IsAtEnd() const noexcept { return _Event == nullptr; }
+    void MoveToEnd() noexcept { _SegmentIndex = _Segments.size(); _EndOfTrack = nullptr; _Event = nullptr; }
+
+    const event_t & GetEvent() const noexcept { return *_Event; }
+    uint32_t GetTime() const noexcept { return _Time; }
+
+    void Next() noexcept;
+
+    static void GetSegments(std::span<const loop_region_t> regions, uint32_t infiniteCount, std::vector<segment_t> & segments);
+
+private:
+    void Find() noexcept;
+
+private:
+    const track_t * _Track;
+    std::vector<segment_t> _Segments;   // Empty if the track has no loop regions.
+
+    size_t _SegmentIndex;
+    size_t _EventIndex;
+
+    const event_t * _Event;
+    uint32_t _Time;
+
+    const event_t * _EndOfTrack;        // The first End of Track event of a track with loop regions is played last, at the latest timestamp, like track_t::AddEvent() keeps it at the end of a track.
+    uint32_t _EndOfTrackTime;
+};
+
 /// <summary>
 /// Represents the format of the file used to create a container.
 /// </summary>
@@ -325,15 +477,66 @@ enum FileFormat
     Unknown = -1
 };
 
+/// <summary>
+/// Represents the tracks and the timing of a subsong. A format 2 subsong consists of a single track; the other formats have one subsong that contains all tracks.
+/// The tempo at the start of the subsong is computed once so that the timestamps can be converted without looking at the tempo maps of other subsongs.
+/// </summary>
+struct subsong_view_t
+{
+    size_t FirstTrack;              // Index of the first track of the subsong
+    size_t TrackCount;              // Number of tracks of the subsong
+
+    const tempo_map_t * TempoMap;   // Tempo changes of the subsong or null
+    uint32_t StartTempo;            // Tempo at the start of the subsong (in μs per quarter note)
+    uint32_t TimeDivision;
+
+    uint64_t ChannelMask;
+    uint32_t EndTimestamp;          // in ticks
+
+    uint32_t TimestampToMS(uint32_t timestamp) const noexcept;
+    uint64_t TimestampToTime(uint32_t timestamp, uint32_t unitsPerSecond) const noexcept;
+};
+
+/// <summary>
+/// Converts the timestamps of a subsong like subsong_view_t but remembers its position in the tempo map between calls.
+/// Converting timestamps in increasing order only walks the tempo map once; a smaller timestamp restarts at the beginning of the map.
+/// </summary>
+class tempo_cursor_t
+{
+public:
+    tempo_cursor_t(const subsong_view_t & subSong) noexcept : _SubSong(subSong)
+    {
+        Reset();
+    }
+
+    uint32_t TimestampToMS(uint32_t timestamp) noexcept;
+    uint64_t TimestampToTime(uint32_t timestamp, uint32_t unitsPerSecond) noexcept;
+
+private:
+    void Reset() noexcept;
+    void MoveTo(uint32_t timestamp) noexcept;
+
+private:
+    subsong_view_t _SubSong;
+
+    size_t _Index;                  // Index of the next tempo change
+    uint32_t _Time;                 // Timestamp of the last tempo change (in ticks)
+    uint32_t _Tempo;                // Tempo since the last tempo change (in μs per quarter note)
+    uint32_t _TimestampInMS;        // Time of the last tempo change, rounded per tempo change like subsong_view_t::TimestampToMS()
+    uint64_t _Duration;             // Time of the last tempo change (in μs × ticks)
+};
+
+class seek_index_t;
+
 /// <summary>
 /// Implements a container for the MIDI messages.
 /// </summary>
 class container_t
 {
 public:
-    container_t() : FileFormat(FileFormat::Unknown), BankOffset(0), _Format(), _TimeDivision(), _ExtraPercussionChannel(~0u)
+    container_t() : FileFormat(midi::FileFormat::Unknown), BankOffset(0), _Format(), _TimeDivision(), _ExtraPercussionChannel(~0u), _DeviceCounts()
     {
-        _DeviceNames.resize(16);
+        std::fill(std::begin(_PortIndexes), std::end(_PortIndexes), NoPortIndex);
     }
 
     container_t(const container_t &) = delete;
@@ -355,7 +558,44 @@ public:
 
     void ApplyHack(uint32_t hack);
 
+    /// <summary>
+    /// Removes all events that match the predicate from all tracks in a single pass and marks the affected tracks as modified. Returns the number of removed events.
+    /// </summary>
+    template <typename Predicate> size_t RemoveEvents(Predicate predicate)
+    {
+        size_t Count = 0;
+
+        for (size_t i = 0; i < _Tracks.size(); ++i)
+        {
+            const size_t n = _Tracks[i].RemoveEvents(predicate);
+
+            if (n != 0)
+            {
+                MarkTrackDirty(i);
+                Count += n;
+            }
+        }
+
+        return Count;
+    }
+
+    void MarkTrackDirty(size_t trackIndex) noexcept;
+    void UpdateSummaries();
+
+    size_t ApplyFilter(const event_filter_t & filter);
+
+    void SetLoopRegions(std::vector<loop_region_t> && regions);
+    const std::vector<loop_region_t> & GetLoopRegions() const noexcept { return _LoopRegions; }
+    bool HasLoopRegions() const noexcept { return !_LoopRegions.empty(); }
+
+    void ExpandTrack(size_t trackIndex, uint32_t infiniteCount, track_t & track) const;
+    void RenderLoops(uint32_t infiniteCount = 0);
+    uint32_t GetExpandedTime(size_t trackIndex, uint32_t time) const noexcept;
+
     void SerializeAsStream(size_t subSongIndex, std::vector<message_t> & stream, sysex_table_t & sysExTable, std::vector<uint8_t> & portNumbers, uint32_t & loopBegin, uint32_t & loopEnd, uint32_t cleanFlags) const;
+    void SerializeAsStream(size_t subSongIndex, std::vector<message_t> & stream, sysex_table_t & sysExTable, std::vector<uint8_t> & portNumbers, uint32_t & loopBegin, uint32_t & loopEnd, const event_filter_t & filter) const;
+    void SerializeAsStream(size_t subSongIndex, std::vector<message_t> & stream, sysex_table_t & sysExTable, std::vector<uint8_t> & portNumbers, uint32_t & loopBegin, uint32_t & loopEnd, const event_filter_t & filter, seek_index_t & seekIndex) const;
+    void SerializeAsStream(size_t subSongIndex, std::vector<timed_message_t> & stream, sysex_table_t & sysExTable, std::vector<uint8_t> & portNumbers, uint32_t & loopBegin, uint32_t & loopEnd, const event_filter_t & filter, uint32_t unitsPerSecond) const;
     void SerializeAsSMF(std::vector<uint8_t> & data) const;
 
     void PromoteToType1();
@@ -369,7 +609,8 @@ public:
     bool IsEmpty() const noexcept { return _Tracks.empty(); }
 
     size_t GetSubSongCount() const;
-    size_t GetSubSong(size_t index) const;
+    size_t GetSubSong(size_t index) const noexcept;
+    subsong_view_t GetSubSongView(size_t subSongIndex) const noexcept;
 
     uint32_t GetDuration(size_t subsongIndex, bool ms = false) const;
 
@@ -387,6 +628,7 @@ public:
     void SetArtwork(const std::vector<uint8_t> & artwork) noexcept { _Artwork = artwork; }
 
     void GetMetaData(size_t subSongIndex, metadata_table_t & data);
+    void GetLyrics(size_t subSongIndex, lyrics_t & lyrics) const;
 
     void SetExtraPercussionChannel(uint32_t channelNumber) noexcept { _ExtraPercussionChannel = channelNumber; }
     uint32_t GetExtraPercussionChannel() const noexcept { return _ExtraPercussionChannel; }
@@ -394,6 +636,7 @@ public:
     void DetectLoops(bool detectXMILoops, bool detectMarkerLoops, bool detectRPGMakerLoops, bool detectTouhouLoops, bool detectLeapFrogLoops);
 
     uint32_t TimestampToMS(uint32_t timestamp, size_t subsongIndex) const;
+    uint64_t TimestampToTime(uint32_t timestamp, size_t subsongIndex, uint32_t unitsPerSecond) const;
 
     static void EncodeVariableLengthQuantity(std::vector<uint8_t> & data, uint32_t delta);
 
@@ -411,6 +654,8 @@ public:
     const_iterator cend() const { return _Tracks.cend(); }
 
 public:
+    static constexpr uint32_t TimeUnitMicroseconds = 1'000'000; // Units per second for timestamps in μs
+
     enum
     {
         CleanFlagEMIDI = 1 << 0,
@@ -418,14 +663,44 @@ public:
         CleanFlagBanks = 1 << 2,
     };
 
-    FileFormat FileFormat;
+    midi::FileFormat FileFormat;
 
     std::vector<uint8_t> SoundFont;
     int BankOffset;                 // Bank offset for MIDI files that contain an embedded soundfont. See https://github.com/spessasus/sf2-rmidi-specification?tab=readme-ov-file#dbnk-chunk
 
 private:
+    /// <summary>
+    /// The channels, tempo changes and end timestamp of a track of a format 0 or 1 file. UpdateSummaries() merges them so that only the modified tracks have to be scanned again.
+    /// </summary>
+    struct track_summary_t
+    {
+        uint64_t ChannelMask;
+        tempo_map_t TempoMap;
+        uint32_t EndTimestamp;
+
+        track_summary_t() noexcept : ChannelMask(), EndTimestamp() { }
+    };
+
+    track_summary_t & GetTrackSummary(size_t trackIndex);
+    void MergeTrackSummary(const track_summary_t & summary);
+
+    void ScanTrack(size_t trackIndex, uint64_t & channelMask, tempo_map_t & tempoMap, uint32_t & endTimestamp);
+
+    template <typename T, typename F>
+    void SerializeEvents(size_t subSongIndex, std::vector<T> & stream, sysex_table_t & sysExTable, std::vector<uint8_t> & portNumbers, uint32_t & loopBegin, uint32_t & loopEnd, const event_filter_t & filter, F timestampToTime) const;
+
+    std::span<const loop_region_t> GetLoopRegions(size_t trackIndex) const noexcept;
+    track_cursor_t GetTrackCursor(size_t trackIndex) const { return track_cursor_t(_Tracks[trackIndex], GetLoopRegions(trackIndex)); }
+
+    subsong_view_t GetSummaryView(size_t summaryIndex) const noexcept;
+    void UpdateSubSong(size_t summaryIndex);
+
+    uint32_t InternDeviceName(std::vector<uint8_t>::const_iterator begin, std::vector<uint8_t>::const_iterator end, std::string & name);
+    uint32_t FindDeviceName(std::vector<uint8_t>::const_iterator begin, std::vector<uint8_t>::const_iterator end, std::string & name) const;
+    size_t GetDeviceIndex(uint32_t channelNumber, uint32_t nameId) const noexcept;
+
     void TrimRange(size_t start, size_t end);
-    void TrimTempoMap(size_t index, uint32_t base_timestamp);
+    static void TrimTempoMap(tempo_map_t & tempoMap, uint32_t base_timestamp);
 
     #pragma warning(disable: 4267)
 
@@ -434,19 +709,16 @@ private:
     /// </summary>
     template <typename T> void NormalizePortNumber(T & number)
     {
-        for (size_t i = 0; i < _PortNumbers.size(); ++i)
+        uint16_t & Index = _PortIndexes[(uint8_t) number];
+
+        if (Index == NoPortIndex)
         {
-            if (number == _PortNumbers[i])
-            {
-                number = (T) i;
+            Index = (uint16_t) _PortNumbers.size();
 
-                return;
-            }
+            _PortNumbers.push_back((uint8_t) number);
         }
 
-        _PortNumbers.push_back((uint8_t) number);
-
-        number = _PortNumbers.size() - 1;
+        number = (T) Index;
     }
 
     /// <summary>
@@ -454,15 +726,10 @@ private:
     /// </summary>
     template <typename T> void NormalizePortNumber(T & number) const
     {
-        for (size_t i = 0; i < _PortNumbers.size(); ++i)
-        {
-            if (number == _PortNumbers[i])
-            {
-                number = (T) i;
+        const uint16_t Index = _PortIndexes[(uint8_t) number];
 
-                return;
-            }
-        }
+        if (Index != NoPortIndex)
+            number = (T) Index;
     }
 
     #pragma warning(default: 4267)
@@ -481,18 +748,34 @@ private:
     const size_t MaxChannels = 48;
 
     std::vector<uint64_t> _ChannelMask;
+    std::vector<size_t> _SubSongs;      // Indexes of the summaries with a non-empty channel mask, in ascending order.
     std::vector<tempo_map_t> _TempoMaps;
+    std::vector<uint32_t> _StartTempos; // Tempo at the start of each summary: the last tempo of the closest preceding summary that changes the tempo. Maintained by UpdateSubSong().
     std::vector<track_t> _Tracks;
+    std::vector<bool> _IsTrackDirty;    // True if the track was modified since the last call to UpdateSummaries().
 
     std::vector<uint8_t> _PortNumbers;
+    uint16_t _PortIndexes[256];         // Index in _PortNumbers of each raw port number or NoPortIndex
+
+    static constexpr uint16_t NoPortIndex = 0xFFFF;
+    static constexpr uint32_t DefaultTempo = 500'000;   // 500,000 μs per beat / 120 beats per minute
 
-    std::vector<std::vector<std::string>> _DeviceNames;
+    // Device and Instrument Name meta events route the events of a track to a port: each name that is used on a channel gets the next port number of that channel.
+    std::unordered_map<std::string, uint32_t> _DeviceNameIds;   // Interned, lower-case device names
+    std::vector<uint16_t> _DeviceIndexes[16];                   // Per channel and device name id, 1 + the order in which the name was first used on the channel or 0
+    size_t _DeviceCounts[16];                                   // Number of device names used on each channel
+
+    static constexpr uint32_t NoDeviceName = ~0u;
+    static constexpr uint32_t UnknownDeviceName = ~0u - 1;
 
     metadata_table_t _ExtraMetaData;
 
     std::vector<uint32_t> _EndTimestamps;   // Largest timestamp for each track.
 
+    std::vector<track_summary_t> _TrackSummaries;   // Summary of each track of a format 0 or 1 file
+
     std::vector<range_t> _Loop;
+    std::vector<loop_region_t> _LoopRegions; // Sorted by track, begin (ascending) and end (descending) so that nested regions follow their parent.
     std::vector<uint8_t> _Artwork;
 };
 
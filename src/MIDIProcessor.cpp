@@ -1,5 +1,5 @@
 
-/** $VER: MIDIProcessor.cpp (2026.05.01) **/
+/** $VER: MIDIProcessor.cpp (2026.10.19) **/
 
 #include "pch.h"
 
@@ -10,8 +10,6 @@
 namespace midi
 {
 
-processor_options_t processor_t::_Options;
-
 const uint8_t processor_t::MIDIEventEndOfTrack[2] = { StatusCode::MetaData, MetaDataType::EndOfTrack };
 const uint8_t processor_t::LoopBeginMarker[11]    = { StatusCode::MetaData, MetaDataType::Marker, 'l', 'o', 'o', 'p', 'S', 't', 'a', 'r', 't' };
 const uint8_t processor_t::LoopEndMarker[9]       = { StatusCode::MetaData, MetaDataType::Marker, 'l', 'o', 'o', 'p', 'E', 'n', 'd' };
@@ -21,83 +19,209 @@ const uint8_t processor_t::LoopEndMarker[9]       = { StatusCode::MetaData, Meta
 /// </summary>
 bool processor_t::Process(std::vector<uint8_t> const & data, const wchar_t * filePath, container_t & container, const processor_options_t & options)
 {
-    _Options = options;
+    diagnostics_scope_t DiagnosticsScope(options.DiagnosticsSink, options.DiagnosticsContext, options.DiagnosticsLevel);
+    stats_scope_t StatsScope((options.Stats != nullptr) ? options.Stats : Stats);
 
-    std::wstring FileExtension;
+    detection_t Detection;
 
-    if (filePath != nullptr)
     {
-        std::filesystem::path FilePath(filePath);
-
-        FileExtension = FilePath.extension().wstring();
+        MIDI_TIME_PHASE(Detection);
 
-        if (!FileExtension.empty() && FileExtension[0] == L'.')
-            FileExtension = FileExtension.substr(1);
+        Detection = Detect(data.data(), data.size(), data.size(), GetFileExtension(filePath));
     }
 
-    if (IsSMF(data))
-        return ProcessSMF(data, container);
+    if (Detection.Confidence < confidence_t::Medium)
+        return false;
 
-    // .RMI
-    if (IsRMI(data))
-        return ProcessRMI(data, container);
+    MIDI_TIME_PHASE(Parsing);
 
-    // .XMI, .XFM
-    if (IsXMI(data))
-        return ProcessXMI(data, container);
+    switch (Detection.Format)
+    {
+        case FileFormat::SMF: return ProcessSMF(data, container, options);
+        case FileFormat::RMI: return ProcessRMI(data, container, options);
+        case FileFormat::XMI: return ProcessXMI(data, container);
+        case FileFormat::MDS: return ProcessMDS(data, container);
+        case FileFormat::HMP: return ProcessHMP(data, container, options);
+        case FileFormat::HMI: return ProcessHMI(data, container, options);
+        case FileFormat::MUS: return ProcessMUS(data, container);
+        case FileFormat::LDS: return ProcessLDS(data, container);
+        case FileFormat::GMF: return ProcessGMF(data, container, options);
+        case FileFormat::RCP: return ProcessRCP(data, filePath, container, options);
+        case FileFormat::XMF: return ProcessXMF(data, container, options);
+        case FileFormat::MMF: return ProcessMMF(data, container);
+        case FileFormat::MMD: return ProcessMMD(data, filePath, container, options);
+#ifdef _DEBUG
+        case FileFormat::TST: return ProcessTST(data, container);
+#endif
+        case FileFormat::SYX: return ProcessSYX(data, container);
 
-    if (IsMDS(data))
-        return ProcessMDS(data, container);
+        default:
+            return false;
+    }
+}
 
-    if (IsHMP(data))
-        return ProcessHMP(data, container);
+/// <summary>
+/// Detects the format of a file without parsing it. The data can be the complete file or only its first bytes, preferably at least DetectionSize bytes.
+/// </summary>
+detection_t processor_t::Detect(const uint8_t * data, size_t size, uint64_t fileSize, const wchar_t * filePath) noexcept
+{
+    try
+    {
+        return Detect(data, size, fileSize, GetFileExtension(filePath));
+    }
+    catch (...)
+    {
+        return { FileFormat::Unknown, confidence_t::None };
+    }
+}
 
-    if (IsHMI(data))
-        return ProcessHMI(data, container);
+/// <summary>
+/// Detects the format of a file by its signature. Only the probe of the format with a matching signature is called.
+/// </summary>
+detection_t processor_t::Detect(const uint8_t * data, size_t size, uint64_t fileSize, const std::wstring & fileExtension) noexcept
+{
+    auto HasSignature = [data, size](size_t offset, const char * signature) noexcept
+    {
+        const size_t Length = ::strlen(signature);
 
-    if (IsMUS(data))
-        return ProcessMUS(data, container);
+        return (size >= offset + Length) && (::memcmp(data + offset, signature, Length) == 0);
+    };
 
-    if (IsLDS(data, FileExtension))
-        return ProcessLDS(data, container);
+    // A header that is not completely available yet can't be rejected.
+    auto Result = [size, fileSize](FileFormat format, size_t headerSize, bool isValid) noexcept -> detection_t
+    {
+        if (isValid)
+            return { format, confidence_t::High };
 
-    if (IsGMF(data))
-        return ProcessGMF(data, container);
+        if ((size < headerSize) && (size < fileSize))
+            return { format, confidence_t::Medium };
 
-    if (IsRCP(data, FileExtension))
-        return ProcessRCP(data, filePath, container);
+        return { format, confidence_t::Low };
+    };
 
-    if (IsXMF(data))
-        return ProcessXMF(data, container);
+    if (size == 0)
+        return { FileFormat::Unknown, confidence_t::None };
 
-    // .MMF
-    if (IsMMF(data))
-        return ProcessMMF(data, container);
+    switch (data[0])
+    {
+        case 'M':
+        {
+            if (HasSignature(0, "MThd"))
+                return Result(FileFormat::SMF, 18, IsSMF(data, size));
+
+            if (HasSignature(0, "MUS\x1A"))
+                return Result(FileFormat::MUS, 0x20, IsMUS(data, size, fileSize));
+
+            if (HasSignature(0, "MMMD"))
+                return Result(FileFormat::MMF, 8, IsMMF(data, size, fileSize));
+            break;
+        }
+
+        case 'R':
+        {
+            if (HasSignature(0, "RIFF"))
+            {
+                if (HasSignature(8, "RMID"))
+                    return Result(FileFormat::RMI, 20 + 18, IsRMI(data, size, fileSize));
+
+                if (HasSignature(8, "MIDS"))
+                    return Result(FileFormat::MDS, 16, IsMDS(data, size, fileSize));
+            }
+            else
+            if (HasSignature(0, "RCM-PC98V2.0(C)COME ON MUSIC"))
+                return Result(FileFormat::RCP, 0, IsRCP(data, size, fileExtension));
+            break;
+        }
+
+        case 'C':
+        {
+            if (HasSignature(0, "COME ON MUSIC RECOMPOSER RCP3.0"))
+                return Result(FileFormat::RCP, 0, IsRCP(data, size, fileExtension));
+            break;
+        }
+
+        case 'F':
+        {
+            if (HasSignature(0, "FORM") && HasSignature(8, "XDIR"))
+                return Result(FileFormat::XMI, 34, IsXMI(data, size));
+            break;
+        }
+
+        case 'H':
+        {
+            if (HasSignature(0, "HMI-"))
+                return Result(FileFormat::HMI, 12, IsHMI(data, size));
+
+            if (HasSignature(0, "HMIMIDI"))
+                return Result(FileFormat::HMP, 8, IsHMP(data, size));
+            break;
+        }
+
+        case 'G':
+        {
+            if (HasSignature(0, "GMF\x01"))
+                return Result(FileFormat::GMF, 32, IsGMF(data, size));
+            break;
+        }
+
+        case 'X':
+        {
+            if (HasSignature(0, "XMF_"))
+                return Result(FileFormat::XMF, 4, IsXMF(data, size));
+            break;
+        }
+    }
 
-    // .MMD
-   if (IsMMD(data, FileExtension))
-        return ProcessMMD(data, filePath, container);
+    // The remaining formats have no signature and are recognized by their file extension.
+    if (IsLDS(data, size, fileExtension))
+        return { FileFormat::LDS, confidence_t::Medium };
+
+    if (IsMMD(data, size, fileSize, fileExtension))
+        return { FileFormat::MMD, confidence_t::Medium };
 
 #ifdef _DEBUG
-    // .TST
-    if (IsTST(data, FileExtension))
-        return ProcessTST(data, container);
+    if (IsTST(data, size, fileExtension))
+        return { FileFormat::TST, confidence_t::Medium };
 #endif
-    if (IsSYX(data))
-        return ProcessSYX(data, container);
 
-    return false;
+    // SysEx dumps come last so that a file with one of the extensions above that starts with F0 is not taken for one.
+    if (data[0] == StatusCode::SysEx)
+    {
+        // The last byte can only be checked when all data is available.
+        if (size < fileSize)
+            return { FileFormat::SYX, confidence_t::Medium };
+
+        return Result(FileFormat::SYX, 2, IsSYX(data, size));
+    }
+
+    return { FileFormat::Unknown, confidence_t::None };
+}
+
+/// <summary>
+/// Gets the extension of a file path without the leading period.
+/// </summary>
+std::wstring processor_t::GetFileExtension(const wchar_t * filePath)
+{
+    if (filePath == nullptr)
+        return std::wstring();
+
+    std::wstring FileExtension = std::filesystem::path(filePath).extension().wstring();
+
+    if (!FileExtension.empty() && FileExtension[0] == L'.')
+        FileExtension = FileExtension.substr(1);
+
+    return FileExtension;
 }
 
 /// <summary>
 /// Returns true if the data represents a SysEx message.
 /// </summary>
-bool processor_t::IsSYX(std::vector<uint8_t> const & data) noexcept
+bool processor_t::IsSYX(const uint8_t * data, size_t size) noexcept
 {
-    if (data.size() < 2)
+    if (size < 2)
         return false;
 
-    if (data[0] != StatusCode::SysEx || data[data.size() - 1] != StatusCode::SysExEnd)
+    if (data[0] != StatusCode::SysEx || data[size - 1] != StatusCode::SysExEnd)
         return false;
 
     return true;
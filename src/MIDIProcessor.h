@@ -1,5 +1,5 @@
 
-/** $VER: MIDIProcessor.h (2026.05.03) **/
+/** $VER: MIDIProcessor.h (2026.10.19) **/
 
 #pragma once
 
@@ -7,6 +7,8 @@
 
 #include "MIDIContainer.h"
 #include "IFF.h"
+#include "Diagnostics.h"
+#include "Instrumentation.h"
 
 #include <string>
 
@@ -21,9 +23,11 @@ struct processor_options_t
     bool WriteCueMarkers;
     bool WriteSysExNames;
     bool ExpandLoops;
+    bool SymbolicLoops;         // Stores each loop once as a loop region of the container instead of repeating it.
     bool WolfteamLoopMode;
     bool IgnoreMutedTracks;
     bool IncludeControlData;
+    bool ParallelTracks;        // Passed to the RCP and MMD converters
 
     // HMI / HMP
     uint16_t DefaultTempo;      // in bpm
@@ -31,6 +35,14 @@ struct processor_options_t
     // SMF
     bool IsEndOfTrackRequired;
     bool DetectExtraPercussionChannel;
+
+    // Diagnostics
+    diagnostics_sink_t DiagnosticsSink;     // Receives the diagnostic messages of the conversion. No messages are generated when null.
+    void * DiagnosticsContext;              // Passed to the sink
+    severity_t DiagnosticsLevel;            // Minimum severity that is reported
+
+    // Instrumentation
+    stats_t * Stats;                        // Receives the counters and phase times of the conversion. Only filled when the library is built with LIBMIDI_INSTRUMENTATION.
 };
 
 const processor_options_t DefaultOptions
@@ -41,9 +53,11 @@ const processor_options_t DefaultOptions
     .WriteCueMarkers = false,
     .WriteSysExNames = false,
     .ExpandLoops = false,
+    .SymbolicLoops = false,
     .WolfteamLoopMode = false,
     .IgnoreMutedTracks = true,
     .IncludeControlData = true,
+    .ParallelTracks = false,
 
     // HMI / HMP
     .DefaultTempo = 160, // in bpm
@@ -51,6 +65,73 @@ const processor_options_t DefaultOptions
     // SMF
     .IsEndOfTrackRequired = true,
     .DetectExtraPercussionChannel = true,
+
+    // Diagnostics
+    .DiagnosticsSink = nullptr,
+    .DiagnosticsContext = nullptr,
+    .DiagnosticsLevel = severity_t::Warning,
+
+    // Instrumentation
+    .Stats = nullptr,
+};
+
+enum class confidence_t : uint8_t
+{
+    None = 0,   // The format was not recognized.
+    Low,        // The signature matches but the header is invalid or the file extension does not match. Process() rejects the data.
+    Medium,     // The format was recognized by its file extension and a plausible header or from an incomplete header.
+    High,       // The signature and the header are valid.
+};
+
+/// <summary>
+/// Represents the result of a format detection.
+/// </summary>
+struct detection_t
+{
+    FileFormat Format;
+    confidence_t Confidence;
+};
+
+/// <summary>
+/// Decodes the events of an SMF track chunk. The decoder keeps its state between calls so that a track can be decoded while its data arrives.
+/// </summary>
+class smf_track_decoder_t
+{
+public:
+    smf_track_decoder_t(const processor_options_t & options) noexcept;
+
+    bool Decode(const uint8_t * & data, const uint8_t * tail, bool isFinal, container_t & container);
+
+    const track_t & GetTrack() const noexcept { return _Track; }
+    bool IsComplete() const noexcept { return _IsComplete; }
+
+    /// <summary>
+    /// Sets a vector that receives a copy of each event in the order in which it is decoded, or null.
+    /// </summary>
+    void SetEventSink(std::vector<event_t> * events) noexcept { _Events = events; }
+
+private:
+    void AddEvent(const event_t & event);
+    void AddEventToStart(const event_t & event);
+    void FlushSysEx();
+
+    static bool Rewind(const uint8_t * & data, const uint8_t * head, bool isFinal, const char * message);
+
+private:
+    track_t _Track;
+    std::vector<uint8_t> _Temp;
+    std::vector<event_t> * _Events;
+
+    uint32_t _RunningTime;
+    uint32_t _SysExSize;        // Size of the pending SysEx message in _Temp. It gets added when the next event starts because it can be continued by F7 packets.
+    uint32_t _SysExTime;
+    uint8_t _RunningStatus;
+
+    bool _DetectedPercussionText;
+    bool _IsComplete;
+
+    bool _IsEndOfTrackRequired;
+    bool _DetectExtraPercussionChannel;
 };
 
 class processor_t
@@ -58,47 +139,56 @@ class processor_t
 public:
     static bool Process(std::vector<uint8_t> const & data, const wchar_t * filePath, container_t & container, const processor_options_t & options = DefaultOptions);
 
+    static detection_t Detect(const uint8_t * data, size_t size, uint64_t fileSize, const wchar_t * filePath = nullptr) noexcept;
+    static detection_t Detect(std::vector<uint8_t> const & data, const wchar_t * filePath = nullptr) noexcept { return Detect(data.data(), data.size(), data.size(), filePath); }
+
+    static constexpr size_t DetectionSize = 128; // Number of bytes at the start of a file that Detect() examines
+
     static int Inflate(const std::vector<uint8_t> & src, std::vector<uint8_t> & dst) noexcept;
     static int InflateRaw(const std::vector<uint8_t> & src, std::vector<uint8_t> & dst) noexcept;
 
 private:
-    static bool IsSMF(std::vector<uint8_t> const & data) noexcept;
-    static bool IsRMI(std::vector<uint8_t> const & data) noexcept;
-    static bool IsHMP(std::vector<uint8_t> const & data) noexcept;
-    static bool IsHMI(std::vector<uint8_t> const & data) noexcept;
-    static bool IsXMI(std::vector<uint8_t> const & data) noexcept;
-    static bool IsMUS(std::vector<uint8_t> const & data) noexcept;
-    static bool IsMDS(std::vector<uint8_t> const & data) noexcept;
-    static bool IsLDS(std::vector<uint8_t> const & data, const std::wstring & fileExtension) noexcept;
-    static bool IsGMF(std::vector<uint8_t> const & data) noexcept;
-    static bool IsRCP(std::vector<uint8_t> const & data, const std::wstring & fileExtension) noexcept;
-    static bool IsXMF(std::vector<uint8_t> const & data) noexcept;
-    static bool IsMMF(std::vector<uint8_t> const & data) noexcept;
-    static bool IsMMD(std::vector<uint8_t> const & data, const std::wstring & fileExtension) noexcept;
+    static std::wstring GetFileExtension(const wchar_t * filePath);
+    static detection_t Detect(const uint8_t * data, size_t size, uint64_t fileSize, const std::wstring & fileExtension) noexcept;
+
+    static bool IsSMF(const uint8_t * data, size_t size) noexcept;
+    static bool IsRMI(const uint8_t * data, size_t size, uint64_t fileSize) noexcept;
+    static bool IsHMP(const uint8_t * data, size_t size) noexcept;
+    static bool IsHMI(const uint8_t * data, size_t size) noexcept;
+    static bool IsXMI(const uint8_t * data, size_t size) noexcept;
+    static bool IsMUS(const uint8_t * data, size_t size, uint64_t fileSize) noexcept;
+    static bool IsMDS(const uint8_t * data, size_t size, uint64_t fileSize) noexcept;
+    static bool IsLDS(const uint8_t * data, size_t size, const std::wstring & fileExtension) noexcept;
+    static bool IsGMF(const uint8_t * data, size_t size) noexcept;
+    static bool IsRCP(const uint8_t * data, size_t size, const std::wstring & fileExtension) noexcept;
+    static bool IsXMF(const uint8_t * data, size_t size) noexcept;
+    static bool IsMMF(const uint8_t * data, size_t size, uint64_t fileSize) noexcept;
+    static bool IsMMD(const uint8_t * data, size_t size, uint64_t fileSize, const std::wstring & fileExtension) noexcept;
 #ifdef _DEBUG
-    static bool IsTST(std::vector<uint8_t> const & data, const std::wstring & fileExtension) noexcept;
+    static bool IsTST(const uint8_t * data, size_t size, const std::wstring & fileExtension) noexcept;
 #endif
-    static bool IsSYX(std::vector<uint8_t> const & data) noexcept;
+    static bool IsSYX(const uint8_t * data, size_t size) noexcept;
 
-    static bool ProcessSMF(std::vector<uint8_t> const & data, container_t & container);
-    static bool ProcessRMI(std::vector<uint8_t> const & data, container_t & container);
-    static bool ProcessHMP(std::vector<uint8_t> const & data, container_t & container);
-    static bool ProcessHMI(std::vector<uint8_t> const & data, container_t & container);
+    static bool ProcessSMF(std::vector<uint8_t> const & data, container_t & container, const processor_options_t & options);
+    static bool ProcessRMI(std::vector<uint8_t> const & data, container_t & container, const processor_options_t & options);
+    static bool ProcessHMP(std::vector<uint8_t> const & data, container_t & container, const processor_options_t & options);
+    static bool ProcessHMI(std::vector<uint8_t> const & data, container_t & container, const processor_options_t & options);
     static bool ProcessXMI(std::vector<uint8_t> const & data, container_t & container);
     static bool ProcessMUS(std::vector<uint8_t> const & data, container_t & container);
     static bool ProcessMDS(std::vector<uint8_t> const & data, container_t & container);
     static bool ProcessLDS(std::vector<uint8_t> const & data, container_t & container);
-    static bool ProcessGMF(std::vector<uint8_t> const & data, container_t & container);
-    static bool ProcessRCP(std::vector<uint8_t> const & data, const std::wstring & filePath, container_t & container);
-    static bool ProcessXMF(std::vector<uint8_t> const & data, container_t & container);
+    static bool ProcessGMF(std::vector<uint8_t> const & data, container_t & container, const processor_options_t & options);
+    static bool ProcessRCP(std::vector<uint8_t> const & data, const std::wstring & filePath, container_t & container, const processor_options_t & options);
+    static bool ProcessXMF(std::vector<uint8_t> const & data, container_t & container, const processor_options_t & options);
     static bool ProcessMMF(std::vector<uint8_t> const & data, container_t & container);
-    static bool ProcessMMD(std::vector<uint8_t> const & data, const std::wstring & filePath, container_t & container);
+    static bool ProcessMMD(std::vector<uint8_t> const & data, const std::wstring & filePath, container_t & container, const processor_options_t & options);
 #ifdef _DEBUG
     static bool ProcessTST(std::vector<uint8_t> const & data, container_t & container);
 #endif
     static bool ProcessSYX(std::vector<uint8_t> const & data, container_t & container);
 
-    static bool ProcessSMFTrack(std::vector<uint8_t>::const_iterator & it, std::vector<uint8_t>::const_iterator end, container_t & container);
+    static size_t ProcessSMFHeader(const uint8_t * data, container_t & container);
+    static bool ProcessSMFTrack(std::vector<uint8_t>::const_iterator & it, std::vector<uint8_t>::const_iterator end, container_t & container, const processor_options_t & options);
     static int DecodeVariableLengthQuantity(std::vector<uint8_t>::const_iterator & it, std::vector<uint8_t>::const_iterator end) noexcept;
 
     static uint32_t DecodeVariableLengthQuantityHMP(std::vector<uint8_t>::const_iterator & it, std::vector<uint8_t>::const_iterator end) noexcept;
@@ -107,9 +197,11 @@ private:
     static bool ReadChunk(std::vector<uint8_t>::const_iterator & it, std::vector<uint8_t>::const_iterator end, iff_chunk_t & chunk, bool isFirstChunk);
     static uint32_t DecodeVariableLengthQuantityXMI(std::vector<uint8_t>::const_iterator & it, std::vector<uint8_t>::const_iterator end) noexcept;
 
-    static bool ProcessNode(std::vector<uint8_t>::const_iterator & head, std::vector<uint8_t>::const_iterator tail, std::vector<uint8_t>::const_iterator & data, metadata_table_t & metaData, container_t & container);
+    static bool ProcessNode(std::vector<uint8_t>::const_iterator & head, std::vector<uint8_t>::const_iterator tail, std::vector<uint8_t>::const_iterator & data, metadata_table_t & metaData, container_t & container, const processor_options_t & options);
 
 private:
+    friend class incremental_processor_t;
+
     static const uint8_t MIDIEventEndOfTrack[2];
     static const uint8_t LoopBeginMarker[11];
     static const uint8_t LoopEndMarker[9];
@@ -117,8 +209,6 @@ private:
     static const uint8_t DefaultTempoXMI[5];
 
     static const uint8_t DefaultTempoLDS[5];
-
-    static processor_options_t _Options;
 };
 
 }
@@ -1,5 +1,5 @@
 
-/** $VER: MIDIProcessorGMF.cpp (2025.07.22) Game Music Format (http://www.vgmpf.com/Wiki/index.php?title=GMF) **/
+/** $VER: MIDIProcessorGMF.cpp (2026.10.19) Game Music Format (http://www.vgmpf.com/Wiki/index.php?title=GMF) **/
 
 #include "pch.h"
 
@@ -8,9 +8,9 @@
 namespace midi
 {
 
-bool processor_t::IsGMF(std::vector<uint8_t> const & data) noexcept
+bool processor_t::IsGMF(const uint8_t * data, size_t size) noexcept
 {
-    if (data.size() < 32)
+    if (size < 32)
         return false;
 
     if (data[0] != 'G' || data[1] != 'M' || data[2] != 'F' || data[3] != 1)
@@ -19,7 +19,7 @@ bool processor_t::IsGMF(std::vector<uint8_t> const & data) noexcept
     return true;
 }
 
-bool processor_t::ProcessGMF(std::vector<uint8_t> const & data, container_t & container)
+bool processor_t::ProcessGMF(std::vector<uint8_t> const & data, container_t & container, const processor_options_t & options)
 {
     container.FileFormat = FileFormat::GMF;
 
@@ -60,7 +60,7 @@ bool processor_t::ProcessGMF(std::vector<uint8_t> const & data, container_t & co
 
     auto it = data.begin() + 7;
 
-    return ProcessSMFTrack(it, data.end(), container);
+    return ProcessSMFTrack(it, data.end(), container, options);
 }
 
 }
@@ -1,5 +1,5 @@
 
-/** $VER: MIDIProcessorHMI.cpp (2025.07.22) Human Machine Interface (http://www.vgmpf.com/Wiki/index.php?title=HMI) **/
+/** $VER: MIDIProcessorHMI.cpp (2026.10.19) Human Machine Interface (http://www.vgmpf.com/Wiki/index.php?title=HMI) **/
 
 #include "pch.h"
 
@@ -12,20 +12,20 @@ namespace midi
 /// <summary>
 /// Returns true if data points to an HMI sequence.
 /// </summary>
-bool processor_t::IsHMI(std::vector<uint8_t> const & data) noexcept
+bool processor_t::IsHMI(const uint8_t * data, size_t size) noexcept
 {
-    if (data.size() < 12)
+    if (size < 12)
         return false;
 
     const char Id[] = { 'H', 'M', 'I', '-', 'M', 'I', 'D', 'I', 'S', 'O', 'N', 'G' };
 
-    return (::memcmp(data.data(), Id, _countof(Id)) == 0);
+    return (::memcmp(data, Id, _countof(Id)) == 0);
 }
 
 /// <summary>
 /// Processes the sequence data.
 /// </summary>
-bool processor_t::ProcessHMI(std::vector<uint8_t> const & data, container_t & container)
+bool processor_t::ProcessHMI(std::vector<uint8_t> const & data, container_t & container, const processor_options_t & options)
 {
     container.FileFormat = FileFormat::HMI;
 
@@ -57,7 +57,7 @@ bool processor_t::ProcessHMI(std::vector<uint8_t> const & data, container_t & co
         uint8_t Data[] = { StatusCode::MetaData, MetaDataType::SetTempo, 0, 0, 0 };
 
         {
-            uint32_t us = (uint32_t) (60 * 1000 * 1000) / _Options.DefaultTempo; // Convert from bpm to µs / quarter note.
+            uint32_t us = (uint32_t) (60 * 1000 * 1000) / options.DefaultTempo; // Convert from bpm to µs / quarter note.
 
             Data[4] = us & 0x7F; us >>= 7;
 
@@ -1,5 +1,5 @@
 
-/** $VER: MIDIProcessorHMP.cpp (2025.07.22) Human Machine Interfaces MIDI P/R (http://www.vgmpf.com/Wiki/index.php?title=HMP) **/
+/** $VER: MIDIProcessorHMP.cpp (2026.10.19) Human Machine Interfaces MIDI P/R (http://www.vgmpf.com/Wiki/index.php?title=HMP) **/
 
 #include "pch.h"
 
@@ -12,20 +12,20 @@ namespace midi
 /// <summary>
 /// Returns true if data points to an HMP sequence.
 /// </summary>
-bool processor_t::IsHMP(std::vector<uint8_t> const & data) noexcept
+bool processor_t::IsHMP(const uint8_t * data, size_t size) noexcept
 {
-    if (data.size() < 8)
+    if (size < 8)
         return false;
 
     const char Id[] = { 'H', 'M', 'I', 'M', 'I', 'D', 'I' };
 
-    return ((::memcmp(data.data(), Id, _countof(Id)) == 0) && (data[7] == 'P' || data[7] == 'R'));
+    return ((::memcmp(data, Id, _countof(Id)) == 0) && (data[7] == 'P' || data[7] == 'R'));
 }
 
 /// <summary>
 /// Processes the sequence data.
 /// </summary>
-bool processor_t::ProcessHMP(std::vector<uint8_t> const & data, container_t & container)
+bool processor_t::ProcessHMP(std::vector<uint8_t> const & data, container_t & container, const processor_options_t & options)
 {
     container.FileFormat = FileFormat::HMP;
 
@@ -65,7 +65,7 @@ bool processor_t::ProcessHMP(std::vector<uint8_t> const & data, container_t & co
         uint8_t Data[] = { StatusCode::MetaData, MetaDataType::SetTempo, 0, 0, 0 };
 
         {
-            uint32_t us = (uint32_t) (60 * 1000 * 1000) / _Options.DefaultTempo; // Convert from bpm to µs / quarter note.
+            uint32_t us = (uint32_t) (60 * 1000 * 1000) / options.DefaultTempo; // Convert from bpm to µs / quarter note.
 
             Data[4] = us & 0x7F; us >>= 7;
 
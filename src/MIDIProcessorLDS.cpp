@@ -1,5 +1,5 @@
 
-/** $VER: MIDIProcessorLDS.cpp (2025.07.22) Loudness Sound System (http://www.vgmpf.com/Wiki/index.php?title=LDS) **/
+/** $VER: MIDIProcessorLDS.cpp (2026.10.19) Loudness Sound System (http://www.vgmpf.com/Wiki/index.php?title=LDS) **/
 
 #include "pch.h"
 
@@ -50,7 +50,7 @@ static const unsigned char tremtab[] =
 };
 #endif
 
-bool processor_t::IsLDS(std::vector<uint8_t> const & data, const std::wstring & fileExtension) noexcept
+bool processor_t::IsLDS(const uint8_t * data, size_t size, const std::wstring & fileExtension) noexcept
 {
     if (fileExtension.empty())
         return false;
@@ -58,7 +58,7 @@ bool processor_t::IsLDS(std::vector<uint8_t> const & data, const std::wstring &
     if (::_wcsicmp(fileExtension.c_str(), L"lds"))
         return false;
 
-    if (data.size() < 1)
+    if (size < 1)
         return false;
 
     if (data[0] > 2)
@@ -1,5 +1,5 @@
 
-/** $VER: MIDIProcessorMDS.cpp (2025.07.22) MIDI Stream. created by Microsoft with the release of Windows 95 (http://www.vgmpf.com/Wiki/index.php?title=MDS) **/
+/** $VER: MIDIProcessorMDS.cpp (2026.10.19) MIDI Stream. created by Microsoft with the release of Windows 95 (http://www.vgmpf.com/Wiki/index.php?title=MDS) **/
 
 #include "pch.h"
 
@@ -9,9 +9,9 @@
 namespace midi
 {
 
-bool processor_t::IsMDS(std::vector<uint8_t> const & data) noexcept
+bool processor_t::IsMDS(const uint8_t * data, size_t size, uint64_t fileSize) noexcept
 {
-    if (data.size() < 8)
+    if (size < 16)
         return false;
 
     if (data[0] != 'R' || data[1] != 'I' || data[2] != 'F' || data[3] != 'F')
@@ -19,7 +19,7 @@ bool processor_t::IsMDS(std::vector<uint8_t> const & data) noexcept
 
     uint32_t Size = (uint32_t) (data[4] | (data[5] << 8) | (data[6] << 16) | (data[7] << 24));
 
-    if ((Size < 8) || (data.size() < (size_t) (Size + 8)))
+    if ((Size < 8) || (fileSize < (uint64_t) Size + 8))
         return false;
 
     if (data[8] != 'M' || data[9] != 'I' || data[10] != 'D' || data[11] != 'S' || data[12] != 'f' || data[13] != 'm' || data[14] != 't' || data[15] != ' ')
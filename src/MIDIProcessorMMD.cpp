@@ -1,5 +1,5 @@
 
-/** $VER: MIDIProcessorMMD.cpp (2026.05.03) P. Stuer **/
+/** $VER: MIDIProcessorMMD.cpp (2026.10.19) P. Stuer **/
 
 #include "pch.h"
 
@@ -13,7 +13,7 @@ namespace midi
 /// <summary>
 /// Returns true if data points to an MMD sequence.
 /// </summary>
-bool processor_t::IsMMD(std::vector<uint8_t> const & data, const std::wstring & fileExtension) noexcept
+bool processor_t::IsMMD(const uint8_t * data, size_t size, uint64_t fileSize, const std::wstring & fileExtension) noexcept
 {
     if (fileExtension.empty())
         return false;
@@ -24,17 +24,19 @@ bool processor_t::IsMMD(std::vector<uint8_t> const & data, const std::wstring &
     const size_t TrackCount = 18;
     const size_t HeaderSize = 2 + (TrackCount * 4);
 
-    if (data.size() < HeaderSize)
+    // Only the start of the file may be available. Verify the track offsets that are.
+    if ((size < HeaderSize) && (size >= fileSize))
         return false;
 
-    // Verify the track offsets.
-    const uint8_t * Data = data.data() + 2;
+    const size_t Count = (size < HeaderSize) ? ((size > 2) ? (size - 2) / 4 : 0) : TrackCount;
 
-    for (size_t i = 0; i < TrackCount; ++i)
+    const uint8_t * Data = data + 2;
+
+    for (size_t i = 0; i < Count; ++i)
     {
         uint16_t TrackOffset = (uint16_t) ((Data[0x01] << 8) | (Data[0x00] << 0));
 
-        if (TrackOffset >= data.size())
+        if (TrackOffset >= fileSize)
             return false;
 
         Data += 4;
@@ -46,16 +48,46 @@ bool processor_t::IsMMD(std::vector<uint8_t> const & data, const std::wstring &
 /// <summary>
 /// Processes the MMD data.
 /// </summary>
-bool processor_t::ProcessMMD(std::vector<uint8_t> const & data, const std::wstring & filePath, container_t & container)
+bool processor_t::ProcessMMD(std::vector<uint8_t> const & data, [[maybe_unused]] const std::wstring & filePath, container_t & container, const processor_options_t & options)
 {
-    std::vector<uint8_t> Data;
+    mmd::options_t Options;
+
+    Options.MaxLoopExpansions = options.MaxLoopExpansions;
+    Options.ExpandLoops       = options.ExpandLoops;
+    Options.IgnoreMutedTracks = options.IgnoreMutedTracks;
+    Options.SymbolicLoops     = options.SymbolicLoops;
+    Options.ParallelTracks    = options.ParallelTracks;
 
-    if (mmd::Convert(data.data(), (uint32_t) data.size(), Data) != 0)
+    std::vector<std::vector<uint8_t>> Tracks;
+    std::vector<mmd::loop_region_t> Loops;
+
+    if (mmd::ConvertTracks(data.data(), (uint32_t) data.size(), Tracks, Options, Loops) != 0)
         return false;
 
+    // Add the converted tracks directly instead of going through an intermediate Standard MIDI File.
+    container.Initialize(1, mmd::Resolution);
+
+    for (const auto & Track : Tracks)
+    {
+        auto Data = Track.begin();
+
+        if (!ProcessSMFTrack(Data, Track.end(), container, options))
+            return false;
+    }
+
     container.FileFormat = FileFormat::MMD;
 
-    return processor_t::Process(Data, filePath.c_str(), container);
+    if (!Loops.empty())
+    {
+        std::vector<loop_region_t> Regions;
+
+        for (const auto & Loop : Loops)
+            Regions.push_back({ Loop.TrackIndex, Loop.Begin, Loop.End, Loop.Count, Loop.IsInfinite });
+
+        container.SetLoopRegions(std::move(Regions));
+    }
+
+    return true;
 }
 
 }
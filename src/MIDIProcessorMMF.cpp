@@ -1,5 +1,5 @@
 
-/** $VER: MIDIProcessorMMF.cpp (2025.07.22) Mobile Music File / Synthetic-music Mobile Application Format (https://docs.fileformat.com/audio/mmf/) (SMAF) **/
+/** $VER: MIDIProcessorMMF.cpp (2026.10.19) Mobile Music File / Synthetic-music Mobile Application Format (https://docs.fileformat.com/audio/mmf/) (SMAF) **/
 
 #include "pch.h"
 
@@ -22,25 +22,29 @@ static void ProcessMetadata(const std::span<const uint8_t> & data, state_t & sta
 static void ProcessOPDA(const std::span<const uint8_t> & data, state_t & state, container_t & container);
 static void ProcessMTR(const std::span<const uint8_t> & data, state_t & state, container_t & container);
 static void ProcessHPSTrack(const std::span<const uint8_t> & data, state_t & state, container_t & container);
+static void ProcessMSTrack(const std::span<const uint8_t> & data, state_t & state, container_t & container);
 
 static uint32_t GetHPSValue(std::span<const uint8_t>::iterator data) noexcept;
 static uint32_t GetHPSValueEx(std::span<const uint8_t>::iterator & data) noexcept;
+static uint32_t GetMSValue(std::span<const uint8_t>::iterator & data, const std::span<const uint8_t>::iterator & tail);
 
+static const char * GetContentsTypeDescription(uint8_t type) noexcept;
 static std::string GetEncodingDescription(uint8_t encoding) noexcept;
+
 /// <summary>
 /// Returns true if the byte vector contains MMF data.
 /// </summary>
-bool processor_t::IsMMF(std::vector<uint8_t> const & data) noexcept
+bool processor_t::IsMMF(const uint8_t * data, size_t size, uint64_t fileSize) noexcept
 {
-    if (data.size() < 8)
+    if (size < 8)
         return false;
 
-    if (::memcmp(data.data(), "MMMD", 4) != 0)
+    if (::memcmp(data, "MMMD", 4) != 0)
         return false;
 
-    const uint32_t Size = toInt32LE(data.data() + 4);
+    const uint32_t Size = toInt32LE(data + 4);
 
-    if (data.size() < (size_t) Size + 8)
+    if (fileSize < (uint64_t) Size + 8)
         return false;
 
     return true;
@@ -84,7 +88,7 @@ bool processor_t::ProcessMMF(std::vector<uint8_t> const & data, container_t & co
         // Is it a "Contents Info" chunk?
         if (::memcmp(&it[0], "CNTI", 4) == 0)
         {
-            ::_putws(msc::FormatText(L"Chunk \"CNTI\", %zu bytes (Contents Information)", ChunkSize).c_str());
+            MIDI_DIAGNOSTIC(severity_t::Trace, "MMF", ChunkId, (size_t) (it - data.begin()), (size_t) ChunkSize, "Contents Information");
 
             it += (ptrdiff_t) 8;
 
@@ -94,35 +98,12 @@ bool processor_t::ProcessMMF(std::vector<uint8_t> const & data, container_t & co
             uint8_t CopyStatus = it[3];
             uint8_t CopyCounts = it[4];
 
-            ::printf("- Class: %s\n", (Class == 0x00) ? "Yamaha" : "Other");
-
-            if ((0x00 <= Type && Type <= 0x0F) || (0x30 <= Type && Type <= 0x33))
-                ::printf("- Type: Ringtone (0x%02X)\n", Type);
-            else
-            if ((0x10 <= Type && Type <= 0x1F) || (0x40 <= Type && Type <= 0x42))
-                ::printf("- Type: Karaoke (0x%02X)\n", Type);
-            else
-            if ((0x20 <= Type && Type <= 0x2F) || (0x50 <= Type && Type <= 0x53))
-                ::printf("- Type: CM (0x%02X)\n", Type);
-            else
-                ::printf("- Type: Reserved (0x%02X)\n", Type);
-
-            ::printf("- Encoding: 0x%02X (%s)\n", Encoding, GetEncodingDescription(Encoding).c_str());
-            
-            ::printf("- Status: ");
-
-            if ((CopyStatus & 0x01) == 0x00)
-                ::printf("Transferable, ");
-
-            if ((CopyStatus & 0x02) == 0x00)
-                ::printf("Can be saved, ");
-
-            if ((CopyStatus & 0x04) == 0x00)
-                ::printf("Editable, ");
-
-            ::puts("");
-
-            ::printf("- Copy Count: %d\n", CopyCounts);
+            MIDI_DIAGNOSTIC(severity_t::Trace, "MMF", ChunkId, (size_t) (it - data.begin()), 5, "Class: %s, Type: %s (0x%02X), Encoding: 0x%02X (%s), Transferable: %s, Can be saved: %s, Editable: %s, Copy Count: %d",
+                (Class == 0x00) ? "Yamaha" : "Other",
+                GetContentsTypeDescription(Type), Type,
+                Encoding, GetEncodingDescription(Encoding).c_str(),
+                ((CopyStatus & 0x01) == 0x00) ? "Yes" : "No", ((CopyStatus & 0x02) == 0x00) ? "Yes" : "No", ((CopyStatus & 0x04) == 0x00) ? "Yes" : "No",
+                CopyCounts);
 
             it += (ptrdiff_t) 5;
 
@@ -134,7 +115,7 @@ bool processor_t::ProcessMMF(std::vector<uint8_t> const & data, container_t & co
         // Is it a "Optional Data" chunk?
         if (::memcmp(&it[0], "OPDA", 4) == 0)
         {
-            ::_putws(msc::FormatText(L"Chunk \"OPDA\", %zu bytes (Optional Data)", ChunkSize).c_str());
+            MIDI_DIAGNOSTIC(severity_t::Trace, "MMF", ChunkId, (size_t) (it - data.begin()), (size_t) ChunkSize, "Optional Data");
 
             it += (ptrdiff_t) 8;
 
@@ -146,7 +127,7 @@ bool processor_t::ProcessMMF(std::vector<uint8_t> const & data, container_t & co
         // Is it a "Score Track" chunk?
         if (::memcmp(&it[0], "MTR", 3) == 0)
         {
-            ::_putws(msc::FormatText(L"Chunk \"MTR_\", %zu bytes (Score Track)", ChunkSize).c_str());
+            MIDI_DIAGNOSTIC(severity_t::Trace, "MMF", ChunkId, (size_t) (it - data.begin()), (size_t) ChunkSize, "Score Track");
 
             it += (ptrdiff_t) 8;
 
@@ -160,7 +141,7 @@ bool processor_t::ProcessMMF(std::vector<uint8_t> const & data, container_t & co
         // Is it an "PCM Audio Track" chunk? Stores PCM audio sounds such as ADPCM, MP3, and TwinVQ in event format.
         if (::memcmp(&it[0], "ATR", 3) == 0)
         {
-            ::_putws(msc::FormatText(L"Chunk \"ATR_\", %zu bytes (PCM Audio Track)", ChunkSize).c_str());
+            MIDI_DIAGNOSTIC(severity_t::Info, "MMF", ChunkId, (size_t) (it - data.begin()), (size_t) ChunkSize, "Skipping PCM Audio Track");
 
             it += (ptrdiff_t) 8 + ChunkSize;
         }
@@ -168,7 +149,7 @@ bool processor_t::ProcessMMF(std::vector<uint8_t> const & data, container_t & co
         // Is it a "Graphics Track" chunk? Stores background images, inserted still images, text data, and sequence data for playing these.
         if (::memcmp(&it[0], "GTR", 3) == 0)
         {
-            ::_putws(msc::FormatText(L"Chunk \"ATR_\", %zu bytes (Graphics Track)", ChunkSize).c_str());
+            MIDI_DIAGNOSTIC(severity_t::Info, "MMF", ChunkId, (size_t) (it - data.begin()), (size_t) ChunkSize, "Skipping Graphics Track");
 
             it += (ptrdiff_t) 8 + ChunkSize;
         }
@@ -176,17 +157,16 @@ bool processor_t::ProcessMMF(std::vector<uint8_t> const & data, container_t & co
         // Is it a "Master Track" chunk? Stores music information sequences synchronized with playback sequences such as the Score Track, and sequence data for controlling the SMAF playback system.
         if (::memcmp(&it[0], "MSTR", 4) == 0)
         {
-            ::_putws(msc::FormatText(L"Chunk \"MSTR\", %zu bytes (Master Track)", ChunkSize).c_str());
+            MIDI_DIAGNOSTIC(severity_t::Info, "MMF", ChunkId, (size_t) (it - data.begin()), (size_t) ChunkSize, "Skipping Master Track");
 
             it += (ptrdiff_t) 8 + ChunkSize;
         }
-#ifdef _DEBUG
         else
         {
-            ::_putws(msc::FormatText(L"Unknown chunk \"%S\", %zu bytes", ChunkId.c_str(), ChunkSize).c_str());
+            MIDI_DIAGNOSTIC(severity_t::Warning, "MMF", ChunkId, (size_t) (it - data.begin()), (size_t) ChunkSize, "Skipping unknown chunk");
+
             it += (ptrdiff_t) 8 + ChunkSize;
         }
-#endif
     }
 
 //  uint16_t CRC = (uint16_t) ((it[0] << 8) | it[1]);
@@ -234,13 +214,11 @@ bool processor_t::ProcessMMF(std::vector<uint8_t> const & data, container_t & co
 /// <summary>
 /// Processes metadata in the CNTI chunk.
 /// </summary>
-static void ProcessMetadata(const std::span<const uint8_t> & data, state_t & state, container_t & container)
+static void ProcessMetadata(const std::span<const uint8_t> & data, state_t & state, [[maybe_unused]] container_t & container)
 {
     auto it = data.begin();
     const auto Tail = data.end();
 
-    auto Anchor = it;
-
     while (it < Tail)
     {
         std::string Name = std::string(&it[0], &it[2]);
@@ -274,7 +252,7 @@ static void ProcessMetadata(const std::span<const uint8_t> & data, state_t & sta
 /// <summary>
 /// Processes an OPDA chunk.
 /// </summary>
-static void ProcessOPDA(const std::span<const uint8_t> & data, state_t & state, container_t & container)
+static void ProcessOPDA(const std::span<const uint8_t> & data, [[maybe_unused]] state_t & state, [[maybe_unused]] container_t & container)
 {
     auto it = data.begin();
     const auto Tail = data.end();
@@ -293,16 +271,13 @@ static void ProcessOPDA(const std::span<const uint8_t> & data, state_t & state,
 
         if (::memcmp(&it[0], "Dch", 3) == 0)
         {
-            ::_putws(msc::FormatText(L"Chunk \"Dch_\", %zu bytes (Data)", ChunkSize).c_str());
-
             uint8_t Encoding = it[3];
 
-            ::printf("- Encoding: 0x%02X (%s)\n", Encoding, GetEncodingDescription(Encoding).c_str());
+            MIDI_DIAGNOSTIC(severity_t::Trace, "MMF", ChunkId, diagnostic_t::None, (size_t) ChunkSize, "Data, Encoding: 0x%02X (%s)", Encoding, GetEncodingDescription(Encoding).c_str());
         }
-#ifdef _DEBUG
         else
-            ::_putws(msc::FormatText(L"Unknown chunk \"%S\", %zu bytes", ChunkId.c_str(), ChunkSize).c_str());
-#endif
+            MIDI_DIAGNOSTIC(severity_t::Warning, "MMF", ChunkId, diagnostic_t::None, (size_t) ChunkSize, "Skipping unknown chunk");
+
         it += (ptrdiff_t) (8 + ChunkSize);
     }
 }
@@ -315,6 +290,9 @@ static void ProcessMTR(const std::span<const uint8_t> & data, state_t & state, c
     auto it = data.begin();
     const auto Tail = data.end();
 
+    if (Tail - it < 4)
+        throw midi::exception("Insufficient SMAF data");
+
     // Decode the track header.
     {
         state.FormatType   = it[0];
@@ -322,11 +300,6 @@ static void ProcessMTR(const std::span<const uint8_t> & data, state_t & state, c
         state.DurationBase = it[2];
         state.GateTimeBase = it[3];
 
-        ::printf("- Format        : %02X\n", state.FormatType);
-        ::printf("- Sequence      : %02X\n", state.SequenceType);
-        ::printf("- Duration base : %02X\n", state.DurationBase);
-        ::printf("- Gate Time base: %02X\n", state.GateTimeBase);
-
         switch (state.DurationBase)
         {
             case 0x00: state.DurationBase =  1; break;
@@ -357,73 +330,27 @@ static void ProcessMTR(const std::span<const uint8_t> & data, state_t & state, c
                 throw midi::exception("Unknown gate time base");
         }
 
+        it += (ptrdiff_t) 4;
+
+        // Skip the channel status.
         switch (state.FormatType)
         {
-            case HandyPhoneStandard: // HPS
-            {
-                std::vector<channel_t> Channels;
-
-                Channels.push_back(channel_t(0, (it[0] & 0x80) == 0x80, (it[0] & 0x40) == 0x40, (it[0] >> 4) & 0x03, TrackFormat::MA2));
-                Channels.push_back(channel_t(1, (it[0] & 0x08) == 0x08, (it[0] & 0x04) == 0x04, (it[0]     ) & 0x03, TrackFormat::MA2));
-                Channels.push_back(channel_t(2, (it[1] & 0x80) == 0x80, (it[1] & 0x40) == 0x40, (it[1] >> 4) & 0x03, TrackFormat::MA2));
-                Channels.push_back(channel_t(3, (it[1] & 0x08) == 0x08, (it[1] & 0x04) == 0x04, (it[1]     ) & 0x03, TrackFormat::MA2));
-
-                it += (ptrdiff_t) 2;
-                break;
-            }
-
-            case MobileStandard_Compress: // SMF
-            {
-                uint8_t Buffer[16] = { };
-
-                std::vector<channel_t> Channels;
-
-                for (int i = 0; i < 16; ++i)
-                    Channels.push_back(channel_t(i, (int) Buffer[i]));
-
-                it += (ptrdiff_t) 16;
-
-                throw midi::exception("SMAF Format 1 not supported yet");
-                break;
-            }
-
-            case MobileStandard_NoCompress: // SMF
-            {
-                uint8_t Buffer[16] = { };
-
-                std::vector<channel_t> Channels;
-
-                for (int i = 0; i < 16; ++i)
-                    Channels.push_back(channel_t(i, (int) Buffer[i]));
-
-                it += (ptrdiff_t) 16;
-                throw midi::exception("SMAF Format 2 not supported yet");
-                break;
-            }
-
-            case SEQU: // ???
-            {
-                uint8_t Buffer[32] = { };
-
-                std::vector<channel_t> Channels;
-
-                for (int i = 0; i < 32; ++i)
-                    Channels.push_back(channel_t(i, (int) Buffer[i]));
+            case HandyPhoneStandard:        { it += (ptrdiff_t)  2; break; }
+            case MobileStandard_Compress:   { it += (ptrdiff_t) 16; break; }
+            case MobileStandard_NoCompress: { it += (ptrdiff_t) 16; break; }
 
-                it += (ptrdiff_t) 32;
+            case SEQU:
                 throw midi::exception("SMAF Format 3 not supported yet");
-                break;
-            }
 
             default:
                 throw midi::exception("Unknown SMAF Format");
         }
 
-        it += (ptrdiff_t) 4;
+        if (it > Tail)
+            throw midi::exception("Insufficient SMAF data");
     }
 
-    if (state.FormatType != SMAFFormat::HandyPhoneStandard)
-        return;
+    std::vector<uint8_t> Sequence;
 
     while (it < Tail)
     {
@@ -432,37 +359,31 @@ static void ProcessMTR(const std::span<const uint8_t> & data, state_t & state, c
 
         const uint32_t ChunkSize = toInt32LE(it + 4);
 
-        if ((Tail - it) < (ptrdiff_t) ChunkSize)
+        if ((Tail - it) - 8 < (ptrdiff_t) ChunkSize)
             throw midi::exception("Insufficient SMAF data");
 
-        const std::string ChunkId(it, it + 4);
+        const std::span<const uint8_t> ChunkData(&it[8], ChunkSize);
 
-        if (::memcmp(&it[0], "Mtsu", 4) == 0)
+        // Is it a "Setup Data" or a "Sequence Data" chunk?
+        if ((::memcmp(&it[0], "Mtsu", 4) == 0) || (::memcmp(&it[0], "Mtsq", 4) == 0))
         {
-            ::_putws(msc::FormatText(L"Chunk \"%S\", %zu bytes (Setup Data)", ChunkId.c_str(), ChunkSize).c_str());
+            state.IsMTSU = (it[3] == 'u');
 
-            state.IsMTSU = true;
+            if (state.FormatType == SMAFFormat::HandyPhoneStandard)
+                ProcessHPSTrack(ChunkData, state, container);
+            else
+            if ((state.FormatType == SMAFFormat::MobileStandard_Compress) && !state.IsMTSU)
+            {
+                if (!DecompressMobileStandard(ChunkData.data(), ChunkData.size(), Sequence))
+                    throw midi::exception("Invalid compressed SMAF sequence data");
 
-            if (state.FormatType == 0)
-                ProcessHPSTrack(std::span<const uint8_t>(&it[8], ChunkSize), state, container);
+                ProcessMSTrack(Sequence, state, container);
+            }
+            else
+                ProcessMSTrack(ChunkData, state, container);
         }
-        else
-        if (::memcmp(&it[0], "Mtsq", 4) == 0)
-        {
-            ::_putws(msc::FormatText(L"Chunk \"%S\", %zu bytes (Sequence Data)", ChunkId.c_str(), ChunkSize).c_str());
 
-            state.IsMTSU = false;
-
-            if (state.FormatType == 0)
-                ProcessHPSTrack(std::span<const uint8_t>(&it[8], ChunkSize), state, container);
-        }
-        else
-        if (::memcmp(&it[0], "MspI", 4) == 0)
-        {
-            ::_putws(msc::FormatText(L"Chunk \"%S\", %zu bytes (Seek & Phrase Info)", ChunkId.c_str(), ChunkSize).c_str());
-        }
-        else
-            ::_putws(msc::FormatText(L"Unknown chunk \"%S\", %zu bytes", ChunkId.c_str(), ChunkSize).c_str());
+        // Seek & Phrase Info (MspI) and Stream PCM Wave Data (Mtsp) chunks are ignored.
 
         it += (ptrdiff_t) (8 + ChunkSize);
     }
@@ -605,7 +526,7 @@ static void ProcessHPSTrack(const std::span<const uint8_t> & data, state_t & sta
                             }
                             else
                             {
-                                uint8_t Data[2] = { 0x00, it[2] & 0x7Fu };
+                                uint8_t Data[2] = { 0x00, (uint8_t) (it[2] & 0x7Fu) };
 
                                 Track.AddEvent(event_t(RunningTime, event_t::ControlChange, Channel, Data, 2)); // MSB
 
@@ -685,7 +606,7 @@ static void ProcessHPSTrack(const std::span<const uint8_t> & data, state_t & sta
                         }
 
                         default:
-                            ::printf("Unknown opcode 0x%02X\n", it[1] & 0x0F);
+                            it += 3; // Unknown opcode. Skip it.
                     }
                 }
                 else
@@ -762,7 +683,7 @@ static void ProcessHPSTrack(const std::span<const uint8_t> & data, state_t & sta
                         }
 
                         default:
-                            ::printf("Unknown opcode 0x%02X\n", it[1] & 0x30);
+                            it += 2; // Unknown opcode. Skip it.
                     }
                 }
             }
@@ -772,6 +693,165 @@ static void ProcessHPSTrack(const std::span<const uint8_t> & data, state_t & sta
     container.AddTrack(Track);
 }
 
+/// <summary>
+/// Processes an MS (Mobile Standard) track. The setup track contains only exclusive messages without durations.
+/// </summary>
+static void ProcessMSTrack(const std::span<const uint8_t> & data, state_t & state, container_t & container)
+{
+    track_t Track;
+
+    uint32_t RunningTime = 0;
+
+    auto it = data.begin();
+    const auto Tail = data.end();
+
+    auto Require = [&it, &Tail](ptrdiff_t size)
+    {
+        if (Tail - it < size)
+            throw midi::exception("Insufficient SMAF data");
+    };
+
+    while (it < Tail)
+    {
+        if (!state.IsMTSU)
+            RunningTime += GetMSValue(it, Tail) * state.DurationBase;
+
+        Require(1);
+
+        const uint8_t Status = it[0];
+        const uint8_t Channel = Status & 0x0Fu;
+
+        switch (Status & 0xF0)
+        {
+            // Note without velocity
+            case 0x80:
+            {
+                Require(2);
+
+                const uint8_t Data[2] = { (uint8_t) (it[1] & 0x7Fu), 0x40u };
+
+                it += 2;
+
+                const uint32_t GateTime = GetMSValue(it, Tail) * state.GateTimeBase;
+
+                Track.AddEvent(event_t(RunningTime,            event_t::NoteOn,  Channel, Data, 2));
+                Track.AddEvent(event_t(RunningTime + GateTime, event_t::NoteOff, Channel, Data, 2));
+                break;
+            }
+
+            // Note with velocity
+            case 0x90:
+            {
+                Require(3);
+
+                const uint8_t Data[2] = { (uint8_t) (it[1] & 0x7Fu), (uint8_t) (it[2] & 0x7Fu) };
+
+                it += 3;
+
+                const uint32_t GateTime = GetMSValue(it, Tail) * state.GateTimeBase;
+
+                Track.AddEvent(event_t(RunningTime,            event_t::NoteOn,  Channel, Data, 2));
+                Track.AddEvent(event_t(RunningTime + GateTime, event_t::NoteOff, Channel, Data, 2));
+                break;
+            }
+
+            // Control Change
+            case 0xB0:
+            {
+                Require(3);
+
+                Track.AddEvent(event_t(RunningTime, event_t::ControlChange, Channel, &it[1], 2));
+                it += 3;
+                break;
+            }
+
+            // Program Change
+            case 0xC0:
+            {
+                Require(2);
+
+                Track.AddEvent(event_t(RunningTime, event_t::ProgramChange, Channel, &it[1], 1));
+                it += 2;
+                break;
+            }
+
+            // Channel Pressure
+            case 0xD0:
+            {
+                Require(2);
+
+                Track.AddEvent(event_t(RunningTime, event_t::ChannelPressure, Channel, &it[1], 1));
+                it += 2;
+                break;
+            }
+
+            // Pitch Bend
+            case 0xE0:
+            {
+                Require(3);
+
+                Track.AddEvent(event_t(RunningTime, event_t::PitchBendChange, Channel, &it[1], 2));
+                it += 3;
+                break;
+            }
+
+            case 0xF0:
+            {
+                // Exclusive
+                if (Status == StatusCode::SysEx)
+                {
+                    ++it;
+
+                    const uint32_t Size = GetMSValue(it, Tail);
+
+                    Require((ptrdiff_t) Size);
+
+                    std::vector<uint8_t> Temp(1 + (size_t) Size);
+
+                    Temp[0] = StatusCode::SysEx;
+
+                    std::copy(it, it + (ptrdiff_t) Size, Temp.begin() + 1);
+
+                    Track.AddEvent(event_t(RunningTime, event_t::Extended, 0, Temp.data(), Temp.size()));
+
+                    it += (ptrdiff_t) Size;
+                    break;
+                }
+
+                Require(2);
+
+                // NOP
+                if ((Status == 0xFF) && (it[1] == 0x00))
+                {
+                    it += 2;
+                    break;
+                }
+
+                // End of Sequence
+                if ((Status == 0xFF) && (it[1] == 0x2F))
+                {
+                    it = Tail;
+                    break;
+                }
+
+                throw midi::exception("Invalid SMAF event");
+            }
+
+            default:
+                throw midi::exception("Invalid SMAF event");
+        }
+    }
+
+    if (!state.IsMTSU)
+    {
+        const uint8_t Data[] = { StatusCode::MetaData, MetaDataType::EndOfTrack };
+
+        Track.AddEvent(event_t(RunningTime, event_t::Extended, 0, Data, _countof(Data)));
+    }
+
+    container.AddTrack(Track);
+}
+
 /// <summary>
 /// Gets an HPS-encoded value.
 /// </summary>
@@ -802,6 +882,46 @@ static uint32_t GetHPSValueEx(std::span<const uint8_t>::iterator & data) noexcep
     return Value;
 }
 
+/// <summary>
+/// Gets an MS-encoded value (a variable-length quantity of at most 4 bytes) and advances the data pointer.
+/// </summary>
+static uint32_t GetMSValue(std::span<const uint8_t>::iterator & data, const std::span<const uint8_t>::iterator & tail)
+{
+    uint32_t Value = 0;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        if (data >= tail)
+            break;
+
+        const uint8_t Byte = *data++;
+
+        Value = (Value << 7) | (Byte & 0x7Fu);
+
+        if ((Byte & 0x80) == 0)
+            return Value;
+    }
+
+    throw midi::exception("Invalid SMAF variable-length value");
+}
+
+/// <summary>
+/// Gets the description of a contents type.
+/// </summary>
+static const char * GetContentsTypeDescription(uint8_t type) noexcept
+{
+    if ((type <= 0x0F) || (0x30 <= type && type <= 0x33))
+        return "Ringtone";
+
+    if ((0x10 <= type && type <= 0x1F) || (0x40 <= type && type <= 0x42))
+        return "Karaoke";
+
+    if ((0x20 <= type && type <= 0x2F) || (0x50 <= type && type <= 0x53))
+        return "CM";
+
+    return "Reserved";
+}
+
 /// <summary>
 /// Gets the description of an encoding type.
 /// </summary>
@@ -826,7 +946,7 @@ static std::string GetEncodingDescription(uint8_t encoding) noexcept
 
         case 0xFF: return std::string("Binary");                // Only used in OPDA chunk
 
-        default:   return msc::FormatText("Unknown (0x%02X)\n", encoding);
+        default:   return msc::FormatText("Unknown (0x%02X)", encoding);
     }
 }
 
@@ -1,5 +1,5 @@
 
-/** $VER: MIDIProcessorMUS.cpp (2025.07.22) Created by Paul Radek for his DMX audio library. Used by id Software for Doom and several other games. (https://moddingwiki.shikadi.net/wiki/MUS_Format) **/
+/** $VER: MIDIProcessorMUS.cpp (2026.10.19) Created by Paul Radek for his DMX audio library. Used by id Software for Doom and several other games. (https://moddingwiki.shikadi.net/wiki/MUS_Format) **/
 
 #include "pch.h"
 
@@ -8,9 +8,9 @@
 namespace midi
 {
 
-bool processor_t::IsMUS(std::vector<uint8_t> const & data) noexcept
+bool processor_t::IsMUS(const uint8_t * data, size_t size, uint64_t fileSize) noexcept
 {
-    if (data.size() < 0x20)
+    if (size < 0x20)
         return false;
 
     if (data[0] != 'M' || data[1] != 'U' || data[2] != 'S' || data[3] != 0x1A)
@@ -20,7 +20,7 @@ bool processor_t::IsMUS(std::vector<uint8_t> const & data) noexcept
     uint16_t Offset          = (uint16_t) (data[ 6] | (data[ 7] << 8)); // Offset to song data
     uint16_t InstrumentCount = (uint16_t) (data[12] | (data[13] << 8)); // No. of primary channels used
 
-    if (Offset >= (16 + (InstrumentCount * 2)) && Offset < (16 + (InstrumentCount * 4)) && (size_t) (Offset + Length) <= data.size())
+    if (Offset >= (16 + (InstrumentCount * 2)) && Offset < (16 + (InstrumentCount * 4)) && (uint64_t) (Offset + Length) <= fileSize)
         return true;
 
     return false;
@@ -1,5 +1,5 @@
 
-/** $VER: MIDIProcessorRCP.cpp (2026.05.03) P. Stuer - Based on Valley Bell's rpc2mid (https://github.com/ValleyBell/MidiConverters). **/
+/** $VER: MIDIProcessorRCP.cpp (2026.10.19) P. Stuer - Based on Valley Bell's rpc2mid (https://github.com/ValleyBell/MidiConverters). **/
 
 #include "pch.h"
 
@@ -13,15 +13,15 @@ namespace midi
 /// <summary>
 /// Returns true if data points to an RCP sequence.
 /// </summary>
-bool processor_t::IsRCP(std::vector<uint8_t> const & data, const std::wstring & fileExtension) noexcept
+bool processor_t::IsRCP(const uint8_t * data, size_t size, const std::wstring & fileExtension) noexcept
 {
     if (fileExtension.empty())
         return false;
 
-    if (data.size() < 28)
+    if (size < 28)
         return false;
 
-    if (::strncmp((const char *) data.data(), "RCM-PC98V2.0(C)COME ON MUSIC", 28) == 0)
+    if (::strncmp((const char *) data, "RCM-PC98V2.0(C)COME ON MUSIC", 28) == 0)
     {
         if (::_wcsicmp(fileExtension.c_str(), L"rcp") == 0)
             return true;
@@ -32,10 +32,10 @@ bool processor_t::IsRCP(std::vector<uint8_t> const & data, const std::wstring &
         return false;
     }
 
-    if (data.size() < 31)
+    if (size < 31)
         return false;
 
-    if (::strncmp((const char *) data.data(), "COME ON MUSIC RECOMPOSER RCP3.0", 31) == 0)
+    if (::strncmp((const char *) data, "COME ON MUSIC RECOMPOSER RCP3.0", 31) == 0)
     {
         if (::_wcsicmp(fileExtension.c_str(), L"g18") == 0)
             return true;
@@ -52,7 +52,7 @@ bool processor_t::IsRCP(std::vector<uint8_t> const & data, const std::wstring &
 /// <summary>
 /// Processes the sequence data.
 /// </summary>
-bool processor_t::ProcessRCP(std::vector<uint8_t> const & data, const std::wstring & filePath, container_t & container)
+bool processor_t::ProcessRCP(std::vector<uint8_t> const & data, const std::wstring & filePath, container_t & container, const processor_options_t & options)
 {
     rcp::converter_t RCPConverter;
 
@@ -60,14 +60,16 @@ bool processor_t::ProcessRCP(std::vector<uint8_t> const & data, const std::wstri
 
     auto & Options = RCPConverter._Options;
 
-    Options.MaxLoopExpansions  = _Options.MaxLoopExpansions;
+    Options.MaxLoopExpansions  = options.MaxLoopExpansions;
 
-    Options.WriteCueMarkers    = _Options.WriteCueMarkers;
-    Options.WriteSysExNames    = _Options.WriteSysExNames;
-    Options.ExpandLoops        = _Options.ExpandLoops;
-    Options.WolfteamLoopMode   = _Options.WolfteamLoopMode;
-    Options.IgnoreMutedTracks  = _Options.IgnoreMutedTracks;
-    Options.IncludeControlData = _Options.IncludeControlData;
+    Options.WriteCueMarkers    = options.WriteCueMarkers;
+    Options.WriteSysExNames    = options.WriteSysExNames;
+    Options.ExpandLoops        = options.ExpandLoops;
+    Options.SymbolicLoops      = options.SymbolicLoops;
+    Options.WolfteamLoopMode   = options.WolfteamLoopMode;
+    Options.IgnoreMutedTracks  = options.IgnoreMutedTracks;
+    Options.IncludeControlData = options.IncludeControlData;
+    Options.ParallelTracks     = options.ParallelTracks;
 
     rcp::buffer_t SrcData;
 
@@ -81,9 +83,22 @@ bool processor_t::ProcessRCP(std::vector<uint8_t> const & data, const std::wstri
 
     Data.insert(Data.end(), DstData.Data, DstData.Data + DstData.Size);
 
+    if (!ProcessSMF(Data, container, options))
+        return false;
+
     container.FileFormat = FileFormat::RCP;
 
-    return processor_t::Process(Data, filePath.c_str(), container);
+    if (!RCPConverter.GetLoops().empty())
+    {
+        std::vector<loop_region_t> Regions;
+
+        for (const auto & Loop : RCPConverter.GetLoops())
+            Regions.push_back({ Loop.TrackIndex, Loop.Begin, Loop.End, Loop.Count, Loop.IsInfinite });
+
+        container.SetLoopRegions(std::move(Regions));
+    }
+
+    return true;
 }
 
 }
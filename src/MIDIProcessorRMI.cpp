@@ -1,5 +1,5 @@
 
-/** $VER: MIDIProcessorRMI.cpp (2025.09.07) **/
+/** $VER: MIDIProcessorRMI.cpp (2026.10.19) **/
 
 #include "pch.h"
 
@@ -53,17 +53,17 @@ static bool GetCodePage(std::vector<uint8_t>::const_iterator data, ptrdiff_t siz
 /// <summary>
 /// Returns true if the data contains a RIFF file.
 /// </summary>
-bool processor_t::IsRMI(std::vector<uint8_t> const & data) noexcept
+bool processor_t::IsRMI(const uint8_t * data, size_t size, uint64_t fileSize) noexcept
 {
-    if (data.size() < 20)
+    if (size < 20 + 18)
         return false;
 
-    if (::memcmp(data.data(), "RIFF", 4) != 0)
+    if (::memcmp(data, "RIFF", 4) != 0)
         return false;
 
     uint32_t Size = toInt32LE(&data[4]);
 
-    if ((Size < 12) || (data.size() < (size_t) Size + 8))
+    if ((Size < 12) || (fileSize < (uint64_t) Size + 8))
         return false;
 
     if (::memcmp(&data[8], "RMID", 4) != 0 || ::memcmp(&data[12], "data", 4) != 0)
@@ -71,18 +71,16 @@ bool processor_t::IsRMI(std::vector<uint8_t> const & data) noexcept
 
     uint32_t DataSize = toInt32LE(&data[16]);
 
-    if ((DataSize < 18) || (data.size() < (size_t) DataSize + 20) || (Size < DataSize + 12))
+    if ((DataSize < 18) || (fileSize < (uint64_t) DataSize + 20) || (Size < DataSize + 12))
         return false;
 
-    std::vector<uint8_t> Data(data.begin() + 20, data.begin() + 20 + 18);
-
-    return IsSMF(Data);
+    return IsSMF(data + 20, 18);
 }
 
 /// <summary>
 /// Processes the data as an RIFF file and returns an intialized container.
 /// </summary>
-bool processor_t::ProcessRMI(std::vector<uint8_t> const & data, container_t & container)
+bool processor_t::ProcessRMI(std::vector<uint8_t> const & data, container_t & container, const processor_options_t & options)
 {
     container.FileFormat = FileFormat::RMI;
 
@@ -121,7 +119,7 @@ bool processor_t::ProcessRMI(std::vector<uint8_t> const & data, container_t & co
 
             std::vector<uint8_t> Data(it + 8, it + 8 + ChunkSize);
 
-            if (!ProcessSMF(Data, container))
+            if (!ProcessSMF(Data, container, options))
                 return false;
 
             HasDataChunk = true;
@@ -162,12 +160,9 @@ bool processor_t::ProcessRMI(std::vector<uint8_t> const & data, container_t & co
                 container.SoundFont = Data;
             }
         }
-#ifdef _DEBUG
         else
-        {
-            ::OutputDebugStringW(msc::FormatText(L"Unknown chunk \"%s\", %zu bytes\n", ChunkId.c_str(), ChunkSize).c_str());
-        }
-#endif
+            MIDI_DIAGNOSTIC(severity_t::Info, "RMI", ChunkId, (size_t) (it - data.begin()), (size_t) ChunkSize, "Skipping unknown chunk");
+
         it += (ptrdiff_t) 8 + ChunkSize;
 
         if ((ChunkSize & 1) && (it < Tail))
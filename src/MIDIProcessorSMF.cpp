@@ -1,5 +1,5 @@
 
-/** $VER: MIDIProcessorSMF.cpp (2026.04.10) Standard MIDI File **/
+/** $VER: MIDIProcessorSMF.cpp (2026.10.19) Standard MIDI File **/
 
 #include "pch.h"
 
@@ -18,12 +18,12 @@ namespace midi
 /// <summary>
 /// Returns true if the data contains an SMF file.
 /// </summary>
-bool processor_t::IsSMF(std::vector<uint8_t> const & data) noexcept
+bool processor_t::IsSMF(const uint8_t * data, size_t size) noexcept
 {
-    if (data.size() < 18)
+    if (size < 18)
         return false;
 
-    if (::memcmp(data.data(), "MThd", 4) != 0)
+    if (::memcmp(data, "MThd", 4) != 0)
         return false;
 
     if (data[4] != 0 || data[5] != 0 || data[6] != 0 || data[7] != 6)
@@ -51,35 +51,12 @@ bool processor_t::IsSMF(std::vector<uint8_t> const & data) noexcept
 /// <summary>
 /// Processes the data as an SMF file and returns an intialized container.
 /// </summary>
-bool processor_t::ProcessSMF(std::vector<uint8_t> const & data, container_t & container)
+bool processor_t::ProcessSMF(std::vector<uint8_t> const & data, container_t & container, const processor_options_t & options)
 {
-    container.FileFormat = FileFormat::SMF;
-
     if (data.size() < 18)
         throw midi::exception("Insufficient SMF data");
 
-    if (::memcmp(&data[0], "MThd", 4) != 0)
-        throw midi::exception("Invalid SMF header chunk type");
-
-    if (data[4] != 0 || data[5] != 0 || data[6] != 0 || data[7] != 6)
-        throw midi::exception("Invalid SMF header chunk size");
-
-    const int Format = (data[8] << 8) | data[9];
-
-    if (Format > 2)
-        throw midi::exception(msc::FormatText("Unrecognized MIDI format: %d", Format));
-
-    const size_t TrackCount = (size_t) ((data[10] << 8) | data[11]);
-
-    if ((TrackCount == 0) || ((Format == 0) && (TrackCount != 1)))
-        throw midi::exception("Invalid track count");
-
-    const int TimeDivision = (data[12] << 8) | data[13];
-
-    if ((TimeDivision == 0))
-        throw midi::exception("Invalid time division");
-
-    container.Initialize((uint32_t) Format, (uint32_t) TimeDivision);
+    const size_t TrackCount = ProcessSMFHeader(data.data(), container);
 
     const auto Tail = data.end();
 
@@ -101,7 +78,7 @@ bool processor_t::ProcessSMF(std::vector<uint8_t> const & data, container_t & co
 
             const auto ChunkTail = Data + ChunkSize;
 
-            if (!ProcessSMFTrack(Data, ChunkTail, container))
+            if (!ProcessSMFTrack(Data, ChunkTail, container, options))
                 return false;
 
             Data = ChunkTail; // In case not all track data gets used.
@@ -118,39 +95,129 @@ bool processor_t::ProcessSMF(std::vector<uint8_t> const & data, container_t & co
     return true;
 }
 
+/// <summary>
+/// Validates the 14-byte SMF header chunk and initializes the container with it. Returns the number of track chunks.
+/// </summary>
+size_t processor_t::ProcessSMFHeader(const uint8_t * data, container_t & container)
+{
+    container.FileFormat = FileFormat::SMF;
+
+    if (::memcmp(&data[0], "MThd", 4) != 0)
+        throw midi::exception("Invalid SMF header chunk type");
+
+    if (data[4] != 0 || data[5] != 0 || data[6] != 0 || data[7] != 6)
+        throw midi::exception("Invalid SMF header chunk size");
+
+    const int Format = (data[8] << 8) | data[9];
+
+    if (Format > 2)
+        throw midi::exception(msc::FormatText("Unrecognized MIDI format: %d", Format));
+
+    const size_t TrackCount = (size_t) ((data[10] << 8) | data[11]);
+
+    if ((TrackCount == 0) || ((Format == 0) && (TrackCount != 1)))
+        throw midi::exception("Invalid track count");
+
+    const int TimeDivision = (data[12] << 8) | data[13];
+
+    if ((TimeDivision == 0))
+        throw midi::exception("Invalid time division");
+
+    container.Initialize((uint32_t) Format, (uint32_t) TimeDivision);
+
+    return TrackCount;
+}
+
 /// <summary>
 /// Processes an SMF track.
 /// </summary>
-bool processor_t::ProcessSMFTrack(std::vector<uint8_t>::const_iterator & data, std::vector<uint8_t>::const_iterator tail, container_t & container)
+bool processor_t::ProcessSMFTrack(std::vector<uint8_t>::const_iterator & data, std::vector<uint8_t>::const_iterator tail, container_t & container, const processor_options_t & options)
+{
+    smf_track_decoder_t Decoder(options);
+
+    const uint8_t * Head = std::to_address(data);
+
+    Decoder.Decode(Head, std::to_address(tail), true, container);
+
+    data += Head - std::to_address(data);
+
+    container.AddTrack(Decoder.GetTrack());
+
+    return true;
+}
+
+#pragma region SMF Track Decoder
+
+/// <summary>
+/// Decodes a variable-length quantity. Returns false if the data ends before the last byte of the quantity. The value is 0 in that case.
+/// </summary>
+static bool DecodeVariableLengthQuantity(const uint8_t * & data, const uint8_t * tail, int & value) noexcept
 {
-    track_t Track;
+    int Quantity = 0;
 
-    uint32_t RunningTime = 0;
-    uint8_t RunningStatus = 0xFF;
+    uint8_t Byte;
 
-    uint32_t SysExSize = 0;
-    uint32_t SysExTime = 0;
+    do
+    {
+        if (data == tail)
+        {
+            value = 0;
 
-    std::vector<uint8_t> Temp(3);
+            return false;
+        }
+
+        Byte = *data++;
+        Quantity = (Quantity << 7) + (Byte & 0x7F);
+    }
+    while (Byte & 0x80);
+
+    value = Quantity;
+
+    return true;
+}
+
+smf_track_decoder_t::smf_track_decoder_t(const processor_options_t & options) noexcept : _Temp(3), _Events(), _RunningTime(), _SysExSize(), _SysExTime(), _RunningStatus(0xFF), _DetectedPercussionText(), _IsComplete(),
+    _IsEndOfTrackRequired(options.IsEndOfTrackRequired), _DetectExtraPercussionChannel(options.DetectExtraPercussionChannel)
+{
+}
+
+/// <summary>
+/// Decodes the events in the data and adds them to the track. Returns true when the track is complete.
+/// Returns false when the data ends in the middle of an event. The data then points to the first byte of that event and the next call continues with it.
+/// Set isFinal when the data contains the remainder of the track chunk; an incomplete event is an error then.
+/// </summary>
+bool smf_track_decoder_t::Decode(const uint8_t * & data, const uint8_t * tail, bool isFinal, container_t & container)
+{
+    if (_IsComplete)
+        return true;
 
     bool FoundEndOfTrack = false;
-    bool DetectedPercussionText = false;
 
     for (;;)
     {
-        // Workaround for invalid SMF files that have tracks without an End of Track message.
-        if (!_Options.IsEndOfTrackRequired && (data == tail))
-            break;
+        if (data == tail)
+        {
+            if (!isFinal)
+                return false;
+
+            // Workaround for invalid SMF files that have tracks without an End of Track message.
+            if (!_IsEndOfTrackRequired)
+                break;
+        }
+
+        const uint8_t * Head = data;
+
+        int DeltaTime;
 
-        int DeltaTime = DecodeVariableLengthQuantity(data, tail);
+        DecodeVariableLengthQuantity(data, tail, DeltaTime);
 
         if (data == tail)
-            throw midi::exception("Insufficient SMF data");
+            return Rewind(data, Head, isFinal, "Insufficient SMF data");
 
         if (DeltaTime < 0)
             DeltaTime = -DeltaTime; // "Encountered negative delta: " << delta << "; flipping sign."
 
-        RunningTime += DeltaTime;
+        const uint32_t Time = _RunningTime + (uint32_t) DeltaTime;
 
         uint8_t StatusCode = *data++;
         uint32_t BytesRead = 0;
@@ -158,43 +225,33 @@ bool processor_t::ProcessSMFTrack(std::vector<uint8_t>::const_iterator & data, s
         // Is it a data byte?
         if (StatusCode < StatusCode::NoteOff)
         {
-            // Flush any pending SysEx.
-            if (SysExSize > 0)
-            {
-                Track.AddEvent(event_t(SysExTime, event_t::Extended, 0, Temp.data(), SysExSize));
-                SysExSize = 0;
-            }
+            FlushSysEx();
 
-            if (RunningStatus == 0xFF)
+            if (_RunningStatus == 0xFF)
                 throw midi::exception("Invalid first status code");
 
-            Temp.resize(3);
+            _Temp.resize(3);
 
-            Temp[BytesRead++] = StatusCode;
+            _Temp[BytesRead++] = StatusCode;
 
-            StatusCode = RunningStatus;
+            StatusCode = _RunningStatus;
         }
 
         // Is it a Voice Category message?
         if (StatusCode < StatusCode::SysEx)
         {
-            // Flush any pending SysEx.
-            if (SysExSize > 0)
-            {
-                Track.AddEvent(event_t(SysExTime, event_t::Extended, 0, Temp.data(), SysExSize));
-                SysExSize = 0;
-            }
+            FlushSysEx();
 
-            RunningStatus = StatusCode; // Set the running status
+            _RunningStatus = StatusCode; // Set the running status
 
             if (BytesRead == 0)
             {
                 if (data == tail)
-                    throw midi::exception("Insufficient SMF data");
+                    return Rewind(data, Head, isFinal, "Insufficient SMF data");
 
-                Temp.resize(3);
+                _Temp.resize(3);
 
-                Temp[BytesRead++] = *data++;
+                _Temp[BytesRead++] = *data++;
             }
 
             switch (StatusCode & 0xF0)
@@ -206,112 +263,111 @@ bool processor_t::ProcessSMFTrack(std::vector<uint8_t>::const_iterator & data, s
                 default:
                 {
                     if (data == tail)
-                        throw midi::exception("Insufficient SMF data");
+                        return Rewind(data, Head, isFinal, "Insufficient SMF data");
 
-                    Temp[BytesRead++] = *data++;
+                    _Temp[BytesRead++] = *data++;
                 }
             }
 
             const uint32_t ChannelNumber = (uint32_t) (StatusCode & 0x0F);
 
             // Assign percussion to channel 16 if it's first message was preceeded with meta data containing the word "drum".
-            if ((ChannelNumber == 0x0F) && DetectedPercussionText)
+            if ((ChannelNumber == 0x0F) && _DetectedPercussionText)
             {
                 const uint8_t SysExUseForRhythmPartCh16[] = { 0xF0, 0x41, 0x10, 0x42, 0x12, 0x40, 0x1F, 0x15, 0x02, 0x0A, 0xF7 }; // Use channel 16 for rhythm.
 
-                Track.AddEvent(event_t(0, event_t::Extended, 0, SysExUseForRhythmPartCh16, _countof(SysExUseForRhythmPartCh16)));
+                AddEvent(event_t(0, event_t::Extended, 0, SysExUseForRhythmPartCh16, _countof(SysExUseForRhythmPartCh16)));
 
                 container.SetExtraPercussionChannel(ChannelNumber);
 
-                DetectedPercussionText = false;
+                _DetectedPercussionText = false;
             }
 
-            Track.AddEvent(event_t(RunningTime, (event_t::event_type_t) ((StatusCode >> 4) - 8), ChannelNumber, Temp.data(), BytesRead));
+            AddEvent(event_t(Time, (event_t::event_type_t) ((StatusCode >> 4) - 8), ChannelNumber, _Temp.data(), BytesRead));
         }
         else
         {
             // Is it a SysEx message?
             if (StatusCode == StatusCode::SysEx)
             {
-                // Flush any pending SysEx.
-                if (SysExSize > 0)
-                {
-                    Track.AddEvent(event_t(SysExTime, event_t::Extended, 0, Temp.data(), SysExSize));
-                    SysExSize = 0;
-                }
+                FlushSysEx();
+
+                int Size;
 
-                const int Size = DecodeVariableLengthQuantity(data, tail);
+                if (!DecodeVariableLengthQuantity(data, tail, Size) && !isFinal)
+                    return Rewind(data, Head, isFinal, nullptr);
 
                 if (Size < 0)
                     throw midi::exception("Invalid System Exclusive event");
 
                 if (Size > tail - data)
-                    throw midi::exception("Insufficient data for System Exclusive event");
+                    return Rewind(data, Head, isFinal, "Insufficient data for System Exclusive event");
 
                 {
-                    Temp.resize((size_t) (Size + 1));
+                    _Temp.resize((size_t) (Size + 1));
 
-                    Temp[0] = StatusCode::SysEx;
+                    _Temp[0] = StatusCode::SysEx;
 
-                    std::copy(data, data + Size, Temp.begin() + 1);
+                    std::copy(data, data + Size, _Temp.begin() + 1);
                     data += Size;
 
-                    SysExSize = (uint32_t) (Size + 1);
-                    SysExTime = RunningTime;
+                    _SysExSize = (uint32_t) (Size + 1);
+                    _SysExTime = Time;
                 }
             }
             else
             if (StatusCode == StatusCode::SysExEnd)
             {
-                if (SysExSize == 0)
+                if (_SysExSize == 0)
                     throw midi::exception("Invalid System Exclusive End event");
 
                 // Add the SysEx continuation to the current SysEx message
-                const int Size = DecodeVariableLengthQuantity(data, tail);
+                int Size;
+
+                if (!DecodeVariableLengthQuantity(data, tail, Size) && !isFinal)
+                    return Rewind(data, Head, isFinal, nullptr);
 
                 if (Size < 0)
                     throw midi::exception("Invalid System Exclusive event");
 
                 if (Size > tail - data)
-                    throw midi::exception("Insufficient data for System Exclusive event continuation");
+                    return Rewind(data, Head, isFinal, "Insufficient data for System Exclusive event continuation");
 
                 {
-                    Temp.resize((size_t) SysExSize + Size);
+                    _Temp.resize((size_t) _SysExSize + Size);
 
-                    std::copy(data, data + Size, Temp.begin() + (ptrdiff_t) SysExSize);
+                    std::copy(data, data + Size, _Temp.begin() + (ptrdiff_t) _SysExSize);
                     data += Size;
 
-                    SysExSize += Size;
+                    _SysExSize += Size;
                 }
             }
             else
             if (StatusCode == StatusCode::MetaData)
             {
-                // Flush any pending SysEx.
-                if (SysExSize > 0)
-                {
-                    Track.AddEvent(event_t(SysExTime, event_t::Extended, 0, Temp.data(), SysExSize));
-                    SysExSize = 0;
-                }
+                FlushSysEx();
 
                 if (data == tail)
-                    throw midi::exception("Insufficient data for meta data event");
+                    return Rewind(data, Head, isFinal, "Insufficient data for meta data event");
 
                 const uint8_t MetaDataType = *data++;
 
                 if (MetaDataType > MetaDataType::SequencerSpecific)
                     throw midi::exception("Invalid meta data type");
 
-                int Size = DecodeVariableLengthQuantity(data, tail);
+                int Size;
+
+                if (!DecodeVariableLengthQuantity(data, tail, Size) && !isFinal)
+                    return Rewind(data, Head, isFinal, nullptr);
 
                 if (Size < 0)
                     throw midi::exception("Invalid meta data event");
 
                 if (Size > tail - data)
-                    throw midi::exception("Insufficient data for meta data event");
+                    return Rewind(data, Head, isFinal, "Insufficient data for meta data event");
 
                 // Remember when the track or instrument name contains the word "drum". We'll need it later.
-                if (_Options.DetectExtraPercussionChannel && ((MetaDataType == MetaDataType::Text) || (MetaDataType == MetaDataType::TrackName) || (MetaDataType == MetaDataType::InstrumentName)))
+                if (_DetectExtraPercussionChannel && ((MetaDataType == MetaDataType::Text) || (MetaDataType == MetaDataType::TrackName) || (MetaDataType == MetaDataType::InstrumentName)))
                 {
                     const char * p = (const char *) &data[0];
 
@@ -319,29 +375,31 @@ bool processor_t::ProcessSMFTrack(std::vector<uint8_t>::const_iterator & data, s
                     {
                         if (::_strnicmp(p, "drum", 4) == 0)
                         {
-                            DetectedPercussionText = true;
+                            _DetectedPercussionText = true;
                             break;
                         }
                     }
                 }
 
                 {
-                    Temp.resize((size_t)(Size + 2));
+                    _Temp.resize((size_t)(Size + 2));
 
-                    Temp[0] = StatusCode::MetaData;
-                    Temp[1] = MetaDataType;
+                    _Temp[0] = StatusCode::MetaData;
+                    _Temp[1] = MetaDataType;
 
-                    std::copy(data, data + Size, Temp.begin() + 2);
+                    std::copy(data, data + Size, _Temp.begin() + 2);
                     data += Size;
 
-                    if ((MetaDataType != MetaDataType::MIDIPort) || ((MetaDataType == MetaDataType::MIDIPort) && Track.IsPortSet()))
-                        Track.AddEvent(event_t(RunningTime, event_t::Extended, 0, Temp.data(), (size_t) (Size + 2)));
+                    if ((MetaDataType != MetaDataType::MIDIPort) || ((MetaDataType == MetaDataType::MIDIPort) && _Track.IsPortSet()))
+                        AddEvent(event_t(Time, event_t::Extended, 0, _Temp.data(), (size_t) (Size + 2)));
                     else
-                        Track.AddEventToStart(event_t(0, event_t::Extended, 0, Temp.data(), (size_t) (Size + 2)));
+                        AddEventToStart(event_t(0, event_t::Extended, 0, _Temp.data(), (size_t) (Size + 2)));
                 }
 
                 if (MetaDataType == MetaDataType::EndOfTrack) // Mandatory, Marks the end of the track.
                 {
+                    _RunningTime = Time;
+
                     FoundEndOfTrack = true;
                     break;
                 }
@@ -351,25 +409,77 @@ bool processor_t::ProcessSMFTrack(std::vector<uint8_t>::const_iterator & data, s
             // Is it a RealTime Category message?
             if ((StatusCode::SysExEnd < StatusCode) && (StatusCode < StatusCode::MetaData)) // Sequencer specific events, single byte.
             {
-                Temp[0] = StatusCode;
+                _Temp[0] = StatusCode;
 
-                Track.AddEvent(event_t(RunningTime, event_t::Extended, 0, Temp.data(), 1));
+                AddEvent(event_t(Time, event_t::Extended, 0, _Temp.data(), 1));
             }
             else
                 throw midi::exception("Invalid status code");
         }
+
+        _RunningTime = Time;
     }
 
     if (!FoundEndOfTrack)
     {
         const uint8_t EventData[] = { StatusCode::MetaData, MetaDataType::EndOfTrack };
 
-        Track.AddEvent(event_t(RunningTime, event_t::Extended, 0, EventData, _countof(EventData)));
+        AddEvent(event_t(_RunningTime, event_t::Extended, 0, EventData, _countof(EventData)));
     }
 
-    container.AddTrack(Track);
+    _IsComplete = true;
 
     return true;
 }
 
+/// <summary>
+/// Adds an event to the track and to the event sink, if any.
+/// </summary>
+void smf_track_decoder_t::AddEvent(const event_t & event)
+{
+    _Track.AddEvent(event);
+
+    if (_Events != nullptr)
+        _Events->push_back(event);
+}
+
+/// <summary>
+/// Adds an event to the start of the track and to the event sink, if any.
+/// </summary>
+void smf_track_decoder_t::AddEventToStart(const event_t & event)
+{
+    _Track.AddEventToStart(event);
+
+    if (_Events != nullptr)
+        _Events->push_back(event);
+}
+
+/// <summary>
+/// Adds the pending SysEx message, if any, to the track.
+/// </summary>
+void smf_track_decoder_t::FlushSysEx()
+{
+    if (_SysExSize == 0)
+        return;
+
+    AddEvent(event_t(_SysExTime, event_t::Extended, 0, _Temp.data(), _SysExSize));
+
+    _SysExSize = 0;
+}
+
+/// <summary>
+/// Handles an incomplete event. Throws if the data was final; otherwise moves the data back to the start of the event so that the next call decodes it again.
+/// </summary>
+bool smf_track_decoder_t::Rewind(const uint8_t * & data, const uint8_t * head, bool isFinal, const char * message)
+{
+    if (isFinal)
+        throw midi::exception(message);
+
+    data = head;
+
+    return false;
+}
+
+#pragma endregion
+
 }
@@ -1,5 +1,5 @@
 
-/** $VER: MIDIProcessorTST.cpp (2025.07.22) Test File **/
+/** $VER: MIDIProcessorTST.cpp (2026.10.19) Test File **/
 
 #include "pch.h"
 
@@ -14,7 +14,7 @@ namespace midi
 /// <summary>
 /// Returns true if the byte vector contains TST data.
 /// </summary>
-bool processor_t::IsTST(std::vector<uint8_t> const & data, const std::wstring & fileExtension) noexcept
+bool processor_t::IsTST(const uint8_t * data, size_t size, const std::wstring & fileExtension) noexcept
 {
     if (::_wcsicmp(fileExtension.c_str(), L"tst"))
         return false;
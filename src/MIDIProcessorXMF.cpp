@@ -1,5 +1,5 @@
 
-/** $VER: MIDIProcessorXMF.cpp (2025.09.06) Extensible Music Format (https://www.midi.org/specifications/file-format-specifications/xmf-extensible-music-format/extensible-music-format-xmf-2) **/
+/** $VER: MIDIProcessorXMF.cpp (2026.10.19) Extensible Music Format (https://www.midi.org/specifications/file-format-specifications/xmf-extensible-music-format/extensible-music-format-xmf-2) **/
 
 #include "pch.h"
 
@@ -9,11 +9,6 @@
 
 #undef WINAPI
 
-#ifdef _DEBUG
-#define __TRACE
-#endif
-
-#include <libmidi.h>
 #include <zlib.h>
 
 namespace midi
@@ -148,7 +143,7 @@ struct xmf_metadata_item_t
 struct xmf_unpacker_t
 {
     UnpackerID ID;
-    StandardUnpackerID StandardUnpackerID;
+    midi::StandardUnpackerID StandardUnpackerID;
     int ManufacturerID;
     int InternalUnpackerID;
     size_t UnpackedSize;
@@ -198,9 +193,9 @@ const size_t MagicSize = 4;
 /// <summary>
 /// Returns true if the byte vector contains XMF data.
 /// </summary>
-bool processor_t::IsXMF(std::vector<uint8_t> const & data) noexcept
+bool processor_t::IsXMF(const uint8_t * data, size_t size) noexcept
 {
-    if (data.size() < MagicSize)
+    if (size < MagicSize)
         return false;
 
     if (data[ 0] != 'X' || data[ 1] != 'M' || data[ 2] != 'F' || data[ 3] != '_')
@@ -212,10 +207,8 @@ bool processor_t::IsXMF(std::vector<uint8_t> const & data) noexcept
 /// <summary>
 /// Processes a byte vector with XMF data.
 /// </summary>
-bool processor_t::ProcessXMF(std::vector<uint8_t> const & data, container_t & container)
+bool processor_t::ProcessXMF(std::vector<uint8_t> const & data, container_t & container, const processor_options_t & options)
 {
-    TRACE_INDENT();
-
     xmf_file_t File = { };
     metadata_table_t Metadata;
 
@@ -230,9 +223,7 @@ bool processor_t::ProcessXMF(std::vector<uint8_t> const & data, container_t & co
 
     Metadata.AddItem(metadata_item_t(0, "xmf_meta_file_version", File.XMFMetaFileVersion.c_str()));
 
-    #ifdef __TRACE
-    ::printf("%*sXMF File Version %s\n", __TRACE_LEVEL * 4, "", File.XMFMetaFileVersion.c_str());
-    #endif
+    MIDI_DIAGNOSTIC(severity_t::Trace, "XMF", {}, diagnostic_t::None, data.size(), "XMF File Version %s", File.XMFMetaFileVersion.c_str());
 
     // RP-043: XMF Meta File Format 2.0, September 2004
     if (std::atof(File.XMFMetaFileVersion.c_str()) >= 2.0f)
@@ -257,9 +248,7 @@ bool processor_t::ProcessXMF(std::vector<uint8_t> const & data, container_t & co
 
         Metadata.AddItem(metadata_item_t(0, "xmf_file_type_revision", t));
 
-        #ifdef __TRACE
-        ::printf("%*sXMF File Type %s Revision %s\n", __TRACE_LEVEL * 4, "", s, t);
-        #endif
+        MIDI_DIAGNOSTIC(severity_t::Trace, "XMF", {}, diagnostic_t::None, diagnostic_t::None, "XMF File Type %s Revision %s", s, t);
     }
 
     File.Size = (uint32_t) DecodeVariableLengthQuantity(Data, Tail);
@@ -277,29 +266,21 @@ bool processor_t::ProcessXMF(std::vector<uint8_t> const & data, container_t & co
 
         Data = data.begin() + TreeStart;
 
-        ProcessNode(Head, Tail, Data, Metadata, container);
+        ProcessNode(Head, Tail, Data, Metadata, container, options);
 
         container.SetExtraMetaData(Metadata);
 
         container.FileFormat = FileFormat::XMF;
     }
 
-    TRACE_UNINDENT();
-
     return true;
 }
 
 /// <summary>
 /// Processes a tree node.
 /// </summary>
-bool processor_t::ProcessNode(std::vector<uint8_t>::const_iterator & head, std::vector<uint8_t>::const_iterator tail, std::vector<uint8_t>::const_iterator & data, metadata_table_t & metadata, container_t & container)
+bool processor_t::ProcessNode(std::vector<uint8_t>::const_iterator & head, std::vector<uint8_t>::const_iterator tail, std::vector<uint8_t>::const_iterator & data, metadata_table_t & metadata, container_t & container, const processor_options_t & options)
 {
-    #ifdef __TRACE
-    ::printf("%*sNode\n", __TRACE_LEVEL * 4, "");
-    #endif
-
-    TRACE_INDENT();
-
     const std::vector<uint8_t>::const_iterator HeaderHead = data;
 
     xmf_node_t Node = {};
@@ -309,6 +290,8 @@ bool processor_t::ProcessNode(std::vector<uint8_t>::const_iterator & head, std::
     Node.ItemCount  = (size_t) DecodeVariableLengthQuantity(data, tail); // 3.2.1 NodeMetaData NodeContainedItems
     Node.HeaderSize = (size_t) DecodeVariableLengthQuantity(data, tail); // 3.2.1 NodeMetaData NodeHeaderLength
 
+    MIDI_DIAGNOSTIC(severity_t::Trace, "XMF", {}, (size_t) (HeaderHead - head), Node.Size, "Node, %zu items", Node.ItemCount);
+
     auto StandardResourceFormat = StandardResourceFormatID::InvalidStandardResourceFormat;
 
     // Read the metadata.
@@ -317,11 +300,7 @@ bool processor_t::ProcessNode(std::vector<uint8_t>::const_iterator & head, std::
         const size_t MetaDataSize = (size_t) DecodeVariableLengthQuantity(data, tail);
         const auto MetaDataTail = data + (ptrdiff_t) MetaDataSize;
 
-        #ifdef __TRACE
-        ::printf("%*sMetadata (%d bytes)\n", __TRACE_LEVEL * 4, "", (uint32_t) MetaDataSize);
-        #endif
-
-        TRACE_INDENT();
+        MIDI_DIAGNOSTIC(severity_t::Trace, "XMF", {}, (size_t) (data - head), MetaDataSize, "Metadata");
 
         while (data < MetaDataTail)
         {
@@ -363,8 +342,8 @@ bool processor_t::ProcessNode(std::vector<uint8_t>::const_iterator & head, std::
 
                     //  const bool HiddenContents = (MetadataItem.UniversalContentsFormat & 1);
 
-                        auto Head = MetadataItem.UniversalContentsData.begin();
-                        auto Tail = MetadataItem.UniversalContentsData.end();
+                        auto Head = MetadataItem.UniversalContentsData.cbegin();
+                        auto Tail = MetadataItem.UniversalContentsData.cend();
 
                         // 5.2.1. Standard FieldID Assignments (RP-030)
                         switch (MetadataItem.FieldSpecifier.FieldID)
@@ -525,9 +504,7 @@ bool processor_t::ProcessNode(std::vector<uint8_t>::const_iterator & head, std::
                         }
                     }
 
-                    #ifdef __TRACE
-                    ::printf("%*sUniversal metadata, %9d bytes, %-30s: %s\n", __TRACE_LEVEL * 4, "", (uint32_t) Size, Name.c_str(), Value.c_str());
-                    #endif
+                    MIDI_DIAGNOSTIC(severity_t::Trace, "XMF", {}, diagnostic_t::None, (size_t) Size, "Universal metadata, %s: %s", Name.c_str(), Value.c_str());
                 }
                 else
                 {
@@ -538,9 +515,7 @@ bool processor_t::ProcessNode(std::vector<uint8_t>::const_iterator & head, std::
 
                         const size_t Size = (size_t) DecodeVariableLengthQuantity(data, tail);
 
-                        #ifdef __TRACE
-                        ::printf("%*sInternational metadata, %9zu bytes, ID %3d\n", __TRACE_LEVEL * 4, "", Size, MetaDataTypeID);
-                        #endif
+                        MIDI_DIAGNOSTIC(severity_t::Trace, "XMF", {}, (size_t) (data - head), Size, "International metadata, ID %d", MetaDataTypeID);
 
                         data += (ptrdiff_t) Size;
                     }
@@ -549,8 +524,6 @@ bool processor_t::ProcessNode(std::vector<uint8_t>::const_iterator & head, std::
 
             Node.MetaData.push_back(MetadataItem);
         }
-
-        TRACE_UNINDENT();
     }
 
     // Read the unpackers.
@@ -648,7 +621,7 @@ bool processor_t::ProcessNode(std::vector<uint8_t>::const_iterator & head, std::
                     {
                         UnpackedData = Node.Unpack(Data);
 
-                        ProcessSMF(UnpackedData, container);
+                        ProcessSMF(UnpackedData, container, options);
                     }
                     break;
                 }
@@ -672,9 +645,7 @@ bool processor_t::ProcessNode(std::vector<uint8_t>::const_iterator & head, std::
                     ; // Not yet supported.
             }
 
-            #ifdef __TRACE
-            ::printf("%*s%d bytes\n", __TRACE_LEVEL * 4, "", (uint32_t) Size);
-            #endif
+            MIDI_DIAGNOSTIC(severity_t::Trace, "XMF", {}, (size_t) (data - head), (size_t) Size, "File node contents");
 
             data += Size;
         }
@@ -690,7 +661,7 @@ bool processor_t::ProcessNode(std::vector<uint8_t>::const_iterator & head, std::
 
                     for (size_t i = 0; i < Node.ItemCount; ++i)
                     {
-                        ProcessNode(head, tail, Data, metadata, container);
+                        ProcessNode(head, tail, Data, metadata, container, options);
                     }
                     break;
                 }
@@ -708,8 +679,6 @@ bool processor_t::ProcessNode(std::vector<uint8_t>::const_iterator & head, std::
         }
     }
 
-    TRACE_UNINDENT();
-
     return true;
 }
 
@@ -751,6 +720,8 @@ std::vector<uint8_t> xmf_node_t::Unpack(const std::vector<uint8_t> & data)
 /// </summary>
 int processor_t::Inflate(const std::vector<uint8_t> & src, std::vector<uint8_t> & dst) noexcept
 {
+    MIDI_TIME_PHASE(Decompression);
+
     z_stream Stream = { };
 
     Stream.total_in = Stream.avail_in = (uInt) src.size();
@@ -769,6 +740,8 @@ int processor_t::Inflate(const std::vector<uint8_t> & src, std::vector<uint8_t>
             Status = Z_OK;
     }
 
+    MIDI_COUNT(BytesInflated, Stream.total_out);
+
     ::inflateEnd(&Stream);
 
     return Status;
@@ -779,6 +752,8 @@ int processor_t::Inflate(const std::vector<uint8_t> & src, std::vector<uint8_t>
 /// </summary>
 int processor_t::InflateRaw(const std::vector<uint8_t> & src, std::vector<uint8_t> & dst) noexcept
 {
+    MIDI_TIME_PHASE(Decompression);
+
     z_stream Stream = { };
 
     Stream.avail_in = (uInt) src.size();
@@ -797,6 +772,8 @@ int processor_t::InflateRaw(const std::vector<uint8_t> & src, std::vector<uint8_
             Status = Z_OK;
     }
 
+    MIDI_COUNT(BytesInflated, Stream.total_out);
+
     ::inflateEnd(&Stream);
 
     return Status;
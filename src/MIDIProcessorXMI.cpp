@@ -1,5 +1,5 @@
 
-/** $VER: MIDIProcessorXMI.cpp (2025.07.22) Extended Multiple Instrument Digital Interface (http://www.vgmpf.com/Wiki/index.php?title=XMI) **/
+/** $VER: MIDIProcessorXMI.cpp (2026.10.19) Extended Multiple Instrument Digital Interface (http://www.vgmpf.com/Wiki/index.php?title=XMI) **/
 
 #include "pch.h"
 
@@ -12,9 +12,9 @@ namespace midi
 /// <summary>
 /// Returns true if the byte vector contains XMI data.
 /// </summary>
-bool processor_t::IsXMI(std::vector<uint8_t> const & data) noexcept
+bool processor_t::IsXMI(const uint8_t * data, size_t size) noexcept
 {
-    if (data.size() < 34)
+    if (size < 34)
         return false;
 
     if (data[ 0] != 'F' || data[ 1] != 'O' || data[ 2] != 'R' || data[ 3] != 'M' ||
@@ -1,11 +1,13 @@
 
-/** $VER: MMD.cpp (2026.05.03) P. Stuer - Based on Valley Bell's mmd2mid (https://github.com/ValleyBell/MidiConverters). **/
+/** $VER: MMD.cpp (2026.10.19) P. Stuer - Based on Valley Bell's mmd2mid (https://github.com/ValleyBell/MidiConverters). **/
 
 #include "pch.h"
 
-#include <CppCoreCheck\Warnings.h>
+#ifdef _MSC_VER
+#include <CppCoreCheck/Warnings.h>
 
 #pragma warning(disable: 4100 4625 4626 4710 4711 4738 4820 5045 ALL_CPPCORECHECK_WARNINGS)
+#endif
 
 #include <cstdint>
 #include <cstdlib>
@@ -17,6 +19,7 @@
 #include "MMD.h"
 
 #include <MIDI.h>
+#include <Parallel.h>
 #include <Support.h>
 
 namespace mmd
@@ -39,6 +42,9 @@ struct track_t
     uint32_t LoopLength;
     uint16_t MaxLoopExpansions;     // Number of times to take the loops of this track
 
+    uint32_t OutputSize;            // Estimated size of the MIDI output of one pass through the track (in bytes)
+    uint32_t LoopOutputSize;        // Estimated size of the MIDI output of one pass through the loop (in bytes)
+
     int8_t Transpose;
     uint8_t Channel;
 };
@@ -47,47 +53,153 @@ struct loop_t
 {
     uint8_t Command[4];
     uint32_t Offset;
-    uint32_t Length;
+    uint32_t Length;                // Track length at the start of the loop (in ticks)
+    uint32_t OutputSize;
     uint16_t Count;
 };
 
 }
 
 #include "MemoryStream.h"
-#include "RunningNotes.h"
+
+#include <RunningNotes.h>
 
 namespace mmd
 {
 
-static uint8_t GetDeltaTime(memory_stream_t * stream, uint32_t & deltaTime);
+/// <summary>
+/// Holds the output and the conversion state of a single track.
+/// </summary>
+struct track_output_t
+{
+    memory_stream_t Stream;
+    midi::running_notes_t RunningNotes;
+    std::vector<loop_region_t> Loops;
+    uint8_t Result;
+};
 
-static running_notes_t _RunningNotes;
+static uint8_t GetDeltaTime(memory_stream_t * stream, uint32_t & deltaTime, void * context);
 
+static uint8_t ConvertTracks(const uint8_t * srcData, uint32_t srcSize, const options_t & options, std::vector<track_output_t> & outputs, size_t & trackCount) noexcept;
 static uint8_t ParseTrack(const uint8_t * data, uint32_t size, const mmd_t * mmd, track_t * track);
-static uint8_t ConvertTrack(const uint8_t * data, uint32_t size, const mmd_t * mmd, track_t * track, memory_stream_t * ms, midi_state_t * state, uint8_t trackNumber);
+static uint8_t ConvertTrack(const uint8_t * data, uint32_t size, const mmd_t * mmd, track_t * track, track_output_t & output, uint8_t trackNumber, const options_t & options);
 static size_t GetSysExSize(const uint8_t * data, size_t size, size_t startOffset) noexcept;
 static void GetSysEx(const uint8_t * srcData, uint8_t param1, uint8_t param2, uint8_t channelNumber, std::vector<uint8_t> & dstData) noexcept;
+static uint16_t AdjustTracks(track_t * tracks, uint16_t trackCount, uint32_t minLoopTicks) noexcept;
 
 inline uint32_t MMDTempo2MIDITemp(uint16_t bpm, uint8_t scale) noexcept;
 static uint16_t ReadLE16(const uint8_t * data) noexcept;
 
-const uint16_t MIDIResolution = 48u;
+const size_t TrackCount = 18;
 
-// Options
-const uint16_t MaxLoopExpansions = 2u;  // Expand loops this many times.
-const bool ExpandLoops = false;
-const bool IgnoreMutedTracks = true;
+// Worst case MIDI output of a single MMD command: a note on and its note off, each with a 4-byte delta time.
+const uint32_t MaxBytesPerCommand = 2u * (4u + 3u);
 
 /// <summary>
-/// Converts the MMD data.
+/// Converts the MMD data using the default options.
 /// </summary>
 uint8_t Convert(const uint8_t * srcData, uint32_t srcSize, std::vector<uint8_t> & dstData) noexcept
 {
-    memory_stream_t ms(0x20000, GetDeltaTime); // 128 KB
+    return Convert(srcData, srcSize, dstData, options_t());
+}
+
+/// <summary>
+/// Converts the MMD data.
+/// </summary>
+uint8_t Convert(const uint8_t * srcData, uint32_t srcSize, std::vector<uint8_t> & dstData, const options_t & options) noexcept
+{
+    std::vector<loop_region_t> Loops;
+
+    return Convert(srcData, srcSize, dstData, options, Loops);
+}
+
+/// <summary>
+/// Converts the MMD data to a Standard MIDI File. In symbolic loop mode, the loops that were written once are returned.
+/// </summary>
+uint8_t Convert(const uint8_t * srcData, uint32_t srcSize, std::vector<uint8_t> & dstData, const options_t & options, std::vector<loop_region_t> & loops) noexcept
+{
+    loops.clear();
+
+    std::vector<track_output_t> Outputs(TrackCount);
+
+    size_t ConvertedTrackCount = 0;
+
+    const uint8_t Result = ConvertTracks(srcData, srcSize, options, Outputs, ConvertedTrackCount);
+
+    if (ConvertedTrackCount == 0)
+        return Result;
+
+    // Splice the tracks.
+    size_t OutputSize = 0x0E;
+
+    for (size_t i = 0; i < ConvertedTrackCount; ++i)
+        OutputSize += 0x08 + Outputs[i].Stream.Offset;
+
+    memory_stream_t ms(OutputSize, nullptr, nullptr);
+
+    ms.WriteHeader(0x0001, (uint16_t) ConvertedTrackCount, Resolution);
+
+    midi_state_t State;
+
+    for (size_t i = 0; i < ConvertedTrackCount; ++i)
+    {
+        const auto & Output = Outputs[i];
+
+        ms.WriteTrackBegin(&State);
+        ms.Write(Output.Stream.Data, Output.Stream.Offset);
+        ms.WriteTrackEnd(&State);
+
+        loops.insert(loops.end(), Output.Loops.begin(), Output.Loops.end());
+    }
+
+    dstData.assign(ms.Data, ms.Data + ms.Offset);
+
+    return Result;
+}
+
+/// <summary>
+/// Converts the MMD data to one MIDI track per MMD track. Each track contains the events of an MTrk chunk without the chunk header. The tracks use the time division specified by Resolution.
+/// In symbolic loop mode, the loops that were written once are returned.
+/// </summary>
+uint8_t ConvertTracks(const uint8_t * srcData, uint32_t srcSize, std::vector<std::vector<uint8_t>> & tracks, const options_t & options, std::vector<loop_region_t> & loops) noexcept
+{
+    tracks.clear();
+    loops.clear();
+
+    std::vector<track_output_t> Outputs(TrackCount);
+
+    size_t ConvertedTrackCount = 0;
+
+    const uint8_t Result = ConvertTracks(srcData, srcSize, options, Outputs, ConvertedTrackCount);
+
+    tracks.resize(ConvertedTrackCount);
+
+    for (size_t i = 0; i < ConvertedTrackCount; ++i)
+    {
+        const auto & Output = Outputs[i];
+
+        tracks[i].assign(Output.Stream.Data, Output.Stream.Data + Output.Stream.Offset);
+
+        loops.insert(loops.end(), Output.Loops.begin(), Output.Loops.end());
+    }
+
+    return Result;
+}
+
+/// <summary>
+/// Converts each track of the MMD data into its own output. The tracks are independent once their offsets are known so they can be converted concurrently.
+/// Returns the number of tracks that were converted in trackCount.
+/// </summary>
+static uint8_t ConvertTracks(const uint8_t * srcData, uint32_t srcSize, const options_t & options, std::vector<track_output_t> & outputs, size_t & trackCount) noexcept
+{
+    trackCount = 0;
+
+    if (srcSize < 0x4C)
+        return 1; // Insufficient data
 
     uint32_t Offset = 2;
 
-    track_t Tracks[18] = { };
+    track_t Tracks[TrackCount] = { };
 
     for (size_t i = 0; i < _countof(Tracks); ++i, Offset += 4)
     {
@@ -113,7 +225,9 @@ uint8_t Convert(const uint8_t * srcData, uint32_t srcSize, std::vector<uint8_t>
     mmd_t MMD =
     {
         .Tempo     = srcData[0x00],
-        .Transpose = (int8_t) srcData[0x01]
+        .Transpose = (int8_t) srcData[0x01],
+        .SysEx     = { },
+        .Title     = nullptr
     };
 
     for (size_t i = 0; i < _countof(MMD.SysEx); ++i)
@@ -142,71 +256,52 @@ uint8_t Convert(const uint8_t * srcData, uint32_t srcSize, std::vector<uint8_t>
 
         ParseTrack(srcData, srcSize, &MMD, Track);
 
-        Track->MaxLoopExpansions = (Track->LoopOffset != 0) ? MaxLoopExpansions : 0u;
+        Track->MaxLoopExpansions = (Track->LoopOffset != 0) ? options.MaxLoopExpansions : 0u;
     }
 
-    if (ExpandLoops)
-        AdjustTracks(Tracks, _countof(Tracks), (uint32_t) (MIDIResolution / 4));
-
-    // Write the MIDI header with default values.
-    ms.WriteHeader(0x0001, 0, MIDIResolution);
-
-    uint8_t Result = 0;
+    if (options.ExpandLoops)
+        AdjustTracks(Tracks, _countof(Tracks), (uint32_t) (Resolution / 4));
 
+    for (size_t i = 0; i < _countof(Tracks); ++i)
     {
-        midi_state_t State;
-        uint8_t TrackNumber;
-
-        for (TrackNumber = 0; TrackNumber < _countof(Tracks); ++TrackNumber)
-        {
-            ms.WriteTrackBegin(&State);
-
-            if (TrackNumber == 0)
-            {
-                if ((MMD.Title != nullptr) && (MMD.Title[0] != '\0'))
-                    ms.WriteMetaEvent(&State, midi::MetaDataType::TrackName, MMD.Title, (uint32_t) ::strlen(MMD.Title));
-
-                const uint32_t Tempo = MMDTempo2MIDITemp(MMD.Tempo, 64);
+        auto & Output = outputs[i];
 
-                uint8_t Data[32] = { };
+        Output.Stream._GetDeltaTime = GetDeltaTime;
+        Output.Stream._Context = &Output.RunningNotes;
 
-                WriteBE32(Data, Tempo);
-
-                ms.WriteMetaEvent(&State, midi::MetaDataType::SetTempo, Data + 1, 3);
-            }
-
-            Result = ConvertTrack(srcData, srcSize, &MMD, &Tracks[TrackNumber], &ms, &State, TrackNumber);
-
-            ms.WriteEvent(&State, midi::StatusCode::MetaData, midi::MetaDataType::EndOfTrack, 0x00);
-
-            ms.WriteTrackEnd(&State);
+        if (options.PreallocateOutput)
+        {
+            const size_t OutputSize = ((i == 0) ? 0x100u : 0x00u) + 0x04 + (size_t) Tracks[i].OutputSize + (size_t) Tracks[i].LoopOutputSize * Tracks[i].MaxLoopExpansions; // Title and tempo, End of Track and events
 
-            if (Result != 0)
-                break;
+            Output.Stream.Grow((uint32_t) OutputSize);
         }
+    }
 
-        // Update the MIDI header with the actual track count and length.
-        {
-            Offset = (uint32_t) ms.Offset;
-
-            ms.Offset = 0;
-            ms.WriteHeader(0x0001, TrackNumber, MIDIResolution);
+    midi::ForEach(_countof(Tracks), options.ParallelTracks, [&](size_t i)
+    {
+        outputs[i].Result = ConvertTrack(srcData, srcSize, &MMD, &Tracks[i], outputs[i], (uint8_t) i, options);
+    });
 
-            dstData.assign(ms.Data, ms.Data + Offset);
-        }
+    // Stop at the first track that failed to convert. That track is included, as it was by the sequential conversion.
+    for (trackCount = 0; trackCount < _countof(Tracks); ++trackCount)
+    {
+        if (outputs[trackCount].Result != 0)
+            return outputs[trackCount++].Result;
     }
 
-    return Result;
+    return 0;
 }
 
 /// <summary>
 /// 
 /// </summary>
-static uint8_t ParseTrack(const uint8_t * data, uint32_t size, const mmd_t * mmd, track_t * track)
+static uint8_t ParseTrack(const uint8_t * data, uint32_t size, [[maybe_unused]] const mmd_t * mmd, track_t * track)
 {
     track->Length = 0;
     track->LoopOffset = 0;
     track->LoopLength = 0;
+    track->OutputSize = 0;
+    track->LoopOutputSize = 0;
 
     if (track->Offset >= size)
         return 1;
@@ -250,7 +345,10 @@ static uint8_t ParseTrack(const uint8_t * data, uint32_t size, const mmd_t * mmd
         {
             case 0x98: // Send SysEx command
             {
-                Offset += GetSysExSize(data, size, Offset);
+                const size_t SysExSize = GetSysExSize(data, size, Offset);
+
+                track->OutputSize += (uint32_t) (SysExSize + 0x04 + 0x01 + 0x04); // Delta time, status and length
+                Offset += SysExSize;
                 break;
             }
 
@@ -264,6 +362,7 @@ static uint8_t ParseTrack(const uint8_t * data, uint32_t size, const mmd_t * mmd
                     {
                         track->LoopOffset = Loops[LoopIndex].Offset;
                         track->LoopLength = Loops[LoopIndex].Length;
+                        track->LoopOutputSize = track->OutputSize - Loops[LoopIndex].OutputSize;
 
                         EndOfTrack = true;
                     }
@@ -286,6 +385,7 @@ static uint8_t ParseTrack(const uint8_t * data, uint32_t size, const mmd_t * mmd
 
                     Loops[LoopIndex].Offset = (uint32_t) Offset;
                     Loops[LoopIndex].Length = track->Length;
+                    Loops[LoopIndex].OutputSize = track->OutputSize;
                     Loops[LoopIndex].Count = 0;
 
                     if ((LoopIndex > 0) && (Loops[LoopIndex].Offset == Loops[LoopIndex - 1].Offset))
@@ -304,6 +404,7 @@ static uint8_t ParseTrack(const uint8_t * data, uint32_t size, const mmd_t * mmd
         }
 
         track->Length += CommandDelay;
+        track->OutputSize += MaxBytesPerCommand;
     }
 
     return 0;
@@ -312,17 +413,43 @@ static uint8_t ParseTrack(const uint8_t * data, uint32_t size, const mmd_t * mmd
 /// <summary>
 /// Converts an MMD track to MIDI events.
 /// </summary>
-static uint8_t ConvertTrack(const uint8_t * data, uint32_t size, const mmd_t * mmd, track_t * track, memory_stream_t * ms, midi_state_t * state, uint8_t trackNumber)
+static uint8_t ConvertTrack(const uint8_t * data, uint32_t size, const mmd_t * mmd, track_t * track, track_output_t & output, uint8_t trackNumber, const options_t & options)
 {
+    memory_stream_t * ms = &output.Stream;
+    midi::running_notes_t & RunningNotes = output.RunningNotes;
+    std::vector<loop_region_t> & loops = output.Loops;
+
+    midi_state_t State = { };
+    midi_state_t * state = &State;
+
+    if (trackNumber == 0)
+    {
+        if ((mmd->Title != nullptr) && (mmd->Title[0] != '\0'))
+            ms->WriteMetaEvent(state, midi::MetaDataType::TrackName, mmd->Title, (uint32_t) ::strlen(mmd->Title));
+
+        const uint32_t Tempo = MMDTempo2MIDITemp(mmd->Tempo, 64);
+
+        uint8_t Data[32] = { };
+
+        WriteBE32(Data, Tempo);
+
+        ms->WriteMetaEvent(state, midi::MetaDataType::SetTempo, Data + 1, 3);
+    }
+
+    // A track that fails is still part of the output and has to be terminated.
     if (track->Offset >= size)
+    {
+        ms->WriteEvent(state, midi::StatusCode::MetaData, midi::MetaDataType::EndOfTrack, 0x00);
+
         return 1;
+    }
 
     uint8_t PortNumber = 0;
     uint8_t ChannelNumber = 0;
 
     if (track->Channel == 0xFF)
     {
-        PortNumber = IgnoreMutedTracks ? 0xFF : 0x00;
+        PortNumber = options.IgnoreMutedTracks ? 0xFF : 0x00;
         ChannelNumber = 0;
 
         track->Channel = 0x00;
@@ -354,7 +481,7 @@ static uint8_t ConvertTrack(const uint8_t * data, uint32_t size, const mmd_t * m
 
     bool EndOfTrack = false;
 
-    _RunningNotes._Count = 0;
+    RunningNotes.Reset();
 
     state->Channel = ChannelNumber;
     state->DeltaTime = 0;
@@ -362,6 +489,8 @@ static uint8_t ConvertTrack(const uint8_t * data, uint32_t size, const mmd_t * m
     size_t Offset = track->Offset;
     size_t LoopIndex = 0;
 
+    uint32_t Time = 0; // Timestamp of the current command (in ticks)
+
     uint8_t Command[4] = { };
     loop_t Loops[16] = { };
     uint8_t GSParameters[6] = { }; // 0 device ID, 1 model ID, 2 address high, 3 address low
@@ -403,28 +532,20 @@ static uint8_t ConvertTrack(const uint8_t * data, uint32_t size, const mmd_t * m
 
             if (EmitNote)
             {
-                _RunningNotes.Check(ms, state->DeltaTime);
+                RunningNotes.Check(*ms, state->DeltaTime);
 
                 Note = (CommandType + Transpose) & 0x7Fu;
 
-                for (size_t i = 0; i < _RunningNotes._Count; ++i)
-                {
-                    if (_RunningNotes._Items[i].Note == Note)
-                    {
-                        // The note is already playing. Set a new length.
-                        _RunningNotes._Items[i].Length = (uint32_t) state->DeltaTime + Duration;
-
-                        EmitNote = false; // Don't emit a new note.
-                        break;
-                    }
-                }
+                // If the note is already playing, set a new length.
+                if (RunningNotes.Extend(Note, (uint32_t) state->DeltaTime + Duration))
+                    EmitNote = false; // Don't emit a new note.
             }
 
             if (EmitNote && (PortNumber != 0xFF))
             {
                 ms->WriteEvent(state, midi::StatusCode::NoteOn, Note, Command[3]);
 
-                _RunningNotes.Add(state->Channel, Note, 0x80, Duration);
+                RunningNotes.Add(state->Channel, Note, 0x80, Duration);
             }
         }
         else
@@ -688,7 +809,7 @@ static uint8_t ConvertTrack(const uint8_t * data, uint32_t size, const mmd_t * m
 
                     if (Byte == 0xFF)
                     {
-                        if (IgnoreMutedTracks)
+                        if (options.IgnoreMutedTracks)
                         {
                             PortNumber = 0xFF;
                             ChannelNumber = 0x00;
@@ -796,6 +917,17 @@ static uint8_t ConvertTrack(const uint8_t * data, uint32_t size, const mmd_t * m
                             TakeLoop = true;
                     }
 
+                    if (options.SymbolicLoops && TakeLoop)
+                    {
+                        const bool IsInfinite = (Command[1] == 0) || (Command[1] >= 0x7F);
+                        const uint16_t Count = IsInfinite ? track->MaxLoopExpansions : Command[1];
+
+                        if (Time > Loops[LoopIndex].Length)
+                            loops.push_back({ trackNumber, Loops[LoopIndex].Length, Time, Count, IsInfinite });
+
+                        TakeLoop = false;
+                    }
+
                     if (TakeLoop)
                     {
                         ::memcpy(Command, Loops[LoopIndex].Command, sizeof(Command));
@@ -817,6 +949,7 @@ static uint8_t ConvertTrack(const uint8_t * data, uint32_t size, const mmd_t * m
                     ::memcpy(Loops[LoopIndex].Command, Command, sizeof(Command));
 
                     Loops[LoopIndex].Offset = (uint32_t) Offset;
+                    Loops[LoopIndex].Length = Time;
                     Loops[LoopIndex].Count = 0;
 
                     if ((LoopIndex > 0) && (Loops[LoopIndex].Offset == Loops[LoopIndex - 1].Offset))
@@ -843,13 +976,16 @@ static uint8_t ConvertTrack(const uint8_t * data, uint32_t size, const mmd_t * m
         }
 
         state->DeltaTime += CommandDelay;
+        Time += CommandDelay;
     }
 
-    _RunningNotes.Flush(ms, state->DeltaTime);
+    state->DeltaTime = RunningNotes.Flush(*ms, state->DeltaTime, false);
 
     if (PortNumber == 0xFF)
         state->DeltaTime = 0;
 
+    ms->WriteEvent(state, midi::StatusCode::MetaData, midi::MetaDataType::EndOfTrack, 0x00);
+
     return 0;
 }
 
@@ -926,19 +1062,71 @@ static void GetSysEx(const uint8_t * srcData, uint8_t param1, uint8_t param2, ui
 }
 
 /// <summary>
-/// 
+/// Inserts the Note Off events of the running notes of the track before a delay is written.
 /// </summary>
-static uint8_t GetDeltaTime(memory_stream_t * ms, uint32_t & deltaTime)
+static uint8_t GetDeltaTime(memory_stream_t * ms, uint32_t & deltaTime, void * context)
 {
-    _RunningNotes.Check(ms, deltaTime);
+    auto * RunningNotes = (midi::running_notes_t *) context;
+
+    RunningNotes->Check(*ms, deltaTime);
+
+    RunningNotes->Advance(deltaTime);
+
+    return 0;
+}
+
+/// <summary>
+/// Adjusts the value of LoopCount so that all tracks play for the approximately same time.
+/// Ignore loops that are shorter than minLoopTicks.
+/// Returns the number of adjusted tracks.
+/// </summary>
+static uint16_t AdjustTracks(track_t * tracks, uint16_t trackCount, uint32_t minLoopTicks) noexcept
+{
+    uint32_t MaxLength = 0;
+
+    // Determine the longest track.
+    for (uint16_t TrackIndex = 0; TrackIndex < trackCount; ++TrackIndex)
+    {
+        const track_t * Track = &tracks[TrackIndex];
 
-    if (deltaTime != 0)
+        uint32_t TrackLength = Track->Length;
+
+        if (Track->MaxLoopExpansions != 0)
+        {
+            const uint32_t LoopLength = Track->Length - Track->LoopLength;
+
+            TrackLength += (LoopLength * (Track->MaxLoopExpansions - 1));
+        }
+
+        if (MaxLength < TrackLength)
+            MaxLength = TrackLength;
+    }
+
+    uint16_t AdjustedTrackCount = 0;
+
+    for (uint16_t TrackIndex = 0; TrackIndex < trackCount; ++TrackIndex)
     {
-        for (size_t i = 0; i < _RunningNotes._Count; ++i)
-            _RunningNotes._Items[i].Length -= (uint16_t) deltaTime;
+        track_t * Track = &tracks[TrackIndex];
+
+        const uint32_t LoopLength = (Track->MaxLoopExpansions != 0) ? (Track->Length - Track->MaxLoopExpansions) : 0;
+
+        if (LoopLength < minLoopTicks)
+            continue; // Ignore tracks with very short loops
+
+        // heuristic: The track needs additional loops, if the longest track is longer than the current track + 1/4 loop.
+        uint32_t TrackLength = Track->Length + LoopLength * (Track->MaxLoopExpansions - 1);
+
+        if (TrackLength + LoopLength / 4 < MaxLength)
+        {
+            TrackLength = MaxLength - Track->LoopLength; // desired length of the loop
+
+            Track->MaxLoopExpansions = (uint16_t)((TrackLength + LoopLength / 3) / LoopLength);
+
+            ++AdjustedTrackCount;
+        }
     }
 
-    return 0;
+    return AdjustedTrackCount;
 }
 
 /// <summary>
@@ -1,13 +1,43 @@
 
-/** $VER: MMD.h (2026.05.03) P. Stuer - Based on Valley Bell's mmd2mid (https://github.com/ValleyBell/MidiConverters). **/
+/** $VER: MMD.h (2026.10.19) P. Stuer - Based on Valley Bell's mmd2mid (https://github.com/ValleyBell/MidiConverters). **/
 
 #pragma once
 
 #include <cstdint>
+#include <vector>
 
 namespace mmd
 {
 
+struct options_t
+{
+    uint16_t MaxLoopExpansions = 2;     // Expand loops this many times.
+
+    bool ExpandLoops = false;
+    bool IgnoreMutedTracks = true;
+    bool PreallocateOutput = true;      // Sizes the output buffer from the track parse pass so that the conversion needs a single allocation.
+    bool SymbolicLoops = false;         // Writes each loop body once and returns the loops instead of repeating them.
+    bool ParallelTracks = false;        // Converts the tracks with midi::ForEach().
+};
+
+const uint16_t Resolution = 48;         // Ticks per quarter note of the converted data
+
+/// <summary>
+/// Represents a loop that was written once instead of being repeated.
+/// </summary>
+struct loop_region_t
+{
+    uint32_t TrackIndex;
+    uint32_t Begin;                     // Timestamp of the first tick of the loop body (in ticks)
+    uint32_t End;                       // Timestamp of the first tick after the loop body (in ticks)
+    uint16_t Count;                     // Number of passes through the loop body
+    bool IsInfinite;
+};
+
 uint8_t Convert(const uint8_t * srcData, uint32_t srcSize, std::vector<uint8_t> & dstData) noexcept;
+uint8_t Convert(const uint8_t * srcData, uint32_t srcSize, std::vector<uint8_t> & dstData, const options_t & options) noexcept;
+uint8_t Convert(const uint8_t * srcData, uint32_t srcSize, std::vector<uint8_t> & dstData, const options_t & options, std::vector<loop_region_t> & loops) noexcept;
+
+uint8_t ConvertTracks(const uint8_t * srcData, uint32_t srcSize, std::vector<std::vector<uint8_t>> & tracks, const options_t & options, std::vector<loop_region_t> & loops) noexcept;
 
 }
@@ -1,12 +1,15 @@
 
-/** $VER: MemoryStream.h (2026.05.03) P. Stuer - Based on Valley Bell's mmd2mid (https://github.com/ValleyBell/MidiConverters). **/
+/** $VER: MemoryStream.h (2026.10.19) P. Stuer - Based on Valley Bell's mmd2mid (https://github.com/ValleyBell/MidiConverters). **/
 
 #pragma once
 
-#include <CppCoreCheck\Warnings.h>
+#ifdef _MSC_VER
+#include <CppCoreCheck/Warnings.h>
 
 #pragma warning(disable: 4100 4514 4625 4626 4710 4711 4738 5045 ALL_CPPCORECHECK_WARNINGS)
+#endif
 
+#include <algorithm>
 #include <cstdint>
 
 #include <malloc.h>
@@ -29,11 +32,19 @@ struct midi_state_t
 class memory_stream_t
 {
 public:
-    typedef uint8_t (* GetDeltaTimeCallback)(memory_stream_t * stream, uint32_t & deltaTime);
+    typedef uint8_t (* GetDeltaTimeCallback)(memory_stream_t * stream, uint32_t & deltaTime, void * context);
 
-    memory_stream_t() : Data(), Size(), Offset(), _GetDeltaTime() {}
+    memory_stream_t() : Data(), Size(), Offset(), _GetDeltaTime(), _Context() {}
 
-    memory_stream_t(size_t initialSize, GetDeltaTimeCallback callback) : Data((uint8_t *) ::malloc(initialSize)), Size(initialSize), Offset(), _GetDeltaTime(callback) {}
+    memory_stream_t(size_t initialSize, GetDeltaTimeCallback callback, void * context) : Data((uint8_t *) ::malloc(initialSize)), Size((Data != nullptr) ? initialSize : 0), Offset(), _GetDeltaTime(callback), _Context(context) {}
+
+    memory_stream_t(const memory_stream_t &) = delete;
+    memory_stream_t & operator=(const memory_stream_t &) = delete;
+
+    ~memory_stream_t()
+    {
+        ::free(Data);
+    }
 
     void WriteHeader(uint16_t format, uint16_t tracks, uint16_t resolution) noexcept;
     void WriteTrackBegin(midi_state_t * state) noexcept;
@@ -45,6 +56,8 @@ public:
 
     void WriteEventOpt(midi_state_t * state, uint8_t event, uint8_t param1, uint8_t param2) noexcept;
 
+    void Write(const void * data, size_t size) noexcept;
+
     void WriteDeltaTime(uint32_t & deltaTime) noexcept;
     void WriteVariableLengthQuantity(uint32_t value) noexcept;
 
@@ -58,6 +71,7 @@ public:
     // Note: _GetDeltaTime can be used to inject additional events. IMPORTANT: You must not call any of the Write*Event() functions or WriteDeltaTime() within this function.
     // Optional callback for injecting raw data before writing delays. Returning non-zero makes it skip writing the delay.
     GetDeltaTimeCallback _GetDeltaTime = nullptr;
+    void * _Context = nullptr;              // Passed to the callback. Keeps the state of the callback per stream so that several streams can be written concurrently.
 };
 
 /// <summary>
@@ -218,12 +232,23 @@ void memory_stream_t::WriteEventOpt(midi_state_t * state, uint8_t event, uint8_t
     }
 }
 
+/// <summary>
+/// Writes raw data.
+/// </summary>
+void memory_stream_t::Write(const void * data, size_t size) noexcept
+{
+    Grow((uint32_t) size);
+
+    ::memcpy(&Data[Offset], data, size);
+    Offset += size;
+}
+
 /// <summary>
 /// 
 /// </summary>
 void memory_stream_t::WriteDeltaTime(uint32_t & deltaTime) noexcept
 {
-    if ((_GetDeltaTime != nullptr) && _GetDeltaTime(this, deltaTime))
+    if ((_GetDeltaTime != nullptr) && _GetDeltaTime(this, deltaTime, _Context))
         return;
 
     WriteVariableLengthQuantity(deltaTime);
@@ -279,15 +304,19 @@ void memory_stream_t::Grow(uint32_t bytesNeeded) noexcept
     if (NewOffset <= Size)
         return;
 
-    const size_t REALLOC_STEP = 0x8000u;
+    // Grow geometrically to keep the total cost of copying linear.
+    size_t NewSize = (std::max)(Size + (Size >> 1), (size_t) 0x8000u);
 
-    while (NewOffset > Size)
-        Size += REALLOC_STEP;
+    if (NewSize < NewOffset)
+        NewSize = NewOffset;
 
-    auto p = (uint8_t *) realloc(Data, Size);
+    auto p = (uint8_t *) ::realloc(Data, NewSize);
 
     if (p != nullptr)
+    {
         Data = p;
+        Size = NewSize;
+    }
 }
 
 /// <summary>
@@ -0,0 +1,88 @@
+
+/** $VER: Parallel.h (2026.10.19) P. Stuer - Runs independent tasks on multiple threads **/
+
+#pragma once
+
+#include "pch.h"
+
+#include "Diagnostics.h"
+#include "Instrumentation.h"
+
+#include <atomic>
+#include <thread>
+
+namespace midi
+{
+
+/// <summary>
+/// Calls the task for each index. In parallel mode, the indexes are distributed over a number of threads and the calling thread takes part in the work.
+/// The diagnostics of each task are reported in index order after all tasks have finished so that the messages are identical to a sequential run.
+/// The statistics of each task are collected separately and added to the statistics of the calling thread afterwards.
+/// The tasks must not throw. The result is identical to a sequential run.
+/// Each call starts and joins its own threads. Callers that already process several files in parallel should use sequential mode.
+/// </summary>
+template<typename T>
+void ForEach(size_t count, bool parallel, T task) noexcept
+{
+    if (!parallel || (count < 2))
+    {
+        for (size_t i = 0; i < count; ++i)
+            task(i);
+
+        return;
+    }
+
+    const diagnostics_t Caller = Diagnostics;
+
+    std::vector<diagnostics_buffer_t> Buffers(Caller.Sink != nullptr ? count : 0);
+
+    stats_t * const CallerStats = Stats;
+
+    std::vector<stats_t> TaskStats(CallerStats != nullptr ? count : 0);
+
+    std::atomic<size_t> Next = 0;
+
+    auto Worker = [&]()
+    {
+        for (size_t i = Next++; i < count; i = Next++)
+        {
+            stats_scope_t StatsScope(!TaskStats.empty() ? &TaskStats[i] : nullptr);
+
+            if (!Buffers.empty())
+            {
+                diagnostics_scope_t Scope(diagnostics_buffer_t::Write, &Buffers[i], Caller.Level);
+
+                task(i);
+            }
+            else
+                task(i);
+        }
+    };
+
+    const size_t ThreadCount = (std::min)((size_t) std::thread::hardware_concurrency(), count);
+
+    std::vector<std::thread> Threads;
+
+    try
+    {
+        for (size_t i = 1; i < ThreadCount; ++i)
+            Threads.emplace_back(Worker);
+    }
+    catch (...)
+    {
+        // Continue with the threads that were started.
+    }
+
+    Worker();
+
+    for (auto & Thread : Threads)
+        Thread.join();
+
+    for (const auto & Buffer : Buffers)
+        Buffer.Replay();
+
+    for (const auto & s : TaskStats)
+        CallerStats->Add(s);
+}
+
+}
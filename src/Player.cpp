@@ -0,0 +1,243 @@
+
+/** $VER: Player.cpp (2026.10.19) P. Stuer - Real-time playback of a container **/
+
+#include "pch.h"
+
+#include "Player.h"
+#include "MIDI.h"
+
+#include <chrono>
+
+namespace midi
+{
+
+/// <summary>
+/// Prepares the playback of a sub-song. Stops the producer thread if it is running. Returns false if the container is empty.
+/// </summary>
+bool player_t::Open(const container_t & container, size_t subSongIndex, const player_options_t & options)
+{
+    Stop();
+
+    _Options = options;
+
+    _Stream.clear();
+    _SysExTable = sysex_table_t();
+    _ActiveNotes.clear();
+
+    _LoopBegin = ~(size_t) 0;
+    _FadeBegin = ~(uint64_t) 0;
+    _FadeEnd = ~(uint64_t) 0;
+
+    _IsProducerDone.store(true, std::memory_order_relaxed);
+
+    if (container.IsEmpty())
+        return false;
+
+    uint32_t LoopBegin, LoopEnd;
+
+    container.SerializeAsStream(subSongIndex, _Stream, _SysExTable, _PortNumbers, LoopBegin, LoopEnd, _Options.Filter, _Options.SampleRate);
+
+    if (_Stream.empty())
+        return false;
+
+    // Determine the loop region.
+    if (LoopBegin != ~0u)
+    {
+        const subsong_view_t SubSong = container.GetSubSongView(subSongIndex);
+
+        const uint32_t LoopBeginTimestamp = container.GetLoopBeginTimestamp(subSongIndex);
+        const uint32_t LoopEndTimestamp = container.GetLoopEndTimestamp(subSongIndex);
+
+        _LoopBeginTime = SubSong.TimestampToTime(LoopBeginTimestamp, _Options.SampleRate);
+        _LoopEndTime = SubSong.TimestampToTime((LoopEndTimestamp != ~0u) ? LoopEndTimestamp : container.GetDuration(subSongIndex), _Options.SampleRate);
+
+        _LoopEnd = (LoopEnd != ~0u) ? LoopEnd : _Stream.size();
+
+        // Ignore empty loop regions. They would never advance the time.
+        if ((_LoopEndTime > _LoopBeginTime) && (_LoopEnd > LoopBegin))
+        {
+            _LoopBegin = LoopBegin;
+
+            if ((_Options.FadeDuration != 0) && (_Options.LoopCount != player_options_t::InfiniteLoops))
+            {
+                _FadeBegin = _LoopEndTime + (_LoopEndTime - _LoopBeginTime) * _Options.LoopCount;
+                _FadeEnd = _FadeBegin + ((uint64_t) _Options.FadeDuration * _Options.SampleRate + 500) / 1000;
+            }
+        }
+    }
+
+    _Queue.Reset(_Options.QueueSize);
+
+    return true;
+}
+
+/// <summary>
+/// Starts the producer thread.
+/// </summary>
+void player_t::Start()
+{
+    Stop();
+
+    if (_Stream.empty())
+        return;
+
+    _Stop.store(false, std::memory_order_relaxed);
+    _IsProducerDone.store(false, std::memory_order_relaxed);
+
+    _Producer = std::thread(&player_t::Produce, this);
+}
+
+/// <summary>
+/// Stops the producer thread. Messages that are already in the queue remain available.
+/// </summary>
+void player_t::Stop() noexcept
+{
+    _Stop.store(true, std::memory_order_relaxed);
+
+    if (_Producer.joinable())
+        _Producer.join();
+}
+
+/// <summary>
+/// Takes the next message that is due before the specified time (in samples). Returns false if there is none. Real-time safe; call from the audio thread only.
+/// </summary>
+bool player_t::Pop(uint64_t time, timed_message_t & message) noexcept
+{
+    const timed_message_t * Front = _Queue.Front();
+
+    if ((Front == nullptr) || (Front->Time >= time))
+        return false;
+
+    message = *Front;
+
+    _Queue.Pop();
+
+    return true;
+}
+
+/// <summary>
+/// Gets the gain of the fade-out at the specified time (in samples).
+/// </summary>
+float player_t::GetGain(uint64_t time) const noexcept
+{
+    if (time <= _FadeBegin)
+        return 1.f;
+
+    if (time >= _FadeEnd)
+        return 0.f;
+
+    return 1.f - (float) (time - _FadeBegin) / (float) (_FadeEnd - _FadeBegin);
+}
+
+/// <summary>
+/// Schedules the messages of the stream, repeating the loop region, until the end of the song or the fade-out.
+/// </summary>
+void player_t::Produce() noexcept
+{
+    size_t Position = 0;
+    uint64_t Offset = 0;        // Time added to the timestamps of the stream by the repetitions
+    uint32_t LoopCount = 0;     // Number of repetitions so far
+
+    const bool HasLoop = (_LoopBegin != ~(size_t) 0);
+    const bool HasFade = (_FadeBegin != ~(uint64_t) 0);
+
+    for (;;)
+    {
+        if (HasLoop && (Position == _LoopEnd))
+        {
+            const bool Repeat = (LoopCount < _Options.LoopCount) || HasFade;
+
+            if (Repeat)
+            {
+                if (!ReleaseNotes(_LoopEndTime + Offset))
+                    break;
+
+                Position = _LoopBegin;
+                Offset += _LoopEndTime - _LoopBeginTime;
+
+                if (LoopCount != player_options_t::InfiniteLoops)
+                    ++LoopCount;
+            }
+        }
+
+        if (Position >= _Stream.size())
+        {
+            ReleaseNotes(_Stream.back().Time + Offset);
+            break;
+        }
+
+        const timed_message_t & Message = _Stream[Position++];
+
+        const uint64_t Time = Message.Time + Offset;
+
+        if (HasFade && (Time >= _FadeEnd))
+        {
+            ReleaseNotes(_FadeEnd);
+            break;
+        }
+
+        if (!Schedule(Time, Message.Data))
+            break;
+    }
+
+    _IsProducerDone.store(true, std::memory_order_release);
+}
+
+/// <summary>
+/// Adds a message to the queue, waiting while the queue is full. Returns false if the player was stopped.
+/// </summary>
+bool player_t::Schedule(uint64_t time, uint32_t data) noexcept
+{
+    // Keep track of the sounding notes.
+    if (!(data & 0x80000000u))
+    {
+        const uint8_t Status = (uint8_t) data;
+        const uint8_t Type = Status & 0xF0;
+
+        if ((Type == StatusCode::NoteOn) || (Type == StatusCode::NoteOff))
+        {
+            const uint32_t NoteOff = (data & 0xFF00FF0Fu) | StatusCode::NoteOff;
+
+            auto it = std::find(_ActiveNotes.begin(), _ActiveNotes.end(), NoteOff);
+
+            const bool IsNoteOn = (Type == StatusCode::NoteOn) && ((data & 0x00FF0000u) != 0);
+
+            if (IsNoteOn)
+            {
+                if (it == _ActiveNotes.end())
+                    _ActiveNotes.push_back(NoteOff);
+            }
+            else
+            if (it != _ActiveNotes.end())
+                _ActiveNotes.erase(it);
+        }
+    }
+
+    const timed_message_t Message = { time, data };
+
+    while (!_Queue.Push(Message))
+    {
+        if (_Stop.load(std::memory_order_relaxed))
+            return false;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    return !_Stop.load(std::memory_order_relaxed);
+}
+
+/// <summary>
+/// Schedules a Note Off message for each sounding note so that no notes hang at a loop jump or at the end of the song.
+/// </summary>
+bool player_t::ReleaseNotes(uint64_t time) noexcept
+{
+    while (!_ActiveNotes.empty())
+    {
+        if (!Schedule(time, _ActiveNotes.back()))
+            return false;
+    }
+
+    return true;
+}
+
+}
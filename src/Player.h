@@ -0,0 +1,87 @@
+
+/** $VER: Player.h (2026.10.19) P. Stuer - Real-time playback of a container **/
+
+#pragma once
+
+#include "pch.h"
+
+#include "MIDIContainer.h"
+#include "RingBuffer.h"
+
+#include <atomic>
+#include <thread>
+
+namespace midi
+{
+
+struct player_options_t
+{
+    uint32_t SampleRate = 44'100;           // Units per second of the message timestamps
+    uint32_t LoopCount = 0;                 // Number of times the loop region is repeated. Use InfiniteLoops to repeat it until the player is stopped.
+    uint32_t FadeDuration = 0;              // Duration of the fade-out after the last repetition (in ms). 0 plays the rest of the song instead.
+    uint32_t QueueSize = 4096;              // Number of messages in the queue. Rounded up to a power of 2.
+
+    event_filter_t Filter;
+
+    static constexpr uint32_t InfiniteLoops = ~0u;
+};
+
+/// <summary>
+/// Plays a sub-song of a container. A producer thread schedules the messages, with the loop region repeated, into a lock-free queue.
+/// The audio thread takes the messages that are due with Pop(); it never blocks and never allocates memory. SysEx messages are passed
+/// as an index in the SysEx table (see message_t::IsSysEx()).
+/// </summary>
+class player_t
+{
+public:
+    player_t() noexcept : _LoopBegin(), _LoopEnd(), _LoopBeginTime(), _LoopEndTime(), _FadeBegin(), _FadeEnd(), _Stop(), _IsProducerDone() { }
+
+    player_t(const player_t &) = delete;
+    player_t & operator=(const player_t &) = delete;
+
+    virtual ~player_t() noexcept { Stop(); }
+
+    bool Open(const container_t & container, size_t subSongIndex, const player_options_t & options);
+
+    void Start();
+    void Stop() noexcept;
+
+    bool Pop(uint64_t time, timed_message_t & message) noexcept;
+
+    float GetGain(uint64_t time) const noexcept;
+
+    bool IsDone() const noexcept { return _IsProducerDone.load(std::memory_order_acquire) && _Queue.IsEmpty(); }
+
+    const sysex_table_t & GetSysExTable() const noexcept { return _SysExTable; }
+    const std::vector<uint8_t> & GetPortNumbers() const noexcept { return _PortNumbers; }
+
+private:
+    void Produce() noexcept;
+
+    bool Schedule(uint64_t time, uint32_t data) noexcept;
+    bool ReleaseNotes(uint64_t time) noexcept;
+
+private:
+    player_options_t _Options;
+
+    std::vector<timed_message_t> _Stream;
+    sysex_table_t _SysExTable;
+    std::vector<uint8_t> _PortNumbers;
+
+    size_t _LoopBegin;              // Index of the first message of the loop region or ~0 if there is no loop
+    size_t _LoopEnd;                // Index of the first message after the loop region
+    uint64_t _LoopBeginTime;
+    uint64_t _LoopEndTime;
+    uint64_t _FadeBegin;            // ~0 if there is no fade
+    uint64_t _FadeEnd;
+
+    std::vector<uint32_t> _ActiveNotes; // Notes that are sounding in the produced stream, as Note Off messages. Used by the producer only.
+
+    ring_buffer_t<timed_message_t> _Queue;
+
+    std::thread _Producer;
+    std::atomic<bool> _Stop;
+    std::atomic<bool> _IsProducerDone;
+};
+
+}
@@ -1,5 +1,5 @@
 
-/** $VER: CM6File.cpp (2025.03.21) P. Stuer - Based on Valley Bell's rpc2mid (https://github.com/ValleyBell/MidiConverters). **/
+/** $VER: CM6File.cpp (2026.10.19) P. Stuer - Based on Valley Bell's rpc2mid (https://github.com/ValleyBell/MidiConverters). **/
 
 #include "pch.h"
 
@@ -41,60 +41,60 @@ void cm6_file_t::Read(const buffer_t & data)
 }
 
 /// <summary>
-/// Converts a CM6 file to a MIDI file.
+/// Converts a CM6 file to SysEx events.
 /// </summary>
-void converter_t::Convert(const cm6_file_t & cm6File, midi_stream_t & midiStream, uint8_t mode)
+void converter_t::Convert(const cm6_file_t & cm6File, sysex_builder_t & builder, uint8_t mode)
 {
     if (mode & 0x01)
-        midiStream.WriteMetaEvent(midi::MetaDataType::Text, cm6File.Comment.Data, cm6File.Comment.Len);
+        builder.WriteMetaEvent(midi::MetaDataType::Text, cm6File.Comment.Data, cm6File.Comment.Len);
 
     if (mode & 0x10)
-        midiStream.WriteMetaEvent(midi::MetaDataType::Text, "MT-32 System");
+        builder.WriteMetaEvent(midi::MetaDataType::Text, "MT-32 System");
 
-    midiStream.WriteRolandSysEx(SysExHeaderMT32, 0x100000, cm6File.laSystem, 0x17, SYXOPT_DELAY);
+    builder.WriteRolandSysEx(SysExHeaderMT32, 0x100000, cm6File.laSystem, 0x17, SYXOPT_DELAY);
 
     if (mode & 0x10)
-        midiStream.WriteMetaEvent(midi::MetaDataType::Text, "MT-32 Patch Temporary");
+        builder.WriteMetaEvent(midi::MetaDataType::Text, "MT-32 Patch Temporary");
 
-    midiStream.WriteRolandSysEx(SysExHeaderMT32, 0x030000, cm6File.laPatchTemp, 0x90, SYXOPT_DELAY);
+    builder.WriteRolandSysEx(SysExHeaderMT32, 0x030000, cm6File.laPatchTemp, 0x90, SYXOPT_DELAY);
 
     if (mode & 0x10)
-        midiStream.WriteMetaEvent(midi::MetaDataType::Text, "MT-32 Rhythm Setup");
+        builder.WriteMetaEvent(midi::MetaDataType::Text, "MT-32 Rhythm Setup");
 
-    midiStream.WriteRolandSysEx(SysExHeaderMT32, 0x030110, cm6File.laRhythmTemp, 0x154, SYXOPT_DELAY, 0x100);
+    builder.WriteRolandSysEx(SysExHeaderMT32, 0x030110, cm6File.laRhythmTemp, 0x154, SYXOPT_DELAY, 0x100);
 
     if (mode & 0x10)
-        midiStream.WriteMetaEvent(midi::MetaDataType::Text, "MT-32 Timbre Temporary");
+        builder.WriteMetaEvent(midi::MetaDataType::Text, "MT-32 Timbre Temporary");
 
-    midiStream.WriteRolandSysEx(SysExHeaderMT32, 0x040000, cm6File.laTimbreTemp, 0x7B0, SYXOPT_DELAY, 0x100);
+    builder.WriteRolandSysEx(SysExHeaderMT32, 0x040000, cm6File.laTimbreTemp, 0x7B0, SYXOPT_DELAY, 0x100);
 
     if (mode & 0x10)
-        midiStream.WriteMetaEvent(midi::MetaDataType::Text, "MT-32 Patch Memory");
+        builder.WriteMetaEvent(midi::MetaDataType::Text, "MT-32 Patch Memory");
 
-    midiStream.WriteRolandSysEx(SysExHeaderMT32, 0x050000, cm6File.laPatchMem, 0x400, SYXOPT_DELAY, 0x100);
+    builder.WriteRolandSysEx(SysExHeaderMT32, 0x050000, cm6File.laPatchMem, 0x400, SYXOPT_DELAY, 0x100);
 
     if (mode & 0x10)
-        midiStream.WriteMetaEvent(midi::MetaDataType::Text, "MT-32 Timbre Memory");
+        builder.WriteMetaEvent(midi::MetaDataType::Text, "MT-32 Timbre Memory");
 
-    midiStream.WriteRolandSysEx(SysExHeaderMT32, 0x080000, cm6File.laTimbreMem, 0x4000, SYXOPT_DELAY, 0x100);
+    builder.WriteRolandSysEx(SysExHeaderMT32, 0x080000, cm6File.laTimbreMem, 0x4000, SYXOPT_DELAY, 0x100);
 
     if (mode & 0x10)
-        midiStream.WriteMetaEvent(midi::MetaDataType::Text, "CM-32P Patch Temporary");
+        builder.WriteMetaEvent(midi::MetaDataType::Text, "CM-32P Patch Temporary");
 
-    midiStream.WriteRolandSysEx(SysExHeaderMT32, 0x500000, cm6File.pcmPatchTemp, 0x7E, SYXOPT_DELAY);
+    builder.WriteRolandSysEx(SysExHeaderMT32, 0x500000, cm6File.pcmPatchTemp, 0x7E, SYXOPT_DELAY);
 
     if (mode & 0x10)
-        midiStream.WriteMetaEvent(midi::MetaDataType::Text, "CM-32P Patch Memory");
+        builder.WriteMetaEvent(midi::MetaDataType::Text, "CM-32P Patch Memory");
 
-    midiStream.WriteRolandSysEx(SysExHeaderMT32, 0x510000, cm6File.pcmPatchMem, 0x980, SYXOPT_DELAY, 0x100);
+    builder.WriteRolandSysEx(SysExHeaderMT32, 0x510000, cm6File.pcmPatchMem, 0x980, SYXOPT_DELAY, 0x100);
 
     if (mode & 0x10)
-        midiStream.WriteMetaEvent(midi::MetaDataType::Text, "CM-32P System");
+        builder.WriteMetaEvent(midi::MetaDataType::Text, "CM-32P System");
 
-    midiStream.WriteRolandSysEx(SysExHeaderMT32, 0x520000, cm6File.pcmSystem, 0x11, SYXOPT_DELAY);
+    builder.WriteRolandSysEx(SysExHeaderMT32, 0x520000, cm6File.pcmSystem, 0x11, SYXOPT_DELAY);
 
     if (mode & 0x10)
-        midiStream.WriteMetaEvent(midi::MetaDataType::Text, "Setup Finished.");
+        builder.WriteMetaEvent(midi::MetaDataType::Text, "Setup Finished.");
 }
 
 }
@@ -0,0 +1,161 @@
+
+/** $VER: ControlFileCache.cpp (2026.10.19) P. Stuer **/
+
+#include "pch.h"
+
+#include "ControlFileCache.h"
+
+namespace rcp
+{
+
+/// <summary>
+/// Reads and parses a control file.
+/// </summary>
+void control_file_t::Read(const std::wstring & filePath, uint8_t fileType)
+{
+    buffer_t Data;
+
+    Data.ReadFile(filePath.c_str());
+
+    if (fileType == 0x10)
+        CM6File.Read(Data);
+    else
+        GSDFile.Read(Data);
+
+    Type = fileType;
+}
+
+/// <summary>
+/// Gets the events that were generated for the specified time base, if any.
+/// </summary>
+std::shared_ptr<const control_events_t> control_file_t::GetEvents(uint32_t ticksPerQuarter, uint32_t tempo) const noexcept
+{
+    std::lock_guard<std::mutex> Lock(_Mutex);
+
+    for (const auto & Events : _Events)
+    {
+        if ((Events->TicksPerQuarter == ticksPerQuarter) && (Events->Tempo == tempo))
+            return Events;
+    }
+
+    return nullptr;
+}
+
+/// <summary>
+/// Adds the events generated for a time base. Returns the events that were added by another thread for the same time base, if any.
+/// Only the events of the last MaxEvents time bases are kept.
+/// </summary>
+std::shared_ptr<const control_events_t> control_file_t::AddEvents(const std::shared_ptr<const control_events_t> & events) const
+{
+    std::lock_guard<std::mutex> Lock(_Mutex);
+
+    for (const auto & Events : _Events)
+    {
+        if ((Events->TicksPerQuarter == events->TicksPerQuarter) && (Events->Tempo == events->Tempo))
+            return Events;
+    }
+
+    if (_Events.size() >= MaxEvents)
+        _Events.erase(_Events.begin());
+
+    _Events.push_back(events);
+
+    return events;
+}
+
+/// <summary>
+/// Gets the process-wide instance.
+/// </summary>
+control_file_cache_t & control_file_cache_t::GetInstance() noexcept
+{
+    static control_file_cache_t Instance;
+
+    return Instance;
+}
+
+/// <summary>
+/// Gets a control file. The file is read when it is not in the cache or when it has changed since it was cached.
+/// </summary>
+std::shared_ptr<const control_file_t> control_file_cache_t::Get(const std::wstring & filePath, uint8_t fileType)
+{
+    std::error_code ec;
+
+    const auto LastWriteTime = std::filesystem::last_write_time(filePath, ec);
+    const auto Size = !ec ? std::filesystem::file_size(filePath, ec) : 0;
+
+    if (ec)
+    {
+        // Let the reader report the error.
+        auto File = std::make_shared<control_file_t>();
+
+        File->Read(filePath, fileType);
+
+        return File;
+    }
+
+    {
+        std::lock_guard<std::mutex> Lock(_Mutex);
+
+        auto it = _Entries.find(filePath);
+
+        if ((it != _Entries.end()) && (it->second.LastWriteTime == LastWriteTime) && (it->second.Size == Size) && (it->second.File->Type == fileType))
+        {
+            it->second.LastUse = ++_UseCount;
+
+            return it->second.File;
+        }
+    }
+
+    // Read the file without holding the lock so that conversions that use other control files are not blocked.
+    auto File = std::make_shared<control_file_t>();
+
+    File->Read(filePath, fileType);
+
+    {
+        std::lock_guard<std::mutex> Lock(_Mutex);
+
+        auto & Entry = _Entries[filePath];
+
+        Entry.LastUse = ++_UseCount;
+
+        // Keep the file that was cached by another thread in the meantime.
+        if ((Entry.File != nullptr) && (Entry.LastWriteTime == LastWriteTime) && (Entry.Size == Size) && (Entry.File->Type == fileType))
+            return Entry.File;
+
+        Entry.LastWriteTime = LastWriteTime;
+        Entry.Size = Size;
+        Entry.File = File;
+
+        // Remove the least recently used file. Conversions that still use it keep their reference.
+        if (_Entries.size() > MaxEntries)
+        {
+            auto Oldest = std::min_element(_Entries.begin(), _Entries.end(), [](const auto & a, const auto & b) { return a.second.LastUse < b.second.LastUse; });
+
+            _Entries.erase(Oldest);
+        }
+    }
+
+    return File;
+}
+
+/// <summary>
+/// Removes all control files from the cache. Files that are still in use by a conversion remain valid until the conversion is done.
+/// </summary>
+void control_file_cache_t::Clear() noexcept
+{
+    std::lock_guard<std::mutex> Lock(_Mutex);
+
+    _Entries.clear();
+}
+
+/// <summary>
+/// Gets the number of control files in the cache.
+/// </summary>
+size_t control_file_cache_t::GetCount() noexcept
+{
+    std::lock_guard<std::mutex> Lock(_Mutex);
+
+    return _Entries.size();
+}
+
+}
@@ -0,0 +1,88 @@
+
+/** $VER: ControlFileCache.h (2026.10.19) P. Stuer **/
+
+#pragma once
+
+#include "pch.h"
+
+#include "RCP.h"
+
+namespace rcp
+{
+
+/// <summary>
+/// The events generated from a control file for a specific time base.
+/// </summary>
+struct control_events_t
+{
+    uint32_t TicksPerQuarter;
+    uint32_t Tempo;
+
+    std::vector<uint8_t> Data;  // The events without the delta time of the first event.
+    uint32_t Ticks;             // Sum of the delta times in Data
+    uint32_t Duration;          // Delay after the last event
+};
+
+/// <summary>
+/// Represents a parsed CM6 or GSD control file and the SysEx events generated from it.
+/// </summary>
+class control_file_t
+{
+public:
+    control_file_t() noexcept : Type() { }
+
+    control_file_t(const control_file_t &) = delete;
+    control_file_t & operator=(const control_file_t &) = delete;
+
+    void Read(const std::wstring & filePath, uint8_t fileType);
+
+    std::shared_ptr<const control_events_t> GetEvents(uint32_t ticksPerQuarter, uint32_t tempo) const noexcept;
+    std::shared_ptr<const control_events_t> AddEvents(const std::shared_ptr<const control_events_t> & events) const;
+
+    static constexpr size_t MaxEvents = 8; // Maximum number of time bases for which the events are kept
+
+public:
+    uint8_t Type;           // 0x10 - CM6, 0x11 - GSD
+    cm6_file_t CM6File;
+    gsd_file_t GSDFile;
+
+private:
+    mutable std::mutex _Mutex;
+    mutable std::vector<std::shared_ptr<const control_events_t>> _Events;
+};
+
+/// <summary>
+/// Implements a process-wide cache of control files. A file is identified by its path, last write time and size so that modified files are reloaded.
+/// The cache keeps at most MaxEntries files and removes the least recently used file when it is full.
+/// </summary>
+class control_file_cache_t
+{
+public:
+    static control_file_cache_t & GetInstance() noexcept;
+
+    std::shared_ptr<const control_file_t> Get(const std::wstring & filePath, uint8_t fileType);
+
+    void Clear() noexcept;
+
+    size_t GetCount() noexcept;
+
+    static constexpr size_t MaxEntries = 16;
+
+private:
+    control_file_cache_t() noexcept : _UseCount() { }
+
+    struct entry_t
+    {
+        std::filesystem::file_time_type LastWriteTime;
+        uintmax_t Size;
+
+        std::shared_ptr<const control_file_t> File;
+        uint64_t LastUse;           // Value of _UseCount when the file was last returned
+    };
+
+    std::mutex _Mutex;
+    std::unordered_map<std::wstring, entry_t> _Entries;
+    uint64_t _UseCount;
+};
+
+}
@@ -1,5 +1,5 @@
 
-/** $VER: GSDFile.cpp (2025.03.21) P. Stuer - Based on Valley Bell's rpc2mid (https://github.com/ValleyBell/MidiConverters). **/
+/** $VER: GSDFile.cpp (2026.10.19) P. Stuer - Based on Valley Bell's rpc2mid (https://github.com/ValleyBell/MidiConverters). **/
 
 #include "pch.h"
 
@@ -35,19 +35,19 @@ void gsd_file_t::Read(const buffer_t & data)
 }
 
 /// <summary>
-/// Converts a GSD file to a MIDI stream.
+/// Converts a GSD file to SysEx events.
 /// </summary>
-void converter_t::Convert(const gsd_file_t & gsdFile, midi_stream_t & midiStream, uint8_t mode)
+void converter_t::Convert(const gsd_file_t & gsdFile, sysex_builder_t & builder, uint8_t mode)
 {
     static const uint8_t Part2Channel[0x10] = { 0x09, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F };
     static const uint8_t Channel2Part[0x10] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x00, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F };
 
     // The order follows how Recomposer 3.0 sends the data.
     if (mode & 0x10)
-        midiStream.WriteMetaEvent(midi::MetaDataType::Text, "SC-55 Common Settings");
+        builder.WriteMetaEvent(midi::MetaDataType::Text, "SC-55 Common Settings");
 
     // Recomposer 3.0 sends Master Volume (40 00 04), Key-Shift (40 00 06) and Pan (via GM SysEx) separately, but doing a bulk-dump works just fine on SC-55/88.
-    midiStream.WriteRolandSysEx(SysExHeaderSC55, 0x400000, gsdFile.sysParams, 0x07, SYXOPT_DELAY);
+    builder.WriteRolandSysEx(SysExHeaderSC55, 0x400000, gsdFile.sysParams, 0x07, SYXOPT_DELAY);
 
     {
         uint8_t VoiceReserve[0x10] = { };
@@ -56,23 +56,23 @@ void converter_t::Convert(const gsd_file_t & gsdFile, midi_stream_t & midiStream
             VoiceReserve[i] = gsdFile.partParams[Part2Channel[i] * 0x7A + 0x79];
 
         if (mode & 0x10)
-            midiStream.WriteMetaEvent(midi::MetaDataType::Text, "SC-55 Voice Reserve");
+            builder.WriteMetaEvent(midi::MetaDataType::Text, "SC-55 Voice Reserve");
 
-        midiStream.WriteRolandSysEx(SysExHeaderSC55, 0x400110, VoiceReserve, _countof(VoiceReserve), SYXOPT_DELAY);
+        builder.WriteRolandSysEx(SysExHeaderSC55, 0x400110, VoiceReserve, _countof(VoiceReserve), SYXOPT_DELAY);
     }
 
     if (mode & 0x10)
-        midiStream.WriteMetaEvent(midi::MetaDataType::Text, "SC-55 Reverb Settings");
+        builder.WriteMetaEvent(midi::MetaDataType::Text, "SC-55 Reverb Settings");
 
-    midiStream.WriteRolandSysEx(SysExHeaderSC55, 0x400130, gsdFile.reverbParams, 0x07, SYXOPT_DELAY);
+    builder.WriteRolandSysEx(SysExHeaderSC55, 0x400130, gsdFile.reverbParams, 0x07, SYXOPT_DELAY);
 
     if (mode & 0x10)
-        midiStream.WriteMetaEvent(midi::MetaDataType::Text, "SC-55 Chorus Settings");
+        builder.WriteMetaEvent(midi::MetaDataType::Text, "SC-55 Chorus Settings");
 
-    midiStream.WriteRolandSysEx(SysExHeaderSC55, 0x400138, gsdFile.chorusParams, 0x08, SYXOPT_DELAY);
+    builder.WriteRolandSysEx(SysExHeaderSC55, 0x400138, gsdFile.chorusParams, 0x08, SYXOPT_DELAY);
 
     if (mode & 0x10)
-        midiStream.WriteMetaEvent(midi::MetaDataType::Text, "SC-55 Part Settings");
+        builder.WriteMetaEvent(midi::MetaDataType::Text, "SC-55 Part Settings");
 
     {
         uint8_t Bulk[0x100] = { };
@@ -84,11 +84,11 @@ void converter_t::Convert(const gsd_file_t & gsdFile, midi_stream_t & midiStream
 
             ConvertParameter2Bulk(&gsdFile.partParams[i * 0x7A], Bulk);
 
-            midiStream.WriteRolandSysEx(SysExHeaderSC55, 0x480000 | syxAddr, Bulk, 0xE0, SYXOPT_DELAY, 0x80);
+            builder.WriteRolandSysEx(SysExHeaderSC55, 0x480000 | syxAddr, Bulk, 0xE0, SYXOPT_DELAY, 0x80);
         }
 
         if (mode & 0x10)
-            midiStream.WriteMetaEvent(midi::MetaDataType::Text, "SC-55 Drum Setup");
+            builder.WriteMetaEvent(midi::MetaDataType::Text, "SC-55 Drum Setup");
 
         for (size_t i = 0; i < 2; ++i) // Each drum map
         {
@@ -110,7 +110,7 @@ void converter_t::Convert(const gsd_file_t & gsdFile, midi_stream_t & midiStream
 
                 ConvertBytes2Nibbles(Parameter, sizeof(Parameter), Bulk);
 
-                midiStream.WriteRolandSysEx(SysExHeaderSC55, 0x490000 | syxAddr, Bulk, sizeof(Bulk), SYXOPT_DELAY, 0x80);
+                builder.WriteRolandSysEx(SysExHeaderSC55, 0x490000 | syxAddr, Bulk, sizeof(Bulk), SYXOPT_DELAY, 0x80);
             }
         }
     }
@@ -119,7 +119,7 @@ void converter_t::Convert(const gsd_file_t & gsdFile, midi_stream_t & midiStream
     //gsdInf->masterTune;
 
     if (mode & 0x10)
-        midiStream.WriteMetaEvent(midi::MetaDataType::Text, "Setup Finished.");
+        builder.WriteMetaEvent(midi::MetaDataType::Text, "Setup Finished.");
 }
 
 /// <summary>
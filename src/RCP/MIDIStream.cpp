@@ -1,5 +1,5 @@
 
-/** $VER: MIDIStream.cpp (2025.04.06) P. Stuer - Based on Valley Bell's rpc2mid (https://github.com/ValleyBell/MidiConverters). **/
+/** $VER: MIDIStream.cpp (2026.10.19) P. Stuer - Based on Valley Bell's rpc2mid (https://github.com/ValleyBell/MidiConverters). **/
 
 #include "pch.h"
 
@@ -9,9 +9,6 @@
 namespace rcp
 {
 
-// Optional callback for injecting raw data before writing a MIDI timestamp. Returning non-zero makes it skip writing the timestamp.
-uint8_t (* midi_stream_t::_HandleDuration)(midi_stream_t * midiStream, uint32_t & duration);
-
 /// <summary>
 /// Writes a Roland SysEx message in chunks.
 /// </summary>
@@ -1,5 +1,5 @@
 
-/** $VER: MIDIStream.h (2025.04.06) P. Stuer - Based on Valley Bell's rpc2mid (https://github.com/ValleyBell/MidiConverters). **/
+/** $VER: MIDIStream.h (2026.10.19) P. Stuer - Based on Valley Bell's rpc2mid (https://github.com/ValleyBell/MidiConverters). **/
 
 #pragma once
 
@@ -17,18 +17,20 @@ namespace rcp
 class midi_stream_t
 {
 public:
-    typedef uint8_t (* duration_handler_t)(midi_stream_t * fileInfo, uint32_t & duration);
+    typedef uint8_t (* duration_handler_t)(midi_stream_t * midiStream, uint32_t & duration, void * context);
 
-    midi_stream_t() : _Data(), _Size(), _Offs(), _TicksPerBeat(), _Tempo(500000)
+    midi_stream_t() : _Data(), _Size(), _Offs(), _TicksPerBeat(), _Tempo(500000), _HandleDuration(), _Context()
     {
-        SetDurationHandler(nullptr);
     }
 
-    midi_stream_t(uint32_t size) : _Size(size), _Offs(), _TicksPerBeat(), _Tempo(500000)
+    midi_stream_t(uint32_t size) : _Size(size), _Offs(), _TicksPerBeat(), _Tempo(500000), _HandleDuration(), _Context()
     {
         _Data = (uint8_t *) ::malloc(_Size);
     }
 
+    midi_stream_t(const midi_stream_t &) = delete;
+    midi_stream_t & operator=(const midi_stream_t &) = delete;
+
     virtual ~midi_stream_t()
     {
         if (_Data != nullptr)
@@ -43,9 +45,13 @@ public:
 
     void Reset() { _Offs = 0; }
 
-    void SetDurationHandler(duration_handler_t durationHandler) { _HandleDuration = durationHandler; }
+    /// <summary>
+    /// Sets the optional handler that can inject raw data before a MIDI timestamp is written. The context keeps the state of the handler per stream.
+    /// </summary>
+    void SetDurationHandler(duration_handler_t durationHandler, void * context) noexcept { _HandleDuration = durationHandler; _Context = context; }
 
     uint32_t GetTicksPerQuarter() const noexcept { return _TicksPerBeat; }
+    void SetTicksPerQuarter(uint32_t ticksPerQuarter) noexcept { _TicksPerBeat = ticksPerQuarter; }
 
     uint32_t GetTempo() const noexcept { return _Tempo; }
     void SetTempo(uint32_t tempo) noexcept { _Tempo = tempo; }
@@ -120,10 +126,10 @@ public:
     {
         uint8_t Data[4]
         {
-            (value >> 24) & 0xFF,
-            (value >> 16) & 0xFF,
-            (value >>  8) & 0xFF,
-            (value >>  0) & 0xFF
+            (uint8_t) (value >> 24),
+            (uint8_t) (value >> 16),
+            (uint8_t) (value >>  8),
+            (uint8_t) (value >>  0)
         };
 
         WriteMetaEvent(type, Data + (4 - size), size);
@@ -150,6 +156,31 @@ public:
         WriteMetaEvent(type, text, (uint32_t) ::strlen(text));
     }
 
+    /// <summary>
+    /// Writes events that were generated by another stream. The data starts with the status of the first event, without its delta time. "duration" is the delay after the last event.
+    /// </summary>
+    void WriteEvents(const uint8_t * data, uint32_t size, uint32_t duration)
+    {
+        WriteTimestamp();
+
+        Ensure(size);
+
+        Add(data, size);
+
+        _State.RunningStatus = 0x00;
+        _State.Duration = duration;
+    }
+
+    /// <summary>
+    /// Writes raw data, e.g. the events of a track that was converted into another stream.
+    /// </summary>
+    void Write(const uint8_t * data, uint32_t size)
+    {
+        Ensure(size);
+
+        Add(data, size);
+    }
+
     void WriteVariableLengthQuantity(uint32_t quantity)
     {
         uint8_t Size = 0;
@@ -200,20 +231,19 @@ public:
         if (NewOffs <= _Size)
             return;
 
-        const uint32_t ChunkSize = 0x8000;
+        // Grow geometrically to keep the total cost of copying linear.
+        size_t NewSize = (std::max)((size_t) _Size + (_Size >> 1), (size_t) 0x8000);
 
-        size_t NewSize = _Size;
-
-        while (NewOffs > NewSize)
-            NewSize += ChunkSize;
+        if (NewSize < NewOffs)
+            NewSize = NewOffs;
 
         void * NewData = ::realloc(_Data, NewSize);
 
-        if (NewData != nullptr)
-        {
-            _Data = (uint8_t *) NewData;
-            _Size = (uint32_t) NewSize;
-        }
+        if (NewData == nullptr)
+            throw std::bad_alloc();
+
+        _Data = (uint8_t *) NewData;
+        _Size = (uint32_t) NewSize;
     }
 
     void WriteRolandSysEx(const uint8_t * syxHdr, uint32_t address, const uint8_t * data, uint32_t size, uint8_t opts);
@@ -230,7 +260,7 @@ public:
 private:
     void WriteTimestamp()
     {
-        if ((_HandleDuration != nullptr) && _HandleDuration(this, _State.Duration))
+        if ((_HandleDuration != nullptr) && _HandleDuration(this, _State.Duration, _Context))
             return;
 
         WriteVariableLengthQuantity(_State.Duration);
@@ -337,7 +367,9 @@ private:
 
     midi_state_t _State;
 
-    static duration_handler_t _HandleDuration;
+    // Optional handler for injecting raw data before writing a MIDI timestamp. Returning non-zero makes it skip writing the timestamp.
+    duration_handler_t _HandleDuration;
+    void * _Context;
 };
 
 }
@@ -1,10 +1,9 @@
 
-/** $VER: RCP.cpp (2026.05.03) P. Stuer - Based on Valley Bell's rpc2mid (https://github.com/ValleyBell/MidiConverters). **/
+/** $VER: RCP.cpp (2026.10.19) P. Stuer - Based on Valley Bell's rpc2mid (https://github.com/ValleyBell/MidiConverters). **/
 
 #include "pch.h"
 
 #include "RCP.h"
-#include "RunningNotes.h"
 
 namespace rcp
 {
@@ -17,12 +16,14 @@ struct loop_t
     uint16_t Counter;
 };
 
-extern running_notes_t RunningNotes;
-
 constexpr uint8_t MCMD_INI_EXCLUDE  = 0x00; // exclude initial command
 constexpr uint8_t MCMD_INI_INCLUDE  = 0x01; // include initial command
 constexpr uint8_t MCMD_RET_DATASIZE = 0x02; // return number of data bytes
 
+// Estimated MIDI output of a single RCP command: a note on and its note off, each with a 4-byte delta time. User SysEx commands expand to a complete SysEx message.
+const uint32_t MaxBytesPerCommand = 2u * (4u + 3u);
+const uint32_t MaxBytesPerUserSysEx = 4u + 1u + 4u + 24u + 2u;
+
 static uint8_t DetermineShift(uint32_t value);
 static uint16_t ConvertRCPSysExToMIDISysEx(const uint8_t * srcData, uint16_t srcSize, uint8_t * dstData, uint8_t param1, uint8_t param2, uint8_t channel);
 
@@ -36,24 +37,16 @@ void rcp_file_t::ParseTrack(const uint8_t * data, uint32_t size, uint32_t offset
 
     const uint32_t TrackHead = offset;
 
-    uint32_t TrackSize = 0;
+    const uint32_t SizeFieldSize = (_Version == 2) ? 2u : ((_Version == 3) ? 4u : 0u);
 
-    if (_Version == 2)
-    {
-        TrackSize = ReadLE16(data + offset);
-        offset += 2;
-    }
-    else
-    if (_Version == 3)
-    {
-        TrackSize = ReadLE32(data + offset);
-        offset += 4;
-    }
+    if (offset + SizeFieldSize + 0x2A > size)
+        throw std::runtime_error("Insufficient data to read track header");
 
-    const uint32_t TrackTail = std::min(TrackHead + TrackSize, size);
+    const uint32_t TrackSize = (_Version == 2) ? ReadLE16(data + offset) : ((_Version == 3) ? ReadLE32(data + offset) : 0u);
 
-    if (offset + 0x2A > size)
-        throw std::runtime_error("Insufficient data to read track header");
+    offset += SizeFieldSize;
+
+    const uint32_t TrackTail = std::min(TrackHead + TrackSize, size);
 
     offset += 0x2A; // Skip the track header.
 
@@ -64,13 +57,14 @@ void rcp_file_t::ParseTrack(const uint8_t * data, uint32_t size, uint32_t offset
     track->LoopStartOffs = 0;
     track->LoopStartTick = 0;
 
+    track->OutputSize = 0;
+    track->LoopOutputSize = 0;
+
     std::vector<uint32_t> MeasureOffsets;
 
     MeasureOffsets.reserve(256);
 
-#ifdef _RCP_VERBOSE
-    ::printf("%04X: Track begin\n", offset);
-#endif
+    RCP_TRACE(offset, "Track begin");
 
     MeasureOffsets.push_back(offset);
 
@@ -87,15 +81,19 @@ void rcp_file_t::ParseTrack(const uint8_t * data, uint32_t size, uint32_t offset
     uint32_t LoopParentOffs[8] = { };
     uint32_t LoopStartOffs[8] = { };
     uint32_t LoopStartTick[8] = { };
+    uint32_t LoopOutputSize[8] = { };
     uint16_t LoopCounter[8] = { };
 
-    while ((offset < TrackTail) && !EndOfTrack)
+    const uint32_t CommandSize = (_Version == 2) ? 4u : 6u;
+
+    // A command that is cut off by the end of the data is not read.
+    while ((offset + CommandSize <= TrackTail) && !EndOfTrack)
     {
         uint8_t  CmdType     = 0;
         uint16_t CmdP0       = 0;
         uint8_t  CmdP1       = 0;
         uint8_t  CmdP2       = 0;
-        uint16_t CmdDuration = 0;
+        [[maybe_unused]] uint16_t CmdDuration = 0;
 
         if (_Version == 2)
         {
@@ -133,6 +131,7 @@ void rcp_file_t::ParseTrack(const uint8_t * data, uint32_t size, uint32_t offset
                     {
                         track->LoopStartOffs = LoopStartOffs[LoopIndex];
                         track->LoopStartTick = LoopStartTick[LoopIndex];
+                        track->LoopOutputSize = track->OutputSize - LoopOutputSize[LoopIndex];
 
                         EndOfTrack = 1;
                     }
@@ -159,6 +158,7 @@ void rcp_file_t::ParseTrack(const uint8_t * data, uint32_t size, uint32_t offset
                     LoopParentOffs[LoopIndex] = ParentOffs;
                     LoopStartOffs[LoopIndex] = offset;
                     LoopStartTick[LoopIndex] = track->Duration;
+                    LoopOutputSize[LoopIndex] = track->OutputSize;
                     LoopCounter[LoopIndex] = 0;
 
                     LoopIndex++;
@@ -238,9 +238,7 @@ void rcp_file_t::ParseTrack(const uint8_t * data, uint32_t size, uint32_t offset
             {
                 if (MeasureOffsets.size() >= 0x8000)
                 {
-                #ifdef _RCP_VERBOSE
-                    ::printf("Warning: too many measures in track.\n");
-                #endif
+                    RCP_WARNING(offset, "Too many measures in track.");
 
                     EndOfTrack = 1;
                     break;
@@ -263,6 +261,7 @@ void rcp_file_t::ParseTrack(const uint8_t * data, uint32_t size, uint32_t offset
                         LoopParentOffs[LoopIndex] = ParentOffs;
                         LoopStartOffs[LoopIndex] = offset;
                         LoopStartTick[LoopIndex] = track->Duration;
+                        LoopOutputSize[LoopIndex] = track->OutputSize;
                         LoopCounter[LoopIndex] = 0;
 
                         LoopIndex++;
@@ -293,6 +292,7 @@ void rcp_file_t::ParseTrack(const uint8_t * data, uint32_t size, uint32_t offset
 
                     track->LoopStartOffs = LoopStartOffs[LoopIndex];
                     track->LoopStartTick = LoopStartTick[LoopIndex];
+                    track->LoopOutputSize = track->OutputSize - LoopOutputSize[LoopIndex];
 
                     Loops.clear();
                 }
@@ -307,46 +307,36 @@ void rcp_file_t::ParseTrack(const uint8_t * data, uint32_t size, uint32_t offset
         }
 
         track->Duration += CmdP0;
+        track->OutputSize += ((CmdType & 0xF8) == 0x90) ? MaxBytesPerUserSysEx : MaxBytesPerCommand;
     }
 
-#ifdef _RCP_VERBOSE
-    ::printf("%04X: Track End: %d measures, %d ticks.\n\n", offset, (int) MeasureOffsets.size(), track->Duration);
-#endif
+    RCP_TRACE(offset, "Track End: %d measures, %d ticks.", (int) MeasureOffsets.size(), track->Duration);
 }
 
 /// <summary>
 /// Converts an RCP track to a MIDI track.
 /// </summary>
-void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * offset, rcp_track_t * track, midi_stream_t & midiStream) const
+void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t offset, rcp_track_t * track, midi_stream_t & midiStream, midi::running_notes_t & runningNotes) const
 {
-    uint32_t Offset = *offset;
+    uint32_t Offset = offset;
+
+    track->Loops.clear();
 
     if (Offset >= size)
         throw std::runtime_error("Invalid start of track position");
 
     const uint32_t TrackHead = Offset;
 
-    uint32_t TrackSize = 0;
+    const uint32_t SizeFieldSize = (_Version == 2) ? 2u : ((_Version == 3) ? 4u : 0u);
 
-    if (_Version == 2)
-    {
-        TrackSize = ReadLE16(&data[Offset]);
+    if (Offset + SizeFieldSize + 0x2A > size)
+        throw std::runtime_error("Insufficient data to read track header");
 
-        // Bits 0/1 are used as 16/17, allowing for up to 256 KB per track. This is used by some ItoR.x conversions.
-        TrackSize = (TrackSize & ~0x03) | ((TrackSize & 0x03) << 16);
-        Offset += 2;
-    }
-    else
-    if (_Version == 3)
-    {
-        TrackSize = ReadLE32(&data[Offset]);
-        Offset += 4;
-    }
+    const uint32_t TrackSize = ReadTrackSize(data, Offset);
 
-    uint32_t TrackTail = std::min(TrackHead + TrackSize, size);
+    Offset += SizeFieldSize;
 
-    if (Offset + 0x2A > size)
-        throw std::runtime_error("Insufficient data to read track header");
+    uint32_t TrackTail = std::min(TrackHead + TrackSize, size);
 
     uint8_t TrackId       = data[Offset + 0x00]; // Track ID (1-based)
     uint8_t RhythmMode    = data[Offset + 0x01]; // Rhythm mode (0x00 - off, 0x80 - on, others undefined / fall back to off)
@@ -375,18 +365,15 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
 
     Offset += 0x2A; // Skip the track header.
 
-#ifdef _RCP_VERBOSE
-    ::printf("Track %02X, \"%.*s\"\n", TrackId, TrackName.Len, TrackName.Data);
-    ::printf("    Rhythm Mode: %02X, Port: %02X, Channel: %02X, Transposition: %4d, Start Tick: %6d, Mute Mode: %02X \n", RhythmMode, PortNumber, ChannelNumber, Transposition, StartTick, MuteMode);
+    RCP_TRACE(TrackHead, "Track %02X, \"%.*s\", Rhythm Mode: %02X, Port: %02X, Channel: %02X, Transposition: %4d, Start Tick: %6d, Mute Mode: %02X", TrackId, TrackName.Len, TrackName.Data, RhythmMode, PortNumber, ChannelNumber, Transposition, StartTick, MuteMode);
 
     // For MuteMode, 0x00 == off, 0x01 == on. Others are undefined.
     if ((MuteMode != 0x00) && (MuteMode != 0x01))
-        ::printf("Warning: Track %2u: Unknown Mute Mode 0x%02X.\n", TrackId, MuteMode);
+        RCP_WARNING(TrackHead, "Track %2u: Unknown Mute Mode 0x%02X.", TrackId, MuteMode);
 
     // For RhythmMode, values 0 (melody channel) and 0x80 (rhythm channel) are common. Some songs use different values, but the actual meaning of the value is unknown.
     if ((RhythmMode != 0) && (RhythmMode != 0x80))
-        ::printf("Warning: Track %2u: Unknown Rhythm Mode 0x%02X.\n", TrackId, RhythmMode);
-#endif
+        RCP_WARNING(TrackHead, "Track %2u: Unknown Rhythm Mode 0x%02X.", TrackId, RhythmMode);
 
     // Write the track setup.
     {
@@ -398,11 +385,7 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
             midiStream.WriteMetaEvent(midi::TrackName, TrackName.Data, TrackName.Len);
 
         if ((MuteMode == 0x01) && _Options.IgnoreMutedTracks)
-        {
-            *offset = TrackHead + TrackSize;
-
             return;
-        }
 
         if (PortNumber != 0xFF)
         {
@@ -423,7 +406,7 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
 
         midiStream.SetDuration(OldDuration);
 
-        RunningNotes.Reset();
+        runningNotes.Reset();
     }
 
     midiStream.SetChannel(ChannelNumber);
@@ -446,6 +429,8 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
         midiStream.SetDuration(Timestamp);
     }
 
+    uint32_t Time = midiStream.GetDuration(); // Timestamp of the current command (in ticks)
+
     {
         uint8_t Temp[256];
 
@@ -453,7 +438,7 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
         uint8_t XGParameters[6] = { }; // 0 device ID, 1 model ID, 2 address high, 3 address low
 
         uint32_t ParentOffs = 0;
-        uint16_t RepeatingBarID = 0xFFFF;
+        [[maybe_unused]] uint16_t RepeatingBarID = 0xFFFF;
 
         std::vector<uint32_t> BarOffsets;
         uint16_t BarCount = 0;
@@ -469,9 +454,13 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
     
         uint32_t LoopParentOffs[8] = { };
         uint32_t LoopStartOffs[8] = { };
+        uint32_t LoopStartTime[8] = { };
         uint16_t LoopCounter[8] = { };
 
-        while ((Offset < TrackTail) && !EndOfTrack)
+        const uint32_t CommandSize = (_Version == 2) ? 4u : 6u;
+
+        // A command that is cut off by the end of the data is not read.
+        while ((Offset + CommandSize <= TrackTail) && !EndOfTrack)
         {
             uint32_t CmdOffset = Offset; // Offset of the start of the command
 
@@ -512,39 +501,27 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
                     {
                         uint32_t Duration = midiStream.GetDuration();
 
-                        RunningNotes.Check(midiStream, Duration);
+                        runningNotes.Check(midiStream, Duration);
 
                         midiStream.SetDuration(Duration);
                     }
 
-                    for (uint16_t i = 0; i < RunningNotes._Count; ++i)
-                    {
-                        if (RunningNotes._Notes[i].Code == Code)
-                        {
-                            // The note is already playing. Increase its duration.
-                            RunningNotes._Notes[i].DeltaTime = midiStream.GetDuration() + CmdDuration;
-
-                            CmdDuration = 0; // Prevents the note from being added to the MIDI stream yet.
-                            break;
-                        }
-                    }
+                    // If the note is already playing, increase its duration.
+                    if (runningNotes.Extend(Code, midiStream.GetDuration() + CmdDuration))
+                        CmdDuration = 0; // Prevents the note from being added to the MIDI stream yet.
                 }
 
                 // Should we add the note to the stream?
                 if ((CmdDuration > 0) && (PortNumber != 0xFF))
                 {
-                #ifdef _RCP_VERBOSE
-                    ::printf("    %04X: %02X %04X %02X %02X %04X | %08X: Note On %02X %02X\n", CmdOffset, CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), Code, CmdP2);
-                #endif
+                    RCP_TRACE(CmdOffset, "%02X %04X %02X %02X %04X | %08X: Note On %02X %02X", CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), Code, CmdP2);
 
                     midiStream.WriteEvent(midi::NoteOn, Code, CmdP2);
 
-                    RunningNotes.Add(midiStream.GetChannel(), Code, 0x80, CmdDuration);
+                    runningNotes.Add(midiStream.GetChannel(), Code, 0x80, CmdDuration);
                 }
-            #ifdef _RCP_VERBOSE
                 else
-                    ::printf("    %04X: %02X %04X %02X %02X %04X | %08X: Note On %02X %02X (Skipped)\n", CmdOffset, CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), Code, CmdP2);
-            #endif
+                    RCP_TRACE(CmdOffset, "%02X %04X %02X %02X %04X | %08X: Note On %02X %02X (Skipped)", CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), Code, CmdP2);
             }
             else
             {
@@ -564,26 +541,15 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
                         if ((Size > 0) && Temp[Size - 1] != 0xF7)
                             Temp[Size++] = 0xF7;
 
-                        #ifdef _RCP_VERBOSE
-                        {
-                            ::printf("    %04X: %02X %04X %02X %02X %04X | %08X: Add User SysEx \"%.*s\",", CmdOffset, CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), us.Name.Len, us.Name.Data);
-
-                            for (uint16_t i = 0; i < Size; ++i)
-                                ::printf(" %02X", Temp[i]);
-
-                            ::putchar('\n');
-                        }
-                        #endif
+                        RCP_TRACE(CmdOffset, "%02X %04X %02X %02X %04X | %08X: Add User SysEx \"%.*s\", %s", CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), us.Name.Len, us.Name.Data, FormatBytes(Temp, Size).c_str());
 
                         if ((us.Name.Len > 0) && _Options.WriteSysExNames)
                             midiStream.WriteMetaEvent(midi::Text, us.Name.Data, us.Name.Len);
 
                         if (Size > 1)
                             midiStream.WriteEvent(midi::SysEx, Temp, Size);
-                        #ifdef _RCP_VERBOSE
                         else
-                            ::printf("Warning: Track %2u, 0x%04X: Using empty User SysEx command %u.\n", TrackId, CmdOffset, CmdType & 0x07);
-                        #endif
+                            RCP_WARNING(CmdOffset, "Track %2u: Using empty User SysEx command %u.", TrackId, CmdType & 0x07);
                         break;
                     }
 
@@ -601,16 +567,7 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
 
                         Size = ConvertRCPSysExToMIDISysEx(Text.Data, Size, Temp, CmdP1, CmdP2, ChannelNumber);
 
-                        #ifdef _RCP_VERBOSE
-                        {
-                            ::printf("    %04X: %02X %04X %02X %02X %04X | %08X: Send SysEx,", CmdOffset, CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration());
-
-                            for (uint16_t i = 0; i < Size; ++i)
-                                ::printf(" %02X", Temp[i]);
-
-                            ::putchar('\n');
-                        }
-                        #endif
+                        RCP_TRACE(CmdOffset, "%02X %04X %02X %02X %04X | %08X: Send SysEx, %s", CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), FormatBytes(Temp, Size).c_str());
 
                         midiStream.WriteEvent(midi::SysEx, Temp, Size);
                         break;
@@ -643,16 +600,7 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
                         Temp[4] = CmdP2;
                         Temp[5] = 0xF7;
 
-                        #ifdef _RCP_VERBOSE
-                        {
-                            ::printf("    %04X: %02X %04X %02X %02X %04X | %08X: Yamaha SysEx", CmdOffset, CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration());
-
-                            for (uint16_t i = 0; i < 6; ++i)
-                                ::printf(" %02X", Temp[i]);
-
-                            ::putchar('\n');
-                        }
-                        #endif
+                        RCP_TRACE(CmdOffset, "%02X %04X %02X %02X %04X | %08X: Yamaha SysEx %s", CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), FormatBytes(Temp, 6).c_str());
 
                         midiStream.WriteEvent(midi::SysEx, Temp, 6);
                         break;
@@ -671,16 +619,7 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
                         Temp[5] = CmdP2;
                         Temp[6] = 0xF7;
 
-                        #ifdef _RCP_VERBOSE
-                        {
-                            ::printf("    %04X: %02X %04X %02X %02X %04X | %08X: Yamaha SysEx", CmdOffset, CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration());
-
-                            for (uint16_t i = 0; i < 6; ++i)
-                                ::printf(" %02X", Temp[i]);
-
-                            ::putchar('\n');
-                        }
-                        #endif
+                        RCP_TRACE(CmdOffset, "%02X %04X %02X %02X %04X | %08X: Yamaha SysEx %s", CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), FormatBytes(Temp, 6).c_str());
 
                         midiStream.WriteEvent(midi::SysEx, Temp, 7);
                         break;
@@ -700,16 +639,7 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
                         Temp[5] = CmdP2;
                         Temp[6] = 0xF7;
 
-                        #ifdef _RCP_VERBOSE
-                        {
-                            ::printf("    %04X: %02X %04X %02X %02X %04X | %08X: Yamaha SysEx", CmdOffset, CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration());
-
-                            for (uint16_t i = 0; i < 6; ++i)
-                                ::printf(" %02X", Temp[i]);
-
-                            ::putchar('\n');
-                        }
-                        #endif
+                        RCP_TRACE(CmdOffset, "%02X %04X %02X %02X %04X | %08X: Yamaha SysEx %s", CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), FormatBytes(Temp, 6).c_str());
 
                         midiStream.WriteEvent(midi::SysEx, Temp, 7);
                         break;
@@ -720,9 +650,7 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
                         XGParameters[2] = CmdP1;
                         XGParameters[3] = CmdP2;
 
-                    #ifdef _RCP_VERBOSE
-                        ::printf("    %04X: %02X %04X %02X %02X %04X | %08X: Yamaha XG base address %02X %02X", CmdOffset, CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), CmdP1, CmdP2);
-                    #endif
+                        RCP_TRACE(CmdOffset, "%02X %04X %02X %02X %04X | %08X: Yamaha XG base address %02X %02X", CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), CmdP1, CmdP2);
                         break;
                     }
 
@@ -731,9 +659,7 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
                         XGParameters[0] = CmdP1;
                         XGParameters[1] = CmdP2;
 
-                    #ifdef _RCP_VERBOSE
-                        ::printf("    %04X: %02X %04X %02X %02X %04X | %08X: Yamaha XG device data %02X %02X", CmdOffset, CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), CmdP1, CmdP2);
-                    #endif
+                        RCP_TRACE(CmdOffset, "%02X %04X %02X %02X %04X | %08X: Yamaha XG device data %02X %02X", CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), CmdP1, CmdP2);
                         break;
                     }
 
@@ -749,16 +675,7 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
                         ::memcpy(Temp + 1, &XGParameters[0], 6);
                         Temp[7] = 0xF7;
 
-                        #ifdef _RCP_VERBOSE
-                        {
-                            ::printf("    %04X: %02X %04X %02X %02X %04X | %08X: Yamaha XG SysEx", CmdOffset, CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration());
-
-                            for (uint16_t i = 0; i < 8; ++i)
-                                ::printf(" %02X", Temp[i]);
-
-                            ::putchar('\n');
-                        }
-                        #endif
+                        RCP_TRACE(CmdOffset, "%02X %04X %02X %02X %04X | %08X: Yamaha XG SysEx %s", CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), FormatBytes(Temp, 8).c_str());
 
                         midiStream.WriteEvent(midi::SysEx, Temp, 8);
                         break;
@@ -778,16 +695,7 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
                         ::memcpy(Temp + 3, &XGParameters[2], 4);
                         Temp[7] = 0xF7;
 
-                        #ifdef _RCP_VERBOSE
-                        {
-                            ::printf("    %04X: %02X %04X %02X %02X %04X | %08X: Yamaha XG SysEx", CmdOffset, CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration());
-
-                            for (uint16_t i = 0; i < 8; ++i)
-                                ::printf(" %02X", Temp[i]);
-
-                            ::putchar('\n');
-                        }
-                        #endif
+                        RCP_TRACE(CmdOffset, "%02X %04X %02X %02X %04X | %08X: Yamaha XG SysEx %s", CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), FormatBytes(Temp, 8).c_str());
 
                         midiStream.WriteEvent(midi::SysEx, Temp, 8);
                         break;
@@ -805,16 +713,7 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
                         Temp[4] = CmdP2;
                         Temp[5] = 0xF7;
 
-                        #ifdef _RCP_VERBOSE
-                        {
-                            ::printf("    %04X: %02X %04X %02X %02X %04X | %08X: Roland MKS-7 SysEx", CmdOffset, CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration());
-
-                            for (uint16_t i = 0; i < 6; ++i)
-                                ::printf(" %02X", Temp[i]);
-
-                            ::putchar('\n');
-                        }
-                        #endif
+                        RCP_TRACE(CmdOffset, "%02X %04X %02X %02X %04X | %08X: Roland MKS-7 SysEx %s", CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), FormatBytes(Temp, 6).c_str());
 
                         midiStream.WriteEvent(midi::SysEx, Temp, 6);
                         break;
@@ -825,9 +724,7 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
                         GSParameters[2] = CmdP1;
                         GSParameters[3] = CmdP2;
 
-                    #ifdef _RCP_VERBOSE
-                        ::printf("    %04X: %02X %04X %02X %02X %04X | %08X: Roland GS base address %02X %02X\n", CmdOffset, CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), CmdP1, CmdP2);
-                    #endif
+                        RCP_TRACE(CmdOffset, "%02X %04X %02X %02X %04X | %08X: Roland GS base address %02X %02X", CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), CmdP1, CmdP2);
                         break;
                     }
 
@@ -855,16 +752,7 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
                         Temp[8] = (uint8_t) ((0x100 - CheckSum) & 0x7F);
                         Temp[9] = 0xF7;
 
-                        #ifdef _RCP_VERBOSE
-                        {
-                            ::printf("    %04X: %02X %04X %02X %02X %04X | %08X: Roland GS SysEx", CmdOffset, CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration());
-
-                            for (uint16_t i = 0; i < 10; ++i)
-                                ::printf(" %02X", Temp[i]);
-
-                            ::putchar('\n');
-                        }
-                        #endif
+                        RCP_TRACE(CmdOffset, "%02X %04X %02X %02X %04X | %08X: Roland GS SysEx %s", CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), FormatBytes(Temp, 10).c_str());
 
                         midiStream.WriteEvent(midi::SysEx, Temp, 10);
                         break;
@@ -875,9 +763,7 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
                         GSParameters[0] = CmdP1;
                         GSParameters[1] = CmdP2;
 
-                    #ifdef _RCP_VERBOSE
-                        ::printf("    %04X: %02X %04X %02X %02X %04X | %08X: Roland GS device %02X %02X\n", CmdOffset, CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), CmdP1, CmdP2);
-                    #endif
+                        RCP_TRACE(CmdOffset, "%02X %04X %02X %02X %04X | %08X: Roland GS device %02X %02X", CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), CmdP1, CmdP2);
                         break;
                     }
 
@@ -886,9 +772,7 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
                         if (PortNumber == 0xFF)
                             break;
 
-                    #ifdef _RCP_VERBOSE
-                        ::printf("    %04X: %02X %04X %02X %02X %04X | %08X: Set XG instrument (Control Change 20 %02X, Program Change %02X 00)\n", CmdOffset, CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), CmdP2, CmdP1);
-                    #endif
+                        RCP_TRACE(CmdOffset, "%02X %04X %02X %02X %04X | %08X: Set XG instrument (Control Change 20 %02X, Program Change %02X 00)", CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), CmdP2, CmdP1);
 
                         midiStream.WriteEvent(midi::ControlChange, 0x20, CmdP2);
                         midiStream.WriteEvent(midi::ProgramChange, CmdP1, 0x00);
@@ -900,9 +784,7 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
                         if (PortNumber == 0xFF)
                             break;
 
-                    #ifdef _RCP_VERBOSE
-                        ::printf("    %04X: %02X %04X %02X %02X %04X | %08X: Set GS instrument (Control Change 00 %02X, Program Change %02X 00)\n", CmdOffset, CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), CmdP2, CmdP1);
-                    #endif
+                        RCP_TRACE(CmdOffset, "%02X %04X %02X %02X %04X | %08X: Set GS instrument (Control Change 00 %02X, Program Change %02X 00)", CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), CmdP2, CmdP1);
 
                         midiStream.WriteEvent(midi::ControlChange, 0x00, CmdP2);
                         midiStream.WriteEvent(midi::ProgramChange, CmdP1, 0x00);
@@ -911,7 +793,7 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
 
                     case 0xE5: // Key Scan
                     {
-                        ::printf("Warning: Track %2u, 0x%04X: Key Scan command found.\n", TrackId, CmdOffset);
+                        RCP_WARNING(CmdOffset, "Track %2u: Ignoring Key Scan command.", TrackId);
                         break;
                     }
 
@@ -933,9 +815,7 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
                             PortNumber    = (uint8_t) (CmdP1 >> 4); // port ID
                             ChannelNumber = (uint8_t) (CmdP1 & 0x0F); // channel ID
 
-                        #ifdef _RCP_VERBOSE
-                            ::printf("    %04X: %02X %04X %02X %02X %04X | %08X: Set MIDI channel (Port %02X, Channel %02X)\n", CmdOffset, CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), PortNumber, ChannelNumber);
-                        #endif
+                            RCP_TRACE(CmdOffset, "%02X %04X %02X %02X %04X | %08X: Set MIDI channel (Port %02X, Channel %02X)", CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), PortNumber, ChannelNumber);
 
                             midiStream.WriteMetaEvent(midi::MIDIPort,      &PortNumber, 1);
                             midiStream.WriteMetaEvent(midi::ChannelPrefix, &ChannelNumber, 1);
@@ -947,19 +827,15 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
 
                     case 0xE7: // Tempo Modifier, P1 = multiplicator (20h = 50%, 40h = 100%, 80h = 200%) + P2 = 0 / Else: Just set tempo, 01..FF - interpolate tempo over P2 ticks.
                     {
-                    #ifdef _RCP_VERBOSE
                         if (CmdP2 != 0)
-                            ::printf("Warning: Track %2u, 0x%04X: Ignoring gradual tempo change. Speed 0x40, P2 = 0x%02X.\n", TrackId, CmdOffset, CmdP2);
-                    #endif
+                            RCP_WARNING(CmdOffset, "Track %2u: Ignoring gradual tempo change. Speed 0x40, P2 = 0x%02X.", TrackId, CmdP2);
 
                         if (CmdP1 == 0)
                             CmdP1 = 64;
 
                         uint32_t Ticks = BPM2Ticks(_Tempo, CmdP1);
 
-                    #ifdef _RCP_VERBOSE
-                        ::printf("    %04X: %02X %04X %02X %02X %04X | %08X: Set tempo to %u bpm / %u ticks.\n", CmdOffset, CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), _Tempo, Ticks);
-                    #endif
+                        RCP_TRACE(CmdOffset, "%02X %04X %02X %02X %04X | %08X: Set tempo to %u bpm / %u ticks.", CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), _Tempo, Ticks);
 
                         midiStream.WriteMetaEvent(midi::SetTempo, Ticks, 3u);
                         break;
@@ -970,9 +846,7 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
                         if (PortNumber == 0xFF)
                             break;
 
-                    #ifdef _RCP_VERBOSE
-                        ::printf("    %04X: %02X %04X %02X %02X %04X | %08X: Channel Pressure %02X\n", CmdOffset, CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), CmdP1);
-                    #endif
+                        RCP_TRACE(CmdOffset, "%02X %04X %02X %02X %04X | %08X: Channel Pressure %02X", CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), CmdP1);
 
                         midiStream.WriteEvent(midi::ChannelPressure, CmdP1, 0);
                         break;
@@ -983,9 +857,7 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
                         if (PortNumber == 0xFF)
                             break;
 
-                    #ifdef _RCP_VERBOSE
-                        ::printf("    %04X: %02X %04X %02X %02X %04X | %08X: Control Change %02X %02X\n", CmdOffset, CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), CmdP1, CmdP2);
-                    #endif
+                        RCP_TRACE(CmdOffset, "%02X %04X %02X %02X %04X | %08X: Control Change %02X %02X", CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), CmdP1, CmdP2);
 
                         midiStream.WriteEvent(midi::ControlChange, CmdP1, CmdP2);
                         break;
@@ -998,18 +870,14 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
 
                         if (CmdP1 < 0x80)
                         {
-                        #ifdef _RCP_VERBOSE
-                            ::printf("    %04X: %02X %04X %02X %02X %04X | %08X: Program Change %02X\n", CmdOffset, CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), CmdP1);
-                        #endif
+                            RCP_TRACE(CmdOffset, "%02X %04X %02X %02X %04X | %08X: Program Change %02X", CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), CmdP1);
 
                             midiStream.WriteEvent(midi::ProgramChange, CmdP1, 0);
                         }
                         else
                         if ((CmdP1 < 0xC0) && (ChannelNumber >= 1 && ChannelNumber < 9))
                         {
-                        #ifdef _RCP_VERBOSE
-                            ::printf("    %04X: %02X %04X %02X %02X %04X | %08X: MT-32 instrument change\n", CmdOffset, CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration());
-                        #endif
+                            RCP_TRACE(CmdOffset, "%02X %04X %02X %02X %04X | %08X: MT-32 instrument change", CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration());
 
                             // Set MT-32 instrument from user bank used by RCP files from Granada X68000.
                             uint8_t PartMemOffset = (uint8_t) ((ChannelNumber - 1) << 4);
@@ -1029,9 +897,7 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
                         if (PortNumber == 0xFF)
                             break;
 
-                    #ifdef _RCP_VERBOSE
-                        ::printf("    %04X: %02X %04X %02X %02X %04X | %08X: Key Pressure %02X %02X\n", CmdOffset, CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), CmdP1, CmdP2);
-                    #endif
+                        RCP_TRACE(CmdOffset, "%02X %04X %02X %02X %04X | %08X: Key Pressure %02X %02X", CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), CmdP1, CmdP2);
 
                         midiStream.WriteEvent(midi::KeyPressure, CmdP1, CmdP2);
                         break;
@@ -1042,9 +908,7 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
                         if (PortNumber == 0xFF)
                             break;
 
-                    #ifdef _RCP_VERBOSE
-                        ::printf("    %04X: %02X %04X %02X %02X %04X | %08X: Pitch Bend Change %02X %02X\n", CmdOffset, CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), CmdP1, CmdP2);
-                    #endif
+                        RCP_TRACE(CmdOffset, "%02X %04X %02X %02X %04X | %08X: Pitch Bend Change %02X %02X", CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), CmdP1, CmdP2);
 
                         midiStream.WriteEvent(midi::PitchBendChange, CmdP1, CmdP2);
                         break;
@@ -1054,9 +918,7 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
                     {
                         RCP2MIDIKeySignature((uint8_t) CmdP0, Temp);
 
-                    #ifdef _RCP_VERBOSE
-                        ::printf("    %04X: %02X %04X %02X %02X %04X | %08X: Key Signature %02X %02X\n", CmdOffset, CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), Temp[0], Temp[1]);
-                    #endif
+                        RCP_TRACE(CmdOffset, "%02X %04X %02X %02X %04X | %08X: Key Signature %02X %02X", CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), Temp[0], Temp[1]);
 
                         midiStream.WriteMetaEvent(midi::KeySignature, Temp, 2);
 
@@ -1074,9 +936,7 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
                         Size = ReadMultiCmdData(data, size, &Offset, Text.Data, Text.Size, MCMD_INI_INCLUDE);
                         Size = GetTrimmedLength((char *) Text.Data, Size, ' ', false);
 
-                    #ifdef _RCP_VERBOSE
-                        ::printf("    %04X: %02X %04X %02X %02X %04X | %08X: Meta Data Text \"%s\"\n", CmdOffset, CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), msc::TextToUTF8((const char *) Text.Data, Size).c_str());
-                    #endif
+                        RCP_TRACE(CmdOffset, "%02X %04X %02X %02X %04X | %08X: Meta Data Text \"%s\"", CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration(), msc::TextToUTF8((const char *) Text.Data, Size).c_str());
 
                         midiStream.WriteMetaEvent(midi::Text, Text.Data, Size);
 
@@ -1086,9 +946,7 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
 
                     case 0xF7: // Continuation of previous command
                     {
-                    #ifdef _RCP_VERBOSE
-                        ::printf("Warning: Track %2u, 0x%04X: Unexpected continuation command.\n", TrackId, CmdOffset);
-                    #endif
+                        RCP_WARNING(CmdOffset, "Track %2u: Unexpected continuation command.", TrackId);
                         break;
                     }
 
@@ -1108,9 +966,7 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
                                 // Infinite loop
                                 if ((LoopCounter[LoopIndex] < 0x80) && (PortNumber != 0xFF))
                                 {
-                                #ifdef _RCP_VERBOSE
-                                    ::printf("    %04X: %02X %04X %02X %02X %04X | %08X: Loop Begin (RPG Maker)\n", CmdOffset, CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration());
-                                #endif
+                                    RCP_TRACE(CmdOffset, "%02X %04X %02X %02X %04X | %08X: Loop Begin (RPG Maker)", CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration());
 
                                     midiStream.WriteEvent(midi::ControlChange, 0x6F, (uint8_t) LoopCounter[LoopIndex]); // Set an RPG Maker Loop marker.
                                 }
@@ -1131,6 +987,17 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
                                 midiStream.WriteMetaEvent(midi::CueMarker, Temp, (uint32_t) Length);
                             }
 
+                            if (_Options.SymbolicLoops && TakeLoop)
+                            {
+                                const bool IsInfinite = (CmdP0 == 0 || CmdP0 >= 0x7F);
+                                const uint16_t Count = IsInfinite ? track->LoopCount : CmdP0;
+
+                                if (Time > LoopStartTime[LoopIndex])
+                                    track->Loops.push_back({ 0, LoopStartTime[LoopIndex], Time, Count, IsInfinite });
+
+                                TakeLoop = false;
+                            }
+
                             if (TakeLoop)
                             {
                                 ParentOffs = LoopParentOffs[LoopIndex];
@@ -1141,9 +1008,7 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
                         }
                         else
                         {
-                        #ifdef _RCP_VERBOSE
-                            ::printf("Warning: Track %2u, 0x%04X: Loop End without Loop Start.\n", TrackId, CmdOffset);
-                        #endif
+                            RCP_WARNING(CmdOffset, "Track %2u: Loop End without Loop Start.", TrackId);
 
                             if (_Options.WriteCueMarkers)
                                 midiStream.WriteMetaEvent(midi::CueMarker, "Bad Loop End");
@@ -1166,23 +1031,20 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
                         {
                             if (Offset == track->LoopStartOffs && PortNumber != 0xFF)
                             {
-                            #ifdef _RCP_VERBOSE
-                                ::printf("    %04X: %02X %04X %02X %02X %04X | %08X: Loop Begin (RPG Maker)\n", CmdOffset, CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration());
-                            #endif
+                                RCP_TRACE(CmdOffset, "%02X %04X %02X %02X %04X | %08X: Loop Begin (RPG Maker)", CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration());
 
                                 midiStream.WriteEvent(midi::ControlChange, 0x6F, 0);
                             }
 
                             LoopParentOffs[LoopIndex] = ParentOffs; // required by YS-2･018.RCP
                             LoopStartOffs[LoopIndex] = Offset;
+                            LoopStartTime[LoopIndex] = Time;
                             LoopCounter[LoopIndex] = 0;
 
                             LoopIndex++;
                         }
-                    #ifdef _RCP_VERBOSE
                         else
-                            ::printf("Error: Track %u, 0x%04X: Too many nested loops.\n", TrackId, CmdOffset);
-                    #endif
+                            RCP_ERROR(CmdOffset, "Track %2u: Too many nested loops.", TrackId);
 
                         CmdP0 = 0;
                         break;
@@ -1204,7 +1066,7 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
                             uint16_t BarID = 0;
 
                             uint32_t RepeatOffs = 0;
-                            uint32_t CachedOffs = 0;
+                            [[maybe_unused]] uint32_t CachedOffs = 0;
 
                             do
                             {
@@ -1241,9 +1103,7 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
 
                                 if (BarID >= BarOffsets.size())
                                 {
-                                #ifdef _RCP_VERBOSE
-                                    ::printf("Warning: Track %2u, 0x%04X: Trying to repeat invalid bar %u. Max %u bars.\n", TrackId, CmdOffset, BarID, BarCount + 1);
-                                #endif
+                                    RCP_WARNING(CmdOffset, "Track %2u: Trying to repeat invalid bar %u. Max %u bars.", TrackId, BarID, BarCount + 1);
                                     break;
                                 }
 
@@ -1268,9 +1128,7 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
                         }
                         else
                         {
-                        #ifdef _RCP_VERBOSE
-                            ::printf("Warning: Track %2u, 0x%04X: Leaving recursive repeat bar.\n", TrackId, CmdOffset);
-                        #endif
+                            RCP_WARNING(CmdOffset, "Track %2u: Leaving recursive repeat bar.", TrackId);
                             Offset = ParentOffs;
 
                             ParentOffs = 0x00;
@@ -1317,6 +1175,7 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
 
                             LoopParentOffs[LoopIndex] = ParentOffs;
                             LoopStartOffs[LoopIndex] = Offset;
+                            LoopStartTime[LoopIndex] = Time;
                             LoopCounter[LoopIndex] = 0;
 
                             LoopIndex++;
@@ -1338,11 +1197,15 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
                             {
                                 midiStream.WriteEvent(midi::ControlChange, 0x6F, (uint8_t) LoopCounter[LoopIndex]);
 
-                            #ifdef _RCP_VERBOSE
-                                ::printf("    %04X: %02X %04X %02X %02X %04X | %08X: Loop Begin (RPG Maker)\n", CmdOffset, CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration());
-                            #endif
+                                RCP_TRACE(CmdOffset, "%02X %04X %02X %02X %04X | %08X: Loop Begin (RPG Maker)", CmdType, CmdP0, CmdP1, CmdP2, CmdDuration, midiStream.GetDuration());
                             }
 
+                            if ((LoopCounter[LoopIndex] < _Options.MaxLoopExpansions) && _Options.SymbolicLoops)
+                            {
+                                if (Time > LoopStartTime[LoopIndex])
+                                    track->Loops.push_back({ 0, LoopStartTime[LoopIndex], Time, _Options.MaxLoopExpansions, true });
+                            }
+                            else
                             if (LoopCounter[LoopIndex] < _Options.MaxLoopExpansions)
                             {
                                 ParentOffs = LoopParentOffs[LoopIndex];
@@ -1355,9 +1218,7 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
                     }
 
                     default:
-                    #ifdef _RCP_VERBOSE
-                        ::printf("    %04X: %02X %04X %02X %02X %04X Unknown command\n", CmdOffset, CmdType, CmdP0, CmdP1, CmdP2, CmdDuration);
-                    #endif
+                        RCP_WARNING(CmdOffset, "Track %2u: Unknown command %02X %04X %02X %02X %04X.", TrackId, CmdType, CmdP0, CmdP1, CmdP2, CmdDuration);
                         break;
                 }
             }
@@ -1378,6 +1239,8 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
                         Duration = 0;
                 }
 
+                Time += Duration - midiStream.GetDuration();
+
                 midiStream.SetDuration(Duration);
             }
         }
@@ -1386,9 +1249,42 @@ void rcp_file_t::ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * of
     if (PortNumber == 0xFF)
         midiStream.SetDuration(0);
 
-    midiStream.SetDuration(RunningNotes.Flush(midiStream, false));
+    midiStream.SetDuration(runningNotes.Flush(midiStream, midiStream.GetDuration(), false));
+}
+
+/// <summary>
+/// Gets the offset of the track that follows the track at the specified offset. Returns the specified offset if the track header is incomplete because ConvertTrack() fails on it.
+/// </summary>
+uint32_t rcp_file_t::GetNextTrackOffset(const uint8_t * data, uint32_t size, uint32_t offset) const noexcept
+{
+    if (offset >= size)
+        return offset;
+
+    const uint32_t SizeFieldSize = (_Version == 2) ? 2u : ((_Version == 3) ? 4u : 0u);
+
+    if (offset + SizeFieldSize + 0x2A > size)
+        return offset;
+
+    return offset + ReadTrackSize(data, offset);
+}
+
+/// <summary>
+/// Reads the size of the track at the specified offset.
+/// </summary>
+uint32_t rcp_file_t::ReadTrackSize(const uint8_t * data, uint32_t offset) const noexcept
+{
+    if (_Version == 2)
+    {
+        const uint32_t TrackSize = ReadLE16(&data[offset]);
+
+        // Bits 0/1 are used as 16/17, allowing for up to 256 KB per track. This is used by some ItoR.x conversions.
+        return (TrackSize & ~0x03u) | ((TrackSize & 0x03u) << 16);
+    }
+
+    if (_Version == 3)
+        return ReadLE32(&data[offset]);
 
-    *offset = TrackHead + TrackSize;
+    return 0;
 }
 
 /// <summary>
@@ -1557,9 +1453,7 @@ static uint16_t ConvertRCPSysExToMIDISysEx(const uint8_t * srcData, uint16_t src
                     return n;
 
                 default:
-                #ifdef _RCP_VERBOSE
-                    ::printf("Warning: Unknown SysEx command 0x%02X found in SysEx data.\n", Data);
-                #endif
+                    RCP_WARNING(midi::diagnostic_t::None, "Unknown SysEx command 0x%02X found in SysEx data.", Data);
                     break;
             }
         }
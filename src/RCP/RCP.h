@@ -1,13 +1,16 @@
 
-/** $VER: RCP.h (2025.06.09) P. Stuer - Based on Valley Bell's rpc2mid (https://github.com/ValleyBell/MidiConverters). **/
+/** $VER: RCP.h (2026.10.19) P. Stuer - Based on Valley Bell's rpc2mid (https://github.com/ValleyBell/MidiConverters). **/
 
 #pragma once
 
 #include "pch.h"
 
 #include "MIDIStream.h"
+#include "SysExBuilder.h"
 #include "Support.h"
 
+#include <RunningNotes.h>
+
 namespace rcp
 {
 
@@ -21,6 +24,10 @@ struct rcp_options_t
     bool WolfteamLoopMode = false;
     bool IgnoreMutedTracks = true;
     bool IncludeControlData = true;
+    bool PreallocateOutput = true;      // Sizes the output buffer from the track parse pass so that the conversion needs a single allocation.
+    bool SymbolicLoops = false;         // Writes each loop body once and records the loop in rcp_track_t::Loops instead of repeating it.
+    bool CacheControlFiles = true;      // Shares the CM6 and GSD control files and the SysEx events generated from them between conversions.
+    bool ParallelTracks = false;        // Converts the tracks with midi::ForEach().
 };
 
 class rcp_string_t
@@ -73,6 +80,18 @@ public:
     uint32_t Size;
 };
 
+/// <summary>
+/// Represents a loop that was written once instead of being repeated.
+/// </summary>
+struct rcp_loop_t
+{
+    uint32_t TrackIndex;    // Index of the MIDI track
+    uint32_t Begin;         // Timestamp of the first tick of the loop body (in ticks)
+    uint32_t End;           // Timestamp of the first tick after the loop body (in ticks)
+    uint16_t Count;         // Number of passes through the loop body
+    bool IsInfinite;
+};
+
 class rcp_track_t
 {
 public:
@@ -83,6 +102,20 @@ public:
     uint32_t LoopStartOffs; // Offset of the start of the loop
     uint32_t LoopStartTick; // Tick of the start of the loop
     uint16_t LoopCount;     // Number of loops
+
+    uint32_t OutputSize;    // Estimated size of the MIDI output of one pass through the track (in bytes)
+    uint32_t LoopOutputSize;// Estimated size of the MIDI output of one pass through the loop (in bytes)
+
+    std::vector<rcp_loop_t> Loops; // Loops that were not repeated (Symbolic loop mode only)
+};
+
+/// <summary>
+/// Holds the conversion state of a MIDI track. Each track has its own state so that tracks can be converted concurrently.
+/// </summary>
+struct track_state_t
+{
+    midi::running_notes_t RunningNotes;
+    uint32_t TickCount = 0;             // Number of ticks written to the track
 };
 
 class rcp_file_t
@@ -107,9 +140,11 @@ public:
     rcp_file_t & operator=(rcp_file_t &&) = delete;
 
     void ParseTrack(const uint8_t * data, uint32_t size, uint32_t offset, rcp_track_t * track) const;
-    void ConvertTrack(const uint8_t * data, uint32_t size, uint32_t * offset, rcp_track_t * track, midi_stream_t & midiStream) const;
+    void ConvertTrack(const uint8_t * data, uint32_t size, uint32_t offset, rcp_track_t * track, midi_stream_t & midiStream, midi::running_notes_t & runningNotes) const;
+    uint32_t GetNextTrackOffset(const uint8_t * data, uint32_t size, uint32_t offset) const noexcept;
 
 private:
+    uint32_t ReadTrackSize(const uint8_t * data, uint32_t offset) const noexcept;
     uint16_t GetMultiCmdDataSize(const uint8_t * data, uint32_t size, uint32_t offset, uint8_t flags) const;
     uint16_t ReadMultiCmdData(const uint8_t * srcData, uint32_t srcSize, uint32_t * srcOffset, uint8_t * dstData, uint32_t dstSize, uint8_t flags) const;
 
@@ -207,6 +242,8 @@ private:
     buffer_t _Data;
 };
 
+class control_file_t;
+
 class converter_t
 {
 public:
@@ -217,19 +254,27 @@ public:
     void ConvertSequence(const buffer_t & rcpData, buffer_t & midData);
     void ConvertControl(const buffer_t & rcpData, buffer_t & midData, uint8_t fileType, uint8_t outMode);
 
-    void Convert(const cm6_file_t & cm6File, midi_stream_t & midiStream, uint8_t mode);
-    void Convert(const gsd_file_t & gsdFile, midi_stream_t & midiStream, uint8_t mode);
+    void Convert(const cm6_file_t & cm6File, sysex_builder_t & builder, uint8_t mode);
+    void Convert(const gsd_file_t & gsdFile, sysex_builder_t & builder, uint8_t mode);
 
     static uint8_t GetFileType(const buffer_t & rcpData) noexcept;
 
+    const std::vector<rcp_loop_t> & GetLoops() const noexcept { return _Loops; }
+
 private:
     static uint16_t BalanceTrackTimes(std::vector<rcp_track_t> & rcpTracks, uint32_t minLoopTicks, uint8_t verbose);
-    static uint8_t HandleDuration(midi_stream_t * fileInfo, uint32_t & duration);
+    static uint8_t HandleDuration(midi_stream_t * midiStream, uint32_t & duration, void * context);
+
+    std::shared_ptr<const control_file_t> ReadControlFile(const std::wstring & filePath, uint8_t fileType) const;
+    void WriteControlEvents(const control_file_t & controlFile, midi_stream_t & midiStream, track_state_t & state);
 
 public:
     rcp_options_t _Options;
 
     std::wstring _FilePath;
+
+private:
+    std::vector<rcp_loop_t> _Loops;
 };
 
 const uint8_t SysExHeaderMT32[] = { 0x41, 0x10, 0x16, 0x12 };
@@ -1,18 +1,16 @@
 
-/** $VER: RCPConverter.cpp (2025.06.09) P. Stuer - Based on Valley Bell's rpc2mid (https://github.com/ValleyBell/MidiConverters). **/
+/** $VER: RCPConverter.cpp (2026.10.19) P. Stuer - Based on Valley Bell's rpc2mid (https://github.com/ValleyBell/MidiConverters). **/
 
 #include "pch.h"
 
 #include "RCP.h"
-#include "RunningNotes.h"
+#include "ControlFileCache.h"
+
+#include <Parallel.h>
 
 namespace rcp
 {
 
-uint32_t _MIDITickCount = 0;
-
-running_notes_t RunningNotes;
-
 /// <summary>
 /// Converts the RCP data.
 /// </summary>
@@ -69,9 +67,7 @@ void converter_t::ConvertSequence(const buffer_t & rcpData, buffer_t & midData)
     if (RCPFile._Version >= 0x10)
         throw std::runtime_error("Unknown RCP file type");
 
-#ifdef _RCP_VERBOSE
-    ::printf("RCP version %u\n\n", RCPFile._Version);
-#endif
+    RCP_TRACE(0, "RCP version %u", RCPFile._Version);
 
     uint32_t Offset = 0;
 
@@ -152,9 +148,7 @@ void converter_t::ConvertSequence(const buffer_t & rcpData, buffer_t & midData)
         {
             if (TrackOffset >= rcpData.Size)
             {
-            #ifdef _RCP_VERBOSE
-                ::printf("%04X: Warning: Insufficient track data.\n", TrackOffset);
-            #endif
+                RCP_WARNING(TrackOffset, "Insufficient track data.");
 
                 RCPFile._TrackCount = n;
                 RCPTracks.resize(n);
@@ -175,38 +169,29 @@ void converter_t::ConvertSequence(const buffer_t & rcpData, buffer_t & midData)
 
     uint8_t ControlTrackCount = 0; // Number of tracks that contain control sequences.
 
-    cm6_file_t CM6File;
-    gsd_file_t GSD1File;
-    gsd_file_t GSD2File;
+    std::shared_ptr<const control_file_t> CM6File;
+    std::shared_ptr<const control_file_t> GSD1File;
+    std::shared_ptr<const control_file_t> GSD2File;
 
     if (_Options.IncludeControlData)
     {
-        wchar_t FilePath[260];
+        // The control files are located in the directory of the RCP file.
+        std::wstring DirectoryPath = _FilePath.substr(0, (size_t) (GetFileName(_FilePath.c_str()) - _FilePath.c_str()));
 
-        ::wcscpy_s(FilePath, _countof(FilePath), _FilePath.c_str());
-
-        wchar_t * FileName = (wchar_t *) GetFileName(FilePath); *FileName = '\0';
-
-        char FileNameA[260];
+        auto GetFilePath = [&DirectoryPath](const rcp_string_t & fileName) -> std::wstring
+        {
+            return DirectoryPath + msc::UTF8ToWide(std::string(fileName.Data, fileName.Len));
+        };
 
         // Roland MT-32 / Roland CM-64 (Combines the CM-32L and CM-32P)
         if (RCPFile._CM6FileName.Len > 0)
         {
-            ::memcpy(FileNameA, RCPFile._CM6FileName.Data, RCPFile._CM6FileName.Len), FileNameA[RCPFile._CM6FileName.Len] = '\0';
-
-            ::wcscat_s(FilePath, _countof(FilePath), msc::UTF8ToWide(FileNameA).c_str());
-
-            buffer_t CM6Data;
-
             try
             {
-                CM6Data.ReadFile(FilePath);
+                CM6File = ReadControlFile(GetFilePath(RCPFile._CM6FileName), 0x10);
 
-                CM6File.Read(CM6Data);
+                RCP_INFO(midi::diagnostic_t::None, "Using CM6 %s control file \"%.*s\".", (CM6File->CM6File.DeviceType ? "CM-64" : "MT-32"), RCPFile._CM6FileName.Len, RCPFile._CM6FileName.Data);
 
-                #ifdef _RCP_VERBOSE
-                ::wprintf(L"Using CM6 %s control file \"%.*hs\".\n", (CM6File.DeviceType ? L"CM-64" : L"MT-32"), RCPFile._CM6FileName.Len, RCPFile._CM6FileName.Data);
-                #endif
                 ControlTrackCount++;
             }
             catch (std::exception & e)
@@ -218,21 +203,12 @@ void converter_t::ConvertSequence(const buffer_t & rcpData, buffer_t & midData)
         // Roland SC-55
         if (RCPFile._GSD1FileName.Len > 0)
         {
-            ::memcpy(FileNameA, RCPFile._GSD1FileName.Data, RCPFile._GSD1FileName.Len), FileNameA[RCPFile._GSD1FileName.Len] = '\0';
-
-            ::wcscat_s(FilePath, _countof(FilePath), msc::UTF8ToWide(FileNameA).c_str());
-
-            buffer_t GSDData;
-
             try
             {
-                GSDData.ReadFile(FilePath);
+                GSD1File = ReadControlFile(GetFilePath(RCPFile._GSD1FileName), 0x11);
 
-                GSD1File.Read(GSDData);
+                RCP_INFO(midi::diagnostic_t::None, "Using GSD control file \"%.*s\".", RCPFile._GSD1FileName.Len, RCPFile._GSD1FileName.Data);
 
-                #ifdef _RCP_VERBOSE
-                ::printf("Using GSD control file \"%.*hs\".\n", RCPFile._GSD1FileName.Len, RCPFile._GSD1FileName.Data);
-                #endif
                 ControlTrackCount++;
             }
             catch (std::exception & e)
@@ -244,21 +220,12 @@ void converter_t::ConvertSequence(const buffer_t & rcpData, buffer_t & midData)
         // Roland SC-55
         if (RCPFile._GSD2FileName.Len > 0)
         {
-            ::memcpy(FileName, RCPFile._GSD2FileName.Data, RCPFile._GSD2FileName.Len), FileName[RCPFile._GSD2FileName.Len] = '\0';
-
-            ::wcscat_s(FilePath, _countof(FilePath), msc::UTF8ToWide(FileNameA).c_str());
-
-            buffer_t GSDData;
-
             try
             {
-                GSDData.ReadFile(FilePath);
+                GSD2File = ReadControlFile(GetFilePath(RCPFile._GSD2FileName), 0x11);
 
-                GSD2File.Read(GSDData);
+                RCP_INFO(midi::diagnostic_t::None, "Using GSD control file \"%.*s\" for port B.", RCPFile._GSD2FileName.Len, RCPFile._GSD2FileName.Data);
 
-                #ifdef _RCP_VERBOSE
-                ::printf("Using GSD control file \"%.*hs\" for port B.\n", RCPFile._GSD2FileName.Len, RCPFile._GSD2FileName.Data);
-                #endif
                 ControlTrackCount++;
             }
             catch (std::exception & e)
@@ -268,13 +235,21 @@ void converter_t::ConvertSequence(const buffer_t & rcpData, buffer_t & midData)
         }
     }
 
-    #ifdef _RCP_VERBOSE
-    ::puts("Converting...");
-    #endif
+    uint32_t OutputSize = 0x20000; // 128 KB
+
+    if (_Options.PreallocateOutput)
+    {
+        OutputSize = 0x0E + 0x400 + (uint32_t) ControlTrackCount * 0x8000; // Header, conductor track and control data
+
+        for (const auto & Track : RCPTracks)
+            OutputSize += 0x08 + 0x04 + Track.OutputSize + Track.LoopOutputSize * Track.LoopCount;
+    }
+
+    midi_stream_t MIDIStream(OutputSize);
 
-    midi_stream_t MIDIStream(0x20000);
+    track_state_t State; // State of the conductor and the control tracks
 
-    MIDIStream.SetDurationHandler(HandleDuration);
+    MIDIStream.SetDurationHandler(HandleDuration, &State);
 
     // Write the MIDI header.
     MIDIStream.WriteMIDIHeader(1, (uint16_t) (1 + ControlTrackCount + RCPFile._TrackCount), RCPFile._TicksPerQuarter);
@@ -283,9 +258,9 @@ void converter_t::ConvertSequence(const buffer_t & rcpData, buffer_t & midData)
 
     // Write the conductor track.
     {
-        ::puts("Creating conductor track...");
+        RCP_TRACE(midi::diagnostic_t::None, "Creating conductor track.");
 
-        _MIDITickCount = 0;
+        State.TickCount = 0;
 
         MIDIStream.BeginWriteMIDITrack();
 
@@ -315,9 +290,7 @@ void converter_t::ConvertSequence(const buffer_t & rcpData, buffer_t & midData)
             MIDIStream.SetTempo(Tempo);
             MIDIStream.WriteMetaEvent(midi::SetTempo, Tempo, 3);
 
-            #ifdef _RCP_VERBOSE
-            ::printf("Tempo: %u bpm, %u ticks.\n", RCPFile._Tempo, Tempo);
-            #endif
+            RCP_TRACE(midi::diagnostic_t::None, "Tempo: %u bpm, %u ticks.", RCPFile._Tempo, Tempo);
         }
 
         if (RCPFile._BPMNumerator > 0) // time signature being 0/0 happened in AB_AFT32.RCP
@@ -326,9 +299,7 @@ void converter_t::ConvertSequence(const buffer_t & rcpData, buffer_t & midData)
 
             MIDIStream.WriteMetaEvent(midi::TimeSignature, Temp, 4);
 
-            #ifdef _RCP_VERBOSE
-            ::printf("Time signature: %u/%u.\n", RCPFile._BPMNumerator, RCPFile._BPMDenominator);
-            #endif
+            RCP_TRACE(midi::diagnostic_t::None, "Time signature: %u/%u.", RCPFile._BPMNumerator, RCPFile._BPMDenominator);
         }
 
         {
@@ -336,9 +307,7 @@ void converter_t::ConvertSequence(const buffer_t & rcpData, buffer_t & midData)
 
             MIDIStream.WriteMetaEvent(midi::KeySignature, Temp, 2);
 
-            #ifdef _RCP_VERBOSE
-            ::printf("Key signature: %u.\n", RCPFile._KeySignature);
-            #endif
+            RCP_TRACE(midi::diagnostic_t::None, "Key signature: %u.", RCPFile._KeySignature);
         }
 
         MIDIStream.WriteEvent(midi::MetaData, midi::EndOfTrack, 0);
@@ -350,9 +319,9 @@ void converter_t::ConvertSequence(const buffer_t & rcpData, buffer_t & midData)
 
     if (ControlTrackCount > 0)
     {
-        if (RCPFile._CM6FileName.Len > 0)
+        if (CM6File != nullptr)
         {
-            _MIDITickCount = 0;
+            State.TickCount = 0;
 
             MIDIStream.BeginWriteMIDITrack();
 
@@ -369,18 +338,18 @@ void converter_t::ConvertSequence(const buffer_t & rcpData, buffer_t & midData)
                 MIDIStream.SetDuration(Timestamp);
             }
 
-            Convert(CM6File, MIDIStream, 0x11);
+            WriteControlEvents(*CM6File, MIDIStream, State);
 
-            RunningTime += _MIDITickCount;
+            RunningTime += State.TickCount;
 
             MIDIStream.WriteEvent(midi::MetaData, midi::EndOfTrack, 0);
 
             MIDIStream.EndWriteMIDITrack();
         }
 
-        if (RCPFile._GSD1FileName.Len > 0)
+        if (GSD1File != nullptr)
         {
-            _MIDITickCount = 0;
+            State.TickCount = 0;
 
             MIDIStream.BeginWriteMIDITrack();
 
@@ -392,18 +361,18 @@ void converter_t::ConvertSequence(const buffer_t & rcpData, buffer_t & midData)
                 MIDIStream.WriteMetaEvent(midi::MIDIPort, Temp, 1);
             }
 
-            Convert(GSD1File, MIDIStream, 0x11);
+            WriteControlEvents(*GSD1File, MIDIStream, State);
 
-            RunningTime += _MIDITickCount;
+            RunningTime += State.TickCount;
 
             MIDIStream.WriteEvent(midi::MetaData, midi::EndOfTrack, 0);
 
             MIDIStream.EndWriteMIDITrack();
         }
 
-        if (RCPFile._GSD2FileName.Len > 0)
+        if (GSD2File != nullptr)
         {
-            _MIDITickCount = 0;
+            State.TickCount = 0;
 
             MIDIStream.BeginWriteMIDITrack();
 
@@ -412,9 +381,9 @@ void converter_t::ConvertSequence(const buffer_t & rcpData, buffer_t & midData)
             Temp[0] = 0x01; // Port B
             MIDIStream.WriteMetaEvent(midi::MIDIPort, Temp, 1);
 
-            Convert(GSD2File, MIDIStream, 0x11);
+            WriteControlEvents(*GSD2File, MIDIStream, State);
 
-            RunningTime += _MIDITickCount;
+            RunningTime += State.TickCount;
 
             MIDIStream.WriteEvent(midi::MetaData, midi::EndOfTrack, 0);
 
@@ -437,19 +406,7 @@ void converter_t::ConvertSequence(const buffer_t & rcpData, buffer_t & midData)
 
             Offset += DataSize;
 
-        #ifdef _RCP_VERBOSE
-            ::printf("%04X: User SysEx \"%s\",", SyxOffset, msc::TextToUTF8(SysEx.Name.Data, SysEx.Name.Len).c_str());
-
-            if (SysEx.Size != 0)
-            {
-                for (size_t i = 0; i < SysEx.Size; ++i)
-                    ::printf(" %02X", SysEx.Data[i]);
-
-                ::putchar('\n');
-            }
-            else
-                ::puts(" Empty");
-        #endif
+            RCP_TRACE(SyxOffset, "User SysEx \"%s\", %s", msc::TextToUTF8(SysEx.Name.Data, SysEx.Name.Len).c_str(), (SysEx.Size != 0) ? FormatBytes(SysEx.Data, SysEx.Size).c_str() : "Empty");
         }
     }
 
@@ -465,46 +422,94 @@ void converter_t::ConvertSequence(const buffer_t & rcpData, buffer_t & midData)
         // Round the initial timestamp up to a full bar.
         RunningTime = (RunningTime + TicksPerBar - 1) / TicksPerBar * TicksPerBar;
 
-    #ifdef _RCP_VERBOSE
-        ::printf("Initial timestamp: %u ticks (%u bars)\n", RunningTime, RunningTime / TicksPerBar);
-    #endif
+        RCP_TRACE(midi::diagnostic_t::None, "Initial timestamp: %u ticks (%u bars)", RunningTime, RunningTime / TicksPerBar);
     }
-    #ifdef _RCP_VERBOSE
     else
-        ::printf("Initial timestamp: %u ticks\n", RunningTime);
-    #endif
+        RCP_TRACE(midi::diagnostic_t::None, "Initial timestamp: %u ticks", RunningTime);
 
-    for (auto & RCPTrack : RCPTracks)
+    // The tracks are independent once their offsets are known. Convert each track into its own stream and splice the streams in track order.
+    struct track_output_t
     {
-        _MIDITickCount = 0;
+        midi_stream_t MIDIStream;
+        track_state_t State;
+        std::exception_ptr Exception;
+    };
 
-        MIDIStream.BeginWriteMIDITrack();
+    // These are the offsets that a sequential conversion reaches. ConvertTrack() only throws when a track header is incomplete and leaves the offset unchanged, as does GetNextTrackOffset().
+    // The parse pass above already rejects files with an incomplete header so all tracks that get here start at the end of the previous track, even in a truncated file.
+    std::vector<uint32_t> TrackOffsets(RCPTracks.size());
 
-        MIDIStream.SetDuration(RunningTime);
+    for (auto & TrackOffset : TrackOffsets)
+    {
+        TrackOffset = Offset;
+
+        Offset = RCPFile.GetNextTrackOffset(rcpData.Data, rcpData.Size, Offset);
+    }
+
+    std::vector<track_output_t> Outputs(RCPTracks.size());
+
+    midi::ForEach(RCPTracks.size(), _Options.ParallelTracks, [&](size_t i)
+    {
+        auto & RCPTrack = RCPTracks[i];
+        auto & Output = Outputs[i];
 
         try
         {
-            RCPFile.ConvertTrack(rcpData.Data, rcpData.Size, &Offset, &RCPTrack, MIDIStream);
+            Output.MIDIStream.SetTicksPerQuarter(MIDIStream.GetTicksPerQuarter());
+            Output.MIDIStream.SetTempo(MIDIStream.GetTempo());
+            Output.MIDIStream.SetDurationHandler(HandleDuration, &Output.State);
+
+            if (_Options.PreallocateOutput)
+                Output.MIDIStream.Ensure(0x04 + RCPTrack.OutputSize + RCPTrack.LoopOutputSize * RCPTrack.LoopCount);
+
+            Output.MIDIStream.SetDuration(RunningTime);
+
+            try
+            {
+                RCPFile.ConvertTrack(rcpData.Data, rcpData.Size, TrackOffsets[i], &RCPTrack, Output.MIDIStream, Output.State.RunningNotes);
+            }
+            catch (std::exception &)
+            {
+            // Assume that early EOF is not an error.
+                RCP_WARNING(RCPTrack.Offs, "Early end-of-track.");
+            }
+
+            Output.MIDIStream.WriteEvent(midi::MetaData, midi::EndOfTrack, 0);
         }
-        catch (std::exception &)
+        catch (...)
         {
-        // Assume that early EOF is not an error.
-        #ifdef _RCP_VERBOSE
-            ::puts("Warning: Early end-of-track.");
-        #endif
+            Output.Exception = std::current_exception();
         }
+    });
 
-        MIDIStream.WriteEvent(midi::MetaData, midi::EndOfTrack, 0);
+    _Loops.clear();
+
+    uint32_t TrackIndex = 1u + ControlTrackCount;
+
+    for (size_t i = 0; i < RCPTracks.size(); ++i)
+    {
+        const auto & Output = Outputs[i];
+
+        if (Output.Exception != nullptr)
+            std::rethrow_exception(Output.Exception);
+
+        MIDIStream.BeginWriteMIDITrack();
+
+        MIDIStream.Write(Output.MIDIStream.GetData(), Output.MIDIStream.GetOffs());
 
         MIDIStream.EndWriteMIDITrack();
-    }
 
-    midData.Copy(MIDIStream.GetData(), MIDIStream.GetOffs());
+        for (auto & Loop : RCPTracks[i].Loops)
+        {
+            Loop.TrackIndex = TrackIndex;
 
-    MIDIStream.Reset();
-    MIDIStream.WriteMIDIHeader(1, (uint16_t) (1 + ControlTrackCount + RCPFile._TrackCount), RCPFile._TicksPerQuarter);
+            _Loops.push_back(Loop);
+        }
 
-    ::puts("Done.");
+        ++TrackIndex;
+    }
+
+    midData.Copy(MIDIStream.GetData(), MIDIStream.GetOffs());
 }
 
 /// <summary>
@@ -519,48 +524,48 @@ void converter_t::ConvertControl(const buffer_t & ctrlData, buffer_t & midiData,
     {
         CM6File.Read(ctrlData);
 
-    #ifdef _RCP_VERBOSE
-        ::printf("CM6 control file, %s mode.\n", CM6File.DeviceType ? "CM-64" : "MT-32");
-    #endif
+        RCP_TRACE(midi::diagnostic_t::None, "CM6 control file, %s mode.", CM6File.DeviceType ? "CM-64" : "MT-32");
     }
     else
     if (fileType == 0x11)
     {
         GSDFile.Read(ctrlData);
 
-    #ifdef _RCP_VERBOSE
-        ::printf("GSD control file\n");
-    #endif
+        RCP_TRACE(midi::diagnostic_t::None, "GSD control file");
     }
     else
         throw std::runtime_error("Unknown file type");
 
     midi_stream_t MIDIFile(0x10000);
 
-    if (outMode & 0x01) // MIDI mode
+    auto WriteEvents = [&]()
     {
-        _MIDITickCount = 0;
+        sysex_builder_t Builder(MIDIFile.GetTicksPerQuarter(), MIDIFile.GetTempo());
 
+        if (fileType == 0x10)
+            Convert(CM6File, Builder, outMode);
+        else
+            Convert(GSDFile, Builder, outMode);
+
+        Builder.Finalize();
+
+        MIDIFile.WriteEvents(Builder.GetData().data(), (uint32_t) Builder.GetData().size(), Builder.GetDuration());
+    };
+
+    if (outMode & 0x01) // MIDI mode
+    {
         MIDIFile.WriteMIDIHeader(1, 1, 48);
 
         MIDIFile.BeginWriteMIDITrack();
 
-        if (fileType == 0x10)
-            Convert(CM6File, MIDIFile, outMode);
-        else
-            Convert(GSDFile, MIDIFile, outMode);
+        WriteEvents();
 
         MIDIFile.WriteEvent(midi::MetaData, midi::EndOfTrack, 0);
 
         MIDIFile.EndWriteMIDITrack();
     }
     else
-    {
-        if (fileType == 0x10)
-            Convert(CM6File, MIDIFile, outMode);
-        else
-            Convert(GSDFile, MIDIFile, outMode);
-    }
+        WriteEvents();
 
     midiData.Copy(MIDIFile.GetData(), MIDIFile.GetOffs());
 }
@@ -603,10 +608,8 @@ uint16_t converter_t::BalanceTrackTimes(std::vector<rcp_track_t> & rcpTracks, ui
         // Ignore tracks with very short loops.
         if (LoopTicks < minLoopTicks)
         {
-            #ifdef _RCP_VERBOSE
             if (LoopTicks > 0 && (verbose & 0x02))
-                ::printf("Track %u: Ignoring micro-loop (%u ticks).\n", i, LoopTicks);
-            #endif
+                RCP_INFO(midi::diagnostic_t::None, "Track %u: Ignoring micro-loop (%u ticks).", i, LoopTicks);
             continue;
         }
 
@@ -619,10 +622,8 @@ uint16_t converter_t::BalanceTrackTimes(std::vector<rcp_track_t> & rcpTracks, ui
             RCPTrack.LoopCount = (uint16_t)((Duration + LoopTicks / 3) / LoopTicks);
             adjustCnt++;
 
-            #ifdef _RCP_VERBOSE
             if (verbose & 0x01)
-                ::printf("Track %u: Extended loop to %u times.\n", i, RCPTrack.LoopCount);
-            #endif
+                RCP_INFO(midi::diagnostic_t::None, "Track %u: Extended loop to %u times.", i, RCPTrack.LoopCount);
         }
 
         ++i;
@@ -660,25 +661,68 @@ uint8_t converter_t::GetFileType(const buffer_t & rcpData) noexcept
 }
 
 /// <summary>
-/// 
+/// Inserts the Note Off events of the running notes of the track before a timestamp is written.
+/// </summary>
+uint8_t converter_t::HandleDuration(midi_stream_t * midiStream, uint32_t & duration, void * context)
+{
+    auto * State = (track_state_t *) context;
+
+    State->TickCount += duration;
+
+    State->RunningNotes.Check(*midiStream, duration);
+
+    State->RunningNotes.Advance(duration);
+
+    return 0;
+}
+
+/// <summary>
+/// Reads a control file, from the cache if enabled.
 /// </summary>
-uint8_t converter_t::HandleDuration(midi_stream_t * midiStream, uint32_t & duration)
+std::shared_ptr<const control_file_t> converter_t::ReadControlFile(const std::wstring & filePath, uint8_t fileType) const
 {
-    _MIDITickCount += duration;
+    if (_Options.CacheControlFiles)
+        return control_file_cache_t::GetInstance().Get(filePath, fileType);
+
+    auto File = std::make_shared<control_file_t>();
 
-    RunningNotes.Check(*midiStream, duration);
+    File->Read(filePath, fileType);
 
-    if (duration != 0)
+    return File;
+}
+
+/// <summary>
+/// Writes the SysEx events of a control file. The events are generated once per time base and reused by later conversions.
+/// </summary>
+void converter_t::WriteControlEvents(const control_file_t & controlFile, midi_stream_t & midiStream, track_state_t & state)
+{
+    auto Events = controlFile.GetEvents(midiStream.GetTicksPerQuarter(), midiStream.GetTempo());
+
+    if (Events == nullptr)
     {
-        for (uint16_t i = 0; i < RunningNotes._Count; ++i)
-        {
-            assert(RunningNotes._Notes[i].DeltaTime > duration);
+        sysex_builder_t Builder(midiStream.GetTicksPerQuarter(), midiStream.GetTempo());
 
-            RunningNotes._Notes[i].DeltaTime -= duration;
-        }
+        if (controlFile.Type == 0x10)
+            Convert(controlFile.CM6File, Builder, 0x11);
+        else
+            Convert(controlFile.GSDFile, Builder, 0x11);
+
+        Builder.Finalize();
+
+        auto NewEvents = std::make_shared<control_events_t>();
+
+        NewEvents->TicksPerQuarter = midiStream.GetTicksPerQuarter();
+        NewEvents->Tempo = midiStream.GetTempo();
+        NewEvents->Data = Builder.GetData();
+        NewEvents->Ticks = Builder.GetTicks();
+        NewEvents->Duration = Builder.GetDuration();
+
+        Events = controlFile.AddEvents(NewEvents);
     }
 
-    return 0;
+    midiStream.WriteEvents(Events->Data.data(), (uint32_t) Events->Data.size(), Events->Duration);
+
+    state.TickCount += Events->Ticks;
 }
 
 }
@@ -1,5 +1,5 @@
 
-/** $VER: Support.cpp (2025.03.21) P. Stuer - Based on Valley Bell's rpc2mid (https://github.com/ValleyBell/MidiConverters). **/
+/** $VER: Support.cpp (2026.10.19) P. Stuer - Based on Valley Bell's rpc2mid (https://github.com/ValleyBell/MidiConverters). **/
 
 #include "pch.h"
 
@@ -55,4 +55,27 @@ const wchar_t * GetFileName(const wchar_t * filePath)
     return (Sep1 != nullptr) ? (Sep1 + 1) : filePath;
 }
 
+/// <summary>
+/// Formats data as a list of hexadecimal bytes.
+/// </summary>
+std::string FormatBytes(const uint8_t * data, size_t size)
+{
+    static const char Digits[] = "0123456789ABCDEF";
+
+    std::string Text;
+
+    Text.reserve(size * 3);
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (i != 0)
+            Text += ' ';
+
+        Text += Digits[data[i] >> 4];
+        Text += Digits[data[i] & 0x0F];
+    }
+
+    return Text;
+}
+
 }
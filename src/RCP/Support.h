@@ -1,11 +1,12 @@
 
-/** $VER: Support.h (2025.03.21) P. Stuer - Based on Valley Bell's rpc2mid (https://github.com/ValleyBell/MidiConverters). **/
+/** $VER: Support.h (2026.10.19) P. Stuer - Based on Valley Bell's rpc2mid (https://github.com/ValleyBell/MidiConverters). **/
 
 #pragma once
 
 #include "pch.h"
 
 #include "MIDI.h"
+#include "Diagnostics.h"
 
 namespace rcp
 {
@@ -17,6 +18,13 @@ uint32_t BPM2Ticks(uint16_t bpm, uint8_t scale);
 
 const wchar_t * GetFileName(const wchar_t * filePath);
 
+std::string FormatBytes(const uint8_t * data, size_t size);
+
+#define RCP_TRACE(offset, ...)      MIDI_DIAGNOSTIC(midi::severity_t::Trace,   "RCP", {}, (size_t) (offset), midi::diagnostic_t::None, __VA_ARGS__)
+#define RCP_INFO(offset, ...)       MIDI_DIAGNOSTIC(midi::severity_t::Info,    "RCP", {}, (size_t) (offset), midi::diagnostic_t::None, __VA_ARGS__)
+#define RCP_WARNING(offset, ...)    MIDI_DIAGNOSTIC(midi::severity_t::Warning, "RCP", {}, (size_t) (offset), midi::diagnostic_t::None, __VA_ARGS__)
+#define RCP_ERROR(offset, ...)      MIDI_DIAGNOSTIC(midi::severity_t::Error,   "RCP", {}, (size_t) (offset), midi::diagnostic_t::None, __VA_ARGS__)
+
 struct buffer_t
 {
     uint8_t * Data;
@@ -0,0 +1,150 @@
+
+/** $VER: SysExBuilder.cpp (2026.10.19) P. Stuer **/
+
+#include "pch.h"
+
+#include "SysExBuilder.h"
+#include "MIDIStream.h"
+#include "Support.h"
+
+namespace rcp
+{
+
+/// <summary>
+/// Writes a text meta event.
+/// </summary>
+void sysex_builder_t::WriteMetaEvent(midi::MetaDataType type, const char * text)
+{
+    WriteMetaEvent(type, text, (uint32_t) ::strlen(text));
+}
+
+/// <summary>
+/// Writes a text meta event.
+/// </summary>
+void sysex_builder_t::WriteMetaEvent(midi::MetaDataType type, const char * text, uint32_t size)
+{
+    WriteTimestamp();
+
+    _Data.push_back(midi::StatusCode::MetaData);
+    _Data.push_back((uint8_t) type);
+
+    WriteVariableLengthQuantity(size);
+
+    _Data.insert(_Data.end(), (const uint8_t *) text, (const uint8_t *) text + size);
+}
+
+/// <summary>
+/// Writes a Roland SysEx message in chunks.
+/// </summary>
+void sysex_builder_t::WriteRolandSysEx(const uint8_t * syxHdr, uint32_t address, const uint8_t * data, uint32_t size, uint8_t opts, uint32_t blockSize)
+{
+    uint32_t Data = ((address & 0x00007F) >> 0) | ((address & 0x007F00) >> 1) | ((address & 0x7F0000) >> 2);
+
+    for (uint32_t Offs = 0; Offs < size; )
+    {
+        uint32_t Size    = std::min(size - Offs, blockSize);
+        uint32_t syxOffs = ((Data & 0x00007F) << 0) | ((Data & 0x003F80) << 1) | ((Data & 0x1FC000) << 2);
+
+        WriteRolandSysEx(syxHdr, syxOffs, data + Offs, Size, opts);
+
+        Data += Size;
+        Offs += Size;
+    }
+}
+
+/// <summary>
+/// Writes a Roland SysEx message. The checksum is calculated by Finalize().
+/// </summary>
+void sysex_builder_t::WriteRolandSysEx(const uint8_t * syxHdr, uint32_t address, const uint8_t * data, uint32_t size, uint8_t opts)
+{
+    const uint32_t Size = 0x09 + size;
+
+    WriteTimestamp();
+
+    _Data.push_back(0xF0);
+
+    WriteVariableLengthQuantity(Size);
+
+    const size_t Offs = _Data.size();
+
+    _Data.resize(Offs + Size);
+
+    uint8_t * p = _Data.data() + Offs;
+
+    p[0x00] = syxHdr[0];
+    p[0x01] = syxHdr[1];
+    p[0x02] = syxHdr[2];
+    p[0x03] = syxHdr[3];
+
+    p[0x04] = (address >> 16) & 0x7F;
+    p[0x05] = (address >>  8) & 0x7F;
+    p[0x06] = (address >>  0) & 0x7F;
+
+    ::memcpy(p + 0x07, data, size);
+
+    p[size + 0x08] = 0xF7;
+
+    _Checksums.push_back({ (uint32_t) Offs + 0x04, 0x03 + size });
+
+    if (opts & SYXOPT_DELAY)
+        _Duration += MulDivCeil(1 + Size, _TicksPerQuarter * 320, _Tempo); // F0 status code + data size
+}
+
+/// <summary>
+/// Calculates the checksums of all messages.
+/// </summary>
+void sysex_builder_t::Finalize() noexcept
+{
+    uint8_t * Data = _Data.data();
+
+    for (const auto & [ Offs, Size ] : _Checksums)
+    {
+        const uint8_t * p = Data + Offs;
+
+        uint8_t Sum = 0;
+
+        for (uint32_t i = 0; i < Size; ++i)
+            Sum += p[i];
+
+        Data[Offs + Size] = (uint8_t) ((-Sum) & 0x7F);
+    }
+
+    _Checksums.clear();
+}
+
+/// <summary>
+/// Writes the delta time of the next event. The first event has no delta time.
+/// </summary>
+void sysex_builder_t::WriteTimestamp()
+{
+    if (_Data.empty())
+        return;
+
+    WriteVariableLengthQuantity(_Duration);
+
+    _Ticks += _Duration;
+    _Duration = 0;
+}
+
+/// <summary>
+/// Writes a variable-length quantity.
+/// </summary>
+void sysex_builder_t::WriteVariableLengthQuantity(uint32_t quantity)
+{
+    uint8_t Data[5];
+    size_t Size = 0;
+
+    do
+    {
+        Data[Size++] = quantity & 0x7F;
+        quantity >>= 7;
+    }
+    while (quantity != 0);
+
+    while (Size > 1)
+        _Data.push_back(Data[--Size] | 0x80);
+
+    _Data.push_back(Data[0]);
+}
+
+}
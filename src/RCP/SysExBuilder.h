@@ -0,0 +1,52 @@
+
+/** $VER: SysExBuilder.h (2026.10.19) P. Stuer **/
+
+#pragma once
+
+#include "pch.h"
+
+#include "MIDI.h"
+
+namespace rcp
+{
+
+/// <summary>
+/// Builds a block of Roland DT1 SysEx messages and text meta events in one buffer. The checksums of all messages are calculated in a single pass by Finalize().
+/// The block starts with the status of the first event, without its delta time, and can be written with midi_stream_t::WriteEvents().
+/// </summary>
+class sysex_builder_t
+{
+public:
+    sysex_builder_t(uint32_t ticksPerQuarter, uint32_t tempo) : _TicksPerQuarter(ticksPerQuarter), _Tempo(tempo), _Ticks(), _Duration()
+    {
+        _Data.reserve(0x8000);
+    }
+
+    void WriteMetaEvent(midi::MetaDataType type, const char * text);
+    void WriteMetaEvent(midi::MetaDataType type, const char * text, uint32_t size);
+
+    void WriteRolandSysEx(const uint8_t * syxHdr, uint32_t address, const uint8_t * data, uint32_t size, uint8_t opts);
+    void WriteRolandSysEx(const uint8_t * syxHdr, uint32_t address, const uint8_t * data, uint32_t size, uint8_t opts, uint32_t blockSize);
+
+    void Finalize() noexcept;
+
+    const std::vector<uint8_t> & GetData() const noexcept { return _Data; }
+    uint32_t GetTicks() const noexcept { return _Ticks; }
+    uint32_t GetDuration() const noexcept { return _Duration; }
+
+private:
+    void WriteTimestamp();
+    void WriteVariableLengthQuantity(uint32_t quantity);
+
+private:
+    uint32_t _TicksPerQuarter;
+    uint32_t _Tempo;
+
+    std::vector<uint8_t> _Data;
+    std::vector<std::pair<uint32_t, uint32_t>> _Checksums;    // Offset and size of the checksummed part of each message
+
+    uint32_t _Ticks;        // Sum of the delta times in the data
+    uint32_t _Duration;     // Delay after the last event
+};
+
+}
@@ -0,0 +1,95 @@
+
+/** $VER: RingBuffer.h (2026.10.19) P. Stuer - Lock-free single-producer / single-consumer queue **/
+
+#pragma once
+
+#include "pch.h"
+
+#include <atomic>
+#include <memory>
+
+namespace midi
+{
+
+/// <summary>
+/// Implements a lock-free queue of fixed-size items for exactly one producer thread and one consumer thread.
+/// Push(), Front() and Pop() never block and never allocate memory.
+/// </summary>
+template<typename T>
+class ring_buffer_t
+{
+public:
+    ring_buffer_t() noexcept : _Capacity(), _Mask(), _Head(), _Tail() { }
+
+    ring_buffer_t(const ring_buffer_t &) = delete;
+    ring_buffer_t & operator=(const ring_buffer_t &) = delete;
+
+    /// <summary>
+    /// Allocates room for at least the specified number of items and empties the queue. Must not be called while a producer or consumer uses the queue.
+    /// </summary>
+    void Reset(size_t capacity)
+    {
+        size_t Capacity = 1;
+
+        while (Capacity < capacity)
+            Capacity <<= 1;
+
+        _Items = std::make_unique<T[]>(Capacity);
+
+        _Capacity = Capacity;
+        _Mask = Capacity - 1;
+
+        _Head.store(0, std::memory_order_relaxed);
+        _Tail.store(0, std::memory_order_relaxed);
+    }
+
+    /// <summary>
+    /// Adds an item to the queue. Returns false if the queue is full. Producer only.
+    /// </summary>
+    bool Push(const T & item) noexcept
+    {
+        const size_t Head = _Head.load(std::memory_order_relaxed);
+
+        if (Head - _Tail.load(std::memory_order_acquire) == _Capacity)
+            return false;
+
+        _Items[Head & _Mask] = item;
+
+        _Head.store(Head + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /// <summary>
+    /// Gets the oldest item in the queue or nullptr if the queue is empty. Consumer only.
+    /// </summary>
+    const T * Front() const noexcept
+    {
+        const size_t Tail = _Tail.load(std::memory_order_relaxed);
+
+        if (Tail == _Head.load(std::memory_order_acquire))
+            return nullptr;
+
+        return &_Items[Tail & _Mask];
+    }
+
+    /// <summary>
+    /// Removes the oldest item from the queue. Only call after Front() returned an item. Consumer only.
+    /// </summary>
+    void Pop() noexcept
+    {
+        _Tail.store(_Tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    bool IsEmpty() const noexcept { return _Tail.load(std::memory_order_acquire) == _Head.load(std::memory_order_acquire); }
+
+private:
+    std::unique_ptr<T[]> _Items;
+    size_t _Capacity;
+    size_t _Mask;
+
+    alignas(64) std::atomic<size_t> _Head; // Index of the next item to write. Written by the producer.
+    alignas(64) std::atomic<size_t> _Tail; // Index of the next item to read. Written by the consumer.
+};
+
+}
@@ -0,0 +1,227 @@
+
+/** $VER: RunningNotes.h (2026.10.19) P. Stuer - Based on Valley Bell's rpc2mid and mmd2mid (https://github.com/ValleyBell/MidiConverters). **/
+
+#pragma once
+
+#include "pch.h"
+
+#include "MIDI.h"
+
+namespace midi
+{
+
+struct running_note_t
+{
+    uint32_t Time;              // Timestamp of the Note Off event (in ticks since the last Reset())
+    uint32_t Id;                // Insertion order. Notes that end at the same time are turned off in insertion order.
+    uint8_t Channel;
+    uint8_t Code;
+    uint8_t NoteOffVelocity;
+};
+
+/// <summary>
+/// Keeps track of the notes that are playing and inserts their Note Off events. The notes are kept in a min-heap ordered by the time of their Note Off event.
+/// Used by the RCP and MMD converters. The stream only needs WriteVariableLengthQuantity() and Write().
+/// </summary>
+class running_notes_t
+{
+public:
+    running_notes_t() noexcept : _Notes()
+    {
+        Reset();
+    }
+
+    /// <summary>
+    /// Removes all notes and resets the time.
+    /// </summary>
+    void Reset() noexcept
+    {
+        _Time = 0;
+        _NextId = NoId + 1;
+        _Count = 0;
+
+        _Heap.clear();
+
+        for (auto & rn : _Notes)
+            rn.Id = NoId;
+    }
+
+    /// <summary>
+    /// Adds a note event to the "running notes" list, so that Note Off events can be inserted automatically by Check() while processing delays.
+    /// "length" specifies the number of ticks after which the note is turned off.
+    /// "velocityOff" specifies the velocity for the Note Off event. A value of 0x80 results in Note On with velocity 0.
+    /// </summary>
+    void Add(uint8_t channel, uint8_t note, uint8_t velocityOff, uint32_t length)
+    {
+        running_note_t & rn = _Notes[note & 0x7Fu];
+
+        if (rn.Id == NoId)
+            _Count++;
+
+        rn.Time            = _Time + length;
+        rn.Id              = _NextId++;
+        rn.Channel         = channel;
+        rn.Code            = note & 0x7Fu;
+        rn.NoteOffVelocity = velocityOff;
+
+        Push(rn);
+    }
+
+    /// <summary>
+    /// Sets the remaining length of a note that is already playing. Returns false if the note is not playing.
+    /// </summary>
+    bool Extend(uint8_t note, uint32_t length)
+    {
+        running_note_t & rn = _Notes[note & 0x7Fu];
+
+        if (rn.Id == NoId)
+            return false;
+
+        rn.Time = _Time + length; // Marks the current heap entry as stale.
+
+        Push(rn);
+
+        return true;
+    }
+
+    /// <summary>
+    /// Checks if any note expires within the N ticks specified by the "deltaTime" parameter and
+    /// insert Note Off events when they do. In that case, the value of "deltaTime" will be reduced.
+    /// Call this function from the delta time handler and before extending notes.
+    /// Returns the number of expired notes.
+    /// </summary>
+    template<typename stream_t>
+    size_t Check(stream_t & stream, uint32_t & deltaTime)
+    {
+        size_t ExpiredNotes = 0;
+
+        while (!_Heap.empty())
+        {
+            const running_note_t n = _Heap.front();
+
+            if (IsStale(n))
+            {
+                Pop();
+                continue;
+            }
+
+            const uint32_t NewDeltaTime = n.Time - _Time;
+
+            if (NewDeltaTime > deltaTime)
+                break; // The note is still playing. Continue processing the event.
+
+            Pop();
+
+            _Notes[n.Code].Id = NoId;
+            _Count--;
+
+            deltaTime -= NewDeltaTime;
+            _Time = n.Time;
+
+            const uint8_t Event[3] =
+            {
+                (n.NoteOffVelocity < 0x80) ? (uint8_t) (StatusCode::NoteOff | n.Channel) : (uint8_t) (StatusCode::NoteOn | n.Channel),
+                n.Code,
+                (n.NoteOffVelocity < 0x80) ? n.NoteOffVelocity : (uint8_t) 0u,
+            };
+
+            stream.WriteVariableLengthQuantity(NewDeltaTime);
+            stream.Write(Event, sizeof(Event));
+
+            ExpiredNotes++;
+        }
+
+        return ExpiredNotes;
+    }
+
+    /// <summary>
+    /// Writes Note Off events for all running notes within "deltaTime" ticks. The notes that play longer are either cut at "deltaTime" or extend it.
+    /// Returns the remaining delta time after the last Note Off event.
+    /// </summary>
+    template<typename stream_t>
+    uint32_t Flush(stream_t & stream, uint32_t deltaTime, bool cutNotes)
+    {
+        if (cutNotes)
+        {
+            // Cut all notes at timestamp.
+            std::erase_if(_Heap, [this](const running_note_t & rn) { return IsStale(rn); });
+
+            for (auto & rn : _Heap)
+            {
+                if (rn.Time - _Time > deltaTime)
+                    rn.Time = _Time + deltaTime;
+
+                _Notes[rn.Code].Time = rn.Time;
+            }
+
+            std::make_heap(_Heap.begin(), _Heap.end(), IsLater);
+        }
+        else
+        {
+            // Remember the highest timestamp.
+            for (const auto & rn : _Notes)
+            {
+                if ((rn.Id != NoId) && (rn.Time - _Time > deltaTime))
+                    deltaTime = rn.Time - _Time;
+            }
+        }
+
+        Check(stream, deltaTime);
+
+        return deltaTime;
+    }
+
+    /// <summary>
+    /// Advances the time after an event has been written with the specified delta time.
+    /// </summary>
+    void Advance(uint32_t deltaTime) noexcept { _Time += deltaTime; }
+
+    size_t GetCount() const noexcept { return _Count; }
+
+private:
+    bool IsStale(const running_note_t & note) const noexcept { return (_Notes[note.Code].Id != note.Id) || (_Notes[note.Code].Time != note.Time); }
+
+    /// <summary>
+    /// Orders the heap by Note Off timestamp and insertion order.
+    /// </summary>
+    static bool IsLater(const running_note_t & a, const running_note_t & b) noexcept
+    {
+        if (a.Time != b.Time)
+            return a.Time > b.Time;
+
+        return a.Id > b.Id;
+    }
+
+    /// <summary>
+    /// Adds an entry to the heap.
+    /// </summary>
+    void Push(const running_note_t & note)
+    {
+        _Heap.push_back(note);
+
+        std::push_heap(_Heap.begin(), _Heap.end(), IsLater);
+    }
+
+    /// <summary>
+    /// Removes the entry with the earliest Note Off timestamp from the heap.
+    /// </summary>
+    void Pop() noexcept
+    {
+        std::pop_heap(_Heap.begin(), _Heap.end(), IsLater);
+
+        _Heap.pop_back();
+    }
+
+private:
+    uint32_t _Time;                     // Timestamp of the last event that was written (in ticks since the last Reset())
+    uint32_t _NextId;
+    size_t _Count;                      // Number of notes that are playing
+
+    std::vector<running_note_t> _Heap;  // Can contain stale entries of notes that were extended or turned off.
+
+    static constexpr uint32_t NoId = 0;
+
+    running_note_t _Notes[128];         // The playing note for each note code. Id is NoId if the note is not playing.
+};
+
+}
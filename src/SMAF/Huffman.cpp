@@ -0,0 +1,217 @@
+
+/** $VER: Huffman.cpp (2026.10.19) P. Stuer - Decompresses Huffman-encoded SMAF Mobile Standard sequence data **/
+
+#include "pch.h"
+
+#include "MMF.h"
+#include "Instrumentation.h"
+
+/*
+    Layout of compressed sequence data:
+
+    - Size of the decompressed data (32-bit, big-endian)
+    - Huffman tree, stored depth-first, MSB first: a 1 bit is an inner node followed by its 0- and 1-branch, a 0 bit is a leaf followed by its 8-bit value.
+    - The encoded data, MSB first.
+*/
+
+namespace
+{
+
+/// <summary>
+/// Reads bits MSB first. Reading past the end returns 0 bits; IsOverrun() reports it.
+/// </summary>
+class bit_reader_t
+{
+public:
+    bit_reader_t(const uint8_t * data, size_t size) noexcept : _Data(data), _Size(size), _Offset(), _Bits(), _BitCount(), _BitsRead() { }
+
+    uint32_t Peek(uint32_t count) noexcept
+    {
+        Fill();
+
+        return (uint32_t) (_Bits >> (64 - count));
+    }
+
+    void Skip(uint32_t count) noexcept
+    {
+        _Bits <<= count;
+        _BitCount -= count;
+        _BitsRead += count;
+    }
+
+    uint32_t Read(uint32_t count) noexcept
+    {
+        const uint32_t Value = Peek(count);
+
+        Skip(count);
+
+        return Value;
+    }
+
+    bool IsOverrun() const noexcept { return _BitsRead > (uint64_t) _Size * 8; }
+
+private:
+    void Fill() noexcept
+    {
+        while (_BitCount <= 56)
+        {
+            const uint64_t Byte = (_Offset < _Size) ? _Data[_Offset] : 0u;
+
+            _Bits |= Byte << (56 - _BitCount);
+            _BitCount += 8;
+
+            ++_Offset;
+        }
+    }
+
+private:
+    const uint8_t * _Data;
+    size_t _Size;
+    size_t _Offset;
+
+    uint64_t _Bits;     // Left-aligned bit buffer
+    uint32_t _BitCount; // Number of bits in the buffer
+    uint64_t _BitsRead;
+};
+
+/// <summary>
+/// Decodes the symbols using a lookup table that resolves up to 8 bits at once. Longer codes continue with a tree walk.
+/// </summary>
+class huffman_decoder_t
+{
+public:
+    bool ReadTree(bit_reader_t & br) noexcept
+    {
+        _NodeCount = 0;
+
+        _Root = ReadNode(br, 0);
+
+        if ((_Root == InvalidNode) || br.IsOverrun())
+            return false;
+
+        if (_Root >= LeafBase)
+            return true; // Only one symbol. It has no code.
+
+        // Build the lookup table.
+        for (uint32_t Index = 0; Index < _countof(_Table); ++Index)
+        {
+            uint16_t Node = _Root;
+            uint8_t Length = 0;
+
+            while ((Node < LeafBase) && (Length < TableBits))
+            {
+                const uint32_t Bit = (Index >> (TableBits - 1 - Length)) & 1u;
+
+                Node = Bit ? _Nodes[Node].One : _Nodes[Node].Zero;
+                ++Length;
+            }
+
+            _Table[Index] = { Node, Length };
+        }
+
+        return true;
+    }
+
+    uint8_t Decode(bit_reader_t & br) const noexcept
+    {
+        if (_Root >= LeafBase)
+            return (uint8_t) (_Root - LeafBase);
+
+        const entry_t & Entry = _Table[br.Peek(TableBits)];
+
+        br.Skip(Entry.Length);
+
+        uint16_t Node = Entry.Node;
+
+        while (Node < LeafBase)
+            Node = br.Read(1) ? _Nodes[Node].One : _Nodes[Node].Zero;
+
+        return (uint8_t) (Node - LeafBase);
+    }
+
+private:
+    /// <summary>
+    /// Reads a (sub)tree. Returns the index of an inner node or LeafBase + the value of a leaf.
+    /// </summary>
+    uint16_t ReadNode(bit_reader_t & br, uint32_t depth) noexcept
+    {
+        if ((depth > 255) || br.IsOverrun())
+            return InvalidNode;
+
+        if (br.Read(1) == 0)
+            return (uint16_t) (LeafBase + br.Read(8));
+
+        if (_NodeCount >= _countof(_Nodes))
+            return InvalidNode; // A tree with 256 leaves has 255 inner nodes.
+
+        const uint16_t Index = _NodeCount++;
+
+        const uint16_t Zero = ReadNode(br, depth + 1);
+        const uint16_t One  = ReadNode(br, depth + 1);
+
+        if ((Zero == InvalidNode) || (One == InvalidNode))
+            return InvalidNode;
+
+        _Nodes[Index] = { Zero, One };
+
+        return Index;
+    }
+
+private:
+    static const uint16_t LeafBase = 0x100;
+    static const uint16_t InvalidNode = 0xFFFF;
+    static const uint32_t TableBits = 8;
+
+    struct node_t
+    {
+        uint16_t Zero;
+        uint16_t One;
+    };
+
+    struct entry_t
+    {
+        uint16_t Node;      // Leaf or the inner node to continue from
+        uint8_t Length;     // Number of bits consumed
+    };
+
+    node_t _Nodes[255];
+    uint16_t _NodeCount;
+    uint16_t _Root;
+
+    entry_t _Table[1 << TableBits];
+};
+
+}
+
+/// <summary>
+/// Decompresses Huffman-encoded Mobile Standard sequence data. Returns false if the data is invalid.
+/// </summary>
+bool DecompressMobileStandard(const uint8_t * data, size_t size, std::vector<uint8_t> & output)
+{
+    MIDI_TIME_PHASE(Decompression);
+
+    if (size < 4)
+        return false;
+
+    const size_t Size = ((size_t) data[0] << 24) | ((size_t) data[1] << 16) | ((size_t) data[2] << 8) | (size_t) data[3];
+
+    // Each byte takes at least one bit unless the tree has a single leaf. Reject sizes that are way out of proportion to avoid huge allocations.
+    if (Size > (size - 4) * 8 * 256)
+        return false;
+
+    bit_reader_t br(data + 4, size - 4);
+
+    huffman_decoder_t Decoder;
+
+    if (!Decoder.ReadTree(br))
+        return false;
+
+    output.resize(Size);
+
+    for (auto & Byte : output)
+        Byte = Decoder.Decode(br);
+
+    MIDI_COUNT(BytesInflated, Size);
+
+    return !br.IsOverrun();
+}
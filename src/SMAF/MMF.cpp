@@ -1,11 +1,13 @@
 ﻿
-/** $VER: MMF.cpp (2025.04.05) Convert exclusive CHPARAM/OPPARAM (Adapted from mmftool) **/
+/** $VER: MMF.cpp (2026.10.19) Convert exclusive CHPARAM/OPPARAM (Adapted from mmftool) **/
 
 #include "pch.h"
 
+#ifdef _MSC_VER
 #include <CppCoreCheck/Warnings.h>
 
 #pragma warning(disable: 4100 4625 4626 4710 4711 4738 5045 ALL_CPPCORECHECK_WARNINGS)
+#endif
 
 #include "MMF.h"
 
@@ -1,5 +1,5 @@
 
-/** $VER: MMF.h (2025.04.05) MMF/SMAF types and definitions **/
+/** $VER: MMF.h (2026.10.19) MMF/SMAF types and definitions **/
 
 #pragma once
 
@@ -94,6 +94,8 @@ private:
     SMAFFormat _Format; // Internal use
 };
 
+bool DecompressMobileStandard(const uint8_t * data, size_t size, std::vector<uint8_t> & output);
+
 #pragma region mmftool
 
 #define VOICE_FM    0
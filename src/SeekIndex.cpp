@@ -0,0 +1,593 @@
+
+/** $VER: SeekIndex.cpp (2026.10.19) P. Stuer - Random access into a serialized MIDI stream **/
+
+#include "pch.h"
+
+#include "SeekIndex.h"
+#include "SysEx.h"
+
+namespace
+{
+
+using namespace midi;
+
+const uint8_t Unset = 0xFF;
+
+/// <summary>
+/// Represents the value of an RPN or NRPN parameter that was set with Data Entry.
+/// </summary>
+struct parameter_t
+{
+    uint16_t Number;    // Bit 14: NRPN, bits 13-7: MSB, bits 6-0: LSB
+    uint8_t MSB;
+    uint8_t LSB;        // Unset if no LSB was sent
+};
+
+const uint16_t NRPNFlag = 0x4000;
+const uint16_t NullParameter = 0x3FFF; // RPN 7F 7F
+
+struct channel_state_t
+{
+    channel_state_t() noexcept { Reset(); }
+
+    void Reset() noexcept
+    {
+        ::memset(Controllers, Unset, sizeof(Controllers));
+
+        Program = Unset;
+        Pressure = Unset;
+        PitchBend = 0xFFFF;
+        IsNRPNSelected = false;
+
+        Parameters.clear();
+    }
+
+    uint8_t Controllers[128];
+    uint8_t Program;
+    uint8_t Pressure;
+    uint16_t PitchBend;
+    bool IsNRPNSelected;                // True if the last parameter selection was an NRPN.
+
+    std::vector<parameter_t> Parameters;
+};
+
+/// <summary>
+/// Identifies the setting that a SysEx message changes. A message replaces an earlier message with the same key.
+/// </summary>
+struct sysex_key_t
+{
+    sysex_type_t Type;
+    uint8_t DeviceId;
+    uint32_t Manufacturer;
+    uint32_t Model;
+    uint32_t Address;   // Parameter address or the index of a message that is not classified
+    uint32_t Size;
+
+    auto operator<=>(const sysex_key_t &) const noexcept = default;
+};
+
+struct port_state_t
+{
+    port_state_t() noexcept : ErasedSysExCount() { }
+
+    void AddSysEx(const sysex_key_t & key, uint32_t index);
+    void ClearSysEx() noexcept;
+
+    channel_state_t Channels[16];
+
+    std::vector<uint32_t> SysEx;        // Indexes in the SysEx table of the messages since the last reset, in the order of their last occurrence. Replaced messages are Erased.
+    std::map<sysex_key_t, size_t> SysExPositions; // Position in SysEx of the message of each key
+    size_t ErasedSysExCount;
+
+    static constexpr uint32_t Erased = ~0u;
+};
+
+/// <summary>
+/// Tracks the state that a MIDI device keeps between messages. Notes are not tracked.
+/// </summary>
+class chase_state_t
+{
+public:
+    void Apply(uint32_t message, const sysex_table_t & sysExTable);
+    void Emit(std::vector<uint32_t> & messages) const;
+
+private:
+    void ApplyControlChange(channel_state_t & channel, uint8_t controller, uint8_t value);
+    void ApplySysEx(uint32_t index, const sysex_table_t & sysExTable);
+
+    port_state_t & GetPort(uint8_t portNumber);
+
+    static sysex_key_t GetSysExKey(const sysex_info_t & info, uint32_t index, size_t size) noexcept;
+    static uint16_t GetSelectedParameter(const channel_state_t & channel) noexcept;
+    static parameter_t & GetParameter(channel_state_t & channel, uint16_t number);
+
+    static uint32_t Pack(uint8_t status, uint8_t data1, uint8_t data2, uint8_t portNumber) noexcept
+    {
+        return (uint32_t) status | ((uint32_t) data1 << 8) | ((uint32_t) data2 << 16) | ((uint32_t) portNumber << 24);
+    }
+
+private:
+    std::vector<port_state_t> _Ports;
+};
+
+/// <summary>
+/// Updates the state with a message in the message_t::Data format.
+/// </summary>
+void chase_state_t::Apply(uint32_t message, const sysex_table_t & sysExTable)
+{
+    if (message & 0x80000000u)
+    {
+        ApplySysEx(message & 0x7FFFFFFFu, sysExTable);
+
+        return;
+    }
+
+    const uint8_t Status = (uint8_t) message;
+
+    if ((Status < StatusCode::NoteOff) || (Status >= StatusCode::SysEx))
+        return;
+
+    const uint8_t Data1 = (uint8_t) ((message >>  8) & 0x7F);
+    const uint8_t Data2 = (uint8_t) ((message >> 16) & 0x7F);
+
+    channel_state_t & Channel = GetPort((uint8_t) (message >> 24)).Channels[Status & 0x0F];
+
+    switch (Status & 0xF0)
+    {
+        case StatusCode::ControlChange:
+            ApplyControlChange(Channel, Data1, Data2);
+            break;
+
+        case StatusCode::ProgramChange:
+            Channel.Program = Data1;
+            break;
+
+        case StatusCode::ChannelPressure:
+            Channel.Pressure = Data1;
+            break;
+
+        case StatusCode::PitchBendChange:
+            Channel.PitchBend = (uint16_t) (Data1 | (Data2 << 7));
+            break;
+
+        default:
+            break;
+    }
+}
+
+/// <summary>
+/// Adds the messages that recreate the state to the list.
+/// </summary>
+void chase_state_t::Emit(std::vector<uint32_t> & messages) const
+{
+    for (size_t PortNumber = 0; PortNumber < _Ports.size(); ++PortNumber)
+    {
+        const port_state_t & Port = _Ports[PortNumber];
+        const uint8_t p = (uint8_t) PortNumber;
+
+        for (const uint32_t Index : Port.SysEx)
+        {
+            if (Index != port_state_t::Erased)
+                messages.push_back(Index | 0x80000000u);
+        }
+
+        for (uint8_t i = 0; i < _countof(Port.Channels); ++i)
+        {
+            const channel_state_t & Channel = Port.Channels[i];
+
+            const uint8_t ControlChange = (uint8_t) (StatusCode::ControlChange | i);
+
+            // The bank must be selected before the program.
+            if (Channel.Controllers[Controller::BankSelect] != Unset)
+                messages.push_back(Pack(ControlChange, Controller::BankSelect, Channel.Controllers[Controller::BankSelect], p));
+
+            if (Channel.Controllers[Controller::BankSelectLSB] != Unset)
+                messages.push_back(Pack(ControlChange, Controller::BankSelectLSB, Channel.Controllers[Controller::BankSelectLSB], p));
+
+            if (Channel.Program != Unset)
+                messages.push_back(Pack((uint8_t) (StatusCode::ProgramChange | i), Channel.Program, 0, p));
+
+            for (uint8_t Number = 0; Number < Controller::AllSoundsOff; ++Number)
+            {
+                switch (Number)
+                {
+                    case Controller::BankSelect:
+                    case Controller::BankSelectLSB:
+                    case Controller::DataEntry:
+                    case Controller::DataEntryLSB:
+                    case Controller::DataIncrement:
+                    case Controller::DataDecrement:
+                    case Controller::NRPNLSB:
+                    case Controller::NRPNMSB:
+                    case Controller::RPNLSB:
+                    case Controller::RPNMSB:
+                        continue;
+
+                    default:
+                        break;
+                }
+
+                if (Channel.Controllers[Number] != Unset)
+                    messages.push_back(Pack(ControlChange, Number, Channel.Controllers[Number], p));
+            }
+
+            for (const auto & Parameter : Channel.Parameters)
+            {
+                const bool IsNRPN = (Parameter.Number & NRPNFlag) != 0;
+
+                messages.push_back(Pack(ControlChange, IsNRPN ? Controller::NRPNMSB : Controller::RPNMSB, (uint8_t) ((Parameter.Number >> 7) & 0x7F), p));
+                messages.push_back(Pack(ControlChange, IsNRPN ? Controller::NRPNLSB : Controller::RPNLSB, (uint8_t) ( Parameter.Number       & 0x7F), p));
+                messages.push_back(Pack(ControlChange, Controller::DataEntry, Parameter.MSB, p));
+
+                if (Parameter.LSB != Unset)
+                    messages.push_back(Pack(ControlChange, Controller::DataEntryLSB, Parameter.LSB, p));
+            }
+
+            // Restore the parameter selection. The selection that was made last is restored last.
+            {
+                const uint8_t Order[2][2] =
+                {
+                    { Controller::NRPNMSB, Controller::NRPNLSB },
+                    { Controller::RPNMSB,  Controller::RPNLSB },
+                };
+
+                for (size_t j = 0; j < 2; ++j)
+                {
+                    const uint8_t * Pair = Order[Channel.IsNRPNSelected ? 1 - j : j];
+
+                    for (size_t k = 0; k < 2; ++k)
+                    {
+                        if (Channel.Controllers[Pair[k]] != Unset)
+                            messages.push_back(Pack(ControlChange, Pair[k], Channel.Controllers[Pair[k]], p));
+                    }
+                }
+            }
+
+            if (Channel.PitchBend != 0xFFFF)
+                messages.push_back(Pack((uint8_t) (StatusCode::PitchBendChange | i), (uint8_t) (Channel.PitchBend & 0x7F), (uint8_t) (Channel.PitchBend >> 7), p));
+
+            if (Channel.Pressure != Unset)
+                messages.push_back(Pack((uint8_t) (StatusCode::ChannelPressure | i), Channel.Pressure, 0, p));
+        }
+    }
+}
+
+/// <summary>
+/// Updates the state with a Control Change message.
+/// </summary>
+void chase_state_t::ApplyControlChange(channel_state_t & channel, uint8_t controller, uint8_t value)
+{
+    switch (controller)
+    {
+        case Controller::DataEntry:
+        case Controller::DataEntryLSB:
+        case Controller::DataIncrement:
+        case Controller::DataDecrement:
+        {
+            const uint16_t Number = GetSelectedParameter(channel);
+
+            if ((Number & ~NRPNFlag) == NullParameter)
+                break;
+
+            parameter_t & Parameter = GetParameter(channel, Number);
+
+            if (controller == Controller::DataEntry)
+                Parameter.MSB = value;
+            else
+            if (controller == Controller::DataEntryLSB)
+                Parameter.LSB = value;
+            else
+            if (controller == Controller::DataIncrement)
+                Parameter.MSB = (uint8_t) (std::min)(Parameter.MSB + 1, 0x7F);
+            else
+                Parameter.MSB = (uint8_t) (std::max)(Parameter.MSB - 1, 0);
+            break;
+        }
+
+        case Controller::NRPNLSB:
+        case Controller::NRPNMSB:
+            channel.Controllers[controller] = value;
+            channel.IsNRPNSelected = true;
+            break;
+
+        case Controller::RPNLSB:
+        case Controller::RPNMSB:
+            channel.Controllers[controller] = value;
+            channel.IsNRPNSelected = false;
+            break;
+
+        case Controller::ResetAllControllers:
+        {
+            // Reset the controllers as specified by RP-015.
+            channel.Controllers[Controller::Modulation] = 0;
+            channel.Controllers[Controller::Expression] = 127;
+
+            for (uint8_t i = Controller::SustainPedal; i < Controller::SustainPedal + 4; ++i)
+                channel.Controllers[i] = 0;
+
+            channel.Controllers[Controller::NRPNLSB] = 127;
+            channel.Controllers[Controller::NRPNMSB] = 127;
+            channel.Controllers[Controller::RPNLSB] = 127;
+            channel.Controllers[Controller::RPNMSB] = 127;
+
+            channel.Pressure = 0;
+            channel.PitchBend = 0x2000;
+            break;
+        }
+
+        default:
+        {
+            // Channel Mode messages do not change the state that is restored.
+            if (controller < Controller::AllSoundsOff)
+                channel.Controllers[controller] = value;
+        }
+    }
+}
+
+/// <summary>
+/// Updates the state with a SysEx message. A GM, GS or XG reset clears the state of its port.
+/// </summary>
+void chase_state_t::ApplySysEx(uint32_t index, const sysex_table_t & sysExTable)
+{
+    const uint8_t * Data;
+    size_t Size;
+    uint8_t PortNumber;
+
+    if (!sysExTable.GetItem(index, Data, Size, PortNumber))
+        return;
+
+    port_state_t & Port = GetPort(PortNumber);
+
+    const sysex_info_t Info = sysex_t::Classify(std::span<const uint8_t>(Data, Size));
+
+    switch (Info.Type)
+    {
+        case sysex_type_t::GM1SystemOn:
+        case sysex_type_t::GM1SystemOff:
+        case sysex_type_t::GM2SystemOn:
+        case sysex_type_t::GSReset:
+        case sysex_type_t::MT32Reset:
+        case sysex_type_t::D50Reset:
+        case sysex_type_t::XGSystemOn:
+        case sysex_type_t::XGReset:
+        {
+            for (auto & Channel : Port.Channels)
+                Channel.Reset();
+
+            Port.ClearSysEx();
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    Port.AddSysEx(GetSysExKey(Info, index, Size), index);
+}
+
+/// <summary>
+/// Gets the key of a SysEx message. Parameter changes are identified by their address and size so that a new value replaces the old one.
+/// </summary>
+sysex_key_t chase_state_t::GetSysExKey(const sysex_info_t & info, uint32_t index, size_t size) noexcept
+{
+    sysex_key_t Key = { .Type = info.Type, .DeviceId = info.DeviceId, .Manufacturer = info.Manufacturer, .Model = info.Model, .Address = 0, .Size = 0 };
+
+    switch (info.Type)
+    {
+        case sysex_type_t::RolandParameter:
+        case sysex_type_t::YamahaParameter:
+            Key.Address = info.Address;
+            Key.Size = (uint32_t) size;
+            break;
+
+        // Messages that switch a setting on and off replace each other.
+        case sysex_type_t::DLSOff:
+            Key.Type = sysex_type_t::DLSOn;
+            break;
+
+        case sysex_type_t::DLSStaticVoiceAllocationOff:
+            Key.Type = sysex_type_t::DLSStaticVoiceAllocationOn;
+            break;
+
+        case sysex_type_t::DLSOn:
+        case sysex_type_t::DLSStaticVoiceAllocationOn:
+        case sysex_type_t::MasterVolume:
+        case sysex_type_t::MasterBalance:
+        case sysex_type_t::MasterFineTune:
+        case sysex_type_t::MasterCoarseTune:
+            break;
+
+        // Other messages only replace an identical message.
+        default:
+            Key.Type = sysex_type_t::Unknown;
+            Key.Address = index;
+    }
+
+    return Key;
+}
+
+/// <summary>
+/// Adds a SysEx message and removes the earlier message with the same key, if any.
+/// </summary>
+void port_state_t::AddSysEx(const sysex_key_t & key, uint32_t index)
+{
+    auto [it, IsNew] = SysExPositions.try_emplace(key, SysEx.size());
+
+    if (!IsNew)
+    {
+        SysEx[it->second] = Erased;
+        ++ErasedSysExCount;
+
+        it->second = SysEx.size();
+    }
+
+    SysEx.push_back(index);
+
+    // Remove the erased messages once they make up half of the list.
+    if (ErasedSysExCount > SysEx.size() / 2)
+    {
+        std::vector<size_t> NewPositions(SysEx.size());
+
+        size_t n = 0;
+
+        for (size_t i = 0; i < SysEx.size(); ++i)
+        {
+            NewPositions[i] = n;
+
+            if (SysEx[i] != Erased)
+                SysEx[n++] = SysEx[i];
+        }
+
+        SysEx.resize(n);
+
+        for (auto & Position : SysExPositions)
+            Position.second = NewPositions[Position.second];
+
+        ErasedSysExCount = 0;
+    }
+}
+
+/// <summary>
+/// Removes all SysEx messages.
+/// </summary>
+void port_state_t::ClearSysEx() noexcept
+{
+    SysEx.clear();
+    SysExPositions.clear();
+    ErasedSysExCount = 0;
+}
+
+/// <summary>
+/// Gets the state of the specified port.
+/// </summary>
+port_state_t & chase_state_t::GetPort(uint8_t portNumber)
+{
+    if (portNumber >= _Ports.size())
+        _Ports.resize((size_t) portNumber + 1);
+
+    return _Ports[portNumber];
+}
+
+/// <summary>
+/// Gets the number of the selected RPN or NRPN parameter.
+/// </summary>
+uint16_t chase_state_t::GetSelectedParameter(const channel_state_t & channel) noexcept
+{
+    const uint8_t MSB = channel.Controllers[channel.IsNRPNSelected ? Controller::NRPNMSB : Controller::RPNMSB];
+    const uint8_t LSB = channel.Controllers[channel.IsNRPNSelected ? Controller::NRPNLSB : Controller::RPNLSB];
+
+    if ((MSB == Unset) || (LSB == Unset))
+        return NullParameter;
+
+    return (uint16_t) ((channel.IsNRPNSelected ? NRPNFlag : 0u) | (MSB << 7) | LSB);
+}
+
+/// <summary>
+/// Gets the value of the specified parameter, adding it if necessary.
+/// </summary>
+parameter_t & chase_state_t::GetParameter(channel_state_t & channel, uint16_t number)
+{
+    for (auto & Parameter : channel.Parameters)
+    {
+        if (Parameter.Number == number)
+            return Parameter;
+    }
+
+    channel.Parameters.push_back({ number, 0, Unset });
+
+    return channel.Parameters.back();
+}
+
+}
+
+namespace midi
+{
+
+/// <summary>
+/// Builds the index of a stream. A snapshot is taken every interval ms or every messageInterval messages, whichever comes first.
+/// </summary>
+void seek_index_t::Build(const std::vector<message_t> & stream, const sysex_table_t & sysExTable, uint32_t interval, uint32_t messageInterval)
+{
+    Clear();
+
+    chase_state_t State;
+
+    uint32_t NextTime = interval;
+    size_t NextPosition = messageInterval;
+
+    for (size_t i = 0; i < stream.size(); ++i)
+    {
+        const message_t & Message = stream[i];
+
+        if ((Message.Time >= NextTime) || (i >= NextPosition))
+        {
+            const size_t Offset = _Messages.size();
+
+            State.Emit(_Messages);
+
+            _Snapshots.push_back({ Message.Time, i, Offset, _Messages.size() - Offset });
+
+            NextTime = Message.Time + interval;
+            NextPosition = i + messageInterval;
+        }
+
+        State.Apply(Message.Data, sysExTable);
+    }
+
+    _Snapshots.shrink_to_fit();
+    _Messages.shrink_to_fit();
+}
+
+/// <summary>
+/// Adds the messages that recreate the state at the specified time (in ms) to the list and returns the position in the stream to continue playback from.
+/// The messages have the specified timestamp. Notes are not restored; the host should silence the device before sending the messages.
+/// </summary>
+size_t seek_index_t::Seek(uint32_t time, const std::vector<message_t> & stream, const sysex_table_t & sysExTable, std::vector<message_t> & messages) const
+{
+    const auto Target = std::lower_bound(stream.begin(), stream.end(), time, [](const message_t & message, uint32_t t) { return message.Time < t; });
+
+    const size_t Position = (size_t) (Target - stream.begin());
+
+    chase_state_t State;
+
+    size_t i = 0;
+
+    // Restore the last snapshot before the target.
+    {
+        auto Snapshot = std::upper_bound(_Snapshots.begin(), _Snapshots.end(), Position, [](size_t position, const snapshot_t & snapshot) { return position < snapshot.Position; });
+
+        if (Snapshot != _Snapshots.begin())
+        {
+            --Snapshot;
+
+            for (size_t j = 0; j < Snapshot->Count; ++j)
+                State.Apply(_Messages[Snapshot->Offset + j], sysExTable);
+
+            i = Snapshot->Position;
+        }
+    }
+
+    // Replay the messages between the snapshot and the target.
+    for (; i < Position; ++i)
+        State.Apply(stream[i].Data, sysExTable);
+
+    std::vector<uint32_t> Messages;
+
+    State.Emit(Messages);
+
+    for (const uint32_t Message : Messages)
+        messages.push_back({ time, Message });
+
+    return Position;
+}
+
+/// <summary>
+/// Removes all snapshots.
+/// </summary>
+void seek_index_t::Clear() noexcept
+{
+    _Snapshots.clear();
+    _Messages.clear();
+}
+
+}
@@ -0,0 +1,48 @@
+
+/** $VER: SeekIndex.h (2026.10.19) P. Stuer - Random access into a serialized MIDI stream **/
+
+#pragma once
+
+#include "pch.h"
+
+#include "MIDIContainer.h"
+
+namespace midi
+{
+
+/// <summary>
+/// Reconstructs the channel state at any point of a stream created by container_t::SerializeAsStream() without replaying the stream from the start.
+/// The index contains snapshots of the state of each port and channel (program, controllers, pitch bend, channel pressure, RPN and NRPN values, and the SysEx messages
+/// sent since the last GM, GS or XG reset, with only the latest value of each parameter) at regular intervals. Seek() restores the nearest preceding snapshot and replays the messages between the snapshot and the target.
+/// </summary>
+class seek_index_t
+{
+public:
+    seek_index_t() noexcept { }
+
+    void Build(const std::vector<message_t> & stream, const sysex_table_t & sysExTable, uint32_t interval = DefaultInterval, uint32_t messageInterval = DefaultMessageInterval);
+    size_t Seek(uint32_t time, const std::vector<message_t> & stream, const sysex_table_t & sysExTable, std::vector<message_t> & messages) const;
+
+    void Clear() noexcept;
+
+    bool IsEmpty() const noexcept { return _Snapshots.empty(); }
+    size_t GetSnapshotCount() const noexcept { return _Snapshots.size(); }
+
+public:
+    static constexpr uint32_t DefaultInterval = 5000;           // Time between snapshots (in ms)
+    static constexpr uint32_t DefaultMessageInterval = 16384;   // Maximum number of messages between snapshots
+
+private:
+    struct snapshot_t
+    {
+        uint32_t Time;      // Timestamp of the message at Position (in ms)
+        size_t Position;    // Index of the first message in the stream that is not included in the snapshot
+        size_t Offset;      // Offset of the state messages in _Messages
+        size_t Count;       // Number of state messages
+    };
+
+    std::vector<snapshot_t> _Snapshots;
+    std::vector<uint32_t> _Messages;    // The state of all snapshots as messages in the message_t::Data format.
+};
+
+}
@@ -1,5 +1,5 @@
 
-/** $VER: SysEx.cpp (2026.04.10) P. Stuer **/
+/** $VER: SysEx.cpp (2026.10.19) P. Stuer **/
 
 #include "pch.h"
 
@@ -362,6 +362,169 @@ void sysex_t::Identify() noexcept
     }
 }
 
+/// <summary>
+/// Classifies a SysEx message without allocating memory.
+/// </summary>
+sysex_info_t sysex_t::Classify(std::span<const uint8_t> data) noexcept
+{
+    sysex_info_t Info = { };
+
+    const size_t Size = data.size();
+
+    if ((Size < 3) || (data[0] != StatusCode::SysEx))
+        return Info;
+
+    size_t i = 1;
+
+    Info.Manufacturer = data[i++]; // 1-byte Id
+
+    if (Info.Manufacturer == 0x00)
+    {
+        if (Size < 5)
+            return Info;
+
+        Info.Manufacturer = ((uint32_t) data[i] << 8) | data[i + 1]; // 3-byte Id
+        Info.DeviceId     = data[i + 2];
+        Info.IsExtendedId = true;
+
+        return Info; // None of the extended Ids are classified.
+    }
+
+    Info.DeviceId = data[i++];
+
+    // The last data byte, before End of SysEx.
+    const size_t Tail = (data[Size - 1] == StatusCode::SysExEnd) ? Size - 1 : Size;
+
+    switch (Info.Manufacturer)
+    {
+        // Universal Non-Real Time
+        case 0x7E:
+        {
+            if (i + 2 > Tail)
+                break;
+
+            Info.Command    = data[i++];
+            Info.SubCommand = data[i++];
+
+            switch ((Info.Command << 8) | Info.SubCommand)
+            {
+                case 0x0601: Info.Type = sysex_type_t::IdentityRequest; break;
+                case 0x0602: Info.Type = sysex_type_t::IdentityReply; break;
+
+                case 0x0901: Info.Type = sysex_type_t::GM1SystemOn; break;
+                case 0x0902: Info.Type = sysex_type_t::GM1SystemOff; break;
+                case 0x0903: Info.Type = sysex_type_t::GM2SystemOn; break;
+
+                case 0x0A01: Info.Type = sysex_type_t::DLSOn; break;
+                case 0x0A02: Info.Type = sysex_type_t::DLSOff; break;
+                case 0x0A03: Info.Type = sysex_type_t::DLSStaticVoiceAllocationOff; break;
+                case 0x0A04: Info.Type = sysex_type_t::DLSStaticVoiceAllocationOn; break;
+            }
+            break;
+        }
+
+        // Universal Real Time
+        case 0x7F:
+        {
+            if (i + 2 > Tail)
+                break;
+
+            Info.Command    = data[i++];
+            Info.SubCommand = data[i++];
+
+            switch ((Info.Command << 8) | Info.SubCommand)
+            {
+                case 0x0401: Info.Type = sysex_type_t::MasterVolume; break;
+                case 0x0402: Info.Type = sysex_type_t::MasterBalance; break;
+                case 0x0403: Info.Type = sysex_type_t::MasterFineTune; break;
+                case 0x0404: Info.Type = sysex_type_t::MasterCoarseTune; break;
+            }
+            break;
+        }
+
+        // Roland
+        case 0x41:
+        {
+            // Model ID: 1 byte or up to 4 leading zeroes followed by a non-zero byte.
+            for (size_t n = 0; (n < 5) && (i < Tail); ++n)
+            {
+                Info.Model = (Info.Model << 8) | data[i];
+
+                if (data[i++] != 0x00)
+                    break;
+            }
+
+            if (i >= Tail)
+                break;
+
+            Info.Command = data[i++];
+
+            if ((Info.Command != 0x11) && (Info.Command != 0x12))
+                break;
+
+            const size_t AddressOffset = i;
+
+            // MT-32 and D-50 resets have no checksum. The MT-32 reset has a 2-byte address.
+            if ((i < Tail) && (data[AddressOffset] == 0x7F) && (Info.Command == 0x12) && ((Info.Model == 0x16) || (Info.Model == 0x14)))
+            {
+                Info.Type = (Info.Model == 0x16) ? sysex_type_t::MT32Reset : sysex_type_t::D50Reset;
+                break;
+            }
+
+            if (i + 3 > Tail)
+                break;
+
+            Info.Address    = ((uint32_t) data[i] << 16) | ((uint32_t) data[i + 1] << 8) | data[i + 2];
+            Info.DataOffset = (uint16_t) (i + 3);
+            Info.Type       = sysex_type_t::RolandParameter;
+
+            // The checksum is the last byte before End of SysEx and covers the address and the data.
+            if (Tail > Info.DataOffset)
+            {
+                uint8_t Checksum = 0;
+
+                for (size_t j = AddressOffset; j < Tail - 1; ++j)
+                    Checksum += data[j];
+
+                Info.Checksum = (data[Tail - 1] == (uint8_t) ((128 - Checksum) & 127)) ? sysex_checksum_t::Valid : sysex_checksum_t::Invalid;
+            }
+
+            if ((Info.Model == 0x42) && (Info.Command == 0x12) && (Info.Address == 0x40007F) && (Info.DataOffset < Tail) && (data[Info.DataOffset] == 0x00))
+                Info.Type = sysex_type_t::GSReset;
+            break;
+        }
+
+        // Yamaha
+        case 0x43:
+        {
+            if (i + 4 > Tail)
+                break;
+
+            Info.Model = data[i++];
+
+            // Parameter Change
+            if ((Info.DeviceId & 0xF0) != 0x10)
+                break;
+
+            Info.Address    = ((uint32_t) data[i] << 16) | ((uint32_t) data[i + 1] << 8) | data[i + 2];
+            Info.DataOffset = (uint16_t) (i + 3);
+            Info.Type       = sysex_type_t::YamahaParameter;
+
+            if ((Info.Model == 0x4C) && (Info.DataOffset < Tail) && (data[Info.DataOffset] == 0x00))
+            {
+                if (Info.Address == 0x00007E)
+                    Info.Type = sysex_type_t::XGSystemOn;
+                else
+                if (Info.Address == 0x00007F)
+                    Info.Type = sysex_type_t::XGReset;
+            }
+            break;
+        }
+    }
+
+    return Info;
+}
+
 /// <summary>
 /// Identifies the manufacturer.
 /// </summary>
@@ -369,15 +532,17 @@ uint32_t sysex_t::IdentifyManufacturer() noexcept
 {
     uint32_t Id = *_Iter++; // 1-byte Id
 
-    if (Id == 0x00)
-        Id = ((uint32_t) *_Iter++ << 8) | *_Iter++; // 3-byte Id
+    const bool IsExtended = (Id == 0x00);
 
-    auto it = Manufacturers.find(Id);
+    if (IsExtended)
+    {
+        Id = (uint32_t) *_Iter++ << 8; // 3-byte Id
+        Id |= *_Iter++;
+    }
+
+    const char * Name = ::GetManufacturerName(Id, IsExtended);
 
-    if (it != Manufacturers.end())
-        Manufacturer = it->second;
-    else
-        Manufacturer = "Unknown";
+    Manufacturer = (Name != nullptr) ? Name : "Unknown";
 
     return Id;
 }
@@ -510,6 +675,7 @@ void sysex_t::IdentifyRoland() noexcept
 
                                         default: Model = "Unknown"; break;
                                     }
+                                    break;
                                 }
 
                                 default: Model = "Unknown"; break;
@@ -939,9 +1105,56 @@ void sysex_t::IdentifyRoland() noexcept
             Description = msc::FormatText("Unknown address %06Xh", Address);
     }
 
-    IsChecksumValid = (_Data[_Data.size() - 2] != CalculateRolandCheckSum(_Data.data(), _Data.size()));
+    IsChecksumValid = (_Data[_Data.size() - 2] == CalculateRolandCheckSum(_Data.data(), _Data.size()));
+}
+
+#pragma region SysEx Cache
+
+/// <summary>
+/// Classifies the specified SysEx message. Repeated messages are only classified once.
+/// </summary>
+const sysex_info_t & sysex_cache_t::Classify(std::span<const uint8_t> data)
+{
+    return GetItem(data).Info;
+}
+
+/// <summary>
+/// Identifies the specified SysEx message and renders its description. Repeated messages are only identified once.
+/// </summary>
+const sysex_t & sysex_cache_t::Identify(std::span<const uint8_t> data)
+{
+    item_t & Item = GetItem(data);
+
+    if (!Item.SysEx.has_value())
+    {
+        Item.SysEx.emplace(data.data(), data.size());
+        Item.SysEx->Identify();
+    }
+
+    return *Item.SysEx;
 }
 
+/// <summary>
+/// Gets the cache item of the specified SysEx message.
+/// </summary>
+sysex_cache_t::item_t & sysex_cache_t::GetItem(std::span<const uint8_t> data)
+{
+    const std::string_view Key((const char *) data.data(), data.size());
+
+    auto it = _Items.find(Key);
+
+    if (it != _Items.end())
+        return it->second;
+
+    // Start over instead of growing without limit, e.g. when a tool processes many files with the same cache.
+    if (_Items.size() >= _MaxCount)
+        _Items.clear();
+
+    return _Items.emplace(std::string(Key), item_t { sysex_t::Classify(data), std::nullopt }).first->second;
+}
+
+#pragma endregion
+
 /// <summary>
 /// Converts a block number to a part number.
 /// </summary>
@@ -960,81 +1173,81 @@ int sysex_t::GSBlockToPart(int value) noexcept
 
 const char * sysex_t::IdentifyGSReverbMacro(uint8_t value) noexcept
 {
-    switch (value)
+    static constexpr const char * Names[] =
     {
-        case 0x00: return "Room 1"; break;
-        case 0x01: return "Room 2"; break;
-        case 0x02: return "Room 3"; break;
-        case 0x03: return "Hall 1"; break;
-        case 0x04: return "Hall 2"; break;
-        case 0x05: return "Plate"; break;
-        case 0x06: return "Delay"; break;
-        case 0x07: return "Panning Delay"; break;
-
-        default: return "<Unknown>";
-    }
+        "Room 1",
+        "Room 2",
+        "Room 3",
+        "Hall 1",
+        "Hall 2",
+        "Plate",
+        "Delay",
+        "Panning Delay",
+    };
+
+    return (value < _countof(Names)) ? Names[value] : "<Unknown>";
 }
 
 const char * sysex_t::IdentifyGSChorusMacro(uint8_t value) noexcept
 {
-    switch (value)
+    static constexpr const char * Names[] =
     {
-        case 0x00: return "Chorus 1"; break;
-        case 0x01: return "Chorus 2"; break;
-        case 0x02: return "Chorus 3"; break;
-        case 0x03: return "Chorus 4"; break;
-        case 0x04: return "Feedback Chorus"; break;
-        case 0x05: return "Flanger"; break;
-        case 0x06: return "Short Delay"; break;
-        case 0x07: return "Short Delay (FB)"; break;
-
-        default: return "<Unknown>";
-    }
+        "Chorus 1",
+        "Chorus 2",
+        "Chorus 3",
+        "Chorus 4",
+        "Feedback Chorus",
+        "Flanger",
+        "Short Delay",
+        "Short Delay (FB)",
+    };
+
+    return (value < _countof(Names)) ? Names[value] : "<Unknown>";
 }
 
 const char * sysex_t::IdentifyGSDelayMacro(uint8_t value) noexcept
 {
-    switch (value)
+    static constexpr const char * Names[] =
     {
-        case 0x00: return "Delay 1"; break;
-        case 0x01: return "Delay 2"; break;
-        case 0x02: return "Delay 3"; break;
-        case 0x03: return "Delay 4"; break;
-        case 0x04: return "Pan Delay 1"; break;
-        case 0x05: return "Pan Delay 2"; break;
-        case 0x06: return "Pan Delay 3"; break;
-        case 0x07: return "Pan Delay 4"; break;
-        case 0x08: return "Delay to Reverb"; break;
-        case 0x09: return "Pan Repeat"; break;
-
-        default: return "<Unknown>";
-    }
+        "Delay 1",
+        "Delay 2",
+        "Delay 3",
+        "Delay 4",
+        "Pan Delay 1",
+        "Pan Delay 2",
+        "Pan Delay 3",
+        "Pan Delay 4",
+        "Delay to Reverb",
+        "Pan Repeat",
+    };
+
+    return (value < _countof(Names)) ? Names[value] : "<Unknown>";
 }
 
 const char * sysex_t::IdentifyGSRhythmPart(uint8_t value) noexcept
 {
-    switch (value)
+    static constexpr const char * Names[] =
     {
-        case 0x00: return "Off"; break;
-        case 0x01: return "Map 1"; break;
-        case 0x02: return "Map 2"; break;
+        "Off",
+        "Map 1",
+        "Map 2",
+    };
 
-        default: return "<Unknown>";
-    }
+    return (value < _countof(Names)) ? Names[value] : "<Unknown>";
 }
 
 const char * sysex_t::IdentifyGSToneMap(uint8_t value) noexcept
 {
-    switch (value)
+    static constexpr const char * Names[] =
     {
-        case 0x00: return "Selected"; break;
-        case 0x01: return "SC-55 Map"; break;
-        case 0x02: return "SC-88 Map"; break;
-        case 0x03: return "SC-88Pro Map"; break;
-        case 0x04: return "SC-8850 Map"; break;
-
-        default: return "<Unknown>";
-    }
+        "Selected",
+        "SC-55 Map",
+        "SC-88 Map",
+        "SC-88Pro Map",
+        "SC-8850 Map",
+    };
+
+    return (value < _countof(Names)) ? Names[value] : "<Unknown>";
 }
 
 /// <summary>
@@ -1,21 +1,90 @@
 
-/** $VER: SysEx.h (2025.08.26) **/
+/** $VER: SysEx.h (2026.10.19) **/
 
 #pragma once
 
 #include "pch.h"
 
+#ifdef _MSC_VER
 #include <CppCoreCheck/Warnings.h>
 
 #pragma warning(disable: 4625 4626 ALL_CPPCORECHECK_WARNINGS)
+#endif
 
 #include "MIDI.h"
 
+#include <optional>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+
 namespace midi
 {
 
 #pragma warning(disable: 4820)
 
+/// <summary>
+/// Identifies well-known SysEx messages.
+/// </summary>
+enum class sysex_type_t : uint8_t
+{
+    Unknown = 0,
+
+    GM1SystemOn,
+    GM1SystemOff,
+    GM2SystemOn,
+
+    GSReset,
+    MT32Reset,
+    D50Reset,
+
+    XGSystemOn,
+    XGReset,
+
+    DLSOn,
+    DLSOff,
+    DLSStaticVoiceAllocationOff,
+    DLSStaticVoiceAllocationOn,
+
+    IdentityRequest,
+    IdentityReply,
+
+    MasterVolume,
+    MasterBalance,
+    MasterFineTune,
+    MasterCoarseTune,
+
+    RolandParameter,            // RQ1 or DT1 message with an address.
+    YamahaParameter,            // XG parameter change with an address.
+};
+
+/// <summary>
+/// Represents the result of a SysEx checksum check.
+/// </summary>
+enum class sysex_checksum_t : uint8_t
+{
+    None = 0,                   // The message has no checksum.
+    Valid,
+    Invalid,
+};
+
+/// <summary>
+/// Represents the enum-coded identification of a SysEx message. Use sysex_t::Identify() to render the description.
+/// </summary>
+struct sysex_info_t
+{
+    uint32_t Manufacturer;      // 1-byte id or 3-byte id (00 xx yy)
+    uint32_t Model;             // Model id (Roland, Yamaha)
+    uint32_t Address;           // Parameter address (Roland, Yamaha)
+    uint16_t DataOffset;        // Offset of the first data byte after the address
+    uint8_t DeviceId;
+    uint8_t Command;            // Command id (Roland) or Sub-ID #1 (Universal)
+    uint8_t SubCommand;         // Sub-ID #2 (Universal)
+    sysex_type_t Type;
+    sysex_checksum_t Checksum;
+    bool IsExtendedId;          // True if Manufacturer is a 3-byte id
+};
+
 class sysex_t
 {
 public:
@@ -32,6 +101,8 @@ public:
 
     void Identify() noexcept;
 
+    static sysex_info_t Classify(std::span<const uint8_t> data) noexcept;
+
     std::string Manufacturer;
     std::string Model;
     std::string Command;
@@ -157,6 +228,41 @@ private:
     std::vector<uint8_t>::iterator _Iter;
 };
 
+/// <summary>
+/// Implements a cache that classifies and identifies each unique SysEx message only once. Not thread-safe.
+/// The cache is emptied when it holds maxCount messages. This invalidates the references returned by earlier calls.
+/// </summary>
+class sysex_cache_t
+{
+public:
+    sysex_cache_t(size_t maxCount = 4096) noexcept : _MaxCount(maxCount) { }
+
+    const sysex_info_t & Classify(std::span<const uint8_t> data);
+    const sysex_t & Identify(std::span<const uint8_t> data);
+
+    size_t Size() const noexcept { return _Items.size(); }
+    void Clear() noexcept { _Items.clear(); }
+
+private:
+    struct item_t
+    {
+        sysex_info_t Info;
+        std::optional<sysex_t> SysEx;   // Only rendered when the description is requested.
+    };
+
+    struct hash_t
+    {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view key) const noexcept { return std::hash<std::string_view>()(key); }
+    };
+
+    item_t & GetItem(std::span<const uint8_t> data);
+
+    std::unordered_map<std::string, item_t, hash_t, std::equal_to<>> _Items;
+    size_t _MaxCount;
+};
+
 /// <summary>
 /// Maps a value from one range (srcMin, srcMax) to another (dstMin, dstMax).
 /// </summary>
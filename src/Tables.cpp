@@ -1,12 +1,14 @@
 
-/** $VER: Tables.cpp (2025.07.16) **/
+/** $VER: Tables.cpp (2026.10.19) **/
 
 #include "pch.h"
 
 #include "Tables.h"
 
 // https://midi.org/sysexidtable + https://www.amei.or.jp/report/System_ID_e.html
-const std::unordered_map<uint32_t, const char *> Manufacturers =
+
+// 1-byte Ids
+static constexpr manufacturer_t Manufacturers[] =
 {
     { 0x01, "Sequential Circuits / Dave Smith Instruments" },
     { 0x02, "IDP" },
@@ -112,7 +114,11 @@ const std::unordered_map<uint32_t, const char *> Manufacturers =
     { 0x7D, "Private Use" },
     { 0x7E, "Universal (Non-Real Time)" },
     { 0x7F, "Universal (Real Time)" },
+};
 
+// 3-byte Ids (00 xx yy), sorted by Id.
+static constexpr manufacturer_t ExtendedManufacturers[] =
+{
     // 0x0001 - 0x1F7F American
     { 0x000001, "Time/Warner Interactive" },
     { 0x000002, "Advanced Gravis Comp." },
@@ -606,7 +612,6 @@ const std::unordered_map<uint32_t, const char *> Manufacturers =
     { 0x002105, "Fairlight Instruments Pty Ltd" },
     { 0x002106, "Musicom Lab" },
     { 0x002107, "Modal Electronics (Modulus/VacoLoco)" },
-    { 0x002107, "Modal Electronics" },
     { 0x002108, "RWA (Hong Kong) Limited" },
     { 0x002109, "Native Instruments" },
     { 0x00210A, "Naonext" },
@@ -616,7 +621,6 @@ const std::unordered_map<uint32_t, const char *> Manufacturers =
     { 0x00210E, "Surfin Kangaroo Studio" },
     { 0x00210F, "Philips Electronics HK Ltd" },
     { 0x002110, "ROLI Ltd" },
-    { 0x002110, "Roli" },
     { 0x002111, "Panda-Audio Ltd" },
     { 0x002112, "BauM Software" },
     { 0x002113, "Machinewerks Ltd." },
@@ -640,7 +644,6 @@ const std::unordered_map<uint32_t, const char *> Manufacturers =
     { 0x002125, "Changsha Hotone Audio Co Ltd" },
     { 0x002126, "Expressive E" },
     { 0x002127, "Expert Sleepers Ltd" },
-    { 0x002127, "Expert Sleepers" },
     { 0x002128, "Timecode-Vision Technology" },
     { 0x002129, "Hornberg Research GbR" },
     { 0x00212A, "Sonic Potions" },
@@ -655,7 +658,6 @@ const std::unordered_map<uint32_t, const char *> Manufacturers =
     { 0x002133, "AODYO SAS" },
     { 0x002134, "Pianoforce S.R.O" },
     { 0x002135, "Dreadbox P.C." },
-    { 0x002135, "Dreadbox" },
     { 0x002136, "TouchKeys Instruments Ltd" },
     { 0x002137, "The Gigrig Ltd" },
     { 0x002138, "ALM Co" },
@@ -668,7 +670,6 @@ const std::unordered_map<uint32_t, const char *> Manufacturers =
     { 0x00213F, "Supercritical Ltd" },
     { 0x002140, "Genki Instruments" },
     { 0x002141, "Marienberg Devices Germany" },
-    { 0x002141, "Marienberg" },
     { 0x002142, "Supperware Ltd" },
     { 0x002143, "Imoxplus BVBA" },
     { 0x002144, "Swapp Technologies SRL" },
@@ -763,3 +764,33 @@ const std::unordered_map<uint32_t, const char *> Manufacturers =
 
     // 0x6000 - 0x7F7F Other
 };
+
+/// <summary>
+/// Builds a lookup table indexed by 1-byte manufacturer Id.
+/// </summary>
+static constexpr std::array<const char *, 128> BuildManufacturerIndex() noexcept
+{
+    std::array<const char *, 128> Index = { };
+
+    for (const auto & m : Manufacturers)
+        Index[m.Id] = m.Name;
+
+    return Index;
+}
+
+static constexpr std::array<const char *, 128> ManufacturerIndex = BuildManufacturerIndex();
+
+static_assert(std::adjacent_find(std::begin(ExtendedManufacturers), std::end(ExtendedManufacturers), [](const manufacturer_t & a, const manufacturer_t & b) { return a.Id >= b.Id; }) == std::end(ExtendedManufacturers), "ExtendedManufacturers must be sorted by Id without duplicates.");
+
+/// <summary>
+/// Gets the name of a manufacturer. Returns nullptr if the Id is unknown.
+/// </summary>
+const char * GetManufacturerName(uint32_t id, bool isExtended) noexcept
+{
+    if (!isExtended)
+        return (id < ManufacturerIndex.size()) ? ManufacturerIndex[id] : nullptr;
+
+    auto it = std::lower_bound(std::begin(ExtendedManufacturers), std::end(ExtendedManufacturers), id, [](const manufacturer_t & m, uint32_t id) { return m.Id < id; });
+
+    return ((it != std::end(ExtendedManufacturers)) && (it->Id == id)) ? it->Name : nullptr;
+}
@@ -1,6 +1,17 @@
 
-/** $VER: Tables.h (2025.07.16) P. Stuer **/
+/** $VER: Tables.h (2026.10.19) P. Stuer **/
 
 #pragma once
 
-extern const std::unordered_map<uint32_t, const char *> Manufacturers;
+#include <array>
+
+/// <summary>
+/// Represents a manufacturer of the SysEx Id table.
+/// </summary>
+struct manufacturer_t
+{
+    uint32_t Id;
+    const char * Name;
+};
+
+extern const char * GetManufacturerName(uint32_t id, bool isExtended) noexcept;
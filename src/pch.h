@@ -1,17 +1,20 @@
 
-/** $VER: pch.h (2026.10.04) P. Stuer **/
+/** $VER: pch.h (2026.10.19) P. Stuer **/
 
 #pragma once
 
+#ifdef _MSC_VER
 #include <CppCoreCheck/Warnings.h>
 
 #pragma warning(disable: 4100 4625 4626 4710 4711 4738 5045 ALL_CPPCORECHECK_WARNINGS)
+#endif
 
 // UTF-8 Everywhere recommendation
 #ifndef _UNICODE
 #error Unicode character set compilation not enabled.
 #endif
 
+#ifdef _WIN32
 #include <SDKDDKVer.h>
 
 #define NOMINMAX
@@ -19,6 +22,9 @@
 #include <WinSock2.h>
 #include <Windows.h>
 #include <wincodec.h>
+#else
+#include <Compat.h>
+#endif
 
 #pragma warning(disable: 4242)
 #include <algorithm>
@@ -29,14 +35,22 @@
 #include <cstdint>
 #include <cstdio>
 #include <cstring>
+#include <filesystem>
+#if __has_include(<format>)
 #include <format>
+#else
+#include <Format.h>
+#endif
 #include <fstream>
 #include <functional>
 #include <iostream>
 #include <iomanip>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <libmsc.h>
@@ -52,13 +66,7 @@
 #define TOSTRING_IMPL(x) #x
 #define TOSTRING(x) TOSTRING_IMPL(x)
 
-#ifndef THIS_HINSTANCE
+#if defined(_WIN32) && !defined(THIS_HINSTANCE)
 EXTERN_C IMAGE_DOS_HEADER __ImageBase;
 #define THIS_HINSTANCE ((HINSTANCE) &__ImageBase)
 #endif
-
-#ifdef _DEBUG
-#define _RCP_VERBOSE
-#else
-#undef _RCP_VERBOSE
-#endif
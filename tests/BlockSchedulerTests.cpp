@@ -0,0 +1,229 @@
+
+/** $VER: BlockSchedulerTests.cpp (2026.10.19) P. Stuer - Tests the splitting of a timed message stream into render blocks **/
+
+#include "Test.h"
+
+#include "BlockScheduler.h"
+
+#include <random>
+
+using namespace midi;
+
+namespace
+{
+
+/// <summary>
+/// Adds a Note On event to a track.
+/// </summary>
+void AddNote(track_t & track, uint32_t time, uint8_t note)
+{
+    const uint8_t Data[] = { note, 0x64 };
+
+    track.AddEvent(event_t(time, event_t::NoteOn, 0, Data, _countof(Data)));
+}
+
+/// <summary>
+/// Adds a Set Tempo meta data event to a track.
+/// </summary>
+void AddTempo(track_t & track, uint32_t time, uint32_t tempo)
+{
+    const uint8_t Data[] = { StatusCode::MetaData, MetaDataType::SetTempo, (uint8_t) (tempo >> 16), (uint8_t) (tempo >> 8), (uint8_t) tempo };
+
+    track.AddEvent(event_t(time, event_t::Extended, 0, Data, _countof(Data)));
+}
+
+/// <summary>
+/// Creates a stream with a timestamp in ms. A tick lasts 5 ms until the tempo doubles at 450 ms and 2.5 ms after that.
+/// The notes play at 0, 100, 250, 475 and 525 ms.
+/// </summary>
+std::vector<timed_message_t> CreateStream()
+{
+    track_t Track;
+
+    AddTempo(Track, 0, 500'000);
+
+    AddNote(Track,   0, 60);
+    AddNote(Track,  20, 61);
+    AddNote(Track,  50, 62);
+
+    AddTempo(Track, 90, 250'000);
+
+    AddNote(Track, 100, 63);
+    AddNote(Track, 120, 64);
+
+    const uint8_t EndOfTrack[] = { StatusCode::MetaData, MetaDataType::EndOfTrack };
+
+    Track.AddEvent(event_t(120, event_t::Extended, 0, EndOfTrack, _countof(EndOfTrack)));
+
+    container_t Container;
+
+    Container.Initialize(0, 100);
+    Container.AddTrack(Track);
+
+    std::vector<timed_message_t> Stream;
+    sysex_table_t SysExTable;
+    std::vector<uint8_t> PortNumbers;
+    uint32_t LoopBegin, LoopEnd;
+
+    Container.SerializeAsStream(0, Stream, SysExTable, PortNumbers, LoopBegin, LoopEnd, event_filter_t(), 1'000);
+
+    return Stream;
+}
+
+/// <summary>
+/// Returns true if the block contains the messages with the specified offsets and notes.
+/// </summary>
+bool IsBlock(const std::vector<scheduled_message_t> & messages, std::initializer_list<std::pair<uint32_t, uint8_t>> expected)
+{
+    if (messages.size() != expected.size())
+        return false;
+
+    size_t i = 0;
+
+    for (const auto & [ Offset, Note ] : expected)
+    {
+        if ((messages[i].Offset != Offset) || (((messages[i].Data >> 8) & 0xFFu) != Note))
+            return false;
+
+        ++i;
+    }
+
+    return true;
+}
+
+}
+
+TEST_CASE(MessagesAreSplitAtBlockBoundaries)
+{
+    const std::vector<timed_message_t> Stream = CreateStream();
+
+    CHECK(Stream.size() == 5);
+
+    block_scheduler_t Scheduler;
+
+    Scheduler.SetStream(&Stream);
+
+    std::vector<scheduled_message_t> Messages;
+
+    Scheduler.NextBlock(100, Messages);
+
+    CHECK(IsBlock(Messages, { { 0, 60 } }));
+    CHECK(Scheduler.GetTime() == 100);
+
+    // A message exactly on a block boundary belongs to the block that starts there.
+    Scheduler.NextBlock(100, Messages);
+
+    CHECK(IsBlock(Messages, { { 0, 61 } }));
+
+    Scheduler.NextBlock(100, Messages);
+
+    CHECK(IsBlock(Messages, { { 50, 62 } }));
+
+    Scheduler.NextBlock(100, Messages);
+
+    CHECK(Messages.empty());
+    CHECK(!Scheduler.IsDone());
+
+    // The tempo changes in the middle of this block.
+    Scheduler.NextBlock(100, Messages);
+
+    CHECK(IsBlock(Messages, { { 75, 63 } }));
+
+    Scheduler.NextBlock(100, Messages);
+
+    CHECK(IsBlock(Messages, { { 25, 64 } }));
+    CHECK(Scheduler.IsDone());
+    CHECK(Scheduler.GetTime() == 600);
+
+    // A block that ends exactly on a message does not contain it.
+    Scheduler.SetStream(&Stream);
+
+    Scheduler.NextBlock(250, Messages);
+
+    CHECK(IsBlock(Messages, { { 0, 60 }, { 100, 61 } }));
+
+    Scheduler.NextBlock(250, Messages);
+
+    CHECK(IsBlock(Messages, { { 0, 62 }, { 225, 63 } }));
+}
+
+TEST_CASE(BlocksOfAnySizeCoverTheStream)
+{
+    const std::vector<timed_message_t> Stream = CreateStream();
+
+    std::mt19937 Random(42);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        block_scheduler_t Scheduler;
+
+        Scheduler.SetStream(&Stream);
+
+        std::vector<timed_message_t> Result;
+        std::vector<scheduled_message_t> Messages;
+
+        while (!Scheduler.IsDone())
+        {
+            const uint64_t BlockStart = Scheduler.GetTime();
+            const uint32_t BlockSize = 1 + Random() % 200;
+
+            Scheduler.NextBlock(BlockSize, Messages);
+
+            for (const auto & Message : Messages)
+            {
+                CHECK(Message.Offset < BlockSize);
+
+                Result.push_back({ BlockStart + Message.Offset, Message.Data });
+            }
+        }
+
+        bool IsEqual = (Result.size() == Stream.size());
+
+        for (size_t j = 0; IsEqual && (j < Result.size()); ++j)
+            IsEqual = (Result[j].Time == Stream[j].Time) && (Result[j].Data == Stream[j].Data);
+
+        CHECK(IsEqual);
+    }
+}
+
+TEST_CASE(SetTimeStartsAtTheNextMessage)
+{
+    const std::vector<timed_message_t> Stream = CreateStream();
+
+    block_scheduler_t Scheduler;
+
+    Scheduler.SetStream(&Stream);
+
+    std::vector<scheduled_message_t> Messages;
+
+    // A message at the new time is played at the start of the next block.
+    Scheduler.SetTime(250);
+
+    CHECK(Scheduler.GetPosition() == 2);
+
+    Scheduler.NextBlock(100, Messages);
+
+    CHECK(IsBlock(Messages, { { 0, 62 } }));
+
+    // Messages before the new time are skipped.
+    Scheduler.SetTime(251);
+
+    CHECK(Scheduler.GetPosition() == 3);
+
+    Scheduler.NextBlock(250, Messages);
+
+    CHECK(IsBlock(Messages, { { 224, 63 } }));
+
+    Scheduler.SetTime(600);
+
+    CHECK(Scheduler.IsDone());
+
+    // Without a stream, the blocks are empty and only the time advances.
+    block_scheduler_t Empty;
+
+    Empty.NextBlock(100, Messages);
+
+    CHECK(Messages.empty());
+    CHECK(Empty.IsDone());
+    CHECK(Empty.GetTime() == 100);
+}
@@ -0,0 +1,34 @@
+
+/** $VER: CompatTests.cpp (2026.10.19) P. Stuer - Tests the compatibility layer **/
+
+#include "Test.h"
+
+#include <libmsc.h>
+
+TEST_CASE(FormatReplacesFields)
+{
+    CHECK(std::format("{} {}", 1, "two") == "1 two");
+    CHECK(std::format("{{}} {}", 3) == "{} 3");
+}
+
+TEST_CASE(FormatTextFormatsPrintfStyle)
+{
+    CHECK(msc::FormatText("%d-%s", 42, "x") == "42-x");
+    CHECK(msc::FormatText("%s", std::string(1000, 'a').c_str()).size() == 1000);
+}
+
+TEST_CASE(UTF8RoundTrips)
+{
+    const std::string Text = "Fr\xC3\xA8re \xE3\x81\x82";
+
+    CHECK(msc::WideToUTF8(msc::UTF8ToWide(Text)) == Text);
+    CHECK(msc::UTF8ToWide("abc") == L"abc");
+}
+
+TEST_CASE(TextToUTF8KeepsUTF8AndConvertsShiftJIS)
+{
+    CHECK(msc::TextToUTF8("plain") == "plain");
+    CHECK(msc::TextToUTF8("\xE3\x81\x82") == "\xE3\x81\x82");
+    CHECK(msc::TextToUTF8("\x82\xA0") == "\xE3\x81\x82");
+    CHECK(msc::TextToUTF8(nullptr).empty());
+}
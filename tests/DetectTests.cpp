@@ -0,0 +1,83 @@
+
+/** $VER: DetectTests.cpp (2026.10.19) P. Stuer - Tests the format detection **/
+
+#include "Test.h"
+
+#include "MIDIProcessor.h"
+
+using namespace midi;
+
+namespace
+{
+
+const uint8_t SMFHeader[] = { 'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 1, 0, 2, 0, 0x60, 'M', 'T', 'r', 'k' };
+
+/// <summary>
+/// Creates an MMD file of the specified size with valid track offsets.
+/// </summary>
+std::vector<uint8_t> CreateMMD(size_t size, uint8_t firstByte)
+{
+    std::vector<uint8_t> Data(size, 0);
+
+    Data[0] = firstByte;
+
+    for (size_t i = 0; i < 18; ++i)
+        Data[2 + i * 4] = (uint8_t) (0x4A + i);
+
+    return Data;
+}
+
+}
+
+TEST_CASE(DetectsCompleteSignatures)
+{
+    const detection_t Detection = processor_t::Detect(SMFHeader, sizeof(SMFHeader), 1000);
+
+    CHECK(Detection.Format == FileFormat::SMF);
+    CHECK(Detection.Confidence == confidence_t::High);
+
+    const uint8_t SysEx[] = { 0xF0, 0x41, 0x10, 0x42, 0xF7 };
+
+    CHECK(processor_t::Detect(SysEx, sizeof(SysEx), sizeof(SysEx)).Format == FileFormat::SYX);
+    CHECK(processor_t::Detect(SysEx, sizeof(SysEx), sizeof(SysEx)).Confidence == confidence_t::High);
+}
+
+TEST_CASE(IncompleteHeaderHasMediumConfidence)
+{
+    // Only the signature is available.
+    CHECK(processor_t::Detect(SMFHeader, 8, 1000).Format == FileFormat::SMF);
+    CHECK(processor_t::Detect(SMFHeader, 8, 1000).Confidence == confidence_t::Medium);
+
+    // The complete file is only 8 bytes long, so the header is invalid.
+    CHECK(processor_t::Detect(SMFHeader, 8, 8).Confidence == confidence_t::Low);
+
+    const uint8_t MUS[] = { 'M', 'U', 'S', 0x1A, 0x10, 0x00 };
+
+    CHECK(processor_t::Detect(MUS, sizeof(MUS), 4096).Format == FileFormat::MUS);
+    CHECK(processor_t::Detect(MUS, sizeof(MUS), 4096).Confidence == confidence_t::Medium);
+
+    const std::vector<uint8_t> MMD = CreateMMD(256, 0x00);
+
+    CHECK(processor_t::Detect(MMD.data(), 20, MMD.size(), L"song.mmd").Format == FileFormat::MMD);
+    CHECK(processor_t::Detect(MMD.data(), 20, MMD.size(), L"song.mmd").Confidence == confidence_t::Medium);
+}
+
+TEST_CASE(FileExtensionTakesPriorityOverSysEx)
+{
+    const std::vector<uint8_t> MMD = CreateMMD(256, 0xF0);
+
+    CHECK(processor_t::Detect(MMD, L"song.mmd").Format == FileFormat::MMD);
+    CHECK(processor_t::Detect(MMD.data(), 64, MMD.size(), L"song.mmd").Format == FileFormat::MMD);
+
+    // Without the extension the data is taken for an incomplete SysEx dump.
+    CHECK(processor_t::Detect(MMD.data(), 64, MMD.size(), L"song.syx").Format == FileFormat::SYX);
+    CHECK(processor_t::Detect(MMD.data(), 64, MMD.size(), L"song.syx").Confidence == confidence_t::Medium);
+}
+
+TEST_CASE(UnknownData)
+{
+    const uint8_t Data[] = { 'a', 'b', 'c', 'd' };
+
+    CHECK(processor_t::Detect(Data, sizeof(Data), sizeof(Data)).Confidence == confidence_t::None);
+    CHECK(processor_t::Detect(Data, 0, 0).Confidence == confidence_t::None);
+}
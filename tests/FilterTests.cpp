@@ -0,0 +1,308 @@
+
+/** $VER: FilterTests.cpp (2026.10.19) P. Stuer - Tests the event filter and its parity with the clean flags **/
+
+#include "Test.h"
+
+#include "MIDIContainer.h"
+
+using namespace midi;
+
+namespace
+{
+
+/// <summary>
+/// Adds a channel or meta data event to a track.
+/// </summary>
+void AddEvent(track_t & track, uint32_t time, event_t::event_type_t type, uint32_t channel, std::initializer_list<uint8_t> data)
+{
+    const std::vector<uint8_t> Data(data);
+
+    track.AddEvent(event_t(time, type, channel, Data.data(), Data.size()));
+}
+
+/// <summary>
+/// Adds an End of Track event to a track.
+/// </summary>
+void AddEndOfTrack(track_t & track, uint32_t time)
+{
+    AddEvent(track, time, event_t::Extended, 0, { StatusCode::MetaData, MetaDataType::EndOfTrack });
+}
+
+/// <summary>
+/// Creates a format 1 container with channel events of each type, a track designated for an EMIDI device other than General MIDI, a track for all EMIDI devices and a track on port 1.
+/// The events that the clean flags remove are left out of the container when skipCleaned is true, so the result is what the clean flags used to produce.
+/// </summary>
+void CreateContainer(container_t & container, uint32_t cleanFlags, bool skipCleaned)
+{
+    const bool SkipEMIDI       = skipCleaned && (cleanFlags & container_t::CleanFlagEMIDI);
+    const bool SkipInstruments = skipCleaned && (cleanFlags & container_t::CleanFlagInstruments);
+    const bool SkipBanks       = skipCleaned && (cleanFlags & container_t::CleanFlagBanks);
+
+    container.Initialize(1, 96);
+
+    {
+        track_t Track;
+
+        AddEvent(Track, 0, event_t::Extended, 0, { StatusCode::MetaData, MetaDataType::SetTempo, 0x07, 0xA1, 0x20 });
+        AddEndOfTrack(Track, 0);
+
+        container.AddTrack(Track);
+    }
+
+    {
+        track_t Track;
+
+        if (!SkipBanks)
+        {
+            AddEvent(Track, 0, event_t::ControlChange, 0, { Controller::BankSelect, 0x01 });
+            AddEvent(Track, 0, event_t::ControlChange, 0, { Controller::BankSelectLSB, 0x02 });
+        }
+
+        if (!SkipInstruments)
+            AddEvent(Track, 0, event_t::ProgramChange, 0, { 0x05 });
+
+        AddEvent(Track, 0, event_t::ControlChange, 0, { Controller::ChannelVolume, 0x64 });
+        AddEvent(Track, 0, event_t::ControlChange, 0, { 0x64, 0x00 });
+
+        AddEvent(Track, 10, event_t::NoteOn, 0, { 0x3C, 0x64 });
+        AddEvent(Track, 20, event_t::NoteOff, 0, { 0x3C, 0x40 });
+
+        if (!SkipInstruments)
+            AddEvent(Track, 30, event_t::ProgramChange, 1, { 0x10 });
+
+        AddEvent(Track, 30, event_t::NoteOn, 1, { 0x40, 0x64 });
+        AddEvent(Track, 40, event_t::PitchBendChange, 1, { 0x00, 0x50 });
+        AddEvent(Track, 50, event_t::NoteOn, 1, { 0x40, 0x00 });
+
+        AddEndOfTrack(Track, 50);
+
+        container.AddTrack(Track);
+    }
+
+    // A track designated for the Sound Blaster (EMIDI Track Designation 2)
+    if (!SkipEMIDI)
+    {
+        track_t Track;
+
+        AddEvent(Track, 0, event_t::ControlChange, 2, { 110, 0x02 });
+        AddEvent(Track, 15, event_t::NoteOn, 2, { 0x30, 0x64 });
+        AddEvent(Track, 25, event_t::NoteOn, 2, { 0x30, 0x00 });
+
+        AddEndOfTrack(Track, 25);
+
+        container.AddTrack(Track);
+    }
+
+    // A track designated for all devices
+    {
+        track_t Track;
+
+        AddEvent(Track, 0, event_t::ControlChange, 4, { 110, 0x7F });
+
+        if (!SkipBanks)
+            AddEvent(Track, 5, event_t::ControlChange, 4, { Controller::BankSelect, 0x03 });
+
+        AddEvent(Track, 35, event_t::NoteOn, 4, { 0x34, 0x64 });
+        AddEvent(Track, 45, event_t::NoteOn, 4, { 0x34, 0x00 });
+
+        AddEndOfTrack(Track, 45);
+
+        container.AddTrack(Track);
+    }
+
+    // A track on port 1
+    {
+        track_t Track;
+
+        AddEvent(Track, 0, event_t::Extended, 0, { StatusCode::MetaData, MetaDataType::MIDIPort, 0x01 });
+        AddEvent(Track, 25, event_t::NoteOn, 3, { 0x38, 0x64 });
+        AddEvent(Track, 35, event_t::NoteOn, 3, { 0x38, 0x00 });
+
+        AddEndOfTrack(Track, 35);
+
+        container.AddTrack(Track);
+    }
+}
+
+/// <summary>
+/// Serializes the container, skipping the events that match the filter.
+/// </summary>
+std::vector<message_t> Serialize(const container_t & container, const event_filter_t & filter)
+{
+    std::vector<message_t> Stream;
+    sysex_table_t SysExTable;
+    std::vector<uint8_t> PortNumbers;
+    uint32_t LoopBegin, LoopEnd;
+
+    container.SerializeAsStream(0, Stream, SysExTable, PortNumbers, LoopBegin, LoopEnd, filter);
+
+    return Stream;
+}
+
+/// <summary>
+/// Returns true if both streams contain the same messages at the same times.
+/// </summary>
+bool IsEqual(const std::vector<message_t> & a, const std::vector<message_t> & b)
+{
+    if (a.size() != b.size())
+        return false;
+
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        if ((a[i].Time != b[i].Time) || (a[i].Data != b[i].Data))
+            return false;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Counts the messages with the specified status byte and, optionally, the specified first data byte.
+/// </summary>
+size_t Count(const std::vector<message_t> & stream, uint8_t status, int data1 = -1)
+{
+    size_t n = 0;
+
+    for (const auto & Message : stream)
+    {
+        if (Message.IsSysEx() || ((Message.Data & 0xFFu) != status))
+            continue;
+
+        if ((data1 < 0) || (((Message.Data >> 8) & 0xFFu) == (uint32_t) data1))
+            ++n;
+    }
+
+    return n;
+}
+
+}
+
+TEST_CASE(EmptyFilterKeepsAllEvents)
+{
+    container_t Container;
+
+    CreateContainer(Container, 0, false);
+
+    const event_filter_t Filter;
+
+    CHECK(Filter.IsEmpty());
+    CHECK(Serialize(Container, Filter).size() == 20);
+
+    // Extended events can not be removed.
+    CHECK(event_filter_t().RemoveEventTypes(1u << event_t::Extended).IsEmpty());
+
+    // An empty time range is ignored.
+    CHECK(event_filter_t().RemoveTimeRange(10, 10).IsEmpty());
+}
+
+TEST_CASE(FilterRemovesEachCategory)
+{
+    container_t Container;
+
+    CreateContainer(Container, 0, false);
+
+    const std::vector<message_t> All = Serialize(Container, event_filter_t());
+
+    // Event types
+    {
+        const auto Stream = Serialize(Container, event_filter_t().RemoveEventTypes((1u << event_t::PitchBendChange) | (1u << event_t::NoteOff)));
+
+        CHECK(Count(Stream, 0xE1) == 0);
+        CHECK(Count(Stream, 0x80) == 0);
+        CHECK(Stream.size() == All.size() - 2);
+    }
+
+    // Channels
+    {
+        const auto Stream = Serialize(Container, event_filter_t().RemoveChannels(1u << 1));
+
+        CHECK(Count(Stream, 0xC1) + Count(Stream, 0x91) + Count(Stream, 0xE1) == 0);
+        CHECK(Count(Stream, 0x90) == 1);
+        CHECK(Stream.size() == All.size() - 4);
+    }
+
+    // Ports: the track on port 1 is removed.
+    {
+        const auto Stream = Serialize(Container, event_filter_t().RemovePorts(1ULL << 1));
+
+        CHECK(Count(Stream, 0x93) == 0);
+        CHECK(Stream.size() == All.size() - 2);
+    }
+
+    // Controllers in the lower and in the upper half of the controller range
+    {
+        const auto Stream = Serialize(Container, event_filter_t().RemoveControllers(Controller::ChannelVolume, Controller::ChannelVolume).RemoveControllers(100, 110));
+
+        CHECK(Count(Stream, 0xB0, Controller::ChannelVolume) == 0);
+        CHECK(Count(Stream, 0xB0, 100) == 0);
+        CHECK(Count(Stream, 0xB2, 110) + Count(Stream, 0xB4, 110) == 0);
+        CHECK(Count(Stream, 0xB0, Controller::BankSelect) == 1);
+        CHECK(Stream.size() == All.size() - 4);
+    }
+
+    // Time ranges are half-open.
+    {
+        const auto Stream = Serialize(Container, event_filter_t().RemoveTimeRange(10, 25));
+
+        CHECK(Count(Stream, 0x90) == 0);
+        CHECK(Count(Stream, 0x80) == 0);
+        CHECK(Count(Stream, 0x92) == 1); // The note on channel 2 starts at 15. Its Note Off at 25 is kept.
+        CHECK(Stream.size() == All.size() - 3);
+    }
+
+    // EMIDI tracks for other devices
+    {
+        const auto Stream = Serialize(Container, event_filter_t().RemoveEMIDITracks());
+
+        CHECK(Count(Stream, 0x92) + Count(Stream, 0xB2) == 0);
+        CHECK(Count(Stream, 0x94) == 2);
+        CHECK(Stream.size() == All.size() - 3);
+    }
+}
+
+TEST_CASE(ApplyFilterRemovesTheSameEvents)
+{
+    const event_filter_t Filter = event_filter_t().RemoveChannels(1u << 1).RemovePorts(1ULL << 1).RemoveEMIDITracks();
+
+    container_t Container;
+
+    CreateContainer(Container, 0, false);
+
+    const auto Expected = Serialize(Container, Filter);
+
+    CHECK(Container.ApplyFilter(Filter) == 9);
+    CHECK(IsEqual(Serialize(Container, event_filter_t()), Expected));
+
+    // Nothing is left to remove.
+    CHECK(Container.ApplyFilter(Filter) == 0);
+}
+
+TEST_CASE(CleanFlagsMatchTheirFilter)
+{
+    const uint32_t AllFlags = container_t::CleanFlagEMIDI | container_t::CleanFlagInstruments | container_t::CleanFlagBanks;
+
+    for (uint32_t CleanFlags = 0; CleanFlags <= AllFlags; ++CleanFlags)
+    {
+        container_t Container;
+
+        CreateContainer(Container, CleanFlags, false);
+
+        container_t Cleaned;
+
+        CreateContainer(Cleaned, CleanFlags, true);
+
+        const auto Expected = Serialize(Cleaned, event_filter_t());
+
+        CHECK(IsEqual(Serialize(Container, event_filter_t::FromCleanFlags(CleanFlags)), Expected));
+        CHECK(event_filter_t::FromCleanFlags(CleanFlags).IsEmpty() == (CleanFlags == 0));
+
+        std::vector<message_t> Stream;
+        sysex_table_t SysExTable;
+        std::vector<uint8_t> PortNumbers;
+        uint32_t LoopBegin, LoopEnd;
+
+        Container.SerializeAsStream(0, Stream, SysExTable, PortNumbers, LoopBegin, LoopEnd, CleanFlags);
+
+        CHECK(IsEqual(Stream, Expected));
+    }
+}
@@ -0,0 +1,337 @@
+
+/** $VER: IncrementalProcessorTests.cpp (2026.10.19) P. Stuer - Tests the incremental SMF and RMI processor **/
+
+#include "Test.h"
+
+#include "IncrementalProcessor.h"
+#include "Exception.h"
+
+using namespace midi;
+
+namespace
+{
+
+void AppendChunk(std::vector<uint8_t> & data, const char * id, const std::vector<uint8_t> & body, bool isLittleEndian)
+{
+    const uint32_t Size = (uint32_t) body.size();
+
+    data.insert(data.end(), id, id + 4);
+
+    if (isLittleEndian)
+        data.insert(data.end(), { (uint8_t) Size, (uint8_t) (Size >> 8), (uint8_t) (Size >> 16), (uint8_t) (Size >> 24) });
+    else
+        data.insert(data.end(), { (uint8_t) (Size >> 24), (uint8_t) (Size >> 16), (uint8_t) (Size >> 8), (uint8_t) Size });
+
+    data.insert(data.end(), body.begin(), body.end());
+}
+
+/// <summary>
+/// Creates an SMF with a conductor track, a track with running status and a SysEx message, an unknown chunk and a track with a long delta time.
+/// A format 0 file only contains the second track.
+/// </summary>
+std::vector<uint8_t> CreateSMF(uint16_t format)
+{
+    const std::vector<uint8_t> Conductor =
+    {
+        0x00, 0xFF, 0x03, 0x05, 'T', 'i', 't', 'l', 'e',
+        0x00, 0xFF, 0x51, 0x03, 0x07, 0xA1, 0x20,
+        0x00, 0xFF, 0x58, 0x04, 0x04, 0x02, 0x18, 0x08,
+        0x83, 0x60, 0xFF, 0x51, 0x03, 0x06, 0x1A, 0x80,
+        0x00, 0xFF, 0x2F, 0x00,
+    };
+
+    const std::vector<uint8_t> Melody =
+    {
+        0x00, 0xF0, 0x05, 0x7E, 0x7F, 0x09, 0x01, 0xF7,
+        0x00, 0xC0, 0x05,
+        0x00, 0x90, 0x3C, 0x64,
+        0x60, 0x3C, 0x00,
+        0x00, 0x3E, 0x64,
+        0x60, 0x3E, 0x00,
+        0x30, 0xB0, 0x07, 0x64,
+        0x00, 0xE0, 0x00, 0x40,
+        0x00, 0xFF, 0x2F, 0x00,
+    };
+
+    const std::vector<uint8_t> Drums =
+    {
+        0x00, 0x99, 0x24, 0x7F,
+        0x81, 0x40, 0x89, 0x24, 0x40,
+        0x00, 0xFF, 0x2F, 0x00,
+    };
+
+    // Like processor_t::ProcessSMF(), the incremental processor counts unknown chunks as tracks.
+    const uint16_t TrackCount = (format == 0) ? 1 : 4;
+
+    std::vector<uint8_t> Data;
+
+    AppendChunk(Data, "MThd", { 0, (uint8_t) format, 0, (uint8_t) TrackCount, 0x01, 0xE0 }, false);
+
+    if (format == 0)
+    {
+        AppendChunk(Data, "MTrk", Melody, false);
+
+        return Data;
+    }
+
+    AppendChunk(Data, "MTrk", Conductor, false);
+    AppendChunk(Data, "MTrk", Melody, false);
+    AppendChunk(Data, "XFIH", { 1, 2, 3 }, false);
+    AppendChunk(Data, "MTrk", Drums, false);
+
+    return Data;
+}
+
+/// <summary>
+/// Wraps an SMF in an RMI file with an INFO list.
+/// </summary>
+std::vector<uint8_t> CreateRMI(const std::vector<uint8_t> & smf)
+{
+    std::vector<uint8_t> Body = { 'R', 'M', 'I', 'D' };
+
+    AppendChunk(Body, "data", smf, true);
+
+    if (smf.size() & 1)
+        Body.push_back(0);
+
+    std::vector<uint8_t> List = { 'I', 'N', 'F', 'O' };
+
+    AppendChunk(List, "INAM", { 'S', 'o', 'n', 'g', 0, 0 }, true);
+    AppendChunk(List, "ICOP", { 'N', 'o', 'n', 'e', 0 }, true);
+
+    AppendChunk(Body, "LIST", List, true);
+
+    std::vector<uint8_t> Data;
+
+    AppendChunk(Data, "RIFF", Body, true);
+
+    return Data;
+}
+
+bool IsSameEvent(const event_t & a, const event_t & b) noexcept
+{
+    return (a.Time == b.Time) && (a.Type == b.Type) && (a.ChannelNumber == b.ChannelNumber) && (a.Data == b.Data);
+}
+
+/// <summary>
+/// Returns true if the containers have the same format, tracks and metadata.
+/// </summary>
+bool IsSameContainer(container_t & a, container_t & b)
+{
+    if ((a.FileFormat != b.FileFormat) || (a.GetFormat() != b.GetFormat()) || (a.GetTrackCount() != b.GetTrackCount()))
+        return false;
+
+    for (uint32_t i = 0; i < a.GetTrackCount(); ++i)
+    {
+        const track_t & TrackA = a.GetTracks()[i];
+        const track_t & TrackB = b.GetTracks()[i];
+
+        if (!std::equal(TrackA.begin(), TrackA.end(), TrackB.begin(), TrackB.end(), IsSameEvent))
+            return false;
+    }
+
+    metadata_table_t MetaDataA, MetaDataB;
+
+    a.GetMetaData(0, MetaDataA);
+    b.GetMetaData(0, MetaDataB);
+
+    return std::equal(MetaDataA.begin(), MetaDataA.end(), MetaDataB.begin(), MetaDataB.end(), [](const metadata_item_t & x, const metadata_item_t & y)
+    {
+        return (x.Timestamp == y.Timestamp) && (x.Name == y.Name) && (x.Value == y.Value);
+    });
+}
+
+/// <summary>
+/// Writes the data to an incremental processor in chunks of the specified size.
+/// </summary>
+bool ProcessInChunks(const std::vector<uint8_t> & data, size_t chunkSize, container_t & container)
+{
+    incremental_processor_t Processor(container);
+
+    for (size_t Offset = 0; Offset < data.size(); Offset += chunkSize)
+    {
+        if (!Processor.Write(data.data() + Offset, (std::min)(chunkSize, data.size() - Offset)))
+            return false;
+    }
+
+    Processor.Close();
+
+    return Processor.IsComplete();
+}
+
+}
+
+TEST_CASE(ChunkedSMFMatchesProcess)
+{
+    for (uint16_t Format : { 0, 1 })
+    {
+        const std::vector<uint8_t> Data = CreateSMF(Format);
+
+        container_t Expected;
+
+        CHECK(processor_t::Process(Data, L"test.mid", Expected));
+
+        for (size_t ChunkSize : { 1, 2, 3, 7, 64, 4096 })
+        {
+            container_t Container;
+
+            CHECK(ProcessInChunks(Data, ChunkSize, Container));
+            CHECK(IsSameContainer(Container, Expected));
+        }
+    }
+}
+
+TEST_CASE(ChunkedRMIMatchesProcess)
+{
+    const std::vector<uint8_t> Data = CreateRMI(CreateSMF(1));
+
+    container_t Expected;
+
+    CHECK(processor_t::Process(Data, L"test.rmi", Expected));
+
+    for (size_t ChunkSize : { 1, 5, 64, 4096 })
+    {
+        container_t Container;
+
+        CHECK(ProcessInChunks(Data, ChunkSize, Container));
+        CHECK(IsSameContainer(Container, Expected));
+    }
+
+    metadata_table_t MetaData;
+    metadata_item_t Item;
+
+    Expected.GetMetaData(0, MetaData);
+
+    CHECK(MetaData.GetItem("title", Item) && (Item.Value == "Song"));
+}
+
+TEST_CASE(TracksAreAddedWhenComplete)
+{
+    const std::vector<uint8_t> Data = CreateSMF(1);
+
+    container_t Container;
+
+    incremental_processor_t Processor(Container);
+
+    CHECK(Processor.GetTrackCount() == 0);
+
+    size_t CompletedTrackCount = 0;
+
+    for (size_t Offset = 0; Offset < Data.size(); ++Offset)
+    {
+        CHECK(Processor.Write(&Data[Offset], 1));
+
+        // The tracks complete one by one and each is added to the container at once.
+        CHECK(Processor.GetCompletedTrackCount() >= CompletedTrackCount);
+        CHECK(Container.GetTrackCount() == Processor.GetCompletedTrackCount());
+
+        CompletedTrackCount = Processor.GetCompletedTrackCount();
+
+        if (Offset + 1 < Data.size())
+            CHECK(!Processor.IsComplete());
+    }
+
+    CHECK(Processor.GetTrackCount() == 4);
+    CHECK(CompletedTrackCount == 3);
+    CHECK(Processor.IsComplete());
+}
+
+TEST_CASE(Format0EventsCanBeTakenWhileDecoding)
+{
+    const std::vector<uint8_t> Data = CreateSMF(0);
+
+    container_t Container;
+
+    incremental_processor_t Processor(Container, DefaultOptions, true);
+
+    std::vector<event_t> Events;
+
+    size_t Offset = 0;
+
+    for (; Offset < Data.size(); ++Offset)
+    {
+        CHECK(Processor.Write(&Data[Offset], 1));
+
+        Processor.TakeEvents(Events);
+
+        if (!Events.empty())
+            break;
+    }
+
+    // The first event is available long before the end of the track.
+    CHECK(Offset + 1 < Data.size());
+    CHECK(Container.GetTrackCount() == 0);
+
+    for (++Offset; Offset < Data.size(); ++Offset)
+    {
+        CHECK(Processor.Write(&Data[Offset], 1));
+
+        Processor.TakeEvents(Events);
+    }
+
+    Processor.Close();
+
+    CHECK(Processor.TakeEvents(Events) == 0);
+
+    // Every event of the track was taken once.
+    const track_t & Track = Container.GetTracks()[0];
+
+    CHECK(Events.size() == (size_t) std::distance(Track.begin(), Track.end()));
+
+    for (const event_t & Event : Track)
+        CHECK(std::count_if(Events.begin(), Events.end(), [&Event](const event_t & e) { return IsSameEvent(e, Event); }) >= 1);
+}
+
+TEST_CASE(Format0EventsAreNotKeptByDefault)
+{
+    const std::vector<uint8_t> Data = CreateSMF(0);
+
+    container_t Container;
+
+    incremental_processor_t Processor(Container);
+
+    CHECK(Processor.Write(Data));
+
+    std::vector<event_t> Events;
+
+    CHECK(Processor.TakeEvents(Events) == 0);
+    CHECK(Container.GetTrackCount() == 1);
+}
+
+TEST_CASE(IncompleteDataIsRejected)
+{
+    const std::vector<uint8_t> Data = CreateSMF(1);
+
+    for (size_t Size : { (size_t) 10, (size_t) 30, Data.size() - 1 })
+    {
+        container_t Container;
+
+        incremental_processor_t Processor(Container);
+
+        CHECK(Processor.Write(Data.data(), Size));
+        CHECK(!Processor.IsComplete());
+        CHECK_THROWS(Processor.Close(), midi::exception);
+    }
+
+    {
+        const std::vector<uint8_t> RMI = CreateRMI(Data);
+
+        container_t Container;
+
+        incremental_processor_t Processor(Container);
+
+        CHECK(Processor.Write(RMI.data(), RMI.size() - 4));
+        CHECK_THROWS(Processor.Close(), midi::exception);
+    }
+
+    {
+        const std::vector<uint8_t> Text(64, 'x');
+
+        container_t Container;
+
+        incremental_processor_t Processor(Container);
+
+        CHECK(!Processor.Write(Text));
+        CHECK(!Processor.IsComplete());
+    }
+}
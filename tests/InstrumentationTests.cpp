@@ -0,0 +1,170 @@
+
+/** $VER: InstrumentationTests.cpp (2026.10.19) P. Stuer - Tests the instrumentation counters and phase timers **/
+
+#include "Test.h"
+
+#include "MIDIProcessor.h"
+
+using namespace midi;
+
+namespace
+{
+
+/// <summary>
+/// Creates a format 0 SMF with a tempo change, a note and the same GM System On message twice.
+/// </summary>
+std::vector<uint8_t> CreateSMF()
+{
+    const uint8_t Track[] =
+    {
+        0x00, 0xFF, 0x51, 0x03, 0x07, 0xA1, 0x20,
+        0x00, 0xF0, 0x05, 0x7E, 0x7F, 0x09, 0x01, 0xF7,
+        0x00, 0x90, 0x3C, 0x64,
+        0x60, 0x80, 0x3C, 0x40,
+        0x00, 0xF0, 0x05, 0x7E, 0x7F, 0x09, 0x01, 0xF7,
+        0x00, 0xFF, 0x2F, 0x00,
+    };
+
+    const uint8_t Header[] = { 'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0, 0x60, 'M', 'T', 'r', 'k', 0, 0, 0, (uint8_t) sizeof(Track) };
+
+    std::vector<uint8_t> Data;
+
+    Data.reserve(sizeof(Header) + sizeof(Track));
+
+    Data.insert(Data.end(), Header, Header + sizeof(Header));
+    Data.insert(Data.end(), Track, Track + sizeof(Track));
+
+    return Data;
+}
+
+}
+
+TEST_CASE(StatsScopeRestoresThePreviousSink)
+{
+    stats_t Outer = { };
+    stats_t Inner = { };
+
+    CHECK(Stats == nullptr);
+
+    {
+        stats_scope_t OuterScope(&Outer);
+
+        CHECK(Stats == &Outer);
+
+        {
+            stats_scope_t InnerScope(&Inner);
+
+            CHECK(Stats == &Inner);
+        }
+
+        CHECK(Stats == &Outer);
+    }
+
+    CHECK(Stats == nullptr);
+}
+
+TEST_CASE(PhaseTimerRecordsIntoTheInstalledSink)
+{
+    stats_t Sink = { };
+
+    {
+        // Without a sink nothing is recorded.
+        phase_timer_t Timer(phase_t::Parsing);
+    }
+
+    {
+        stats_scope_t Scope(&Sink);
+
+        phase_timer_t Timer(phase_t::Parsing);
+    }
+
+    CHECK(Sink.PhaseCounts[(size_t) phase_t::Parsing] == 1);
+    CHECK(Sink.PhaseCounts[(size_t) phase_t::Detection] == 0);
+}
+
+TEST_CASE(StatsAccumulate)
+{
+    stats_t a = { };
+    stats_t b = { };
+
+    a.PhaseTimes[(size_t) phase_t::AddTrack] = 10;
+    a.PhaseCounts[(size_t) phase_t::AddTrack] = 1;
+    a.EventsParsed = 5;
+    a.TempoLookups = 2;
+
+    b.PhaseTimes[(size_t) phase_t::AddTrack] = 20;
+    b.PhaseCounts[(size_t) phase_t::AddTrack] = 2;
+    b.EventsParsed = 7;
+    b.SysExDedupHits = 3;
+
+    a.Add(b);
+
+    CHECK(a.PhaseTimes[(size_t) phase_t::AddTrack] == 30);
+    CHECK(a.PhaseCounts[(size_t) phase_t::AddTrack] == 3);
+    CHECK(a.EventsParsed == 12);
+    CHECK(a.TempoLookups == 2);
+    CHECK(a.SysExDedupHits == 3);
+
+    a.Reset();
+
+    CHECK(a.EventsParsed == 0);
+    CHECK(a.PhaseCounts[(size_t) phase_t::AddTrack] == 0);
+}
+
+TEST_CASE(PhasesHaveNames)
+{
+    CHECK(::strcmp(stats_t::GetPhaseName(phase_t::Detection), "Detection") == 0);
+    CHECK(::strcmp(stats_t::GetPhaseName(phase_t::Serialization), "Serialization") == 0);
+    CHECK(::strcmp(stats_t::GetPhaseName(phase_t::Count), "") == 0);
+}
+
+TEST_CASE(ProcessorFillsTheStats)
+{
+    const std::vector<uint8_t> Data = CreateSMF();
+
+    stats_t ProcessStats = { };
+
+    processor_options_t Options = DefaultOptions;
+
+    Options.Stats = &ProcessStats;
+
+    container_t Container;
+
+    CHECK(processor_t::Process(Data, L"test.mid", Container, Options));
+
+    // The sink of the options is only installed during the call.
+    CHECK(Stats == nullptr);
+
+    stats_t SerializeStats = { };
+
+    std::vector<message_t> Stream;
+    sysex_table_t SysExTable;
+    std::vector<uint8_t> PortNumbers;
+    uint32_t LoopBegin, LoopEnd;
+
+    {
+        stats_scope_t Scope(&SerializeStats);
+
+        Container.SerializeAsStream(0, Stream, SysExTable, PortNumbers, LoopBegin, LoopEnd, event_filter_t());
+    }
+
+    CHECK(Stream.size() == 4);
+
+#ifdef LIBMIDI_INSTRUMENTATION
+    CHECK(ProcessStats.PhaseCounts[(size_t) phase_t::Detection] >= 1);
+    CHECK(ProcessStats.PhaseCounts[(size_t) phase_t::Parsing] >= 1);
+    CHECK(ProcessStats.PhaseCounts[(size_t) phase_t::AddTrack] == 1);
+    CHECK(ProcessStats.EventsParsed >= 6);
+
+    CHECK(SerializeStats.PhaseCounts[(size_t) phase_t::Serialization] == 1);
+    CHECK(SerializeStats.SysExDedupMisses == 1);
+    CHECK(SerializeStats.SysExDedupHits == 1);
+    CHECK(SerializeStats.TempoLookups == 6); // One per event, including the meta data events that are not serialized
+#else
+    // The macros are compiled out; the sinks remain untouched.
+    CHECK(ProcessStats.EventsParsed == 0);
+    CHECK(ProcessStats.PhaseCounts[(size_t) phase_t::Parsing] == 0);
+    CHECK(SerializeStats.PhaseCounts[(size_t) phase_t::Serialization] == 0);
+    CHECK(SerializeStats.TempoLookups == 0);
+#endif
+}
@@ -0,0 +1,316 @@
+
+/** $VER: LoopTests.cpp (2026.10.19) P. Stuer - Tests the symbolic loop regions against their physical expansion **/
+
+#include "Test.h"
+
+#include "MIDIContainer.h"
+
+using namespace midi;
+
+namespace
+{
+
+/// <summary>
+/// Describes a note in a hand-built track.
+/// </summary>
+struct note_t
+{
+    uint32_t Time;
+    uint32_t Length;
+    uint8_t Key;
+};
+
+/// <summary>
+/// Creates a track with the specified notes on channel 0 and an End of Track event.
+/// </summary>
+track_t CreateTrack(std::initializer_list<note_t> notes, uint32_t endOfTrack)
+{
+    track_t Track;
+
+    for (const auto & Note : notes)
+    {
+        const uint8_t NoteOn[] = { Note.Key, 0x64 };
+        const uint8_t NoteOff[] = { Note.Key, 0x00 };
+
+        Track.AddEvent(event_t(Note.Time, event_t::NoteOn, 0, NoteOn, _countof(NoteOn)));
+        Track.AddEvent(event_t(Note.Time + Note.Length, event_t::NoteOn, 0, NoteOff, _countof(NoteOff)));
+    }
+
+    const uint8_t EndOfTrack[] = { StatusCode::MetaData, MetaDataType::EndOfTrack };
+
+    Track.AddEvent(event_t(endOfTrack, event_t::Extended, 0, EndOfTrack, _countof(EndOfTrack)));
+
+    return Track;
+}
+
+/// <summary>
+/// Creates a format 1 container with a conductor track and the specified track.
+/// </summary>
+void CreateContainer(container_t & container, const track_t & track)
+{
+    container.Initialize(1, 96);
+
+    {
+        track_t Conductor;
+
+        const uint8_t SetTempo[] = { StatusCode::MetaData, MetaDataType::SetTempo, 0x07, 0xA1, 0x20 };
+        const uint8_t EndOfTrack[] = { StatusCode::MetaData, MetaDataType::EndOfTrack };
+
+        Conductor.AddEvent(event_t(0, event_t::Extended, 0, SetTempo, _countof(SetTempo)));
+        Conductor.AddEvent(event_t(0, event_t::Extended, 0, EndOfTrack, _countof(EndOfTrack)));
+
+        container.AddTrack(Conductor);
+    }
+
+    container.AddTrack(track);
+}
+
+/// <summary>
+/// Creates a cursor over a track of the container with the loop regions of that track.
+/// </summary>
+track_cursor_t GetTrackCursor(container_t & container, uint32_t trackIndex, uint32_t infiniteCount = 0)
+{
+    const auto & Regions = container.GetLoopRegions();
+
+    auto Head = std::find_if(Regions.begin(), Regions.end(), [trackIndex](const loop_region_t & r) { return r.TrackIndex == trackIndex; });
+    auto Tail = std::find_if(Head, Regions.end(), [trackIndex](const loop_region_t & r) { return r.TrackIndex != trackIndex; });
+
+    return track_cursor_t(container.GetTracks()[trackIndex], std::span<const loop_region_t>(Head, Tail), infiniteCount);
+}
+
+/// <summary>
+/// Returns true if two tracks contain the same events in the same order.
+/// </summary>
+bool IsEqual(const track_t & a, const track_t & b)
+{
+    if (a.GetLength() != b.GetLength())
+        return false;
+
+    for (size_t i = 0; i < a.GetLength(); ++i)
+    {
+        if ((a[i].Time != b[i].Time) || (a[i].Type != b[i].Type) || (a[i].ChannelNumber != b[i].ChannelNumber) || (a[i].Data != b[i].Data))
+            return false;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Returns true if a track cursor plays the same events at the same timestamps as the expanded track.
+/// </summary>
+bool IsPlayedAs(track_cursor_t cursor, const track_t & expanded)
+{
+    size_t i = 0;
+
+    for (; !cursor.IsAtEnd(); cursor.Next(), ++i)
+    {
+        if (i == expanded.GetLength())
+            return false;
+
+        const event_t & Event = cursor.GetEvent();
+
+        if ((cursor.GetTime() != expanded[i].Time) || (Event.Type != expanded[i].Type) || (Event.Data != expanded[i].Data))
+            return false;
+    }
+
+    return (i == expanded.GetLength());
+}
+
+/// <summary>
+/// Returns true if the container with loop regions plays and serializes exactly like the container with the physically expanded track.
+/// </summary>
+bool IsSerializedAs(const container_t & symbolic, const container_t & expanded)
+{
+    std::vector<message_t> Streams[2];
+    sysex_table_t SysExTables[2];
+    std::vector<uint8_t> PortNumbers[2];
+    uint32_t LoopBegins[2] = { };
+    uint32_t LoopEnds[2] = { };
+    std::vector<uint8_t> SMFs[2];
+
+    const container_t * Containers[2] = { &symbolic, &expanded };
+
+    for (size_t i = 0; i < 2; ++i)
+    {
+        Containers[i]->SerializeAsStream(0, Streams[i], SysExTables[i], PortNumbers[i], LoopBegins[i], LoopEnds[i], event_filter_t());
+        Containers[i]->SerializeAsSMF(SMFs[i]);
+    }
+
+    if ((Streams[0].size() != Streams[1].size()) || Streams[0].empty())
+        return false;
+
+    for (size_t i = 0; i < Streams[0].size(); ++i)
+    {
+        if ((Streams[0][i].Time != Streams[1][i].Time) || (Streams[0][i].Data != Streams[1][i].Data))
+            return false;
+    }
+
+    return (LoopBegins[0] == LoopBegins[1]) && (LoopEnds[0] == LoopEnds[1]) && (SMFs[0] == SMFs[1]) && (symbolic.GetDuration(0) == expanded.GetDuration(0));
+}
+
+}
+
+TEST_CASE(SimpleLoopMatchesExpansion)
+{
+    // The loop body [96, 288) is played 3 times. The second note ends exactly at the end of the loop body.
+    container_t Symbolic;
+
+    CreateContainer(Symbolic, CreateTrack({ { 0, 48, 60 }, { 96, 48, 62 }, { 192, 96, 64 }, { 288, 48, 65 } }, 384));
+
+    Symbolic.SetLoopRegions({ { 1, 96, 288, 3, false } });
+
+    container_t Expanded;
+
+    CreateContainer(Expanded, CreateTrack(
+    {
+        { 0, 48, 60 },
+        {  96, 48, 62 }, { 192, 96, 64 },
+        { 288, 48, 62 }, { 384, 96, 64 },
+        { 480, 48, 62 }, { 576, 96, 64 },
+        { 672, 48, 65 }
+    }, 768));
+
+    CHECK(IsPlayedAs(GetTrackCursor(Symbolic, 1), Expanded.GetTracks()[1]));
+    CHECK(IsSerializedAs(Symbolic, Expanded));
+
+    // Events are mapped to their first occurrence on playback.
+    CHECK(Symbolic.GetExpandedTime(1, 0) == 0);
+    CHECK(Symbolic.GetExpandedTime(1, 192) == 192);
+    CHECK(Symbolic.GetExpandedTime(1, 288) == 672);
+    CHECK(Symbolic.GetExpandedTime(1, 384) == 768);
+
+    // A track without loop regions is not shifted.
+    CHECK(Symbolic.GetExpandedTime(0, 288) == 288);
+
+    track_t Track;
+
+    Symbolic.ExpandTrack(1, 0, Track);
+
+    CHECK(IsEqual(Track, Expanded.GetTracks()[1]));
+
+    Symbolic.RenderLoops();
+
+    CHECK(!Symbolic.HasLoopRegions());
+    CHECK(IsEqual(Symbolic.GetTracks()[1], Expanded.GetTracks()[1]));
+    CHECK(IsSerializedAs(Symbolic, Expanded));
+}
+
+TEST_CASE(InfiniteLoopUsesTheRequestedPassCount)
+{
+    container_t Symbolic;
+
+    CreateContainer(Symbolic, CreateTrack({ { 0, 48, 60 }, { 96, 48, 62 } }, 192));
+
+    // The converter chose 2 passes.
+    Symbolic.SetLoopRegions({ { 1, 96, 192, 2, true } });
+
+    container_t Expanded;
+
+    CreateContainer(Expanded, CreateTrack({ { 0, 48, 60 }, { 96, 48, 62 }, { 192, 48, 62 } }, 288));
+
+    CHECK(IsSerializedAs(Symbolic, Expanded));
+
+    track_t Track;
+
+    Symbolic.ExpandTrack(1, 4, Track);
+
+    CHECK(IsEqual(Track, CreateTrack({ { 0, 48, 60 }, { 96, 48, 62 }, { 192, 48, 62 }, { 288, 48, 62 }, { 384, 48, 62 } }, 480)));
+    CHECK(IsPlayedAs(GetTrackCursor(Symbolic, 1, 4), Track));
+}
+
+TEST_CASE(NestedLoopsMatchExpansion)
+{
+    // The outer loop [96, 480) is played twice. The inner loop [96, 288) starts with the outer loop and is played twice on each pass.
+    container_t Symbolic;
+
+    CreateContainer(Symbolic, CreateTrack({ { 96, 48, 60 }, { 288, 48, 62 } }, 480));
+
+    Symbolic.SetLoopRegions({ { 1, 96, 288, 2, false }, { 1, 96, 480, 2, false } });
+
+    // The regions are sorted so that the nested region follows its parent.
+    CHECK(Symbolic.GetLoopRegions().size() == 2);
+    CHECK(Symbolic.GetLoopRegions()[0].End == 480);
+
+    container_t Expanded;
+
+    CreateContainer(Expanded, CreateTrack(
+    {
+        {  96, 48, 60 }, { 288, 48, 60 }, { 480, 48, 62 },
+        { 672, 48, 60 }, { 864, 48, 60 }, { 1056, 48, 62 },
+    }, 1248));
+
+    CHECK(IsPlayedAs(GetTrackCursor(Symbolic, 1), Expanded.GetTracks()[1]));
+    CHECK(IsSerializedAs(Symbolic, Expanded));
+
+    CHECK(Symbolic.GetExpandedTime(1, 96) == 96);
+    CHECK(Symbolic.GetExpandedTime(1, 288) == 480);
+    CHECK(Symbolic.GetExpandedTime(1, 480) == 1248);
+
+    Symbolic.RenderLoops();
+
+    CHECK(IsEqual(Symbolic.GetTracks()[1], Expanded.GetTracks()[1]));
+}
+
+TEST_CASE(InvalidLoopRegionsAreIgnored)
+{
+    const track_t Track = CreateTrack({ { 0, 48, 60 }, { 96, 48, 62 }, { 192, 48, 64 } }, 288);
+
+    container_t Symbolic;
+
+    CreateContainer(Symbolic, Track);
+
+    // A zero loop count, a loop end before the loop begin, an empty loop body and a track that does not exist.
+    Symbolic.SetLoopRegions(
+    {
+        { 1,  96, 192, 0, false },
+        { 1, 192,  96, 2, false },
+        { 1,  96,  96, 2, false },
+        { 5,  96, 192, 2, false },
+    });
+
+    CHECK(!Symbolic.HasLoopRegions());
+    CHECK(IsPlayedAs(GetTrackCursor(Symbolic, 1), Track));
+    CHECK(Symbolic.GetExpandedTime(1, 192) == 192);
+
+    container_t Expanded;
+
+    CreateContainer(Expanded, Track);
+
+    CHECK(IsSerializedAs(Symbolic, Expanded));
+
+    Symbolic.RenderLoops();
+
+    CHECK(IsEqual(Symbolic.GetTracks()[1], Track));
+}
+
+TEST_CASE(CursorPlaysTheEndOfTrackLast)
+{
+    // The End of Track event is stored at the end of the loop body. It is played once, after the last repetition.
+    container_t Symbolic;
+
+    CreateContainer(Symbolic, CreateTrack({ { 0, 48, 60 } }, 96));
+
+    Symbolic.SetLoopRegions({ { 1, 0, 96, 3, false } });
+
+    track_cursor_t Cursor = GetTrackCursor(Symbolic, 1);
+
+    std::vector<uint32_t> Times;
+    size_t EndOfTrackCount = 0;
+
+    for (; !Cursor.IsAtEnd(); Cursor.Next())
+    {
+        Times.push_back(Cursor.GetTime());
+
+        if (Cursor.GetEvent().IsEndOfTrack())
+            ++EndOfTrackCount;
+    }
+
+    CHECK(EndOfTrackCount == 1);
+    CHECK((Times == std::vector<uint32_t> { 0, 48, 96, 144, 192, 240, 288 }));
+
+    track_t Track;
+
+    Symbolic.ExpandTrack(1, 0, Track);
+
+    CHECK(IsPlayedAs(GetTrackCursor(Symbolic, 1), Track));
+}
@@ -0,0 +1,258 @@
+
+/** $VER: LyricsTests.cpp (2026.10.19) P. Stuer - Tests the lyrics timeline **/
+
+#include "Test.h"
+
+#include "MIDIContainer.h"
+#include "Lyrics.h"
+
+#include <random>
+
+using namespace midi;
+
+namespace
+{
+
+/// <summary>
+/// Adds the text of an event to the lyrics.
+/// </summary>
+void Add(lyrics_t & lyrics, uint32_t time, const std::string & text, lyrics_t::lyrics_type_t type)
+{
+    lyrics.Add(time, text.c_str(), text.size(), type);
+}
+
+/// <summary>
+/// Returns the index of the last syllable that starts at or before the specified time, or NotFound.
+/// </summary>
+size_t FindLinear(const lyrics_t & lyrics, uint32_t time)
+{
+    size_t Index = lyrics_t::NotFound;
+
+    for (size_t i = 0; i < lyrics.GetCount(); ++i)
+    {
+        if (lyrics[i].Time <= time)
+            Index = i;
+    }
+
+    return Index;
+}
+
+/// <summary>
+/// Adds a meta data event with a text payload to a track.
+/// </summary>
+void AddText(track_t & track, uint32_t time, uint8_t type, const std::string & text)
+{
+    std::vector<uint8_t> Data = { StatusCode::MetaData, type };
+
+    Data.insert(Data.end(), text.begin(), text.end());
+
+    track.AddEvent(event_t(time, event_t::Extended, 0, Data.data(), Data.size()));
+}
+
+/// <summary>
+/// Creates a format 0 container with a tempo of 500 ms per quarter note and 100 ticks per quarter note, so that 1 tick is 5 ms.
+/// The track contains Soft Karaoke text events, with or without the Soft Karaoke header, and Tune 1000 lyrics events.
+/// </summary>
+void CreateContainer(container_t & container, bool hasSoftKaraokeHeader)
+{
+    track_t Track;
+
+    AddText(Track, 0, MetaDataType::SetTempo, std::string("\x07\xA1\x20", 3));
+
+    if (hasSoftKaraokeHeader)
+        AddText(Track, 0, MetaDataType::Text, "@KMIDI KARAOKE FILE");
+
+    AddText(Track, 0,  MetaDataType::Text, "@TSong title");
+    AddText(Track, 10, MetaDataType::Text, "\\Twin");
+    AddText(Track, 20, MetaDataType::Text, "kle");
+    AddText(Track, 30, MetaDataType::Text, "/twin");
+
+    AddText(Track, 10, MetaDataType::Lyrics, "Row ");
+    AddText(Track, 20, MetaDataType::Lyrics, "row\r");
+    AddText(Track, 30, MetaDataType::Lyrics, "row\n");
+    AddText(Track, 40, MetaDataType::Lyrics, "your");
+
+    AddText(Track, 50, MetaDataType::EndOfTrack, "");
+
+    container.Initialize(0, 100);
+    container.AddTrack(Track);
+}
+
+}
+
+TEST_CASE(SoftKaraokeLayoutCharactersBecomeFlags)
+{
+    lyrics_t Lyrics;
+
+    Add(Lyrics,   0, "\\Hel", lyrics_t::SoftKaraoke);
+    Add(Lyrics, 100, "lo", lyrics_t::SoftKaraoke);
+    Add(Lyrics, 200, "/World/", lyrics_t::SoftKaraoke);
+    Add(Lyrics, 300, "a/b", lyrics_t::SoftKaraoke);
+    Add(Lyrics, 400, std::string("c\0d", 3), lyrics_t::SoftKaraoke);
+    Add(Lyrics, 500, "\r\nx", lyrics_t::SoftKaraoke);
+
+    Lyrics.Finalize();
+
+    CHECK(Lyrics.GetType() == lyrics_t::SoftKaraoke);
+    CHECK(Lyrics.GetCount() == 7);
+
+    if (Lyrics.GetCount() != 7)
+        return;
+
+    const char * Texts[] = { "Hel", "lo", "World", "a", "b", "c", "x" };
+    const uint32_t Flags[] = { syllable_t::FlagNewParagraph, 0, syllable_t::FlagNewLine, syllable_t::FlagNewLine, syllable_t::FlagNewLine, 0, syllable_t::FlagNewLine | syllable_t::FlagNewParagraph };
+
+    for (size_t i = 0; i < Lyrics.GetCount(); ++i)
+    {
+        CHECK(Lyrics[i].Text == Texts[i]);
+        CHECK(Lyrics[i].Flags == Flags[i]);
+    }
+
+    // The second half of an event gets the time of the event.
+    CHECK(Lyrics[4].Time == 300);
+
+    CHECK(Lyrics[0].IsNewParagraph() && Lyrics[0].IsNewLine());
+    CHECK(!Lyrics[2].IsNewParagraph() && Lyrics[2].IsNewLine());
+
+    // Lines
+    CHECK(Lyrics.GetLineStart(1) == 0);
+    CHECK(Lyrics.GetLineEnd(1) == 2);
+    CHECK(Lyrics.GetLineStart(5) == 4);
+    CHECK(Lyrics.GetLineEnd(5) == 6);
+    CHECK(Lyrics.GetLineEnd(6) == 7);
+    CHECK(Lyrics.GetLineStart(7) == lyrics_t::NotFound);
+}
+
+TEST_CASE(Tune1000LineBreaksBecomeFlags)
+{
+    lyrics_t Lyrics;
+
+    Add(Lyrics,   0, "Hello\r", lyrics_t::Tune1000);
+    Add(Lyrics, 100, "wide/", lyrics_t::Tune1000);
+    Add(Lyrics, 200, "world\n", lyrics_t::Tune1000);
+    Add(Lyrics, 300, "Again", lyrics_t::Tune1000);
+
+    Lyrics.Finalize();
+
+    CHECK(Lyrics.GetType() == lyrics_t::Tune1000);
+    CHECK(Lyrics.GetCount() == 4);
+
+    if (Lyrics.GetCount() != 4)
+        return;
+
+    // A slash is text in Tune 1000 lyrics.
+    CHECK(Lyrics[1].Text == "wide/");
+    CHECK(Lyrics[1].Flags == syllable_t::FlagNewLine);
+    CHECK(Lyrics[2].Flags == 0);
+    CHECK(Lyrics[3].Flags == syllable_t::FlagNewParagraph);
+
+    CHECK(Lyrics.GetLineStart(2) == 1);
+    CHECK(Lyrics.GetLineEnd(2) == 3);
+
+    Lyrics.Clear();
+
+    CHECK(Lyrics.IsEmpty());
+    CHECK(Lyrics.GetType() == lyrics_t::None);
+}
+
+TEST_CASE(ContainerDetectsTheLyricsType)
+{
+    // The Soft Karaoke text events take precedence over the lyrics events. Text events that start with '@' are not lyrics.
+    {
+        container_t Container;
+
+        CreateContainer(Container, true);
+
+        lyrics_t Lyrics;
+
+        Container.GetLyrics(0, Lyrics);
+
+        CHECK(Lyrics.GetType() == lyrics_t::SoftKaraoke);
+        CHECK(Lyrics.GetCount() == 3);
+
+        if (Lyrics.GetCount() == 3)
+        {
+            CHECK(Lyrics[0].Text == "Twin");
+            CHECK(Lyrics[0].Time == 50);
+            CHECK(Lyrics[0].IsNewParagraph());
+            CHECK(Lyrics[2].Text == "twin");
+            CHECK(Lyrics[2].IsNewLine());
+        }
+    }
+
+    // Without the Soft Karaoke header, the text events are ignored.
+    {
+        container_t Container;
+
+        CreateContainer(Container, false);
+
+        lyrics_t Lyrics;
+
+        Container.GetLyrics(0, Lyrics);
+
+        CHECK(Lyrics.GetType() == lyrics_t::Tune1000);
+        CHECK(Lyrics.GetCount() == 4);
+
+        if (Lyrics.GetCount() == 4)
+        {
+            CHECK(Lyrics[0].Text == "Row ");
+            CHECK(Lyrics[3].Time == 200);
+            CHECK(Lyrics[2].IsNewLine());
+            CHECK(Lyrics[3].IsNewParagraph());
+        }
+    }
+}
+
+TEST_CASE(HintedFindMatchesLinearSearch)
+{
+    std::mt19937 Random(26);
+
+    lyrics_t Lyrics;
+
+    // Syllables are added out of order and several start at the same time.
+    for (size_t i = 0; i < 200; ++i)
+        Add(Lyrics, 100 + (Random() % 100) * 10, "la", lyrics_t::Tune1000);
+
+    Lyrics.Finalize();
+
+    CHECK(std::is_sorted(Lyrics.begin(), Lyrics.end(), [](const syllable_t & a, const syllable_t & b) { return a.Time < b.Time; }));
+
+    // Playback that moves forward, with the result of the previous call as the hint.
+    size_t Hint = lyrics_t::NotFound;
+    size_t Mismatches = 0;
+
+    for (uint32_t Time = 0; Time < 1200; Time += 3)
+    {
+        const size_t Index = Lyrics.Find(Time, Hint);
+
+        if ((Index != FindLinear(Lyrics, Time)) || (Lyrics.Find(Time) != Index))
+            ++Mismatches;
+
+        Hint = Index;
+    }
+
+    // Seeking in both directions with stale and invalid hints.
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        const uint32_t Time = Random() % 1200;
+
+        const size_t Hints[] = { Hint, lyrics_t::NotFound, Random() % Lyrics.GetCount(), Lyrics.GetCount() + 5 };
+
+        for (size_t h : Hints)
+        {
+            if (Lyrics.Find(Time, h) != FindLinear(Lyrics, Time))
+                ++Mismatches;
+        }
+
+        Hint = Lyrics.Find(Time, Hint);
+    }
+
+    CHECK(Mismatches == 0);
+
+    // An empty timeline
+    lyrics_t Empty;
+
+    CHECK(Empty.Find(100) == lyrics_t::NotFound);
+    CHECK(Empty.Find(100, 0) == lyrics_t::NotFound);
+    CHECK(Empty.Find(100, lyrics_t::NotFound) == lyrics_t::NotFound);
+}
@@ -0,0 +1,345 @@
+
+/** $VER: MMFTests.cpp (2026.10.19) P. Stuer - Tests the SMAF Mobile Standard decompression and conversion **/
+
+#include "Test.h"
+
+#include "MIDIProcessor.h"
+#include "Exception.h"
+
+#include "SMAF/MMF.h"
+
+using namespace midi;
+
+namespace
+{
+
+/// <summary>
+/// Writes bits MSB first.
+/// </summary>
+class bit_writer_t
+{
+public:
+    void Write(uint32_t value, uint32_t count)
+    {
+        while (count-- != 0)
+        {
+            if ((_BitCount % 8) == 0)
+                Data.push_back(0);
+
+            if ((value >> count) & 1u)
+                Data.back() |= (uint8_t) (0x80u >> (_BitCount % 8));
+
+            ++_BitCount;
+        }
+    }
+
+    std::vector<uint8_t> Data;
+
+private:
+    size_t _BitCount = 0;
+};
+
+/// <summary>
+/// Compresses the data with a skewed Huffman tree: the n-th distinct byte is encoded as n 1 bits followed by a 0 bit, the last one without the 0 bit.
+/// Inputs with more than 8 distinct bytes produce codes that are longer than the lookup table of the decoder.
+/// </summary>
+std::vector<uint8_t> Compress(const std::vector<uint8_t> & data, uint32_t declaredSize)
+{
+    std::vector<uint8_t> Symbols;
+
+    for (uint8_t Byte : data)
+    {
+        if (std::find(Symbols.begin(), Symbols.end(), Byte) == Symbols.end())
+            Symbols.push_back(Byte);
+    }
+
+    bit_writer_t bw;
+
+    bw.Write(declaredSize, 32);
+
+    // Write the tree depth-first.
+    for (size_t i = 0; i < Symbols.size(); ++i)
+    {
+        if (i + 1 < Symbols.size())
+            bw.Write(1, 1);
+
+        bw.Write(0, 1);
+        bw.Write(Symbols[i], 8);
+    }
+
+    // Write the codes.
+    if (Symbols.size() > 1)
+    {
+        for (uint8_t Byte : data)
+        {
+            const size_t Index = (size_t) (std::find(Symbols.begin(), Symbols.end(), Byte) - Symbols.begin());
+
+            for (size_t i = 0; i < Index; ++i)
+                bw.Write(1, 1);
+
+            if (Index + 1 < Symbols.size())
+                bw.Write(0, 1);
+        }
+    }
+
+    return bw.Data;
+}
+
+std::vector<uint8_t> Compress(const std::vector<uint8_t> & data)
+{
+    return Compress(data, (uint32_t) data.size());
+}
+
+/// <summary>
+/// Gets the Mobile Standard sequence data of the fixture: a program change, a SysEx message, notes with and without velocity on 2 channels, a control change, a pitch bend, a NOP and End of Sequence.
+/// The durations and gate times are in units of 4 ms.
+/// </summary>
+std::vector<uint8_t> GetSequence()
+{
+    return
+    {
+        0x00, 0xC0, 0x05,                               // Program Change
+        0x00, 0xF0, 0x04, 0x43, 0x79, 0x06, 0xF7,       // Exclusive
+        0x00, 0x90, 0x3C, 0x64, 0x30,                   // Note with velocity, gate time 48
+        0x30, 0x81, 0x40, 0x81, 0x00,                   // Note without velocity on channel 1, gate time 128
+        0x10, 0xB0, 0x07, 0x70,                         // Control Change
+        0x10, 0xE1, 0x00, 0x50,                         // Pitch Bend
+        0x00, 0xFF, 0x00,                               // NOP
+        0x81, 0x00, 0xFF, 0x2F,                         // End of Sequence after 128
+    };
+}
+
+void AppendChunk(std::vector<uint8_t> & data, const char * id, const std::vector<uint8_t> & body)
+{
+    const uint32_t Size = (uint32_t) body.size();
+
+    data.insert(data.end(), id, id + 4);
+    data.insert(data.end(), { (uint8_t) (Size >> 24), (uint8_t) (Size >> 16), (uint8_t) (Size >> 8), (uint8_t) Size });
+    data.insert(data.end(), body.begin(), body.end());
+}
+
+/// <summary>
+/// Creates an MMF file with a single Mobile Standard score track that contains the specified sequence data.
+/// </summary>
+std::vector<uint8_t> CreateMMF(const std::vector<uint8_t> & sequence, bool isCompressed)
+{
+    std::vector<uint8_t> Track =
+    {
+        (uint8_t) (isCompressed ? MobileStandard_Compress : MobileStandard_NoCompress), StreamSequence,
+        0x02, 0x02, // Duration and gate time base: 4 ms
+    };
+
+    Track.insert(Track.end(), 16, 0x00); // Channel status
+
+    AppendChunk(Track, "Mtsq", sequence);
+
+    std::vector<uint8_t> Body;
+
+    AppendChunk(Body, "CNTI", { 0x00, 0x00, 0x00, 0x00, 0x00 });
+    AppendChunk(Body, "MTR\x05", Track);
+
+    Body.insert(Body.end(), { 0x00, 0x00 }); // CRC
+
+    std::vector<uint8_t> Data;
+
+    AppendChunk(Data, "MMMD", Body);
+
+    return Data;
+}
+
+/// <summary>
+/// Returns true if the tracks of both containers contain the same events.
+/// </summary>
+bool IsEqual(container_t & a, container_t & b)
+{
+    if (a.GetTrackCount() != b.GetTrackCount())
+        return false;
+
+    for (size_t i = 0; i < a.GetTrackCount(); ++i)
+    {
+        const track_t & TrackA = a.GetTracks()[i];
+        const track_t & TrackB = b.GetTracks()[i];
+
+        if (TrackA.GetLength() != TrackB.GetLength())
+            return false;
+
+        for (size_t j = 0; j < TrackA.GetLength(); ++j)
+        {
+            if ((TrackA[j].Time != TrackB[j].Time) || (TrackA[j].Type != TrackB[j].Type) || (TrackA[j].ChannelNumber != TrackB[j].ChannelNumber) || (TrackA[j].Data != TrackB[j].Data))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+}
+
+TEST_CASE(DecompressesLongAndShortCodes)
+{
+    const std::vector<uint8_t> Sequence = GetSequence();
+
+    std::vector<uint8_t> Output;
+
+    CHECK(DecompressMobileStandard(Compress(Sequence).data(), Compress(Sequence).size(), Output));
+    CHECK(Output == Sequence);
+
+    // A tree with a single leaf has no codes.
+    const std::vector<uint8_t> Zeros(100, 0x00);
+
+    CHECK(DecompressMobileStandard(Compress(Zeros).data(), Compress(Zeros).size(), Output));
+    CHECK(Output == Zeros);
+}
+
+TEST_CASE(RejectsInvalidCompressedData)
+{
+    const std::vector<uint8_t> Sequence = GetSequence();
+    const std::vector<uint8_t> Data = Compress(Sequence);
+
+    std::vector<uint8_t> Output;
+
+    // No declared size.
+    CHECK(!DecompressMobileStandard(Data.data(), 3, Output));
+
+    // The stream ends inside the tree.
+    CHECK(!DecompressMobileStandard(Data.data(), 6, Output));
+
+    // The stream ends inside the encoded data.
+    CHECK(!DecompressMobileStandard(Data.data(), Data.size() - 2, Output));
+
+    // A tree with more inner nodes than a tree with 256 leaves.
+    {
+        std::vector<uint8_t> BadTree = { 0x00, 0x00, 0x00, 0x01 };
+
+        BadTree.insert(BadTree.end(), 64, 0xFF);
+
+        CHECK(!DecompressMobileStandard(BadTree.data(), BadTree.size(), Output));
+    }
+}
+
+TEST_CASE(DecodesOnlyTheDeclaredSize)
+{
+    const std::vector<uint8_t> Sequence = GetSequence();
+
+    std::vector<uint8_t> Output;
+
+    // The encoded data contains more bytes than declared. The remaining codes are ignored.
+    {
+        const std::vector<uint8_t> Data = Compress(Sequence, 10);
+
+        CHECK(DecompressMobileStandard(Data.data(), Data.size(), Output));
+        CHECK((Output == std::vector<uint8_t>(Sequence.begin(), Sequence.begin() + 10)));
+    }
+
+    // The declared size exceeds the encoded data.
+    {
+        const std::vector<uint8_t> Data = Compress(Sequence, (uint32_t) Sequence.size() + 100);
+
+        CHECK(!DecompressMobileStandard(Data.data(), Data.size(), Output));
+    }
+
+    // The declared size is out of proportion to the encoded data. It is rejected before the output is allocated.
+    {
+        const std::vector<uint8_t> Data = Compress(Sequence, 0xFFFFFFFF);
+
+        CHECK(!DecompressMobileStandard(Data.data(), Data.size(), Output));
+    }
+}
+
+TEST_CASE(ConvertsMobileStandardTracks)
+{
+    container_t Container;
+
+    CHECK(processor_t::Process(CreateMMF(GetSequence(), false), L"x.mmf", Container));
+    CHECK(Container.FileFormat == FileFormat::MMF);
+    CHECK(Container.GetTrackCount() == 1);
+
+    if (Container.GetTrackCount() != 1)
+        return;
+
+    const track_t & Track = Container.GetTracks()[0];
+
+    struct expected_t
+    {
+        uint32_t Time;
+        event_t::event_type_t Type;
+        uint32_t Channel;
+    };
+
+    const expected_t Expected[] =
+    {
+        {   0, event_t::ProgramChange,   0 },
+        {   0, event_t::Extended,        0 },
+        {   0, event_t::NoteOn,          0 },
+        { 192, event_t::NoteOff,         0 },
+        { 192, event_t::NoteOn,          1 },
+        { 256, event_t::ControlChange,   0 },
+        { 320, event_t::PitchBendChange, 1 },
+        { 704, event_t::NoteOff,         1 },
+        { 832, event_t::Extended,        0 },
+    };
+
+    CHECK(Track.GetLength() == _countof(Expected));
+
+    for (size_t i = 0; (i < _countof(Expected)) && (i < Track.GetLength()); ++i)
+    {
+        CHECK(Track[i].Time == Expected[i].Time);
+        CHECK(Track[i].Type == Expected[i].Type);
+        CHECK(Track[i].ChannelNumber == Expected[i].Channel);
+    }
+
+    CHECK((Track[1].Data == std::vector<uint8_t> { 0xF0, 0x43, 0x79, 0x06, 0xF7 }));
+    CHECK(Track[8].IsEndOfTrack());
+}
+
+TEST_CASE(CompressedAndUncompressedTracksAreEqual)
+{
+    container_t Uncompressed;
+    container_t Compressed;
+
+    CHECK(processor_t::Process(CreateMMF(GetSequence(), false), L"x.mmf", Uncompressed));
+    CHECK(processor_t::Process(CreateMMF(Compress(GetSequence()), true), L"x.mmf", Compressed));
+
+    CHECK(IsEqual(Uncompressed, Compressed));
+}
+
+TEST_CASE(RejectsInvalidMobileStandardTracks)
+{
+    const std::vector<uint8_t> Sequence = GetSequence();
+
+    // A truncated compressed stream.
+    {
+        std::vector<uint8_t> Data = Compress(Sequence);
+
+        Data.resize(Data.size() - 2);
+
+        container_t Container;
+
+        CHECK_THROWS(processor_t::Process(CreateMMF(Data, true), L"x.mmf", Container), midi::exception);
+    }
+
+    // A truncated event: the note with velocity lacks its gate time.
+    {
+        container_t Container;
+
+        CHECK_THROWS(processor_t::Process(CreateMMF(std::vector<uint8_t>(Sequence.begin(), Sequence.begin() + 14), false), L"x.mmf", Container), midi::exception);
+    }
+
+    // A SysEx message that is longer than the track.
+    {
+        const std::vector<uint8_t> Data = { 0x00, 0xF0, 0x10, 0x43, 0x79, 0xF7 };
+
+        container_t Container;
+
+        CHECK_THROWS(processor_t::Process(CreateMMF(Data, false), L"x.mmf", Container), midi::exception);
+    }
+
+    // A variable-length value of more than 4 bytes.
+    {
+        const std::vector<uint8_t> Data = { 0x81, 0x81, 0x81, 0x81, 0x00, 0xFF, 0x2F };
+
+        container_t Container;
+
+        CHECK_THROWS(processor_t::Process(CreateMMF(Data, false), L"x.mmf", Container), midi::exception);
+    }
+}
@@ -0,0 +1,26 @@
+
+/** $VER: Main.cpp (2026.10.19) P. Stuer - Runs the test cases of a test executable **/
+
+#include "Test.h"
+
+int main()
+{
+    for (const auto & TestCase : test::GetTestCases())
+    {
+        const size_t FailureCount = test::FailureCount;
+
+        try
+        {
+            TestCase.Function();
+        }
+        catch (const std::exception & e)
+        {
+            ::fprintf(stderr, "%s: Unexpected exception: %s\n", TestCase.Name, e.what());
+            ++test::FailureCount;
+        }
+
+        ::printf("%s %s\n", (test::FailureCount == FailureCount) ? "Passed" : "Failed", TestCase.Name);
+    }
+
+    return (test::FailureCount == 0) ? 0 : 1;
+}
@@ -0,0 +1,406 @@
+
+/** $VER: PlayerTests.cpp (2026.10.19) P. Stuer - Tests the lock-free queue and the real-time player **/
+
+#include "Test.h"
+
+#include "Player.h"
+#include "MIDI.h"
+
+#include <map>
+
+using namespace midi;
+
+namespace
+{
+
+// At the default tempo and a time division of 480, a sample rate of 960 makes a sample last exactly one tick.
+constexpr uint32_t TimeDivision = 480;
+constexpr uint32_t SampleRate = 960;
+
+constexpr uint32_t LoopBeginTime = 480;
+constexpr uint32_t EndTime = 1920;
+
+/// <summary>
+/// Creates a container with a sequence of short notes and a note that is still sounding at the end of the song.
+/// The RPG Maker loop marker (Control Change 111) makes the song loop from LoopBeginTime to its end.
+/// </summary>
+void CreateContainer(container_t & container, bool withLoop)
+{
+    track_t Track;
+
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+        const uint8_t NoteOn[] = { (uint8_t) (60 + i), 100 };
+        const uint8_t NoteOff[] = { (uint8_t) (60 + i), 0 };
+
+        Track.AddEvent(event_t(i * 240, event_t::NoteOn, 0, NoteOn, _countof(NoteOn)));
+        Track.AddEvent(event_t(i * 240 + 200, event_t::NoteOn, 0, NoteOff, _countof(NoteOff)));
+    }
+
+    if (withLoop)
+    {
+        const uint8_t LoopMarker[] = { 111, 0 };
+
+        Track.AddEvent(event_t(LoopBeginTime, event_t::ControlChange, 0, LoopMarker, _countof(LoopMarker)));
+    }
+
+    const uint8_t HangingNote[] = { 72, 100 };
+
+    Track.AddEvent(event_t(1800, event_t::NoteOn, 1, HangingNote, _countof(HangingNote)));
+
+    const uint8_t EndOfTrack[] = { StatusCode::MetaData, MetaDataType::EndOfTrack };
+
+    Track.AddEvent(event_t(EndTime, event_t::Extended, 0, EndOfTrack, _countof(EndOfTrack)));
+
+    container.Initialize(0, TimeDivision);
+    container.AddTrack(Track);
+
+    if (withLoop)
+        container.DetectLoops(false, false, true, false, false);
+}
+
+/// <summary>
+/// Plays the song the way an audio thread would until the player is done.
+/// </summary>
+std::vector<timed_message_t> Play(player_t & player, size_t maxCount = ~(size_t) 0)
+{
+    std::vector<timed_message_t> Messages;
+
+    player.Start();
+
+    while (!player.IsDone() && (Messages.size() < maxCount))
+    {
+        timed_message_t Message;
+
+        if (player.Pop(~(uint64_t) 0, Message))
+            Messages.push_back(Message);
+        else
+            std::this_thread::yield();
+    }
+
+    return Messages;
+}
+
+/// <summary>
+/// Returns true if the timestamps do not decrease and each Note On message is followed by a Note Off message.
+/// </summary>
+bool IsWellFormed(const std::vector<timed_message_t> & messages)
+{
+    std::map<uint32_t, int> SoundingNotes;
+
+    uint64_t Time = 0;
+
+    for (const auto & Message : messages)
+    {
+        if (Message.Time < Time)
+            return false;
+
+        Time = Message.Time;
+
+        const uint32_t Type = Message.Data & 0xF0;
+
+        if ((Type != StatusCode::NoteOn) && (Type != StatusCode::NoteOff))
+            continue;
+
+        const uint32_t Key = Message.Data & 0xFF00FF0Fu;
+
+        if ((Type == StatusCode::NoteOn) && ((Message.Data & 0x00FF0000u) != 0))
+            ++SoundingNotes[Key];
+        else
+        if (SoundingNotes[Key] > 0)
+            --SoundingNotes[Key];
+    }
+
+    for (const auto & [ Key, Count ] : SoundingNotes)
+    {
+        if (Count != 0)
+            return false;
+    }
+
+    return true;
+}
+
+size_t CountLoopMarkers(const std::vector<timed_message_t> & messages)
+{
+    return (size_t) std::count_if(messages.begin(), messages.end(), [](const timed_message_t & m) { return (m.Data & 0xFFF0u) == ((111u << 8) | StatusCode::ControlChange); });
+}
+
+}
+
+TEST_CASE(RingBufferRoundsCapacityUp)
+{
+    ring_buffer_t<uint32_t> Queue;
+
+    Queue.Reset(5);
+
+    CHECK(Queue.IsEmpty());
+    CHECK(Queue.Front() == nullptr);
+
+    for (uint32_t i = 0; i < 8; ++i)
+        CHECK(Queue.Push(i));
+
+    CHECK(!Queue.Push(8));
+
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+        const uint32_t * Item = Queue.Front();
+
+        CHECK((Item != nullptr) && (*Item == i));
+
+        Queue.Pop();
+    }
+
+    CHECK(Queue.IsEmpty());
+}
+
+TEST_CASE(RingBufferWrapsAround)
+{
+    ring_buffer_t<uint32_t> Queue;
+
+    Queue.Reset(4);
+
+    uint32_t Next = 0;
+
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        CHECK(Queue.Push(i));
+
+        if (i % 3 != 0)
+            continue;
+
+        while (const uint32_t * Item = Queue.Front())
+        {
+            CHECK(*Item == Next++);
+
+            Queue.Pop();
+        }
+    }
+
+    while (const uint32_t * Item = Queue.Front())
+    {
+        CHECK(*Item == Next++);
+
+        Queue.Pop();
+    }
+
+    CHECK(Next == 1000);
+}
+
+TEST_CASE(RingBufferPassesItemsBetweenThreads)
+{
+    ring_buffer_t<uint64_t> Queue;
+
+    Queue.Reset(64);
+
+    constexpr uint64_t Count = 200'000;
+
+    std::thread Producer([&Queue]()
+    {
+        for (uint64_t i = 0; i < Count;)
+        {
+            if (Queue.Push(i))
+                ++i;
+            else
+                std::this_thread::yield();
+        }
+    });
+
+    uint64_t Next = 0;
+    bool IsOrdered = true;
+
+    while (Next < Count)
+    {
+        const uint64_t * Item = Queue.Front();
+
+        if (Item == nullptr)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        IsOrdered &= (*Item == Next++);
+
+        Queue.Pop();
+    }
+
+    Producer.join();
+
+    CHECK(IsOrdered);
+    CHECK(Queue.IsEmpty());
+}
+
+TEST_CASE(PlayerPlaysTheSerializedStream)
+{
+    container_t Container;
+
+    CreateContainer(Container, false);
+
+    std::vector<timed_message_t> Stream;
+    sysex_table_t SysExTable;
+    std::vector<uint8_t> PortNumbers;
+    uint32_t LoopBegin, LoopEnd;
+
+    Container.SerializeAsStream(0, Stream, SysExTable, PortNumbers, LoopBegin, LoopEnd, event_filter_t(), SampleRate);
+
+    player_options_t Options;
+
+    Options.SampleRate = SampleRate;
+    Options.QueueSize = 4; // Makes the producer wait for the consumer.
+
+    player_t Player;
+
+    CHECK(Player.Open(Container, 0, Options));
+
+    const std::vector<timed_message_t> Messages = Play(Player);
+
+    // The hanging note is released at the time of the last message.
+    Stream.push_back({ Stream.back().Time, StatusCode::NoteOff | 0x01u | (72u << 8) });
+
+    CHECK(Messages.size() == Stream.size());
+
+    for (size_t i = 0; (i < Messages.size()) && (i < Stream.size()); ++i)
+        CHECK((Messages[i].Time == Stream[i].Time) && (Messages[i].Data == Stream[i].Data));
+
+    CHECK(IsWellFormed(Messages));
+}
+
+TEST_CASE(PlayerPopsOnlyDueMessages)
+{
+    container_t Container;
+
+    CreateContainer(Container, false);
+
+    player_options_t Options;
+
+    Options.SampleRate = SampleRate;
+
+    player_t Player;
+
+    CHECK(Player.Open(Container, 0, Options));
+
+    Player.Start();
+
+    timed_message_t Message;
+
+    // The first message is at time 0, so it is due after the first sample.
+    CHECK(!Player.Pop(0, Message));
+
+    while (!Player.Pop(1, Message))
+        std::this_thread::yield();
+
+    CHECK(Message.Time == 0);
+
+    // The next message is at sample 200.
+    while (!Player.IsDone() && Player.Pop(200, Message))
+        ;
+
+    CHECK(!Player.Pop(200, Message));
+    CHECK(Player.Pop(201, Message) && (Message.Time == 200));
+
+    Player.Stop();
+}
+
+TEST_CASE(PlayerRepeatsTheLoop)
+{
+    container_t Container;
+
+    CreateContainer(Container, true);
+
+    player_options_t Options;
+
+    Options.SampleRate = SampleRate;
+    Options.LoopCount = 2;
+    Options.QueueSize = 16;
+
+    player_t Player;
+
+    CHECK(Player.Open(Container, 0, Options));
+
+    const std::vector<timed_message_t> Messages = Play(Player);
+
+    constexpr uint64_t LoopLength = EndTime - LoopBeginTime;
+
+    CHECK(CountLoopMarkers(Messages) == 1 + Options.LoopCount);
+
+    // The last message releases the hanging note at the time of the last Note Off of the last repetition.
+    CHECK(!Messages.empty() && (Messages.back().Time == 1880 + LoopLength * Options.LoopCount));
+
+    // The hanging note is released at each loop jump and at the end.
+    CHECK(IsWellFormed(Messages));
+    CHECK(std::count_if(Messages.begin(), Messages.end(), [](const timed_message_t & m) { return m.Data == (StatusCode::NoteOff | 0x01u | (72u << 8)); }) == 3);
+}
+
+TEST_CASE(PlayerFadesOutAfterTheLastLoop)
+{
+    container_t Container;
+
+    CreateContainer(Container, true);
+
+    player_options_t Options;
+
+    Options.SampleRate = SampleRate;
+    Options.LoopCount = 1;
+    Options.FadeDuration = 1000;
+
+    player_t Player;
+
+    CHECK(Player.Open(Container, 0, Options));
+
+    constexpr uint64_t FadeBegin = EndTime + (EndTime - LoopBeginTime);
+    constexpr uint64_t FadeEnd = FadeBegin + SampleRate;
+
+    CHECK(Player.GetGain(0) == 1.f);
+    CHECK(Player.GetGain(FadeBegin) == 1.f);
+    CHECK(Player.GetGain(FadeBegin + SampleRate / 2) == 0.5f);
+    CHECK(Player.GetGain(FadeEnd) == 0.f);
+
+    const std::vector<timed_message_t> Messages = Play(Player);
+
+    CHECK(!Messages.empty() && (Messages.back().Time > FadeBegin) && (Messages.back().Time <= FadeEnd));
+    CHECK(IsWellFormed(Messages));
+}
+
+TEST_CASE(PlayerStopsAnInfiniteLoop)
+{
+    container_t Container;
+
+    CreateContainer(Container, true);
+
+    player_options_t Options;
+
+    Options.SampleRate = SampleRate;
+    Options.LoopCount = player_options_t::InfiniteLoops;
+    Options.QueueSize = 16;
+
+    player_t Player;
+
+    CHECK(Player.Open(Container, 0, Options));
+
+    const std::vector<timed_message_t> Messages = Play(Player, 1000);
+
+    CHECK(Messages.size() == 1000);
+    CHECK(!Player.IsDone());
+
+    Player.Stop();
+
+    // The messages in the queue remain available after the producer stopped.
+    timed_message_t Message;
+
+    while (Player.Pop(~(uint64_t) 0, Message))
+        ;
+
+    CHECK(Player.IsDone());
+}
+
+TEST_CASE(PlayerRejectsAnEmptyContainer)
+{
+    container_t Container;
+
+    player_t Player;
+
+    CHECK(!Player.Open(Container, 0, player_options_t()));
+
+    Player.Start();
+
+    CHECK(Player.IsDone());
+}
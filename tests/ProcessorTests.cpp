@@ -0,0 +1,109 @@
+
+/** $VER: ProcessorTests.cpp (2026.10.19) P. Stuer - Tests the processor options **/
+
+#include "Test.h"
+
+#include "MIDIProcessor.h"
+
+#include <thread>
+
+using namespace midi;
+
+namespace
+{
+
+/// <summary>
+/// Creates an HMP file without tracks. The processor only adds the conductor track with the default tempo.
+/// </summary>
+std::vector<uint8_t> CreateHMP()
+{
+    const char Id[] = { 'H', 'M', 'I', 'M', 'I', 'D', 'I', 'P' };
+    const uint8_t Tail[] = { 0x01, StatusCode::MetaData, MetaDataType::EndOfTrack, 0, 0, 0, 0, 0 };
+
+    std::vector<uint8_t> Data(0x30 + _countof(Tail), 0);
+
+    std::copy(Id, Id + _countof(Id), Data.begin());
+    std::copy(Tail, Tail + _countof(Tail), Data.begin() + 0x30);
+
+    return Data;
+}
+
+/// <summary>
+/// Gets the tempo event that the processor added for the specified default tempo.
+/// </summary>
+std::vector<uint8_t> GetTempoEvent(const std::vector<uint8_t> & data, uint16_t defaultTempo)
+{
+    processor_options_t Options = DefaultOptions;
+
+    Options.DefaultTempo = defaultTempo;
+
+    container_t Container;
+
+    if (!processor_t::Process(data, L"x.hmp", Container, Options) || (Container.GetTrackCount() == 0))
+        return { };
+
+    for (const auto & Event : Container.GetTracks()[0])
+    {
+        if (Event.IsSetTempo())
+            return Event.Data;
+    }
+
+    return { };
+}
+
+}
+
+TEST_CASE(OptionsApplyToTheirOwnCall)
+{
+    const std::vector<uint8_t> Data = CreateHMP();
+
+    const std::vector<uint8_t> Slow = GetTempoEvent(Data, 60);
+    const std::vector<uint8_t> Fast = GetTempoEvent(Data, 240);
+
+    CHECK(!Slow.empty());
+    CHECK(!Fast.empty());
+    CHECK(Slow != Fast);
+
+    // The default options are not changed by a call with other options.
+    CHECK(GetTempoEvent(Data, DefaultOptions.DefaultTempo) == GetTempoEvent(Data, 160));
+}
+
+TEST_CASE(ProcessesWithDifferentOptionsOnSeveralThreads)
+{
+    const std::vector<uint8_t> Data = CreateHMP();
+
+    constexpr size_t ThreadCount = 4;
+    constexpr size_t Iterations = 200;
+
+    std::vector<std::vector<uint8_t>> Expected;
+    std::vector<size_t> Mismatches(ThreadCount, 0);
+
+    for (size_t i = 0; i < ThreadCount; ++i)
+        Expected.push_back(GetTempoEvent(Data, (uint16_t) (60 + i * 40)));
+
+    std::vector<std::thread> Threads;
+
+    for (size_t i = 0; i < ThreadCount; ++i)
+    {
+        Threads.emplace_back([&Data, &Expected, &Mismatches, i]()
+        {
+            for (size_t j = 0; j < Iterations; ++j)
+            {
+                if (GetTempoEvent(Data, (uint16_t) (60 + i * 40)) != Expected[i])
+                    ++Mismatches[i];
+            }
+        });
+    }
+
+    for (auto & Thread : Threads)
+        Thread.join();
+
+    for (size_t i = 0; i < ThreadCount; ++i)
+    {
+        CHECK(!Expected[i].empty());
+        CHECK(Mismatches[i] == 0);
+    }
+
+    for (size_t i = 1; i < ThreadCount; ++i)
+        CHECK(Expected[i] != Expected[0]);
+}
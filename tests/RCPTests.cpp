@@ -0,0 +1,439 @@
+
+/** $VER: RCPTests.cpp (2026.10.19) P. Stuer - Tests the RCP converter **/
+
+#include "Test.h"
+
+#include "RCP/RCP.h"
+#include "RCP/ControlFileCache.h"
+
+#include <fstream>
+#include <random>
+
+namespace
+{
+
+/// <summary>
+/// Creates an RCP 3.0 sequence with the specified number of tracks of random notes. Returns the offset of each track in trackOffsets.
+/// </summary>
+std::vector<uint8_t> CreateRCP(uint16_t trackCount, std::vector<size_t> & trackOffsets)
+{
+    std::mt19937 Random(trackCount);
+
+    std::vector<uint8_t> Data(0x318 + 128 * 16 + 8 * 48);
+
+    const char Signature[] = "COME ON MUSIC RECOMPOSER RCP3.0";
+
+    ::memcpy(Data.data(), Signature, sizeof(Signature) - 1);
+
+    Data[0x208] = (uint8_t) trackCount;
+    Data[0x20A] = 48;   // Ticks per quarter
+    Data[0x20C] = 120;  // Tempo
+    Data[0x20E] = 4;
+    Data[0x20F] = 4;
+
+    trackOffsets.clear();
+
+    for (uint16_t i = 0; i < trackCount; ++i)
+    {
+        std::vector<uint8_t> Track(4 + 0x2A);
+
+        Track[4 + 0x00] = (uint8_t) (i + 1);    // Track ID
+        Track[4 + 0x02] = (uint8_t) i;          // Channel
+
+        auto AddCommand = [&Track](uint8_t type, uint8_t value, uint16_t delay, uint16_t duration)
+        {
+            const uint8_t Command[6] = { type, value, (uint8_t) delay, (uint8_t) (delay >> 8), (uint8_t) duration, (uint8_t) (duration >> 8) };
+
+            Track.insert(Track.end(), Command, Command + 6);
+        };
+
+        for (int j = 0; j < 40; ++j)
+            AddCommand((uint8_t) (36 + Random() % 48), (uint8_t) (1 + Random() % 127), (uint16_t) (Random() % 24), (uint16_t) (1 + Random() % 48));
+
+        AddCommand(0xFE, 0, 0, 0); // End of Track
+
+        const uint32_t Size = (uint32_t) Track.size();
+
+        ::memcpy(Track.data(), &Size, 4);
+
+        trackOffsets.push_back(Data.size());
+
+        Data.insert(Data.end(), Track.begin(), Track.end());
+    }
+
+    return Data;
+}
+
+/// <summary>
+/// Converts RCP data to a Standard MIDI File. Returns false if the conversion fails.
+/// </summary>
+bool Convert(const uint8_t * data, size_t size, bool parallelTracks, std::vector<uint8_t> & smf)
+{
+    rcp::buffer_t SrcData;
+
+    SrcData.Copy(data, size);
+
+    rcp::converter_t Converter;
+
+    Converter._Options.IncludeControlData = false;
+    Converter._Options.ParallelTracks     = parallelTracks;
+
+    rcp::buffer_t DstData;
+
+    try
+    {
+        Converter.Convert(SrcData, DstData);
+    }
+    catch (const std::exception &)
+    {
+        return false;
+    }
+
+    smf.assign(DstData.Data, DstData.Data + DstData.Size);
+
+    return true;
+}
+
+/// <summary>
+/// Converts RCP data to a Standard MIDI File and splits it into its track chunks. Returns false if the conversion fails.
+/// </summary>
+bool Convert(const uint8_t * data, size_t size, bool parallelTracks, std::vector<std::vector<uint8_t>> & tracks)
+{
+    std::vector<uint8_t> SMF;
+
+    if (!Convert(data, size, parallelTracks, SMF))
+        return false;
+
+    tracks.clear();
+
+    for (size_t Offset = 14; Offset + 8 <= SMF.size();)
+    {
+        const size_t Size = ((size_t) SMF[Offset + 4] << 24) | ((size_t) SMF[Offset + 5] << 16) | ((size_t) SMF[Offset + 6] << 8) | SMF[Offset + 7];
+
+        tracks.emplace_back(SMF.begin() + (ptrdiff_t) Offset + 8, SMF.begin() + (ptrdiff_t) (Offset + 8 + Size));
+
+        Offset += 8 + Size;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Calculates the 64-bit FNV-1a hash of the data.
+/// </summary>
+uint64_t GetHash(const std::vector<uint8_t> & data) noexcept
+{
+    uint64_t Hash = 0xCBF29CE484222325ull;
+
+    for (uint8_t Byte : data)
+    {
+        Hash ^= Byte;
+        Hash *= 0x00000100000001B3ull;
+    }
+
+    return Hash;
+}
+
+/// <summary>
+/// Writes Roland SysEx messages and text meta events to a MIDI stream or a SysEx builder.
+/// </summary>
+template<typename T>
+void WriteSysExMessages(T & writer)
+{
+    const uint8_t Data[0x40] =
+    {
+        0x40, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F,
+        0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F,
+        0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F, 0x7F,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    };
+
+    writer.WriteMetaEvent(midi::MetaDataType::Text, "MT-32 System");
+
+    // A single message, without and with a delay.
+    writer.WriteRolandSysEx(rcp::SysExHeaderMT32, 0x100000, Data, 0x17, 0);
+    writer.WriteRolandSysEx(rcp::SysExHeaderMT32, 0x100000, Data, 0x17, SYXOPT_DELAY);
+
+    // The sum of the address and the data is 0x80, 0x7F and 0x81: the checksums are 0x00, 0x01 and 0x7F.
+    writer.WriteRolandSysEx(rcp::SysExHeaderSC55, 0x400000, Data, 1, SYXOPT_DELAY);
+    writer.WriteRolandSysEx(rcp::SysExHeaderSC55, 0x3F0000, Data, 1, SYXOPT_DELAY);
+    writer.WriteRolandSysEx(rcp::SysExHeaderSC55, 0x400001, Data, 1, SYXOPT_DELAY);
+
+    // Blocks of 7 bytes that cross a 7-bit address boundary.
+    writer.WriteMetaEvent(midi::MetaDataType::Text, "SC-55 Patch Parameters");
+    writer.WriteRolandSysEx(rcp::SysExHeaderSC55, 0x40107A, Data + 0x10, 0x30, SYXOPT_DELAY, 7);
+
+    // A message without data and a large message. The delay after the last message remains.
+    writer.WriteRolandSysEx(rcp::SysExHeaderSC55, 0x000000, Data, 0, 0);
+    writer.WriteRolandSysEx(rcp::SysExHeaderSC55, 0x7F7F7F, Data, sizeof(Data), SYXOPT_DELAY);
+}
+
+
+/// <summary>
+/// Writes a GSD control file of the specified size.
+/// </summary>
+void WriteGSDFile(const std::filesystem::path & filePath, size_t size)
+{
+    std::vector<char> Data(size, 0);
+
+    ::memcpy(Data.data(), "COME ON MUSIC", 13);
+    ::memcpy(Data.data() + 0x0E, "GS CONTROL 1.0", 14);
+
+    std::ofstream Stream(filePath, std::ios::binary | std::ios::trunc);
+
+    Stream.write(Data.data(), (std::streamsize) Data.size());
+}
+
+}
+
+TEST_CASE(ParallelConversionMatchesSequentialConversion)
+{
+    std::vector<size_t> TrackOffsets;
+
+    const std::vector<uint8_t> Data = CreateRCP(12, TrackOffsets);
+
+    std::vector<std::vector<uint8_t>> Sequential, Parallel;
+
+    CHECK(Convert(Data.data(), Data.size(), false, Sequential));
+    CHECK(Convert(Data.data(), Data.size(), true, Parallel));
+    CHECK(Sequential.size() == 1 + 12);
+    CHECK(Sequential == Parallel);
+}
+
+TEST_CASE(TruncatedFilesConvertTheSameInParallel)
+{
+    std::vector<size_t> TrackOffsets;
+
+    const std::vector<uint8_t> Data = CreateRCP(4, TrackOffsets);
+
+    for (size_t Size = TrackOffsets[0]; Size <= Data.size(); ++Size)
+    {
+        std::vector<std::vector<uint8_t>> Sequential, Parallel;
+
+        const bool SequentialResult = Convert(Data.data(), Size, false, Sequential);
+        const bool ParallelResult   = Convert(Data.data(), Size, true, Parallel);
+
+        CHECK(SequentialResult == ParallelResult);
+        CHECK(Sequential == Parallel);
+    }
+}
+
+TEST_CASE(ConversionMatchesSequentialConverterOutput)
+{
+    // The size and hash of the output of the converter before the tracks were converted concurrently.
+    struct golden_t
+    {
+        uint16_t TrackCount;
+        size_t TruncatedSize;   // Number of bytes of the last track or 0 for the whole file
+        size_t Size;
+        uint64_t Hash;
+    };
+
+    const golden_t Golden[] =
+    {
+        {  1,   0,  970, 0x349313DFACA5629Full },
+        {  4,   0, 2068, 0xAD4EE150463F961Aull },
+        {  4, 100, 1820, 0xB8C45CCE6C498C9Bull },
+        { 12,   0, 5052, 0x4228E354BF7F1397ull },
+    };
+
+    for (const auto & Item : Golden)
+    {
+        std::vector<size_t> TrackOffsets;
+
+        std::vector<uint8_t> Data = CreateRCP(Item.TrackCount, TrackOffsets);
+
+        if (Item.TruncatedSize != 0)
+            Data.resize(TrackOffsets.back() + Item.TruncatedSize);
+
+        for (bool ParallelTracks : { false, true })
+        {
+            std::vector<uint8_t> SMF;
+
+            CHECK(Convert(Data.data(), Data.size(), ParallelTracks, SMF));
+            CHECK(SMF.size() == Item.Size);
+            CHECK(GetHash(SMF) == Item.Hash);
+        }
+    }
+}
+
+TEST_CASE(TruncatedTrackEndsTheSequence)
+{
+    std::vector<size_t> TrackOffsets;
+
+    const std::vector<uint8_t> Data = CreateRCP(4, TrackOffsets);
+
+    std::vector<std::vector<uint8_t>> Complete, Truncated;
+
+    CHECK(Convert(Data.data(), Data.size(), false, Complete));
+
+    // Cut the third track in the middle of its events. The following track is dropped and the first tracks are not affected.
+    CHECK(Convert(Data.data(), TrackOffsets[2] + 4 + 0x2A + 60, true, Truncated));
+    CHECK(Truncated.size() == 1 + 3);
+
+    if (Truncated.size() == 1 + 3)
+    {
+        CHECK(Truncated[1] == Complete[1]);
+        CHECK(Truncated[2] == Complete[2]);
+        CHECK(Truncated[3].size() < Complete[3].size());
+    }
+
+    // An incomplete track header is rejected.
+    CHECK(!Convert(Data.data(), TrackOffsets[2] + 10, true, Truncated));
+}
+
+TEST_CASE(SysExBuilderMatchesMIDIStream)
+{
+    rcp::midi_stream_t Expected;
+
+    Expected.SetTicksPerQuarter(48);
+    Expected.SetTempo(500000);
+    Expected.SetDuration(0);
+
+    WriteSysExMessages(Expected);
+
+    rcp::sysex_builder_t Builder(48, 500000);
+
+    WriteSysExMessages(Builder);
+
+    Builder.Finalize();
+
+    rcp::midi_stream_t Actual;
+
+    Actual.SetTicksPerQuarter(48);
+    Actual.SetTempo(500000);
+    Actual.SetDuration(0);
+
+    Actual.WriteEvents(Builder.GetData().data(), (uint32_t) Builder.GetData().size(), Builder.GetDuration());
+
+    CHECK(Actual.GetOffs() == Expected.GetOffs());
+    CHECK(std::equal(Actual.GetData(), Actual.GetData() + Actual.GetOffs(), Expected.GetData(), Expected.GetData() + Expected.GetOffs()));
+    CHECK(Actual.GetDuration() == Expected.GetDuration());
+    CHECK(Builder.GetDuration() != 0);
+
+    // The messages of which the checksum wraps at 0x80.
+    const uint8_t Wrapped[][12] =
+    {
+        { 0xF0, 0x0A, 0x41, 0x10, 0x42, 0x12, 0x40, 0x00, 0x00, 0x40, 0x00, 0xF7 },
+        { 0xF0, 0x0A, 0x41, 0x10, 0x42, 0x12, 0x3F, 0x00, 0x00, 0x40, 0x01, 0xF7 },
+        { 0xF0, 0x0A, 0x41, 0x10, 0x42, 0x12, 0x40, 0x00, 0x01, 0x40, 0x7F, 0xF7 },
+    };
+
+    const std::vector<uint8_t> & Data = Builder.GetData();
+
+    for (const auto & Message : Wrapped)
+        CHECK(std::search(Data.begin(), Data.end(), Message, Message + _countof(Message)) != Data.end());
+}
+
+TEST_CASE(ControlFileCacheReturnsCachedFile)
+{
+    auto & Cache = rcp::control_file_cache_t::GetInstance();
+
+    Cache.Clear();
+
+    const auto FilePath = std::filesystem::temp_directory_path() / "libmidi-control-file.gsd";
+
+    WriteGSDFile(FilePath, 0x0A71);
+
+    const auto File = Cache.Get(FilePath.wstring(), 0x11);
+
+    CHECK(File != nullptr);
+    CHECK(Cache.Get(FilePath.wstring(), 0x11) == File);
+    CHECK(Cache.GetCount() == 1);
+
+    // A change of the last write time invalidates the entry.
+    const auto LastWriteTime = std::filesystem::last_write_time(FilePath);
+
+    std::filesystem::last_write_time(FilePath, LastWriteTime + std::chrono::hours(1));
+
+    const auto Touched = Cache.Get(FilePath.wstring(), 0x11);
+
+    CHECK(Touched != File);
+    CHECK(Cache.Get(FilePath.wstring(), 0x11) == Touched);
+
+    // A change of the size invalidates the entry, even if the last write time is the same.
+    WriteGSDFile(FilePath, 0x0A80);
+
+    std::filesystem::last_write_time(FilePath, LastWriteTime + std::chrono::hours(1));
+
+    const auto Resized = Cache.Get(FilePath.wstring(), 0x11);
+
+    CHECK(Resized != Touched);
+    CHECK(Cache.Get(FilePath.wstring(), 0x11) == Resized);
+    CHECK(Cache.GetCount() == 1);
+
+    // A file that was removed from the cache remains valid.
+    CHECK(File->Type == 0x11);
+
+    Cache.Clear();
+
+    std::filesystem::remove(FilePath);
+}
+
+TEST_CASE(ControlFileCacheRemovesLeastRecentlyUsedFile)
+{
+    auto & Cache = rcp::control_file_cache_t::GetInstance();
+
+    Cache.Clear();
+
+    std::vector<std::filesystem::path> FilePaths;
+    std::vector<std::shared_ptr<const rcp::control_file_t>> Files;
+
+    for (size_t i = 0; i < rcp::control_file_cache_t::MaxEntries + 2; ++i)
+    {
+        FilePaths.push_back(std::filesystem::temp_directory_path() / ("libmidi-control-file-" + std::to_string(i) + ".gsd"));
+
+        WriteGSDFile(FilePaths.back(), 0x0A71);
+
+        Files.push_back(Cache.Get(FilePaths.back().wstring(), 0x11));
+
+        // Keep using the first file.
+        CHECK(Cache.Get(FilePaths[0].wstring(), 0x11) == Files[0]);
+    }
+
+    CHECK(Cache.GetCount() == rcp::control_file_cache_t::MaxEntries);
+
+    // The second and third file were used least recently.
+    CHECK(Cache.Get(FilePaths[1].wstring(), 0x11) != Files[1]);
+    CHECK(Cache.Get(FilePaths.back().wstring(), 0x11) == Files.back());
+    CHECK(Cache.GetCount() == rcp::control_file_cache_t::MaxEntries);
+
+    Cache.Clear();
+
+    for (const auto & FilePath : FilePaths)
+        std::filesystem::remove(FilePath);
+}
+
+TEST_CASE(ControlFileKeepsEventsOfRecentTimeBases)
+{
+    rcp::control_file_t File;
+
+    std::vector<std::shared_ptr<const rcp::control_events_t>> Events;
+
+    for (uint32_t i = 0; i < rcp::control_file_t::MaxEvents + 1; ++i)
+    {
+        auto e = std::make_shared<rcp::control_events_t>();
+
+        e->TicksPerQuarter = 48;
+        e->Tempo = 500000 + i;
+
+        Events.push_back(File.AddEvents(e));
+
+        CHECK(Events.back() == e);
+        CHECK(File.GetEvents(48, 500000 + i) == e);
+    }
+
+    // Events for a time base that is already present are not replaced.
+    {
+        auto e = std::make_shared<rcp::control_events_t>();
+
+        e->TicksPerQuarter = 48;
+        e->Tempo = 500001;
+
+        CHECK(File.AddEvents(e) == Events[1]);
+    }
+
+    // The events of the oldest time base were removed.
+    CHECK(File.GetEvents(48, 500000) == nullptr);
+    CHECK(File.GetEvents(48, 500000 + rcp::control_file_t::MaxEvents) == Events.back());
+}
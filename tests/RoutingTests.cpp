@@ -0,0 +1,144 @@
+
+/** $VER: RoutingTests.cpp (2026.10.19) P. Stuer - Tests the routing of tracks to ports by Device Name and MIDI Port events **/
+
+#include "Test.h"
+
+#include "MIDIContainer.h"
+
+using namespace midi;
+
+namespace
+{
+
+/// <summary>
+/// Adds a meta data event with a text or byte payload to a track.
+/// </summary>
+void AddMetaData(track_t & track, uint32_t time, uint8_t type, const std::string & text)
+{
+    std::vector<uint8_t> Data = { StatusCode::MetaData, type };
+
+    Data.insert(Data.end(), text.begin(), text.end());
+
+    track.AddEvent(event_t(time, event_t::Extended, 0, Data.data(), Data.size()));
+}
+
+/// <summary>
+/// Creates a track that is routed by the specified meta data events and plays a single note at the specified time.
+/// </summary>
+track_t CreateTrack(std::initializer_list<std::pair<uint8_t, std::string>> routing, uint32_t channel, uint32_t time)
+{
+    track_t Track;
+
+    for (const auto & [ Type, Text ] : routing)
+        AddMetaData(Track, 0, Type, Text);
+
+    const uint8_t NoteOn[] = { 0x3C, 0x64 };
+    const uint8_t NoteOff[] = { 0x3C, 0x00 };
+
+    Track.AddEvent(event_t(time, event_t::NoteOn, channel, NoteOn, _countof(NoteOn)));
+    Track.AddEvent(event_t(time + 1, event_t::NoteOn, channel, NoteOff, _countof(NoteOff)));
+
+    AddMetaData(Track, time + 1, MetaDataType::EndOfTrack, "");
+
+    return Track;
+}
+
+/// <summary>
+/// Gets the port of the Note On events in stream order.
+/// </summary>
+std::vector<uint8_t> GetNotePorts(const std::vector<message_t> & stream)
+{
+    std::vector<uint8_t> Ports;
+
+    for (const auto & Message : stream)
+    {
+        if (!Message.IsSysEx() && ((Message.Data & 0xF0u) == StatusCode::NoteOn) && ((Message.Data & 0xFF0000u) != 0))
+            Ports.push_back((uint8_t) (Message.Data >> 24));
+    }
+
+    return Ports;
+}
+
+}
+
+TEST_CASE(DeviceNamesAndPortsRouteTracks)
+{
+    const std::string Port3(1, '\x03');
+
+    container_t Container;
+
+    Container.Initialize(1, 96);
+
+    {
+        track_t Conductor;
+
+        AddMetaData(Conductor, 0, MetaDataType::SetTempo, std::string("\x07\xA1\x20", 3));
+        AddMetaData(Conductor, 0, MetaDataType::EndOfTrack, "");
+
+        Container.AddTrack(Conductor);
+    }
+
+    // The notes are played in track order.
+    Container.AddTrack(CreateTrack({ { MetaDataType::DeviceName, "SC-88" } }, 0, 10));                                            // The first device on channel 0
+    Container.AddTrack(CreateTrack({ { MetaDataType::DeviceName, "sc-88" } }, 0, 20));                                            // Device names are compared case-insensitively.
+    Container.AddTrack(CreateTrack({ { MetaDataType::InstrumentName, "MU-80" } }, 0, 30));                                        // The second device on channel 0
+    Container.AddTrack(CreateTrack({ { MetaDataType::DeviceName, "MU-80" } }, 1, 40));                                            // The first device on channel 1
+    Container.AddTrack(CreateTrack({ { MetaDataType::MIDIPort, Port3 } }, 0, 50));                                                // A raw port number
+    Container.AddTrack(CreateTrack({ { MetaDataType::MIDIPort, Port3 }, { MetaDataType::DeviceName, "MU-80" } }, 0, 60));         // A device name overrides an earlier port.
+    Container.AddTrack(CreateTrack({ { MetaDataType::DeviceName, "SC-88" }, { MetaDataType::MIDIPort, Port3 } }, 0, 70));         // A port overrides an earlier device name.
+    Container.AddTrack(CreateTrack({ }, 2, 80));                                                                                  // No routing
+
+    std::vector<message_t> Stream;
+    sysex_table_t SysExTable;
+    std::vector<uint8_t> PortNumbers;
+    uint32_t LoopBegin, LoopEnd;
+
+    Container.SerializeAsStream(0, Stream, SysExTable, PortNumbers, LoopBegin, LoopEnd, event_filter_t());
+
+    CHECK((GetNotePorts(Stream) == std::vector<uint8_t> { 0, 0, 1, 0, 3, 1, 3, 0 }));
+
+    // The raw port numbers in the order in which they were normalized.
+    CHECK((PortNumbers == std::vector<uint8_t> { 0, 1, 2, 3 }));
+}
+
+TEST_CASE(DeviceNameRoutesSysExAndSystemMessages)
+{
+    container_t Container;
+
+    Container.Initialize(1, 96);
+
+    // Routes the SysEx message of the second track to the second device on channel 0.
+    Container.AddTrack(CreateTrack({ { MetaDataType::DeviceName, "SC-88" } }, 0, 10));
+
+    {
+        track_t Track = CreateTrack({ { MetaDataType::DeviceName, "MU-80" } }, 0, 20);
+
+        const uint8_t SysEx[] = { StatusCode::SysEx, 0x7E, 0x7F, 0x09, 0x01, StatusCode::SysExEnd };
+
+        Track.AddEvent(event_t(5, event_t::Extended, 0, SysEx, _countof(SysEx)));
+
+        Container.AddTrack(Track);
+    }
+
+    // The first device on another channel uses the first port.
+    Container.AddTrack(CreateTrack({ { MetaDataType::DeviceName, "Unknown" } }, 3, 30));
+
+    std::vector<message_t> Stream;
+    sysex_table_t SysExTable;
+    std::vector<uint8_t> PortNumbers;
+    uint32_t LoopBegin, LoopEnd;
+
+    Container.SerializeAsStream(0, Stream, SysExTable, PortNumbers, LoopBegin, LoopEnd, event_filter_t());
+
+    CHECK(SysExTable.Size() == 1);
+
+    const uint8_t * Data = nullptr;
+    size_t Size = 0;
+    uint8_t PortNumber = 0xFF;
+
+    CHECK(SysExTable.GetItem(0, Data, Size, PortNumber));
+    CHECK(Size == 6);
+    CHECK(PortNumber == 1);
+
+    CHECK((GetNotePorts(Stream) == std::vector<uint8_t> { 0, 1, 0 }));
+}
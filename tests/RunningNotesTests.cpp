@@ -0,0 +1,330 @@
+
+/** $VER: RunningNotesTests.cpp (2026.10.19) P. Stuer - Tests the running notes bookkeeping of the RCP and MMD converters **/
+
+#include "Test.h"
+
+#include "RCP/MIDIStream.h"
+
+#include <RunningNotes.h>
+
+#include <random>
+
+namespace
+{
+
+/// <summary>
+/// The array based bookkeeping that the min-heap replaced, without its limit of 32 notes. Notes that expire at the same time are turned off in the order in which they were added.
+/// </summary>
+class reference_notes_t
+{
+public:
+    void Add(uint8_t channel, uint8_t note, uint8_t velocityOff, uint32_t length)
+    {
+        _Notes.push_back({ channel, (uint8_t) (note & 0x7F), velocityOff, length });
+    }
+
+    bool Extend(uint8_t note, uint32_t length)
+    {
+        for (auto & rn : _Notes)
+        {
+            if (rn.Code == (note & 0x7F))
+            {
+                rn.Length = length;
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void Check(rcp::midi_stream_t & stream, uint32_t & deltaTime)
+    {
+        while (!_Notes.empty())
+        {
+            uint32_t NewDeltaTime = deltaTime + 1;
+
+            for (const auto & rn : _Notes)
+                NewDeltaTime = (std::min)(NewDeltaTime, rn.Length);
+
+            if (NewDeltaTime > deltaTime)
+                break;
+
+            for (auto & rn : _Notes)
+                rn.Length -= NewDeltaTime;
+
+            deltaTime -= NewDeltaTime;
+
+            for (auto it = _Notes.begin(); it != _Notes.end();)
+            {
+                if (it->Length > 0)
+                {
+                    ++it;
+                    continue;
+                }
+
+                stream.WriteVariableLengthQuantity(NewDeltaTime);
+                NewDeltaTime = 0;
+
+                stream.Ensure(3);
+
+                if (it->NoteOffVelocity < 0x80)
+                {
+                    stream.Add((uint8_t) (midi::NoteOff | it->Channel));
+                    stream.Add(it->Code);
+                    stream.Add(it->NoteOffVelocity);
+                }
+                else
+                {
+                    stream.Add((uint8_t) (midi::NoteOn | it->Channel));
+                    stream.Add(it->Code);
+                    stream.Add(0);
+                }
+
+                it = _Notes.erase(it);
+            }
+        }
+    }
+
+    void Advance(uint32_t deltaTime)
+    {
+        for (auto & rn : _Notes)
+            rn.Length -= deltaTime;
+    }
+
+    uint32_t Flush(rcp::midi_stream_t & stream, uint32_t deltaTime, bool cutNotes)
+    {
+        uint32_t DeltaTime = deltaTime;
+
+        for (auto & rn : _Notes)
+        {
+            if (rn.Length > DeltaTime)
+            {
+                if (cutNotes)
+                    rn.Length = DeltaTime;
+                else
+                    DeltaTime = rn.Length;
+            }
+        }
+
+        Check(stream, DeltaTime);
+
+        return DeltaTime;
+    }
+
+private:
+    struct note_t
+    {
+        uint8_t Channel;
+        uint8_t Code;
+        uint8_t NoteOffVelocity;
+        uint32_t Length;
+    };
+
+    std::vector<note_t> _Notes;
+};
+
+/// <summary>
+/// Collects the written bytes. It is the minimal stream that the running notes can write to.
+/// </summary>
+struct byte_stream_t
+{
+    void WriteVariableLengthQuantity(uint32_t value)
+    {
+        uint8_t Bytes[5];
+        size_t Size = 0;
+
+        do
+        {
+            Bytes[Size++] = (uint8_t) (value & 0x7F);
+            value >>= 7;
+        }
+        while (value != 0);
+
+        while (Size > 1)
+            Data.push_back((uint8_t) (Bytes[--Size] | 0x80));
+
+        Data.push_back(Bytes[0]);
+    }
+
+    void Write(const uint8_t * data, size_t size)
+    {
+        Data.insert(Data.end(), data, data + size);
+    }
+
+    std::vector<uint8_t> Data;
+};
+
+/// <summary>
+/// Plays a random sequence of dense chords and long sustained notes the way the RCP converter does and returns the resulting stream.
+/// </summary>
+template<typename T>
+std::vector<uint8_t> Play(uint32_t seed, bool cutNotes)
+{
+    std::mt19937 Random(seed);
+
+    T RunningNotes;
+
+    rcp::midi_stream_t Stream;
+
+    Stream.SetDuration(0);
+
+    for (int Chord = 0; Chord < 200; ++Chord)
+    {
+        const uint32_t NoteCount = 1 + Random() % 96;
+        const uint32_t Sustain   = (Random() % 4 == 0) ? 2000 + Random() % 5000 : 1 + Random() % 200;
+
+        uint32_t DeltaTime = Random() % 120;
+
+        for (uint32_t i = 0; i < NoteCount; ++i)
+        {
+            RunningNotes.Check(Stream, DeltaTime);
+
+            const uint8_t Code = (uint8_t) (Random() % 128);
+            const uint32_t Length = (Random() % 3 == 0) ? Sustain : 1 + Random() % (Sustain + 1);
+
+            // Extended notes don't write an event, like a note that is already playing in the converter.
+            if (!RunningNotes.Extend(Code, DeltaTime + Length))
+            {
+                Stream.WriteVariableLengthQuantity(DeltaTime);
+                Stream.Ensure(3);
+                Stream.Add((uint8_t) (midi::NoteOn | (Chord & 0x0F)));
+                Stream.Add(Code);
+                Stream.Add(0x64);
+
+                RunningNotes.Advance(DeltaTime);
+                RunningNotes.Add((uint8_t) (Chord & 0x0F), Code, (Random() % 2 == 0) ? 0x40 : 0x80, Length);
+
+                DeltaTime = 0;
+            }
+        }
+    }
+
+    Stream.SetDuration(Random() % 1000);
+
+    RunningNotes.Flush(Stream, Stream.GetDuration(), cutNotes);
+
+    return std::vector<uint8_t>(Stream.GetData(), Stream.GetData() + Stream.GetOffs());
+}
+
+}
+
+TEST_CASE(RunningNotesMatchReferenceBookkeeping)
+{
+    for (uint32_t Seed = 1; Seed <= 50; ++Seed)
+    {
+        CHECK(Play<midi::running_notes_t>(Seed, false) == Play<reference_notes_t>(Seed, false));
+        CHECK(Play<midi::running_notes_t>(Seed, true)  == Play<reference_notes_t>(Seed, true));
+    }
+}
+
+TEST_CASE(RunningNotesKeepDenseChords)
+{
+    midi::running_notes_t RunningNotes;
+
+    rcp::midi_stream_t Stream;
+
+    // A chord of 100 notes with long sustains. The fixed array of 32 notes dropped the Note Off events of 68 of them.
+    for (uint8_t Code = 0; Code < 100; ++Code)
+        RunningNotes.Add(0, Code, 0x80, 10000u + Code);
+
+    CHECK(RunningNotes.GetCount() == 100);
+
+    uint32_t DeltaTime = 20000;
+
+    CHECK(RunningNotes.Check(Stream, DeltaTime) == 100);
+    CHECK(RunningNotes.GetCount() == 0);
+    CHECK(DeltaTime == 20000 - 10099);
+}
+
+TEST_CASE(RunningNotesTurnOffExtendedNoteOnce)
+{
+    midi::running_notes_t RunningNotes;
+
+    rcp::midi_stream_t Stream;
+
+    RunningNotes.Add(0, 60, 0x80, 10);
+
+    CHECK(RunningNotes.Extend(60, 100));
+    CHECK(!RunningNotes.Extend(61, 100));
+
+    uint32_t DeltaTime = 50;
+
+    CHECK(RunningNotes.Check(Stream, DeltaTime) == 0);
+    CHECK(DeltaTime == 50);
+
+    RunningNotes.Advance(DeltaTime);
+
+    DeltaTime = 1000;
+
+    CHECK(RunningNotes.Check(Stream, DeltaTime) == 1);
+    CHECK(DeltaTime == 950);
+}
+
+TEST_CASE(RunningNotesFlushExtendsOrCutsTheDeltaTime)
+{
+    midi::running_notes_t RunningNotes;
+
+    // The longest note extends the delta time.
+    {
+        byte_stream_t Stream;
+
+        RunningNotes.Add(0, 60, 0x40, 100);
+        RunningNotes.Add(1, 62, 0x80, 300);
+
+        CHECK(RunningNotes.Flush(Stream, 50, false) == 0);
+        CHECK(RunningNotes.GetCount() == 0);
+        CHECK((Stream.Data == std::vector<uint8_t> { 0x64, 0x80, 60, 0x40, 0x81, 0x48, 0x91, 62, 0x00 }));
+    }
+
+    RunningNotes.Reset();
+
+    // The notes are cut at the delta time.
+    {
+        byte_stream_t Stream;
+
+        RunningNotes.Add(0, 60, 0x40, 100);
+        RunningNotes.Add(1, 62, 0x80, 300);
+
+        CHECK(RunningNotes.Flush(Stream, 150, true) == 0);
+        CHECK(RunningNotes.GetCount() == 0);
+        CHECK((Stream.Data == std::vector<uint8_t> { 0x64, 0x80, 60, 0x40, 0x32, 0x91, 62, 0x00 }));
+    }
+
+    RunningNotes.Reset();
+
+    // The notes end before the delta time. The remaining delta time is returned.
+    {
+        byte_stream_t Stream;
+
+        RunningNotes.Add(0, 60, 0x40, 100);
+
+        CHECK(RunningNotes.Flush(Stream, 250, false) == 150);
+        CHECK((Stream.Data == std::vector<uint8_t> { 0x64, 0x80, 60, 0x40 }));
+    }
+}
+
+TEST_CASE(RunningNotesWriteTheSameBytesToEachStream)
+{
+    // The RCP converter writes to a midi_stream_t and the MMD converter to a memory_stream_t. Any stream gets the same Note Off events.
+    midi::running_notes_t A;
+    midi::running_notes_t B;
+
+    rcp::midi_stream_t StreamA;
+    byte_stream_t StreamB;
+
+    for (uint8_t Code = 0; Code < 128; ++Code)
+    {
+        A.Add(Code & 0x0F, Code, (Code % 3 == 0) ? 0x80 : 0x40, 1000u + (Code * 37u) % 500u);
+        B.Add(Code & 0x0F, Code, (Code % 3 == 0) ? 0x80 : 0x40, 1000u + (Code * 37u) % 500u);
+    }
+
+    uint32_t DeltaTimeA = 1200;
+    uint32_t DeltaTimeB = 1200;
+
+    CHECK(A.Check(StreamA, DeltaTimeA) == B.Check(StreamB, DeltaTimeB));
+    CHECK(DeltaTimeA == DeltaTimeB);
+
+    CHECK(A.Flush(StreamA, 0, false) == B.Flush(StreamB, 0, false));
+    CHECK((std::vector<uint8_t>(StreamA.GetData(), StreamA.GetData() + StreamA.GetOffs()) == StreamB.Data));
+}
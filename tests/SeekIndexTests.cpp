@@ -0,0 +1,194 @@
+
+/** $VER: SeekIndexTests.cpp (2026.10.19) P. Stuer - Tests the seek index **/
+
+#include "Test.h"
+
+#include "SeekIndex.h"
+
+#include <random>
+
+using namespace midi;
+
+namespace
+{
+
+/// <summary>
+/// Builds a stream in the format of container_t::SerializeAsStream().
+/// </summary>
+class stream_builder_t
+{
+public:
+    void Add(uint32_t time, uint8_t status, uint8_t data1, uint8_t data2 = 0, uint8_t portNumber = 0)
+    {
+        Stream.push_back({ time, (uint32_t) status | ((uint32_t) data1 << 8) | ((uint32_t) data2 << 16) | ((uint32_t) portNumber << 24) });
+    }
+
+    void AddSysEx(uint32_t time, std::vector<uint8_t> data, uint8_t portNumber = 0)
+    {
+        Stream.push_back({ time, (uint32_t) SysExTable.AddItem(data.data(), data.size(), portNumber) | 0x80000000u });
+    }
+
+    /// <summary>
+    /// Adds a Roland GS DT1 message with the correct checksum.
+    /// </summary>
+    void AddGSParameter(uint32_t time, uint32_t address, uint8_t value)
+    {
+        std::vector<uint8_t> Data = { 0xF0, 0x41, 0x10, 0x42, 0x12, (uint8_t) (address >> 16), (uint8_t) (address >> 8), (uint8_t) address, value };
+
+        uint8_t Sum = 0;
+
+        for (size_t i = 5; i < Data.size(); ++i)
+            Sum += Data[i];
+
+        Data.push_back((uint8_t) ((128 - Sum) & 0x7F));
+        Data.push_back(0xF7);
+
+        AddSysEx(time, Data);
+    }
+
+    void AddGSReset(uint32_t time)
+    {
+        AddGSParameter(time, 0x40007F, 0x00);
+    }
+
+    std::vector<message_t> Stream;
+    sysex_table_t SysExTable;
+};
+
+std::vector<uint32_t> GetSysEx(const std::vector<message_t> & messages)
+{
+    std::vector<uint32_t> SysEx;
+
+    for (const auto & Message : messages)
+    {
+        if (Message.IsSysEx())
+            SysEx.push_back(Message.Data & 0x7FFFFFFFu);
+    }
+
+    return SysEx;
+}
+
+std::vector<uint32_t> GetData(const std::vector<message_t> & messages)
+{
+    std::vector<uint32_t> Data;
+
+    for (const auto & Message : messages)
+        Data.push_back(Message.Data);
+
+    return Data;
+}
+
+}
+
+TEST_CASE(ParameterSysExReplacesOlderValue)
+{
+    stream_builder_t b;
+
+    b.AddGSReset(0);
+    b.AddGSParameter(10, 0x400130, 0x01);   // Reverb macro
+    b.AddGSParameter(20, 0x400138, 0x02);   // Chorus macro
+    b.AddGSParameter(30, 0x400130, 0x04);   // Reverb macro, new value
+    b.Add(40, StatusCode::NoteOn, 60, 100);
+
+    seek_index_t Index;
+
+    Index.Build(b.Stream, b.SysExTable);
+
+    std::vector<message_t> Messages;
+
+    CHECK(Index.Seek(40, b.Stream, b.SysExTable, Messages) == 4);
+
+    const std::vector<uint32_t> Expected = { b.Stream[0].Data & 0x7FFFFFFFu, b.Stream[2].Data & 0x7FFFFFFFu, b.Stream[3].Data & 0x7FFFFFFFu };
+
+    CHECK(GetSysEx(Messages) == Expected);
+}
+
+TEST_CASE(ResetClearsPortState)
+{
+    stream_builder_t b;
+
+    b.Add(0, StatusCode::ProgramChange, 10);
+    b.Add(0, StatusCode::ControlChange | 1, 7, 90);
+    b.AddGSParameter(5, 0x400130, 0x01);
+    b.AddGSReset(10);
+    b.Add(20, StatusCode::ControlChange, 10, 32);
+    b.Add(30, StatusCode::NoteOn, 60, 100);
+
+    seek_index_t Index;
+
+    Index.Build(b.Stream, b.SysExTable);
+
+    std::vector<message_t> Messages;
+
+    Index.Seek(30, b.Stream, b.SysExTable, Messages);
+
+    const std::vector<uint32_t> Expected = { b.Stream[3].Data, b.Stream[4].Data };
+
+    CHECK(GetData(Messages) == Expected);
+}
+
+TEST_CASE(RepeatedParameterChangesKeepTheStateSmall)
+{
+    stream_builder_t b;
+
+    b.AddGSReset(0);
+
+    for (uint32_t i = 0; i < 10000; ++i)
+        b.AddGSParameter(1 + i, 0x401000 | (i % 4), (uint8_t) (i & 0x7F)); // Only 4 parameters change.
+
+    seek_index_t Index;
+
+    Index.Build(b.Stream, b.SysExTable, 100, 64);
+
+    CHECK(Index.GetSnapshotCount() > 100);
+
+    std::vector<message_t> Messages;
+
+    Index.Seek(20000, b.Stream, b.SysExTable, Messages);
+
+    CHECK(GetSysEx(Messages).size() == 1 + 4);
+}
+
+TEST_CASE(SeekMatchesReplayFromTheStart)
+{
+    std::mt19937 Random(7);
+
+    stream_builder_t b;
+
+    uint32_t Time = 0;
+
+    for (int i = 0; i < 5000; ++i)
+    {
+        Time += Random() % 20;
+
+        const uint8_t Channel = (uint8_t) (Random() % 4);
+        const uint8_t Port    = (uint8_t) (Random() % 2);
+
+        switch (Random() % 10)
+        {
+            case 0: b.Add(Time, (uint8_t) (StatusCode::ProgramChange | Channel), (uint8_t) (Random() % 128), 0, Port); break;
+            case 1: b.Add(Time, (uint8_t) (StatusCode::PitchBendChange | Channel), (uint8_t) (Random() % 128), (uint8_t) (Random() % 128), Port); break;
+            case 2: b.Add(Time, (uint8_t) (StatusCode::ChannelPressure | Channel), (uint8_t) (Random() % 128), 0, Port); break;
+            case 3: b.Add(Time, (uint8_t) (StatusCode::ControlChange | Channel), (uint8_t) (Random() % 2 ? Controller::RPNMSB : Controller::NRPNMSB), (uint8_t) (Random() % 3), Port); break;
+            case 4: b.Add(Time, (uint8_t) (StatusCode::ControlChange | Channel), (uint8_t) (Random() % 2 ? Controller::RPNLSB : Controller::NRPNLSB), (uint8_t) (Random() % 3), Port); break;
+            case 5: b.Add(Time, (uint8_t) (StatusCode::ControlChange | Channel), Controller::DataEntry, (uint8_t) (Random() % 128), Port); break;
+            case 6: b.AddGSParameter(Time, 0x401000 | (Random() % 8), (uint8_t) (Random() % 128)); break;
+            case 7: if (Random() % 50 == 0) b.AddGSReset(Time); break;
+            default: b.Add(Time, (uint8_t) (StatusCode::ControlChange | Channel), (uint8_t) (Random() % 120), (uint8_t) (Random() % 128), Port); break;
+        }
+    }
+
+    seek_index_t Index;
+
+    Index.Build(b.Stream, b.SysExTable, 250, 100);
+
+    const seek_index_t NoIndex;
+
+    for (uint32_t t = 0; t <= Time + 1; t += 97)
+    {
+        std::vector<message_t> Indexed, Replayed;
+
+        CHECK(Index.Seek(t, b.Stream, b.SysExTable, Indexed) == NoIndex.Seek(t, b.Stream, b.SysExTable, Replayed));
+        CHECK(GetData(Indexed) == GetData(Replayed));
+    }
+}
@@ -0,0 +1,432 @@
+
+/** $VER: SubsongTests.cpp (2026.10.19) P. Stuer - Tests the subsong views and the conversion of their timestamps **/
+
+#include "Test.h"
+
+#include "MIDIContainer.h"
+
+#include <random>
+
+using namespace midi;
+
+namespace
+{
+
+/// <summary>
+/// Creates a track with a tempo change every few ticks and a note at each tempo change.
+/// </summary>
+track_t CreateTrack(uint32_t seed, uint32_t tempoCount)
+{
+    std::mt19937 Random(seed);
+
+    track_t Track;
+
+    uint32_t Time = 0;
+
+    for (uint32_t i = 0; i < tempoCount; ++i)
+    {
+        const uint32_t Tempo = 200'000 + Random() % 1'000'000;
+
+        const uint8_t SetTempo[] = { StatusCode::MetaData, MetaDataType::SetTempo, (uint8_t) (Tempo >> 16), (uint8_t) (Tempo >> 8), (uint8_t) Tempo };
+        const uint8_t NoteOn[] = { (uint8_t) (Random() % 128), 0x64 };
+
+        Track.AddEvent(event_t(Time, event_t::Extended, 0, SetTempo, _countof(SetTempo)));
+        Track.AddEvent(event_t(Time + Random() % 7, event_t::NoteOn, i % 16, NoteOn, _countof(NoteOn)));
+
+        Time += 1 + Random() % 50;
+    }
+
+    const uint8_t EndOfTrack[] = { StatusCode::MetaData, MetaDataType::EndOfTrack };
+
+    Track.AddEvent(event_t(Time, event_t::Extended, 0, EndOfTrack, _countof(EndOfTrack)));
+
+    return Track;
+}
+
+/// <summary>
+/// Creates a track that optionally sets the tempo and plays the specified number of notes on a channel, 96 ticks apart, starting at the specified offset.
+/// </summary>
+track_t CreateSongTrack(uint32_t channel, uint32_t noteCount, uint32_t tempo = 0, uint32_t offset = 0)
+{
+    track_t Track;
+
+    if (tempo != 0)
+    {
+        const uint8_t SetTempo[] = { StatusCode::MetaData, MetaDataType::SetTempo, (uint8_t) (tempo >> 16), (uint8_t) (tempo >> 8), (uint8_t) tempo };
+
+        Track.AddEvent(event_t(0, event_t::Extended, 0, SetTempo, _countof(SetTempo)));
+    }
+
+    for (uint32_t i = 0; i < noteCount; ++i)
+    {
+        const uint8_t NoteOn[] = { (uint8_t) (60 + i), 0x64 };
+        const uint8_t NoteOff[] = { (uint8_t) (60 + i), 0x00 };
+
+        Track.AddEvent(event_t(offset + i * 96, event_t::NoteOn, channel, NoteOn, _countof(NoteOn)));
+        Track.AddEvent(event_t(offset + i * 96 + 48, event_t::NoteOn, channel, NoteOff, _countof(NoteOff)));
+    }
+
+    const uint8_t EndOfTrack[] = { StatusCode::MetaData, MetaDataType::EndOfTrack };
+
+    Track.AddEvent(event_t(offset + noteCount * 96, event_t::Extended, 0, EndOfTrack, _countof(EndOfTrack)));
+
+    return Track;
+}
+
+/// <summary>
+/// Creates a format 2 container with a song in track 0, a track without channel events in track 1 and songs in tracks 2 and 3.
+/// Track 2 changes the tempo and track 3 does not.
+/// </summary>
+void CreateFormat2Container(container_t & container)
+{
+    container.Initialize(2, 96);
+
+    container.AddTrack(CreateSongTrack(0, 4));
+    container.AddTrack(CreateSongTrack(0, 0));
+    container.AddTrack(CreateSongTrack(1, 8, 250'000));
+    container.AddTrack(CreateSongTrack(2, 2));
+}
+
+}
+
+TEST_CASE(TempoCursorMatchesSubsongView)
+{
+    std::mt19937 Random(42);
+
+    tempo_map_t TempoMap;
+
+    for (uint32_t Time = 0; Time < 100'000; Time += 1 + Random() % 100)
+        TempoMap.Add(100'000 + Random() % 2'000'000, Time);
+
+    const subsong_view_t SubSong = { 0, 1, &TempoMap, 500'000, 96, 0, 100'000 };
+
+    tempo_cursor_t TempoCursor(SubSong);
+
+    uint32_t Timestamp = 0;
+
+    for (int i = 0; i < 10'000; ++i)
+    {
+        // Mostly increasing timestamps, with an occasional jump back to test the restart.
+        Timestamp = (Random() % 100 == 0) ? Random() % Timestamp + 1 : Timestamp + Random() % 20;
+
+        CHECK(TempoCursor.TimestampToMS(Timestamp) == SubSong.TimestampToMS(Timestamp));
+        CHECK(TempoCursor.TimestampToTime(Timestamp, container_t::TimeUnitMicroseconds) == SubSong.TimestampToTime(Timestamp, container_t::TimeUnitMicroseconds));
+        CHECK(TempoCursor.TimestampToTime(Timestamp, 44'100) == SubSong.TimestampToTime(Timestamp, 44'100));
+    }
+}
+
+TEST_CASE(TempoCursorWithoutTempoMap)
+{
+    const subsong_view_t SubSong = { 0, 1, nullptr, 500'000, 480, 0, 0 };
+
+    tempo_cursor_t TempoCursor(SubSong);
+
+    CHECK(TempoCursor.TimestampToMS(480) == 500);
+    CHECK(TempoCursor.TimestampToTime(960, container_t::TimeUnitMicroseconds) == 1'000'000);
+    CHECK(TempoCursor.TimestampToMS(0) == 0);
+}
+
+TEST_CASE(SerializationConvertsEachTimestamp)
+{
+    container_t Container;
+
+    Container.Initialize(1, 480);
+
+    Container.AddTrack(CreateTrack(1, 2'000));
+    Container.AddTrack(CreateTrack(2, 2'000));
+
+    const subsong_view_t SubSong = Container.GetSubSongView(0);
+
+    CHECK(SubSong.TempoMap != nullptr);
+
+    std::vector<uint32_t> Timestamps;
+
+    for (const track_t & Track : Container)
+    {
+        for (const event_t & Event : Track)
+        {
+            if (Event.Type != event_t::Extended)
+                Timestamps.push_back(Event.Time);
+        }
+    }
+
+    std::sort(Timestamps.begin(), Timestamps.end());
+
+    sysex_table_t SysExTable;
+    std::vector<uint8_t> PortNumbers;
+    uint32_t LoopBegin, LoopEnd;
+
+    {
+        std::vector<message_t> Stream;
+
+        Container.SerializeAsStream(0, Stream, SysExTable, PortNumbers, LoopBegin, LoopEnd, event_filter_t());
+
+        CHECK(Stream.size() == Timestamps.size());
+
+        for (size_t i = 0; (i < Stream.size()) && (i < Timestamps.size()); ++i)
+            CHECK(Stream[i].Time == SubSong.TimestampToMS(Timestamps[i]));
+    }
+
+    {
+        std::vector<timed_message_t> Stream;
+
+        Container.SerializeAsStream(0, Stream, SysExTable, PortNumbers, LoopBegin, LoopEnd, event_filter_t(), 44'100);
+
+        CHECK(Stream.size() == Timestamps.size());
+
+        for (size_t i = 0; (i < Stream.size()) && (i < Timestamps.size()); ++i)
+            CHECK(Stream[i].Time == SubSong.TimestampToTime(Timestamps[i], 44'100));
+    }
+}
+
+TEST_CASE(Format2SubsongsSkipTracksWithoutChannelEvents)
+{
+    container_t Container;
+
+    CreateFormat2Container(Container);
+
+    CHECK(Container.GetSubSongCount() == 3);
+    CHECK(Container.GetSubSong(0) == 0);
+    CHECK(Container.GetSubSong(1) == 2);
+    CHECK(Container.GetSubSong(2) == 3);
+    CHECK(Container.GetSubSong(3) == 0);
+
+    for (size_t i = 0; i < 4; ++i)
+    {
+        const subsong_view_t SubSong = Container.GetSubSongView(i);
+
+        CHECK(SubSong.FirstTrack == i);
+        CHECK(SubSong.TrackCount == 1);
+        CHECK(SubSong.TimeDivision == 96);
+    }
+
+    CHECK(Container.GetSubSongView(0).ChannelMask == 1);
+    CHECK(Container.GetSubSongView(1).ChannelMask == 0);
+    CHECK(Container.GetSubSongView(2).ChannelMask == 2);
+    CHECK(Container.GetSubSongView(2).EndTimestamp == 8 * 96);
+
+    // A subsong starts with the last tempo of the preceding subsong that changes the tempo.
+    CHECK(Container.GetSubSongView(2).StartTempo == 500'000);
+    CHECK(Container.GetSubSongView(3).StartTempo == 250'000);
+    CHECK(Container.GetSubSongView(3).TimestampToMS(96) == 250);
+
+    CHECK(Container.GetDuration(2, true) == Container.GetSubSongView(2).TimestampToMS(8 * 96));
+
+    // No loops were detected.
+    CHECK(Container.GetLoopBeginTimestamp(3) == ~0u);
+    CHECK(Container.GetLoopEndTimestamp(3) == ~0u);
+}
+
+TEST_CASE(SubsongListFollowsTheChannelEvents)
+{
+    container_t Container;
+
+    CreateFormat2Container(Container);
+
+    // A note makes track 1 a subsong.
+    const uint8_t NoteOn[] = { 60, 0x64 };
+
+    Container.AddEventToTrack(1, event_t(0, event_t::NoteOn, 5, NoteOn, _countof(NoteOn)));
+
+    CHECK(Container.GetSubSongCount() == 4);
+    CHECK(Container.GetSubSong(1) == 1);
+    CHECK(Container.GetSubSongView(1).ChannelMask == (1 << 5));
+
+    // Removing the notes of track 2 removes its subsong.
+    Container.GetTracks()[2].RemoveEvents([](const event_t & e) { return e.Type == event_t::NoteOn; });
+
+    Container.MarkTrackDirty(2);
+    Container.UpdateSummaries();
+
+    CHECK(Container.GetSubSongCount() == 3);
+    CHECK(Container.GetSubSong(0) == 0);
+    CHECK(Container.GetSubSong(1) == 1);
+    CHECK(Container.GetSubSong(2) == 3);
+    CHECK(Container.GetSubSongView(2).ChannelMask == 0);
+}
+
+TEST_CASE(SubsongSerializesOnlyItsTrack)
+{
+    container_t Container;
+
+    CreateFormat2Container(Container);
+
+    for (size_t i = 0; i < 4; ++i)
+    {
+        std::vector<message_t> Stream;
+        sysex_table_t SysExTable;
+        std::vector<uint8_t> PortNumbers;
+        uint32_t LoopBegin, LoopEnd;
+
+        Container.SerializeAsStream(i, Stream, SysExTable, PortNumbers, LoopBegin, LoopEnd, event_filter_t());
+
+        const subsong_view_t SubSong = Container.GetSubSongView(i);
+
+        size_t NoteCount = 0;
+
+        for (const event_t & Event : Container.GetTracks()[i])
+        {
+            if (Event.Type == event_t::NoteOn)
+                ++NoteCount;
+        }
+
+        CHECK(Stream.size() == NoteCount);
+
+        for (const message_t & Message : Stream)
+            CHECK((SubSong.ChannelMask & (1ull << (Message.Data & 0x0F))) != 0);
+    }
+}
+
+TEST_CASE(Format1SubsongContainsAllTracks)
+{
+    container_t Container;
+
+    Container.Initialize(1, 96);
+
+    Container.AddTrack(CreateSongTrack(0, 0, 250'000));
+    Container.AddTrack(CreateSongTrack(1, 4));
+    Container.AddTrack(CreateSongTrack(2, 8));
+
+    CHECK(Container.GetSubSongCount() == 1);
+    CHECK(Container.GetSubSong(0) == 0);
+
+    const subsong_view_t SubSong = Container.GetSubSongView(0);
+
+    CHECK(SubSong.FirstTrack == 0);
+    CHECK(SubSong.TrackCount == 3);
+    CHECK(SubSong.ChannelMask == 6);
+    CHECK(SubSong.EndTimestamp == 8 * 96);
+    CHECK(SubSong.TimestampToMS(96) == 250);
+}
+
+TEST_CASE(SummaryIsUpdatedOnlyForDirtyTracks)
+{
+    container_t Container;
+
+    Container.Initialize(1, 96);
+
+    Container.AddTrack(CreateSongTrack(0, 0, 250'000));
+    Container.AddTrack(CreateSongTrack(1, 4));
+    Container.AddTrack(CreateSongTrack(2, 8));
+
+    CHECK(Container.GetSubSongView(0).ChannelMask == 0x06);
+
+    // Modify tracks 1 and 2 without marking them.
+    const uint8_t NoteOn[] = { 0x40, 0x64 };
+
+    Container.GetTracks()[1].AddEvent(event_t(0, event_t::NoteOn, 3, NoteOn, _countof(NoteOn)));
+    Container.GetTracks()[2].AddEvent(event_t(0, event_t::NoteOn, 5, NoteOn, _countof(NoteOn)));
+
+    Container.UpdateSummaries();
+
+    CHECK(Container.GetSubSongView(0).ChannelMask == 0x06);
+    CHECK(Container.GetChannelCount(0) == 2);
+
+    // Only the marked track is scanned again.
+    Container.MarkTrackDirty(2);
+    Container.UpdateSummaries();
+
+    CHECK(Container.GetSubSongView(0).ChannelMask == 0x26);
+
+    Container.MarkTrackDirty(1);
+    Container.UpdateSummaries();
+
+    CHECK(Container.GetSubSongView(0).ChannelMask == 0x2E);
+    CHECK(Container.GetChannelCount(0) == 4);
+
+    // The tempo changes and the end timestamp of the clean tracks are kept.
+    CHECK(Container.GetSubSongView(0).EndTimestamp == 8 * 96);
+    CHECK(Container.GetSubSongView(0).TimestampToMS(96) == 250);
+
+    // Removing events through the container marks the modified tracks.
+    CHECK(Container.RemoveEvents([](const event_t & e) { return (e.Type == event_t::NoteOn) && (e.ChannelNumber == 2); }) == 16);
+
+    Container.UpdateSummaries();
+
+    CHECK(Container.GetSubSongView(0).ChannelMask == 0x2A);
+    CHECK(Container.GetSubSongView(0).EndTimestamp == 8 * 96);
+}
+
+TEST_CASE(Format2TrimStartTrimsEachSubsong)
+{
+    // The subsongs have no loops. Trimming them used to write loop ranges past the end of the loop table.
+    container_t Container;
+
+    Container.Initialize(2, 96);
+
+    Container.AddTrack(CreateSongTrack(0, 4, 0, 192));
+    Container.AddTrack(CreateSongTrack(1, 2, 250'000, 96));
+    Container.AddTrack(CreateSongTrack(2, 3));
+
+    CHECK(Container.GetSubSongView(0).EndTimestamp == 192 + 4 * 96);
+    CHECK(Container.GetSubSongView(1).EndTimestamp ==  96 + 2 * 96);
+
+    Container.TrimStart();
+
+    const uint32_t EndTimestamps[] = { 4 * 96, 2 * 96, 3 * 96 };
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+        const subsong_view_t SubSong = Container.GetSubSongView(i);
+
+        CHECK(SubSong.EndTimestamp == EndTimestamps[i]);
+        CHECK(Container.GetDuration(i) == EndTimestamps[i]);
+
+        // Each track starts with its first note.
+        const track_t & Track = Container.GetTracks()[i];
+
+        auto FirstNote = std::find_if(Track.begin(), Track.end(), [](const event_t & e) { return e.Type == event_t::NoteOn; });
+
+        CHECK((FirstNote != Track.end()) && (FirstNote->Time == 0));
+
+        if (i > 0)
+        {
+            CHECK(Container.GetLoopBeginTimestamp(i) == ~0U);
+            CHECK(Container.GetLoopEndTimestamp(i) == ~0U);
+        }
+    }
+
+    // The tempo change of the second subsong stays at the start.
+    CHECK(Container.GetSubSongView(1).TimestampToMS(96) == 250);
+}
+
+TEST_CASE(StartTempoFollowsTheTempoChanges)
+{
+    container_t Container;
+
+    Container.Initialize(2, 96);
+
+    Container.AddTrack(CreateSongTrack(0, 2, 400'000));
+    Container.AddTrack(CreateSongTrack(1, 2));
+    Container.AddTrack(CreateSongTrack(2, 2));
+
+    // The tempo of the first subsong carries over to the subsongs that follow it.
+    CHECK(Container.GetSubSongView(0).StartTempo == 500'000);
+    CHECK(Container.GetSubSongView(1).StartTempo == 400'000);
+    CHECK(Container.GetSubSongView(2).StartTempo == 400'000);
+    CHECK(Container.GetSubSongView(2).TimestampToMS(96) == 400);
+
+    // A tempo change that is added to a track changes the start tempo of the subsongs that follow it.
+    const uint8_t SetTempo[] = { StatusCode::MetaData, MetaDataType::SetTempo, 0x04, 0x93, 0xE0 }; // 300,000 μs per beat
+
+    Container.AddEventToTrack(1, event_t(0, event_t::Extended, 0, SetTempo, _countof(SetTempo)));
+
+    CHECK(Container.GetSubSongView(1).StartTempo == 400'000);
+    CHECK(Container.GetSubSongView(2).StartTempo == 300'000);
+
+    // Removing the tempo changes restores the default tempo.
+    Container.GetTracks()[0].RemoveEvents([](const event_t & e) { return e.IsSetTempo(); });
+
+    Container.MarkTrackDirty(0);
+    Container.UpdateSummaries();
+
+    CHECK(Container.GetSubSongView(1).StartTempo == 500'000);
+    CHECK(Container.GetSubSongView(2).StartTempo == 300'000);
+
+    Container.GetTracks()[1].RemoveEvents([](const event_t & e) { return e.IsSetTempo(); });
+
+    Container.MarkTrackDirty(1);
+    Container.UpdateSummaries();
+
+    CHECK(Container.GetSubSongView(2).StartTempo == 500'000);
+}
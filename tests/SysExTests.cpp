@@ -0,0 +1,185 @@
+
+/** $VER: SysExTests.cpp (2026.10.19) P. Stuer - Tests the SysEx classification and the Roland checksum **/
+
+#include "Test.h"
+
+#include "SysEx.h"
+
+using namespace midi;
+
+namespace
+{
+
+/// <summary>
+/// Describes the expected classification of a SysEx message.
+/// </summary>
+struct classification_t
+{
+    std::vector<uint8_t> Data;
+    sysex_type_t Type;
+    uint32_t Manufacturer;
+    uint32_t Model;
+    uint32_t Address;
+    sysex_checksum_t Checksum;
+};
+
+/// <summary>
+/// Gets a message from one of the sysex_t message constants, up to and including End of SysEx. Some constants are padded with zeroes.
+/// </summary>
+template<size_t N>
+std::vector<uint8_t> GetMessage(const uint8_t (& data)[N])
+{
+    const uint8_t * Tail = std::find(data, data + N, StatusCode::SysExEnd);
+
+    return std::vector<uint8_t>(data, (Tail != data + N) ? Tail + 1 : data + N);
+}
+
+}
+
+TEST_CASE(ClassifiesWellKnownMessages)
+{
+    const classification_t Table[] =
+    {
+        { GetMessage(sysex_t::GM1SystemOn),                 sysex_type_t::GM1SystemOn,                  0x7E, 0, 0, sysex_checksum_t::None },
+        { GetMessage(sysex_t::GM1SystemOff),                sysex_type_t::GM1SystemOff,                 0x7E, 0, 0, sysex_checksum_t::None },
+        { GetMessage(sysex_t::GM2SystemOn),                 sysex_type_t::GM2SystemOn,                  0x7E, 0, 0, sysex_checksum_t::None },
+        { GetMessage(sysex_t::GSReset),                     sysex_type_t::GSReset,                      0x41, 0x42, 0x40007F, sysex_checksum_t::Valid },
+        { GetMessage(sysex_t::MT32Reset),                   sysex_type_t::MT32Reset,                    0x41, 0x16, 0, sysex_checksum_t::None },
+        { GetMessage(sysex_t::D50Reset),                    sysex_type_t::D50Reset,                     0x41, 0x14, 0, sysex_checksum_t::None },
+        { GetMessage(sysex_t::XGSystemOn),                  sysex_type_t::XGSystemOn,                   0x43, 0x4C, 0x00007E, sysex_checksum_t::None },
+        { GetMessage(sysex_t::XGReset),                     sysex_type_t::XGReset,                      0x43, 0x4C, 0x00007F, sysex_checksum_t::None },
+        { GetMessage(sysex_t::DLSOn),                       sysex_type_t::DLSOn,                        0x7E, 0, 0, sysex_checksum_t::None },
+        { GetMessage(sysex_t::DLSOff),                      sysex_type_t::DLSOff,                       0x7E, 0, 0, sysex_checksum_t::None },
+        { GetMessage(sysex_t::DLSStaticVoiceAllocationOff), sysex_type_t::DLSStaticVoiceAllocationOff,  0x7E, 0, 0, sysex_checksum_t::None },
+        { GetMessage(sysex_t::DLSStaticVoiceAllocationOn),  sysex_type_t::DLSStaticVoiceAllocationOn,   0x7E, 0, 0, sysex_checksum_t::None },
+
+        { { 0xF0, 0x7E, 0x7F, 0x06, 0x01, 0xF7 },                                     sysex_type_t::IdentityRequest,  0x7E, 0, 0, sysex_checksum_t::None },
+        { { 0xF0, 0x7E, 0x10, 0x06, 0x02, 0x41, 0x42, 0x00, 0x00, 0x00, 0xF7 },       sysex_type_t::IdentityReply,    0x7E, 0, 0, sysex_checksum_t::None },
+        { { 0xF0, 0x7F, 0x7F, 0x04, 0x01, 0x00, 0x7F, 0xF7 },                         sysex_type_t::MasterVolume,     0x7F, 0, 0, sysex_checksum_t::None },
+        { { 0xF0, 0x7F, 0x7F, 0x04, 0x02, 0x00, 0x40, 0xF7 },                         sysex_type_t::MasterBalance,    0x7F, 0, 0, sysex_checksum_t::None },
+        { { 0xF0, 0x7F, 0x7F, 0x04, 0x03, 0x00, 0x40, 0xF7 },                         sysex_type_t::MasterFineTune,   0x7F, 0, 0, sysex_checksum_t::None },
+        { { 0xF0, 0x7F, 0x7F, 0x04, 0x04, 0x00, 0x40, 0xF7 },                         sysex_type_t::MasterCoarseTune, 0x7F, 0, 0, sysex_checksum_t::None },
+
+        // GS Master Volume with a valid and an invalid checksum
+        { { 0xF0, 0x41, 0x10, 0x42, 0x12, 0x40, 0x00, 0x04, 0x7F, 0x3D, 0xF7 },       sysex_type_t::RolandParameter,  0x41, 0x42, 0x400004, sysex_checksum_t::Valid },
+        { { 0xF0, 0x41, 0x10, 0x42, 0x12, 0x40, 0x00, 0x04, 0x7F, 0x3E, 0xF7 },       sysex_type_t::RolandParameter,  0x41, 0x42, 0x400004, sysex_checksum_t::Invalid },
+
+        // A GS Reset with an invalid checksum is still a GS Reset.
+        { { 0xF0, 0x41, 0x10, 0x42, 0x12, 0x40, 0x00, 0x7F, 0x00, 0x40, 0xF7 },       sysex_type_t::GSReset,          0x41, 0x42, 0x40007F, sysex_checksum_t::Invalid },
+
+        // A model id with a leading zero and a checksum that wraps to 0
+        { { 0xF0, 0x41, 0x10, 0x00, 0x0B, 0x12, 0x00, 0x00, 0x00, 0x05, 0x7B, 0xF7 }, sysex_type_t::RolandParameter,  0x41, 0x0B, 0x000000, sysex_checksum_t::Valid },
+        { { 0xF0, 0x41, 0x10, 0x42, 0x12, 0x40, 0x01, 0x30, 0x0F, 0x00, 0xF7 },       sysex_type_t::RolandParameter,  0x41, 0x42, 0x400130, sysex_checksum_t::Valid },
+
+        // An XG parameter change
+        { { 0xF0, 0x43, 0x10, 0x4C, 0x02, 0x01, 0x00, 0x01, 0xF7 },                   sysex_type_t::YamahaParameter,  0x43, 0x4C, 0x020100, sysex_checksum_t::None },
+
+        // A Yamaha message that is not a parameter change
+        { { 0xF0, 0x43, 0x00, 0x4C, 0x02, 0x01, 0x00, 0x01, 0xF7 },                   sysex_type_t::Unknown,          0x43, 0x4C, 0, sysex_checksum_t::None },
+
+        // Truncated messages
+        { { 0xF0, 0x41, 0x10, 0x42, 0x12, 0x40, 0xF7 },                               sysex_type_t::Unknown,          0x41, 0x42, 0, sysex_checksum_t::None },
+        { { 0xF0, 0x7E, 0x7F, 0xF7 },                                                 sysex_type_t::Unknown,          0x7E, 0, 0, sysex_checksum_t::None },
+        { { 0xF0, 0x43 },                                                             sysex_type_t::Unknown,          0, 0, 0, sysex_checksum_t::None },
+
+        // Not a SysEx message
+        { { 0x90, 0x3C, 0x64 },                                                       sysex_type_t::Unknown,          0, 0, 0, sysex_checksum_t::None },
+    };
+
+    for (const auto & Item : Table)
+    {
+        const sysex_info_t Info = sysex_t::Classify(Item.Data);
+
+        CHECK(Info.Type == Item.Type);
+        CHECK(Info.Manufacturer == Item.Manufacturer);
+        CHECK(Info.Model == Item.Model);
+        CHECK(Info.Address == Item.Address);
+        CHECK(Info.Checksum == Item.Checksum);
+        CHECK(!Info.IsExtendedId);
+    }
+}
+
+TEST_CASE(ClassifiesUniversalAndParameterFields)
+{
+    {
+        const sysex_info_t Info = sysex_t::Classify(GetMessage(sysex_t::GM2SystemOn));
+
+        CHECK(Info.DeviceId == 0x7F);
+        CHECK(Info.Command == 0x09);
+        CHECK(Info.SubCommand == 0x03);
+    }
+
+    {
+        const sysex_info_t Info = sysex_t::Classify(GetMessage(sysex_t::GSReset));
+
+        CHECK(Info.DeviceId == 0x10);
+        CHECK(Info.Command == 0x12);
+        CHECK(Info.DataOffset == 8);
+    }
+
+    // Extended manufacturer ids are not classified.
+    {
+        const std::vector<uint8_t> Data = { 0xF0, 0x00, 0x20, 0x29, 0x02, 0x10, 0xF7 };
+
+        const sysex_info_t Info = sysex_t::Classify(Data);
+
+        CHECK(Info.IsExtendedId);
+        CHECK(Info.Manufacturer == 0x2029);
+        CHECK(Info.DeviceId == 0x02);
+        CHECK(Info.Type == sysex_type_t::Unknown);
+    }
+}
+
+TEST_CASE(RolandChecksumIsValidated)
+{
+    // The checksum used to be reported as valid when it did not match.
+    {
+        sysex_t SysEx(GetMessage(sysex_t::GSReset));
+
+        SysEx.Identify();
+
+        CHECK(SysEx.Manufacturer == "Roland");
+        CHECK(SysEx.IsChecksumValid);
+    }
+
+    {
+        sysex_t SysEx(std::vector<uint8_t> { 0xF0, 0x41, 0x10, 0x42, 0x12, 0x40, 0x00, 0x04, 0x7F, 0x3E, 0xF7 });
+
+        SysEx.Identify();
+
+        CHECK(!SysEx.IsChecksumValid);
+    }
+
+    // The checksum calculation agrees with the classification.
+    std::vector<uint8_t> Data = { 0xF0, 0x41, 0x10, 0x42, 0x12, 0x40, 0x01, 0x30, 0x0F, 0x00, 0xF7 };
+
+    for (uint8_t Value = 0; Value < 0x80; ++Value)
+    {
+        Data[8] = Value;
+        Data[9] = sysex_t::CalculateRolandCheckSum(Data.data(), Data.size());
+
+        CHECK(sysex_t::Classify(Data).Checksum == sysex_checksum_t::Valid);
+    }
+}
+
+TEST_CASE(SysExCacheClassifiesEachMessageOnce)
+{
+    sysex_cache_t Cache(2);
+
+    const std::vector<uint8_t> GSReset = GetMessage(sysex_t::GSReset);
+    const std::vector<uint8_t> XGReset = GetMessage(sysex_t::XGReset);
+
+    const sysex_info_t & Info = Cache.Classify(GSReset);
+
+    CHECK(Info.Type == sysex_type_t::GSReset);
+    CHECK(&Cache.Classify(GSReset) == &Info);
+    CHECK(Cache.Identify(GSReset).Manufacturer == "Roland");
+    CHECK(Cache.Size() == 1);
+
+    CHECK(Cache.Classify(XGReset).Type == sysex_type_t::XGReset);
+    CHECK(Cache.Size() == 2);
+
+    // The cache starts over when it is full.
+    CHECK(Cache.Classify(GetMessage(sysex_t::GM1SystemOn)).Type == sysex_type_t::GM1SystemOn);
+    CHECK(Cache.Size() == 1);
+}
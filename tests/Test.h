@@ -0,0 +1,77 @@
+
+/** $VER: Test.h (2026.10.19) P. Stuer - Minimal test framework for the library tests **/
+
+#pragma once
+
+#include "pch.h"
+
+namespace test
+{
+
+/// <summary>
+/// Represents a test case.
+/// </summary>
+struct test_case_t
+{
+    const char * Name;
+    void (* Function)();
+};
+
+/// <summary>
+/// Gets the test cases of the test executable in the order in which they were defined.
+/// </summary>
+inline std::vector<test_case_t> & GetTestCases()
+{
+    static std::vector<test_case_t> TestCases;
+
+    return TestCases;
+}
+
+inline size_t FailureCount = 0;
+
+/// <summary>
+/// Registers a test case.
+/// </summary>
+struct registrar_t
+{
+    registrar_t(const char * name, void (* function)())
+    {
+        GetTestCases().push_back({ name, function });
+    }
+};
+
+}
+
+/// <summary>
+/// Defines a test case. Each test executable runs all its test cases.
+/// </summary>
+#define TEST_CASE(name) \
+    static void name(); \
+    static test::registrar_t name##Registrar(#name, name); \
+    static void name()
+
+/// <summary>
+/// Reports a failure if the condition is false and continues the test case.
+/// </summary>
+#define CHECK(condition) \
+    do \
+    { \
+        if (!(condition)) \
+        { \
+            ::fprintf(stderr, "%s(%d): Check failed: %s\n", __FILE__, __LINE__, #condition); \
+            ++test::FailureCount; \
+        } \
+    } \
+    while (0)
+
+/// <summary>
+/// Reports a failure if the expression does not throw an exception of the specified type.
+/// </summary>
+#define CHECK_THROWS(expression, exception_type) \
+    do \
+    { \
+        bool Thrown = false; \
+        try { expression; } catch (const exception_type &) { Thrown = true; } \
+        CHECK(Thrown && #expression " throws " #exception_type); \
+    } \
+    while (0)
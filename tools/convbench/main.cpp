@@ -0,0 +1,275 @@
+/** $VER: main.cpp (2026.10.19) P. Stuer - Benchmarks the RCP and MMD converters. **/
+
+#include "pch.h"
+
+#include "RCP/RCP.h"
+#include "RunningNotes.h"
+#include "MMD/MMD.h"
+
+namespace fs = std::filesystem;
+
+struct options_t
+{
+    uint32_t Iterations = 20;
+    uint16_t MaxLoopExpansions = 64;
+};
+
+struct result_t
+{
+    double Time;            // Average time per conversion in ms
+    size_t OutputSize;      // in bytes
+};
+
+static void ProcessFile(const fs::path & filePath, const options_t & options);
+static void BenchmarkRunningNotes(const options_t & options);
+static bool ReadFile(const fs::path & filePath, std::vector<uint8_t> & data);
+static result_t ConvertRCP(const std::vector<uint8_t> & data, const options_t & options, bool preallocateOutput);
+static result_t ConvertMMD(const std::vector<uint8_t> & data, const options_t & options, bool preallocateOutput);
+
+static bool IsRCP(const fs::path & filePath) noexcept;
+static bool IsMMD(const fs::path & filePath) noexcept;
+
+/// <summary>
+/// Entry point
+/// </summary>
+int wmain(int argc, wchar_t * argv[])
+{
+    if (argc < 2)
+    {
+        ::printf("Usage: convbench.exe [-n iterations] [-loops n] <file or directory>\n");
+        ::printf("       convbench.exe [-n iterations] -runningnotes\n");
+        ::printf("Converts RCP/R36/G18/G36 and MMD files with loop expansion enabled and reports the time per conversion with and without output preallocation.\n");
+        ::printf("-runningnotes reports the time per note event of the running notes bookkeeping with 8, 32, 256 and 4096 concurrent notes.\n");
+
+        return -1;
+    }
+
+    options_t Options;
+
+    int i = 1;
+
+    while ((i < argc) && (argv[i][0] == '-'))
+    {
+        if (::_wcsicmp(argv[i], L"-runningnotes") == 0)
+        {
+            BenchmarkRunningNotes(Options);
+
+            return 0;
+        }
+        else
+        if ((::_wcsicmp(argv[i], L"-n") == 0) && (i + 1 < argc - 1))
+            Options.Iterations = (std::max)(1u, (uint32_t) ::wcstoul(argv[++i], nullptr, 0));
+        else
+        if ((::_wcsicmp(argv[i], L"-loops") == 0) && (i + 1 < argc - 1))
+            Options.MaxLoopExpansions = (uint16_t) (std::max)(1ul, ::wcstoul(argv[++i], nullptr, 0));
+        else
+        {
+            ::printf("Unknown option \"%s\".\n", msc::WideToUTF8(argv[i]).c_str());
+
+            return -1;
+        }
+
+        ++i;
+    }
+
+    if (i >= argc)
+    {
+        ::printf("No file or directory specified.\n");
+
+        return -1;
+    }
+
+    const fs::path Path(argv[i]);
+
+    std::error_code ec;
+
+    ::printf("File, Size, Output Size, Time (ms), Time Preallocated (ms), Speed-up\n");
+
+    if (fs::is_directory(Path, ec))
+    {
+        for (const auto & Entry : fs::recursive_directory_iterator(Path, fs::directory_options::skip_permission_denied, ec))
+        {
+            if (Entry.is_regular_file(ec))
+                ProcessFile(Entry.path(), Options);
+        }
+    }
+    else
+        ProcessFile(Path, Options);
+
+    return 0;
+}
+
+/// <summary>
+/// Benchmarks the conversion of a single file.
+/// </summary>
+static void ProcessFile(const fs::path & filePath, const options_t & options)
+{
+    const bool IsRCPFile = IsRCP(filePath);
+
+    if (!IsRCPFile && !IsMMD(filePath))
+        return;
+
+    std::vector<uint8_t> Data;
+
+    if (!ReadFile(filePath, Data))
+        return;
+
+    try
+    {
+        const result_t Baseline     = IsRCPFile ? ConvertRCP(Data, options, false) : ConvertMMD(Data, options, false);
+        const result_t Preallocated = IsRCPFile ? ConvertRCP(Data, options, true)  : ConvertMMD(Data, options, true);
+
+        ::printf("\"%s\", %zu, %zu, %.3f, %.3f, %.2f\n", msc::WideToUTF8(filePath.wstring()).c_str(), Data.size(), Preallocated.OutputSize, Baseline.Time, Preallocated.Time, (Preallocated.Time > 0.) ? Baseline.Time / Preallocated.Time : 0.);
+    }
+    catch (const std::exception & e)
+    {
+        ::printf("\"%s\", %zu, Failed: %s\n", msc::WideToUTF8(filePath.wstring()).c_str(), Data.size(), e.what());
+    }
+}
+
+/// <summary>
+/// Benchmarks the running notes bookkeeping of the RCP and MMD converters. Every tick a note is started that lasts as many ticks as there are concurrent notes.
+/// A track can only play each of the 128 keys once. Beyond that the keys are retriggered, which leaves that many pending Note Off entries in the heap.
+/// </summary>
+static void BenchmarkRunningNotes(const options_t & options)
+{
+    const uint32_t EventCount = 100000;
+
+    ::printf("Concurrent Notes, Events, Time per Event (ns)\n");
+
+    for (const uint32_t NoteCount : { 8u, 32u, 256u, 4096u })
+    {
+        midi::running_notes_t RunningNotes;
+
+        const auto Start = std::chrono::steady_clock::now();
+
+        for (uint32_t i = 0; i < options.Iterations; ++i)
+        {
+            rcp::midi_stream_t Stream;
+
+            RunningNotes.Reset();
+
+            for (uint32_t j = 0; j < EventCount; ++j)
+            {
+                uint32_t Duration = 1;
+
+                RunningNotes.Check(Stream, Duration);
+                RunningNotes.Advance(Duration);
+
+                const uint8_t Code = (uint8_t) (j % (std::min)(NoteCount, 128u));
+
+                if (!RunningNotes.Extend(Code, NoteCount))
+                    RunningNotes.Add((uint8_t) (j & 0x0F), Code, 0x80, NoteCount);
+            }
+
+            RunningNotes.Flush(Stream, Stream.GetDuration(), false);
+        }
+
+        const double Time = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - Start).count() / ((double) options.Iterations * EventCount);
+
+        ::printf("%u, %u, %.1f\n", NoteCount, EventCount, Time);
+    }
+}
+
+/// <summary>
+/// Converts an RCP file the specified number of times.
+/// </summary>
+static result_t ConvertRCP(const std::vector<uint8_t> & data, const options_t & options, bool preallocateOutput)
+{
+    rcp::buffer_t SrcData;
+
+    SrcData.Copy(data.data(), data.size());
+
+    rcp::converter_t Converter;
+
+    Converter._Options.MaxLoopExpansions  = options.MaxLoopExpansions;
+    Converter._Options.ExpandLoops        = true;
+    Converter._Options.IncludeControlData = false;
+    Converter._Options.PreallocateOutput  = preallocateOutput;
+
+    result_t Result = { };
+
+    const auto Start = std::chrono::steady_clock::now();
+
+    for (uint32_t i = 0; i < options.Iterations; ++i)
+    {
+        rcp::buffer_t DstData;
+
+        Converter.Convert(SrcData, DstData);
+
+        Result.OutputSize = DstData.Size;
+    }
+
+    Result.Time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count() / options.Iterations;
+
+    return Result;
+}
+
+/// <summary>
+/// Converts an MMD file the specified number of times.
+/// </summary>
+static result_t ConvertMMD(const std::vector<uint8_t> & data, const options_t & options, bool preallocateOutput)
+{
+    mmd::options_t Options;
+
+    Options.MaxLoopExpansions = options.MaxLoopExpansions;
+    Options.ExpandLoops       = true;
+    Options.PreallocateOutput = preallocateOutput;
+
+    result_t Result = { };
+
+    const auto Start = std::chrono::steady_clock::now();
+
+    for (uint32_t i = 0; i < options.Iterations; ++i)
+    {
+        std::vector<uint8_t> DstData;
+
+        if (mmd::Convert(data.data(), (uint32_t) data.size(), DstData, Options) != 0)
+            throw std::runtime_error("Invalid MMD data");
+
+        Result.OutputSize = DstData.size();
+    }
+
+    Result.Time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count() / options.Iterations;
+
+    return Result;
+}
+
+/// <summary>
+/// Reads a file into memory.
+/// </summary>
+static bool ReadFile(const fs::path & filePath, std::vector<uint8_t> & data)
+{
+    std::ifstream Stream(filePath, std::ios::binary);
+
+    if (!Stream)
+        return false;
+
+    data.assign(std::istreambuf_iterator<char>(Stream), std::istreambuf_iterator<char>());
+
+    return !data.empty();
+}
+
+/// <summary>
+/// Returns true if the file has a Recomposer sequence file extension.
+/// </summary>
+static bool IsRCP(const fs::path & filePath) noexcept
+{
+    const std::wstring Extension = filePath.extension().wstring();
+
+    for (const auto & Filter : { L".rcp", L".r36", L".g18", L".g36" })
+    {
+        if (::_wcsicmp(Extension.c_str(), Filter) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+/// <summary>
+/// Returns true if the file has an MMD file extension.
+/// </summary>
+static bool IsMMD(const fs::path & filePath) noexcept
+{
+    return ::_wcsicmp(filePath.extension().wstring().c_str(), L".mmd") == 0;
+}
@@ -0,0 +1,806 @@
+/** $VER: main.cpp (2026.10.19) P. Stuer - Benchmarks the MIDI processor on a corpus of files and on synthetic stress files. **/
+
+#include "pch.h"
+
+#include "MIDIProcessor.h"
+
+namespace fs = std::filesystem;
+
+#pragma region Allocation Tracking
+
+/*
+    The global allocation functions are replaced to count the allocations and to track the peak number of bytes in use.
+    The RCP and MMD converters allocate their buffers with malloc() and realloc(). Where the linker supports it (see CMakeLists.txt) the C allocation
+    functions are wrapped as well and every block is counted with its usable size. Otherwise each block of operator new is preceded by a header that
+    holds its size and the buffers of the RCP and MMD converters are not counted.
+*/
+namespace
+{
+
+std::atomic<uint64_t> AllocationCount;
+std::atomic<int64_t> BytesInUse;
+std::atomic<int64_t> PeakBytesInUse;
+
+void AddBlock(int64_t size) noexcept
+{
+    ++AllocationCount;
+
+    const int64_t InUse = (BytesInUse += size);
+
+    int64_t Peak = PeakBytesInUse.load();
+
+    while ((InUse > Peak) && !PeakBytesInUse.compare_exchange_weak(Peak, InUse))
+        ;
+}
+
+}
+
+#ifdef MIDIBENCH_WRAP_MALLOC
+
+#include <malloc.h>
+
+const bool IsMallocCounted = true;
+
+extern "C"
+{
+
+void * __real_malloc(size_t size);
+void * __real_realloc(void * block, size_t size);
+void __real_free(void * block);
+
+void * __wrap_malloc(size_t size)
+{
+    void * p = __real_malloc(size);
+
+    if (p != nullptr)
+        AddBlock((int64_t) ::malloc_usable_size(p));
+
+    return p;
+}
+
+void * __wrap_realloc(void * block, size_t size)
+{
+    const int64_t OldSize = (block != nullptr) ? (int64_t) ::malloc_usable_size(block) : 0;
+
+    void * p = __real_realloc(block, size);
+
+    // realloc() frees the block and returns nullptr for a size of 0.
+    if ((p != nullptr) || (size == 0))
+        BytesInUse -= OldSize;
+
+    if (p != nullptr)
+        AddBlock((int64_t) ::malloc_usable_size(p));
+
+    return p;
+}
+
+void __wrap_free(void * block)
+{
+    if (block != nullptr)
+        BytesInUse -= (int64_t) ::malloc_usable_size(block);
+
+    __real_free(block);
+}
+
+}
+
+namespace
+{
+
+void * Allocate(size_t size)
+{
+    void * p = ::malloc((size != 0) ? size : 1);
+
+    if (p == nullptr)
+        throw std::bad_alloc();
+
+    return p;
+}
+
+void Free(void * block) noexcept
+{
+    ::free(block);
+}
+
+}
+
+#else
+
+const bool IsMallocCounted = false;
+
+namespace
+{
+
+const size_t HeaderSize = 16; // Keeps the default alignment of the returned blocks.
+
+void * Allocate(size_t size)
+{
+    uint8_t * p = (uint8_t *) ::malloc(size + HeaderSize);
+
+    if (p == nullptr)
+        throw std::bad_alloc();
+
+    *(size_t *) p = size;
+
+    AddBlock((int64_t) size);
+
+    return p + HeaderSize;
+}
+
+void Free(void * block) noexcept
+{
+    if (block == nullptr)
+        return;
+
+    uint8_t * p = (uint8_t *) block - HeaderSize;
+
+    BytesInUse -= (int64_t) *(size_t *) p;
+
+    ::free(p);
+}
+
+}
+
+#endif
+
+void * operator new(size_t size) { return Allocate(size); }
+void * operator new[](size_t size) { return Allocate(size); }
+void operator delete(void * block) noexcept { Free(block); }
+void operator delete[](void * block) noexcept { Free(block); }
+void operator delete(void * block, size_t) noexcept { Free(block); }
+void operator delete[](void * block, size_t) noexcept { Free(block); }
+
+#pragma endregion
+
+struct options_t
+{
+    uint32_t Iterations = 5;
+    bool IncludeSynthetic = true;
+};
+
+/// <summary>
+/// Represents the cost of an operation.
+/// </summary>
+struct measurement_t
+{
+    double MinTime;         // Fastest iteration in ms
+    double MeanTime;        // Average of all iterations in ms
+    uint64_t Allocations;   // Number of allocations of the first iteration
+    int64_t PeakBytes;      // Peak number of additional bytes in use during the first iteration
+};
+
+/// <summary>
+/// Represents the results of a file.
+/// </summary>
+struct result_t
+{
+    std::string Name;       // UTF-8
+    std::string Format;
+    size_t Size;
+    bool IsValid;
+
+    measurement_t Parse;
+    measurement_t SerializeAsStream;
+    measurement_t SerializeAsSMF;
+    measurement_t GetMetaData;
+
+    size_t MessageCount;
+};
+
+static void ProcessDirectory(const fs::path & directoryPath, const options_t & options, std::vector<result_t> & results);
+static result_t ProcessData(const std::string & name, const std::vector<uint8_t> & data, const std::wstring & filePath, const options_t & options);
+static void GenerateSyntheticFiles(std::vector<std::pair<std::string, std::vector<uint8_t>>> & files);
+static void WriteJSON(FILE * fp, const std::vector<result_t> & files, const std::vector<result_t> & synthetic, const options_t & options);
+static bool ReadFile(const fs::path & filePath, std::vector<uint8_t> & data);
+
+static const char * FormatNames[] = { "SMF", "RMI", "XMI", "XFM", "MDS", "HMP", "HMI", "MUS", "LDS", "GMF", "RCP", "XMF", "MMF", "MMD", "SYX", "TST" };
+
+/// <summary>
+/// Entry point
+/// </summary>
+int wmain(int argc, wchar_t * argv[])
+{
+    options_t Options;
+
+    std::wstring OutputPath;
+
+    int i = 1;
+
+    while ((i < argc) && (argv[i][0] == '-'))
+    {
+        if ((::_wcsicmp(argv[i], L"-n") == 0) && (i + 1 < argc))
+            Options.Iterations = (std::max)(1u, (uint32_t) ::wcstoul(argv[++i], nullptr, 0));
+        else
+        if ((::_wcsicmp(argv[i], L"-o") == 0) && (i + 1 < argc))
+            OutputPath = argv[++i];
+        else
+        if (::_wcsicmp(argv[i], L"-nosynthetic") == 0)
+            Options.IncludeSynthetic = false;
+        else
+        if ((::_wcsicmp(argv[i], L"-?") == 0) || (::_wcsicmp(argv[i], L"-h") == 0))
+        {
+            ::printf("Usage: midibench.exe [-n iterations] [-o output.json] [-nosynthetic] [file or directory]\n");
+            ::printf("Measures the parse, SerializeAsStream, SerializeAsSMF and GetMetaData time, the number of allocations and the peak memory use of each file\n");
+            ::printf("and of a set of generated stress files, and writes the results per file and per format as JSON.\n");
+
+            if (!IsMallocCounted)
+                ::printf("The buffers of the RCP and MMD converters are allocated with malloc() and are not counted on this platform.\n");
+
+            return 0;
+        }
+        else
+        {
+            ::printf("Unknown option \"%s\".\n", msc::WideToUTF8(argv[i]).c_str());
+
+            return -1;
+        }
+
+        ++i;
+    }
+
+    std::vector<result_t> Files;
+
+    if (i < argc)
+    {
+        const fs::path Path(argv[i]);
+
+        std::error_code ec;
+
+        if (fs::is_directory(Path, ec))
+            ProcessDirectory(Path, Options, Files);
+        else
+        {
+            std::vector<uint8_t> Data;
+
+            if (ReadFile(Path, Data))
+                Files.push_back(ProcessData(msc::WideToUTF8(Path.wstring()), Data, Path.wstring(), Options));
+        }
+    }
+
+    std::vector<result_t> Synthetic;
+
+    if (Options.IncludeSynthetic)
+    {
+        std::vector<std::pair<std::string, std::vector<uint8_t>>> SyntheticFiles;
+
+        GenerateSyntheticFiles(SyntheticFiles);
+
+        for (const auto & [Name, Data] : SyntheticFiles)
+            Synthetic.push_back(ProcessData(Name, Data, msc::UTF8ToWide(Name), Options));
+    }
+
+    FILE * fp = stdout;
+
+    if (!OutputPath.empty() && (::_wfopen_s(&fp, OutputPath.c_str(), L"w") != 0))
+    {
+        ::printf("Failed to create \"%s\".\n", msc::WideToUTF8(OutputPath).c_str());
+
+        return -1;
+    }
+
+    WriteJSON(fp, Files, Synthetic, Options);
+
+    if (fp != stdout)
+        ::fclose(fp);
+
+    return 0;
+}
+
+/// <summary>
+/// Benchmarks all files in a directory and its subdirectories. The files are processed in path order so that the output is reproducible.
+/// </summary>
+static void ProcessDirectory(const fs::path & directoryPath, const options_t & options, std::vector<result_t> & results)
+{
+    std::vector<fs::path> FilePaths;
+
+    std::error_code ec;
+
+    for (const auto & Entry : fs::recursive_directory_iterator(directoryPath, fs::directory_options::skip_permission_denied, ec))
+    {
+        if (Entry.is_regular_file(ec))
+            FilePaths.push_back(Entry.path());
+    }
+
+    std::sort(FilePaths.begin(), FilePaths.end());
+
+    for (const auto & FilePath : FilePaths)
+    {
+        std::vector<uint8_t> Data;
+
+        if (!ReadFile(FilePath, Data))
+            continue;
+
+        result_t Result = ProcessData(msc::WideToUTF8(fs::relative(FilePath, directoryPath, ec).wstring()), Data, FilePath.wstring(), options);
+
+        // Skip the files that are not MIDI files, e.g. .txt or .log files.
+        if (Result.IsValid)
+            results.push_back(std::move(Result));
+    }
+}
+
+/// <summary>
+/// Calls the operation the specified number of times and measures it.
+/// </summary>
+template<typename T>
+static measurement_t Measure(uint32_t iterations, T operation)
+{
+    measurement_t Result = { };
+
+    double TotalTime = 0.;
+
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        const uint64_t Allocations = AllocationCount.load();
+        const int64_t BytesInUseBefore = BytesInUse.load();
+
+        PeakBytesInUse = BytesInUseBefore;
+
+        const auto Start = std::chrono::steady_clock::now();
+
+        operation();
+
+        const double Time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+
+        if (i == 0)
+        {
+            Result.MinTime = Time;
+            Result.Allocations = AllocationCount.load() - Allocations;
+            Result.PeakBytes = PeakBytesInUse.load() - BytesInUseBefore;
+        }
+        else
+            Result.MinTime = (std::min)(Result.MinTime, Time);
+
+        TotalTime += Time;
+    }
+
+    Result.MeanTime = TotalTime / iterations;
+
+    return Result;
+}
+
+/// <summary>
+/// Benchmarks the processing of a file.
+/// </summary>
+static result_t ProcessData(const std::string & name, const std::vector<uint8_t> & data, const std::wstring & filePath, const options_t & options)
+{
+    result_t Result = { };
+
+    Result.Name = name;
+    Result.Size = data.size();
+
+    // Classify the file by its detected format; some processors, e.g. RMI, store the format of the embedded data in the container.
+    const midi::detection_t Detection = midi::processor_t::Detect(data, filePath.c_str());
+
+    if ((Detection.Format < 0) || ((size_t) Detection.Format >= _countof(FormatNames)))
+        return Result;
+
+    midi::container_t Container;
+
+    try
+    {
+        if (!midi::processor_t::Process(data, filePath.c_str(), Container))
+            return Result;
+    }
+    catch (const std::exception &)
+    {
+        return Result;
+    }
+
+    Result.IsValid = true;
+    Result.Format = FormatNames[Detection.Format];
+
+    Result.Parse = Measure(options.Iterations, [&]()
+    {
+        midi::container_t c;
+
+        midi::processor_t::Process(data, filePath.c_str(), c);
+    });
+
+    Result.SerializeAsStream = Measure(options.Iterations, [&]()
+    {
+        std::vector<midi::message_t> Stream;
+        midi::sysex_table_t SysExTable;
+        std::vector<uint8_t> PortNumbers;
+        uint32_t LoopBegin, LoopEnd;
+
+        Container.SerializeAsStream(0, Stream, SysExTable, PortNumbers, LoopBegin, LoopEnd, 0);
+
+        Result.MessageCount = Stream.size();
+    });
+
+    Result.SerializeAsSMF = Measure(options.Iterations, [&]()
+    {
+        std::vector<uint8_t> Data;
+
+        Container.SerializeAsSMF(Data);
+    });
+
+    Result.GetMetaData = Measure(options.Iterations, [&]()
+    {
+        midi::metadata_table_t MetaData;
+
+        Container.GetMetaData(0, MetaData);
+    });
+
+    return Result;
+}
+
+#pragma region Synthetic Files
+
+namespace
+{
+
+/// <summary>
+/// Implements a small deterministic pseudo-random number generator (xorshift32) so that the synthetic files are identical on every platform.
+/// </summary>
+class random_t
+{
+public:
+    random_t(uint32_t seed) noexcept : _State(seed) { }
+
+    uint32_t Next(uint32_t range) noexcept
+    {
+        _State ^= _State << 13;
+        _State ^= _State >> 17;
+        _State ^= _State << 5;
+
+        return _State % range;
+    }
+
+private:
+    uint32_t _State;
+};
+
+/// <summary>
+/// Builds a Standard MIDI File.
+/// </summary>
+class smf_writer_t
+{
+public:
+    smf_writer_t(uint16_t format, uint16_t division) noexcept : _Format(format), _Division(division), _TrackCount() { }
+
+    void BeginTrack() { _Track.clear(); }
+
+    void Event(uint32_t delta, std::initializer_list<uint8_t> data)
+    {
+        WriteVLQ(_Track, delta);
+
+        _Track.insert(_Track.end(), data);
+    }
+
+    void Meta(uint32_t delta, uint8_t type, const std::string & text)
+    {
+        WriteVLQ(_Track, delta);
+
+        _Track.insert(_Track.end(), { 0xFF, type });
+
+        WriteVLQ(_Track, (uint32_t) text.size());
+
+        _Track.insert(_Track.end(), text.begin(), text.end());
+    }
+
+    void SysEx(uint32_t delta, size_t size, random_t & random)
+    {
+        WriteVLQ(_Track, delta);
+
+        _Track.push_back(0xF0);
+
+        WriteVLQ(_Track, (uint32_t) size + 1);
+
+        for (size_t i = 0; i < size; ++i)
+            _Track.push_back((uint8_t) random.Next(0x80));
+
+        _Track.push_back(0xF7);
+    }
+
+    void EndTrack()
+    {
+        Event(0, { 0xFF, 0x2F, 0x00 });
+
+        const uint32_t Size = (uint32_t) _Track.size();
+
+        _Tracks.insert(_Tracks.end(), { 'M', 'T', 'r', 'k', (uint8_t) (Size >> 24), (uint8_t) (Size >> 16), (uint8_t) (Size >> 8), (uint8_t) Size });
+        _Tracks.insert(_Tracks.end(), _Track.begin(), _Track.end());
+
+        ++_TrackCount;
+    }
+
+    std::vector<uint8_t> GetData() const
+    {
+        std::vector<uint8_t> Data = { 'M', 'T', 'h', 'd', 0, 0, 0, 6, (uint8_t) (_Format >> 8), (uint8_t) _Format, (uint8_t) (_TrackCount >> 8), (uint8_t) _TrackCount, (uint8_t) (_Division >> 8), (uint8_t) _Division };
+
+        Data.insert(Data.end(), _Tracks.begin(), _Tracks.end());
+
+        return Data;
+    }
+
+private:
+    static void WriteVLQ(std::vector<uint8_t> & data, uint32_t value)
+    {
+        uint8_t Bytes[5];
+        size_t n = 0;
+
+        Bytes[n++] = (uint8_t) (value & 0x7F);
+
+        while (value >>= 7)
+            Bytes[n++] = (uint8_t) (0x80 | (value & 0x7F));
+
+        while (n > 0)
+            data.push_back(Bytes[--n]);
+    }
+
+private:
+    uint16_t _Format;
+    uint16_t _Division;
+    uint16_t _TrackCount;
+
+    std::vector<uint8_t> _Track;
+    std::vector<uint8_t> _Tracks;
+};
+
+/// <summary>
+/// Adds notes and controller changes to the current track.
+/// </summary>
+void AddNotes(smf_writer_t & smf, random_t & random, uint8_t channel, size_t count, uint32_t maxDelta)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        const uint8_t Note = (uint8_t) (36 + random.Next(60));
+
+        if (random.Next(8) == 0)
+            smf.Event(0, { (uint8_t) (0xB0 | channel), (uint8_t) random.Next(120), (uint8_t) random.Next(128) });
+
+        smf.Event(random.Next(maxDelta), { (uint8_t) (0x90 | channel), Note, (uint8_t) (1 + random.Next(127)) });
+        smf.Event(1 + random.Next(maxDelta), { (uint8_t) (0x80 | channel), Note, 0x40 });
+    }
+}
+
+}
+
+/// <summary>
+/// Generates files with stress shapes: many tracks, many tempo changes, huge SysEx messages and a long duration. The RMI and SYX files wrap the same kinds of data.
+/// </summary>
+static void GenerateSyntheticFiles(std::vector<std::pair<std::string, std::vector<uint8_t>>> & files)
+{
+    // Many tracks
+    {
+        random_t Random(1);
+        smf_writer_t SMF(1, 480);
+
+        for (uint8_t i = 0; i < 255; ++i)
+        {
+            SMF.BeginTrack();
+
+            SMF.Meta(0, 0x03, std::format("Track {}", i));
+            SMF.Event(0, { 0xFF, 0x21, 0x01, (uint8_t) (i / 16) }); // MIDI Port
+
+            AddNotes(SMF, Random, (uint8_t) (i & 0x0F), 500, 240);
+
+            SMF.EndTrack();
+        }
+
+        files.push_back({ "synthetic/many-tracks.mid", SMF.GetData() });
+    }
+
+    // Many tempo changes
+    {
+        random_t Random(2);
+        smf_writer_t SMF(0, 480);
+
+        SMF.BeginTrack();
+
+        for (size_t i = 0; i < 50'000; ++i)
+        {
+            const uint32_t Tempo = 300'000 + Random.Next(400'000);
+
+            SMF.Event(Random.Next(60), { 0xFF, 0x51, 0x03, (uint8_t) (Tempo >> 16), (uint8_t) (Tempo >> 8), (uint8_t) Tempo });
+
+            AddNotes(SMF, Random, (uint8_t) (i & 0x0F), 1, 30);
+        }
+
+        SMF.EndTrack();
+
+        files.push_back({ "synthetic/many-tempo-changes.mid", SMF.GetData() });
+    }
+
+    // Huge SysEx messages
+    {
+        random_t Random(3);
+        smf_writer_t SMF(0, 480);
+
+        SMF.BeginTrack();
+
+        for (size_t i = 0; i < 16; ++i)
+        {
+            SMF.SysEx(480, 1024 * 1024, Random);
+
+            AddNotes(SMF, Random, (uint8_t) i, 100, 120);
+        }
+
+        SMF.EndTrack();
+
+        files.push_back({ "synthetic/huge-sysex.mid", SMF.GetData() });
+    }
+
+    // Long duration
+    {
+        random_t Random(4);
+        smf_writer_t SMF(1, 96);
+
+        for (uint8_t i = 0; i < 16; ++i)
+        {
+            SMF.BeginTrack();
+
+            AddNotes(SMF, Random, i, 5'000, 20'000);
+
+            SMF.EndTrack();
+        }
+
+        files.push_back({ "synthetic/long-duration.mid", SMF.GetData() });
+    }
+
+    // RMI: the many tracks file in a RIFF RMID container.
+    {
+        const std::vector<uint8_t> & SMF = files[0].second;
+
+        const uint32_t DataSize = (uint32_t) SMF.size();
+        const uint32_t RIFFSize = 4 + 8 + DataSize + (DataSize & 1);
+
+        std::vector<uint8_t> Data =
+        {
+            'R', 'I', 'F', 'F', (uint8_t) RIFFSize, (uint8_t) (RIFFSize >> 8), (uint8_t) (RIFFSize >> 16), (uint8_t) (RIFFSize >> 24),
+            'R', 'M', 'I', 'D',
+            'd', 'a', 't', 'a', (uint8_t) DataSize, (uint8_t) (DataSize >> 8), (uint8_t) (DataSize >> 16), (uint8_t) (DataSize >> 24),
+        };
+
+        Data.insert(Data.end(), SMF.begin(), SMF.end());
+
+        if (DataSize & 1)
+            Data.push_back(0);
+
+        files.push_back({ "synthetic/many-tracks.rmi", std::move(Data) });
+    }
+
+    // SYX: a dump of many SysEx messages.
+    {
+        random_t Random(5);
+
+        std::vector<uint8_t> Data;
+
+        for (size_t i = 0; i < 20'000; ++i)
+        {
+            Data.insert(Data.end(), { 0xF0, 0x41, 0x10, 0x42, 0x12 });
+
+            for (size_t j = 0, n = 4 + Random.Next(250); j < n; ++j)
+                Data.push_back((uint8_t) Random.Next(0x80));
+
+            Data.push_back(0xF7);
+        }
+
+        files.push_back({ "synthetic/sysex-dump.syx", std::move(Data) });
+    }
+}
+
+#pragma endregion
+
+#pragma region JSON
+
+/// <summary>
+/// Writes a string as a JSON string literal.
+/// </summary>
+static void WriteString(FILE * fp, const std::string & text)
+{
+    ::fputc('"', fp);
+
+    for (const char c : text)
+    {
+        if ((c == '"') || (c == '\\'))
+            ::fprintf(fp, "\\%c", c);
+        else
+        if ((uint8_t) c < 0x20)
+            ::fprintf(fp, "\\u%04X", (uint32_t) c);
+        else
+            ::fputc(c, fp);
+    }
+
+    ::fputc('"', fp);
+}
+
+static void WriteMeasurement(FILE * fp, const char * name, const measurement_t & m, bool isLast)
+{
+    ::fprintf(fp, "\"%s\": { \"min_ms\": %.4f, \"mean_ms\": %.4f, \"allocations\": %" PRIu64 ", \"peak_bytes\": %" PRId64 " }%s", name, m.MinTime, m.MeanTime, m.Allocations, m.PeakBytes, isLast ? "" : ", ");
+}
+
+static void WriteResults(FILE * fp, const std::vector<result_t> & results)
+{
+    ::fprintf(fp, "[");
+
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const result_t & r = results[i];
+
+        ::fprintf(fp, "%s\n    { \"name\": ", (i > 0) ? "," : "");
+
+        WriteString(fp, r.Name);
+
+        ::fprintf(fp, ", \"format\": \"%s\", \"size\": %zu, \"messages\": %zu, ", r.Format.c_str(), r.Size, r.MessageCount);
+
+        WriteMeasurement(fp, "parse", r.Parse, false);
+        WriteMeasurement(fp, "serialize_stream", r.SerializeAsStream, false);
+        WriteMeasurement(fp, "serialize_smf", r.SerializeAsSMF, false);
+        WriteMeasurement(fp, "metadata", r.GetMetaData, true);
+
+        ::fprintf(fp, " }");
+    }
+
+    ::fprintf(fp, "%s]", results.empty() ? "" : "\n  ");
+}
+
+/// <summary>
+/// Writes the results as JSON. The formats section sums the minimum times and the allocations of the files of each format.
+/// </summary>
+static void WriteJSON(FILE * fp, const std::vector<result_t> & files, const std::vector<result_t> & synthetic, const options_t & options)
+{
+    struct totals_t
+    {
+        size_t Count;
+        uint64_t Size;
+        double Time[4];
+        uint64_t Allocations;
+        int64_t PeakBytes;
+    };
+
+    std::map<std::string, totals_t> Formats;
+
+    for (const auto & r : files)
+    {
+        totals_t & t = Formats[r.Format];
+
+        ++t.Count;
+        t.Size += r.Size;
+        t.Time[0] += r.Parse.MinTime;
+        t.Time[1] += r.SerializeAsStream.MinTime;
+        t.Time[2] += r.SerializeAsSMF.MinTime;
+        t.Time[3] += r.GetMetaData.MinTime;
+        t.Allocations += r.Parse.Allocations + r.SerializeAsStream.Allocations + r.SerializeAsSMF.Allocations + r.GetMetaData.Allocations;
+        t.PeakBytes = (std::max)({ t.PeakBytes, r.Parse.PeakBytes, r.SerializeAsStream.PeakBytes, r.SerializeAsSMF.PeakBytes, r.GetMetaData.PeakBytes });
+    }
+
+    // If malloc() is not counted, the allocations and peak bytes of the RCP and MMD files do not include the buffers of their converters.
+    ::fprintf(fp, "{\n  \"version\": 1,\n  \"iterations\": %u,\n  \"malloc_counted\": %s,\n  \"formats\": {", options.Iterations, IsMallocCounted ? "true" : "false");
+
+    size_t i = 0;
+
+    for (const auto & [Name, t] : Formats)
+    {
+        ::fprintf(fp, "%s\n    \"%s\": { \"files\": %zu, \"bytes\": %" PRIu64 ", \"parse_ms\": %.4f, \"serialize_stream_ms\": %.4f, \"serialize_smf_ms\": %.4f, \"metadata_ms\": %.4f, \"allocations\": %" PRIu64 ", \"peak_bytes\": %" PRId64 " }",
+            (i++ > 0) ? "," : "", Name.c_str(), t.Count, t.Size, t.Time[0], t.Time[1], t.Time[2], t.Time[3], t.Allocations, t.PeakBytes);
+    }
+
+    ::fprintf(fp, "%s},\n  \"files\": ", Formats.empty() ? "" : "\n  ");
+
+    WriteResults(fp, files);
+
+    ::fprintf(fp, ",\n  \"synthetic\": ");
+
+    WriteResults(fp, synthetic);
+
+    ::fprintf(fp, "\n}\n");
+}
+
+#pragma endregion
+
+/// <summary>
+/// Reads a file into memory.
+/// </summary>
+static bool ReadFile(const fs::path & filePath, std::vector<uint8_t> & data)
+{
+    std::ifstream Stream(filePath, std::ios::binary);
+
+    if (!Stream)
+        return false;
+
+    data.assign(std::istreambuf_iterator<char>(Stream), std::istreambuf_iterator<char>());
+
+    return !data.empty();
+}
@@ -0,0 +1,48 @@
+/** $VER: pch.h (2026.10.19) P. Stuer **/
+
+#pragma once
+
+#ifdef _MSC_VER
+#include <CppCoreCheck/Warnings.h>
+
+#pragma warning(disable: 4100 4625 4626 4710 4711 4738 5045 ALL_CPPCORECHECK_WARNINGS)
+#endif
+
+#ifdef _WIN32
+#include <SDKDDKVer.h>
+
+#define NOMINMAX
+
+#include <winsock2.h>
+#include <windows.h>
+#else
+#include <Compat.h>
+#endif
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#pragma warning(disable: 4242)
+#include <algorithm>
+#pragma warning(default: 4242)
+#include <cassert>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#if __has_include(<format>)
+#include <format>
+#else
+#include <Format.h>
+#endif
+#include <fstream>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <libmsc.h>
@@ -1,5 +1,5 @@
 
-/** $VER: Messages.cpp (2025.07.18) P. Stuer **/
+/** $VER: Messages.cpp (2026.10.19) P. Stuer **/
 
 #include "pch.h"
 
@@ -15,7 +15,7 @@ inline static T InRange(T value, T minValue, T maxValue)
 }
 
 // General MIDI Level 1 Instrument Families
-const std::vector<const char *> Instruments =
+const char * const Instruments[128] =
 {
     //   1 -  8 Piano
     "Acoustic Grand Piano",
@@ -178,58 +178,68 @@ const std::vector<const char *> Instruments =
     "Gunshot",
 };
 
-// General MIDI Level 1 Percussion Key Map
-const std::unordered_map<int, const char *> Percussions =
+// General MIDI Level 1 Percussion Key Map, starting at key 35.
+static const char * const Percussions[] =
 {
-    { 35, "Acoustic Bass Drum" },
-    { 36, "Bass Drum 1" },
-    { 37, "Side Stick" },
-    { 38, "Acoustic Snare" },
-    { 39, "Hand Clap" },
-    { 40, "Electric Snare" },
-    { 41, "Low Floor Tom" },
-    { 42, "Closed Hi Hat" },
-    { 43, "High Floor Tom" },
-    { 44, "Pedal Hi-Hat" },
-    { 45, "Low Tom" },
-    { 46, "Open Hi-Hat" },
-    { 47, "Low-Mid Tom" },
-    { 48, "Hi-Mid Tom" },
-    { 49, "Crash Cymbal 1" },
-    { 50, "High Tom" },
-    { 51, "Ride Cymbal 1" },
-    { 52, "Chinese Cymbal" },
-    { 53, "Ride Bell" },
-    { 54, "Tambourine" },
-    { 55, "Splash Cymbal" },
-    { 56, "Cowbell" },
-    { 57, "Crash Cymbal 2" },
-    { 58, "Vibraslap" },
-    { 59, "Ride Cymbal 2" },
-    { 60, "Hi Bongo" },
-    { 61, "Low Bongo" },
-    { 62, "Mute Hi Conga" },
-    { 63, "Open Hi Conga" },
-    { 64, "Low Conga" },
-    { 65, "High Timbale" },
-    { 66, "Low Timbale" },
-    { 67, "High Agogo" },
-    { 68, "Low Agogo" },
-    { 69, "Cabasa" },
-    { 70, "Maracas" },
-    { 71, "Short Whistle" },
-    { 72, "Long Whistle" },
-    { 73, "Short Guiro" },
-    { 74, "Long Guiro" },
-    { 75, "Claves" },
-    { 76, "Hi Wood Block" },
-    { 77, "Low Wood Block" },
-    { 78, "Mute Cuica" },
-    { 79, "Open Cuica" },
-    { 80, "Mute Triangle" },
-    { 81, "Open Triangle" },
+    "Acoustic Bass Drum", // 35
+    "Bass Drum 1", // 36
+    "Side Stick", // 37
+    "Acoustic Snare", // 38
+    "Hand Clap", // 39
+    "Electric Snare", // 40
+    "Low Floor Tom", // 41
+    "Closed Hi Hat", // 42
+    "High Floor Tom", // 43
+    "Pedal Hi-Hat", // 44
+    "Low Tom", // 45
+    "Open Hi-Hat", // 46
+    "Low-Mid Tom", // 47
+    "Hi-Mid Tom", // 48
+    "Crash Cymbal 1", // 49
+    "High Tom", // 50
+    "Ride Cymbal 1", // 51
+    "Chinese Cymbal", // 52
+    "Ride Bell", // 53
+    "Tambourine", // 54
+    "Splash Cymbal", // 55
+    "Cowbell", // 56
+    "Crash Cymbal 2", // 57
+    "Vibraslap", // 58
+    "Ride Cymbal 2", // 59
+    "Hi Bongo", // 60
+    "Low Bongo", // 61
+    "Mute Hi Conga", // 62
+    "Open Hi Conga", // 63
+    "Low Conga", // 64
+    "High Timbale", // 65
+    "Low Timbale", // 66
+    "High Agogo", // 67
+    "Low Agogo", // 68
+    "Cabasa", // 69
+    "Maracas", // 70
+    "Short Whistle", // 71
+    "Long Whistle", // 72
+    "Short Guiro", // 73
+    "Long Guiro", // 74
+    "Claves", // 75
+    "Hi Wood Block", // 76
+    "Low Wood Block", // 77
+    "Mute Cuica", // 78
+    "Open Cuica", // 79
+    "Mute Triangle", // 80
+    "Open Triangle", // 81
 };
 
+/// <summary>
+/// Gets the name of a General MIDI Level 1 percussion instrument. Returns nullptr if the key is not mapped.
+/// </summary>
+const char * GetPercussionName(uint8_t key) noexcept
+{
+    const size_t Index = (size_t) key - 35;
+
+    return (Index < _countof(Percussions)) ? Percussions[Index] : nullptr;
+}
+
 /// <summary>
 /// Processes a Control Change message.
 /// </summary>
@@ -362,7 +372,8 @@ std::string DescribeControlChange(uint8_t d1, uint8_t d2) noexcept
             if (InRange((int) d1, 89, 90))
                 ::snprintf(Line.data(), Line.size(), "Undefined");
             else
-                ::snprintf(Line.data(), Line.size(), "Unknown CC %02Xh%3d %02X", (int) d1, (int) d1, Value); break;
+                ::snprintf(Line.data(), Line.size(), "Unknown CC %02Xh%3d %02X", (int) d1, (int) d1, Value);
+            break;
     }
 /*
     if (Event[1] == 98)     // Non-Registered Parameter LSB
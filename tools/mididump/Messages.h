@@ -6,5 +6,5 @@
 
 extern std::string DescribeControlChange(uint8_t d1, uint8_t d2) noexcept;
 
-extern const std::vector<const char *> Instruments;
-extern const std::unordered_map<int, const char *> Percussions;
+extern const char * const Instruments[128];
+extern const char * GetPercussionName(uint8_t key) noexcept;
@@ -0,0 +1,8 @@
+
+/** $VER: Output.h (2026.10.19) P. Stuer **/
+
+#pragma once
+
+#include <stdio.h>
+
+extern thread_local FILE * Output; // Destination of the dump written by the current thread
@@ -1,11 +1,13 @@
 
-/** $VER: Process.cpp (2026.04.10) P. Stuer **/
+/** $VER: Process.cpp (2026.10.19) P. Stuer **/
 
 #include "pch.h"
 
 #include "MIDIContainer.h"
 #include "MIDIProcessor.h"
 
+#include "Output.h"
+
 #include <Encoding.h>
 
 void ProcessContainer(midi::container_t & container, bool asStream);
@@ -13,28 +15,64 @@ void ProcessStream(const midi::container_t & container, const std::vector<midi::
 void ProcessTracks(const midi::container_t & container);
 
 std::vector<uint8_t> ReadFile(const fs::path & filePath);
+static void WriteDiagnostic(const midi::diagnostic_t & diagnostic, void * context);
 
 /// <summary>
-/// Examines the specified file.
+/// Examines the specified file and returns its format.
 /// </summary>
-void ExamineFile(const fs::path & filePath, const std::map<std::string, std::string> & args)
+midi::FileFormat ExamineFile(const fs::path & filePath, const std::map<std::string, std::string> & args)
 {
+    midi::FileFormat FileFormat = midi::FileFormat::Unknown;
+
     try
     {
         std::vector<uint8_t> Data = ReadFile(filePath);
 
         midi::container_t Container;
-        midi::processor_options_t Options;
+        midi::processor_options_t Options = midi::DefaultOptions;
+
+        if (args.contains("Verbose"))
+        {
+            Options.DiagnosticsSink = WriteDiagnostic;
+            Options.DiagnosticsLevel = midi::severity_t::Trace;
+        }
 
         if (midi::processor_t::Process(Data, msc::UTF8ToWide(filePath.string().c_str()).c_str(), Container, Options))
+        {
+            FileFormat = Container.FileFormat;
+
             ProcessContainer(Container, args.contains("AsStream"));
+        }
         else
-            ::puts("File format not recognized.");
+            ::fputs("File format not recognized.\n", Output);
     }
     catch (std::exception & e)
     {
-        ::printf("%s\n", e.what());
+        ::fprintf(Output, "%s\n", e.what());
     }
+
+    return FileFormat;
+}
+
+/// <summary>
+/// Writes a diagnostic message of the library.
+/// </summary>
+static void WriteDiagnostic(const midi::diagnostic_t & diagnostic, void *)
+{
+    static const char * Severities[] = { "Trace", "Info", "Warning", "Error" };
+
+    ::fprintf(Output, "%-7s %s", Severities[(size_t) diagnostic.Severity], diagnostic.Source);
+
+    if (!diagnostic.ChunkId.empty())
+        ::fprintf(Output, " \"%.*s\"", (int) diagnostic.ChunkId.size(), diagnostic.ChunkId.data());
+
+    if (diagnostic.Offset != midi::diagnostic_t::None)
+        ::fprintf(Output, " %08zX", diagnostic.Offset);
+
+    if (diagnostic.Size != midi::diagnostic_t::None)
+        ::fprintf(Output, ", %zu bytes", diagnostic.Size);
+
+    ::fprintf(Output, ": %.*s\n", (int) diagnostic.Message.size(), diagnostic.Message.data());
 }
 
 /// <summary>
@@ -75,7 +113,7 @@ void ProcessContainer(midi::container_t & container, bool asStream)
             const uint32_t Format = container.GetFormat();
             const uint32_t TrackCount = (Format == 2) ? 1 : container.GetTrackCount();
 
-            ::printf("MIDI Format %d, %d tracks, %d subsongs\n", Format, TrackCount, SubsongCount);
+            ::fprintf(Output, "MIDI Format %d, %d tracks, %d subsongs\n", Format, TrackCount, SubsongCount);
 
             for (uint32_t i = 0; i < TrackCount; ++i)
             {
@@ -83,7 +121,7 @@ void ProcessContainer(midi::container_t & container, bool asStream)
                 uint32_t Duration = container.GetDuration(SubsongIndex, false);
                 uint32_t DurationInMS = container.GetDuration(SubsongIndex, true);
 
-                ::printf("Track %2d: %d channels, %8d ticks, %8.2fs\n", i + 1, ChannelCount, Duration, (float) DurationInMS / 1000.0f);
+                ::fprintf(Output, "Track %2d: %d channels, %8d ticks, %8.2fs\n", i + 1, ChannelCount, Duration, (float) DurationInMS / 1000.0f);
 
                 midi::metadata_table_t MetaData;
 
@@ -93,7 +131,7 @@ void ProcessContainer(midi::container_t & container, bool asStream)
                 {
                     const midi::metadata_item_t & Item = MetaData[j];
 
-                    ::printf("- %8d %s: \"%s\"\n", Item.Timestamp, Item.Name.c_str(), msc::TextToUTF8(Item.Value.c_str()).c_str());
+                    ::fprintf(Output, "- %8d %s: \"%s\"\n", Item.Timestamp, Item.Name.c_str(), msc::TextToUTF8(Item.Value.c_str()).c_str());
                 }
             }
         }
@@ -101,8 +139,8 @@ void ProcessContainer(midi::container_t & container, bool asStream)
         uint32_t LoopBegin = container.GetLoopBeginTimestamp(0);
         uint32_t LoopEnd   =  container.GetLoopEndTimestamp(0);
 
-        ::printf("Loop Begin: %d ticks\n", LoopBegin);
-        ::printf("Loop End  : %d ticks\n", LoopEnd);
+        ::fprintf(Output, "Loop Begin: %d ticks\n", LoopBegin);
+        ::fprintf(Output, "Loop End  : %d ticks\n", LoopEnd);
 
         std::vector<midi::message_t> Stream;
         midi::sysex_table_t SysExMap;
@@ -1,5 +1,5 @@
 
-/** $VER: Stream.cpp (2026.04.10) P. Stuer **/
+/** $VER: Stream.cpp (2026.10.19) P. Stuer **/
 
 #include "pch.h"
 
@@ -7,14 +7,15 @@
 #include "MIDIContainer.h"
 
 #include "Messages.h"
+#include "Output.h"
 #include "SysEx.h"
 
 using namespace midi;
 
-static uint8_t CCMSB = 255; // Control Change Most Significant Byte
-static uint8_t CCLSB = 255; // Control Change Least Significant Byte
+static thread_local uint8_t CCMSB = 255; // Control Change Most Significant Byte
+static thread_local uint8_t CCLSB = 255; // Control Change Least Significant Byte
 
-static uint8_t DELSB = 0;
+static thread_local uint8_t DELSB = 0;
 
 static uint32_t ProcessEvent(const midi::message_t & message, uint32_t messageTimeInMS, uint32_t timestamp, size_t index, const midi::sysex_table_t & sysExMap);
 
@@ -25,7 +26,11 @@ void ProcessStream(const midi::container_t & container, const std::vector<midi::
 {
     const uint32_t SubsongIndex = 0;
 
-    ::printf("%u messages, %u unique SysEx messages, %u ports\n", (uint32_t) stream.size(), (uint32_t) sysExMap.Size(), (uint32_t) portNumbers.size());
+    // Start each file without a selected parameter so that the dump does not depend on the previous file handled by this thread.
+    CCMSB = CCLSB = 255;
+    DELSB = 0;
+
+    ::fprintf(Output, "%u messages, %u unique SysEx messages, %u ports\n", (uint32_t) stream.size(), (uint32_t) sysExMap.Size(), (uint32_t) portNumbers.size());
 
     uint32_t Time = std::numeric_limits<uint32_t>::max();
     size_t i = 0;
@@ -64,7 +69,7 @@ static uint32_t ProcessEvent(const midi::message_t & message, uint32_t messageTi
         else
             Display1[0] = Display2[0] = Display3[0] = '\0';
 
-        ::printf("%8d %-14s %-10s %-8s ", (int) index, Display1, Display2, Display3);
+        ::fprintf(Output, "%8d %-14s %-10s %-8s ", (int) index, Display1, Display2, Display3);
     }
 
     // MIDI Event
@@ -77,48 +82,48 @@ static uint32_t ProcessEvent(const midi::message_t & message, uint32_t messageTi
             (uint8_t) (message.Data >> 16)
         };
 
-        const uint8_t StatusCode = (const uint8_t) (Event[0] & 0xF0u);
+        const uint8_t StatusCode = (uint8_t) (Event[0] & 0xF0u);
 
         const uint32_t EventSize = (uint32_t) ((StatusCode >= midi::TimingClock   && StatusCode <= midi::MetaData) ? 1 :
                                               ((StatusCode == midi::ProgramChange || StatusCode == midi::ChannelPressure) ? 2 : 3));
 
         uint8_t PortNumber = (message.Data >> 24) & 0x7F;
 
-        ::printf("%02X", Event[0]);
+        ::fprintf(Output, "%02X", Event[0]);
 
         if (EventSize > 1)
         {
-            ::printf(" %02X", (int) Event[1]);
+            ::fprintf(Output, " %02X", (int) Event[1]);
 
             if (EventSize > 2)
-                ::printf(" %02X", (int) Event[2]);
+                ::fprintf(Output, " %02X", (int) Event[2]);
             else
-                ::printf("   ");
+                ::fprintf(Output, "   ");
         }
         else
-            ::printf("      ");
+            ::fprintf(Output, "      ");
 
         int Channel = (Event[0] & 0x0F) + 1;
 
-        ::printf(" Port %d, Channel %2d, ", PortNumber, Channel);
+        ::fprintf(Output, " Port %d, Channel %2d, ", PortNumber, Channel);
 
         switch (StatusCode)
         {
             case midi::NoteOff:
-                ::printf("Note Off                        %3d, Velocity %3d\n", Event[1], Event[2]);
+                ::fprintf(Output, "Note Off                        %3d, Velocity %3d\n", Event[1], Event[2]);
                 break;
 
             case midi::NoteOn:
-                ::printf("Note On                         %3d, Velocity %3d\n", Event[1], Event[2]);
+                ::fprintf(Output, "Note On                         %3d, Velocity %3d\n", Event[1], Event[2]);
                 break;
 
             case midi::KeyPressure:
-                ::printf("Key Pressure (Aftertouch)       %3d\n", Event[1]);
+                ::fprintf(Output, "Key Pressure (Aftertouch)       %3d\n", Event[1]);
                 break;
 
             case midi::ControlChange:
             {
-                ::printf("Control Change                  %3d %3d \"%s\"\n", Event[1], Event[2], DescribeControlChange(Event[1], Event[2]).c_str());
+                ::fprintf(Output, "Control Change                  %3d %3d \"%s\"\n", Event[1], Event[2], DescribeControlChange(Event[1], Event[2]).c_str());
 
                 if (Event[1] == 98)     // Non-Registered Parameter LSB
                     CCLSB = Event[2];
@@ -144,13 +149,13 @@ static uint32_t ProcessEvent(const midi::message_t & message, uint32_t messageTi
                         int Value = (Event[2] << 7) | DELSB;
 
                         if (Event[1] == 6)      // Data Entry
-                            ::printf("Set RPN 0x%04X to %3d\n", RPN, Value);
+                            ::fprintf(Output, "Set RPN 0x%04X to %3d\n", RPN, Value);
                         else
                         if (Event[1] == 96)
-                            ::printf("Increment RPN 0x%04X by %3d\n", RPN, Value);
+                            ::fprintf(Output, "Increment RPN 0x%04X by %3d\n", RPN, Value);
                         else
                         if (Event[1] == 97)
-                            ::printf("Decrement RPN 0x%04X by %3d\n", RPN, Value);
+                            ::fprintf(Output, "Decrement RPN 0x%04X by %3d\n", RPN, Value);
 
                         CCMSB = CCLSB = 255;
                         DELSB = 0;
@@ -160,67 +165,67 @@ static uint32_t ProcessEvent(const midi::message_t & message, uint32_t messageTi
             }
 
             case midi::ProgramChange:
-                ::printf("Program Change                  %3d     \"%s\"\n", Event[1], Instruments[Event[1]]);;
+                ::fprintf(Output, "Program Change                  %3d     \"%s\"\n", Event[1], Instruments[Event[1]]);;
                 break;
 
             case midi::ChannelPressure:
-                ::printf("Channel Pressure (Aftertouch)   %3d\n", Event[1]);
+                ::fprintf(Output, "Channel Pressure (Aftertouch)   %3d\n", Event[1]);
                 break;
 
             case midi::PitchBendChange:
-                ::printf("Pitch Bend Change             %5d\n", 8192 - ((int) (Event[2] & 0x7F) << 7) | (Event[1] & 0x7F));
+                ::fprintf(Output, "Pitch Bend Change             %5d\n", (((int) (Event[2] & 0x7F) << 7) | (Event[1] & 0x7F)) - 8192);
                 break;
 
             case midi::SysEx:
-                ::puts("SysEx");
+                ::fputs("SysEx\n", Output);
                 break;
 
             case midi::MIDITimeCodeQtrFrame:
-                ::puts("MIDI Time Code Qtr Frame");
+                ::fputs("MIDI Time Code Qtr Frame\n", Output);
                 break;
 
             case midi::SongPositionPointer:
-                ::puts("Song Position Pointer");
+                ::fputs("Song Position Pointer\n", Output);
                 break;
 
             case midi::SongSelect:
-                ::puts("Song Select");
+                ::fputs("Song Select\n", Output);
                 break;
 
             case midi::TuneRequest:
-                ::puts("Tune Request");
+                ::fputs("Tune Request\n", Output);
                 break;
 
             case midi::SysExEnd:
-                ::puts("SysEx End");
+                ::fputs("SysEx End\n", Output);
                 break;
 
             case midi::TimingClock:
-                ::puts("Timing Clock");
+                ::fputs("Timing Clock\n", Output);
                 break;
 
             case midi::Start:
-                ::puts("Start");
+                ::fputs("Start\n", Output);
                 break;
 
             case midi::Continue:
-                ::puts("Continue");
+                ::fputs("Continue\n", Output);
                 break;
 
             case midi::Stop:
-                ::puts("Stop");
+                ::fputs("Stop\n", Output);
                 break;
 
             case midi::ActiveSensing:
-                ::puts("Active Sensing");
+                ::fputs("Active Sensing\n", Output);
                 break;
 
             case midi::MetaData:
-                ::puts("Meta Data");
+                ::fputs("Meta Data\n", Output);
                 break;
 
             default:
-                ::printf("<Unknown Status Code: 0x%02X>\n", StatusCode);
+                ::fprintf(Output, "<Unknown Status Code: 0x%02X>\n", StatusCode);
         }
     }
     // SysEx Index
@@ -236,25 +241,25 @@ static uint32_t ProcessEvent(const midi::message_t & message, uint32_t messageTi
 
         // Show the message in the output.
         {
-            ::printf("SysEx");
+            ::fprintf(Output, "SysEx");
 
             for (size_t j = 0; j < MessageSize; ++j)
-                ::printf(" %02X", MessageData[j]);
+                ::fprintf(Output, " %02X", MessageData[j]);
         }
 
-        ::printf(" Port %d", Port);
+        ::fprintf(Output, " Port %d", Port);
 
         // Identify the SysEx message.
         if (MessageSize > 2)
         {
-            sysex_t SysEx(MessageData, MessageSize);
+            static thread_local sysex_cache_t Cache;
 
-            SysEx.Identify();
+            const sysex_t & SysEx = Cache.Identify({ MessageData, MessageSize });
 
-            ::printf(", \"%s\", \"%s\", \"%s\", \"%s\"", SysEx.Manufacturer.c_str(), SysEx.Model.c_str(), SysEx.Command.c_str(), SysEx.Description.c_str());
+            ::fprintf(Output, ", \"%s\", \"%s\", \"%s\", \"%s\"", SysEx.Manufacturer.c_str(), SysEx.Model.c_str(), SysEx.Command.c_str(), SysEx.Description.c_str());
         }
 
-        ::putchar('\n');
+        ::fputc('\n', Output);
     }
 
     return message.Time;
@@ -1,11 +1,12 @@
 
-/** $VER: Tracks.cpp (2025.09.10) P. Stuer **/
+/** $VER: Tracks.cpp (2026.10.19) P. Stuer **/
 
 #include "pch.h"
 
 #include "MIDIProcessor.h"
 
 #include "Messages.h"
+#include "Output.h"
 #include "SysEx.h"
 #include "Tables.h"
 
@@ -16,79 +17,79 @@ using namespace midi;
 /// </summary>
 static void ProcessMetaData(const midi::event_t & me) noexcept
 {
-    ::printf("Meta Data                    ");
+    ::fprintf(Output, "Meta Data                    ");
 
     switch (me.Data[1])
     {
         case midi::MetaDataType::SequenceNumber:
         {
-            ::printf(" Sequence Number");
+            ::fprintf(Output, " Sequence Number");
             break;
         }
 
         case midi::MetaDataType::Text:
         {
-            ::printf(" Text \"%s\"", (me.Data.size() > 2) ? msc::TextToUTF8((const char *) me.Data.data() + 2, me.Data.size() - 2).c_str() : "");
+            ::fprintf(Output, " Text \"%s\"", (me.Data.size() > 2) ? msc::TextToUTF8((const char *) me.Data.data() + 2, me.Data.size() - 2).c_str() : "");
             break;
         }
 
         case midi::MetaDataType::Copyright:
         {
-            ::printf(" Copyright \"%s\"", (me.Data.size() > 2) ? msc::TextToUTF8((const char *) me.Data.data() + 2, me.Data.size() - 2).c_str() : "");
+            ::fprintf(Output, " Copyright \"%s\"", (me.Data.size() > 2) ? msc::TextToUTF8((const char *) me.Data.data() + 2, me.Data.size() - 2).c_str() : "");
             break;
         }
 
         case midi::MetaDataType::TrackName:
         {
-            ::printf(" Track Name \"%s\"", (me.Data.size() > 2) ? msc::TextToUTF8((const char *) me.Data.data() + 2, me.Data.size() - 2).c_str() : "");
+            ::fprintf(Output, " Track Name \"%s\"", (me.Data.size() > 2) ? msc::TextToUTF8((const char *) me.Data.data() + 2, me.Data.size() - 2).c_str() : "");
             break;
         }
 
         case midi::MetaDataType::InstrumentName:
         {
-            ::printf(" Instrument Name \"%s\"", (me.Data.size() > 2) ? msc::TextToUTF8((const char *) me.Data.data() + 2, me.Data.size() - 2).c_str() : "");
+            ::fprintf(Output, " Instrument Name \"%s\"", (me.Data.size() > 2) ? msc::TextToUTF8((const char *) me.Data.data() + 2, me.Data.size() - 2).c_str() : "");
             break;
         }
 
         case midi::MetaDataType::Lyrics:
         {
-            ::printf(" Lyrics \"%s\"", (me.Data.size() > 2) ? msc::TextToUTF8((const char *) me.Data.data() + 2, me.Data.size() - 2).c_str() : "");
+            ::fprintf(Output, " Lyrics \"%s\"", (me.Data.size() > 2) ? msc::TextToUTF8((const char *) me.Data.data() + 2, me.Data.size() - 2).c_str() : "");
             break;
         }
 
         case midi::MetaDataType::Marker:
         {
-            ::printf(" Marker \"%s\"", (me.Data.size() > 2) ? msc::TextToUTF8((const char *) me.Data.data() + 2, me.Data.size() - 2).c_str() : "");
+            ::fprintf(Output, " Marker \"%s\"", (me.Data.size() > 2) ? msc::TextToUTF8((const char *) me.Data.data() + 2, me.Data.size() - 2).c_str() : "");
             break;
         }
 
         case midi::MetaDataType::CueMarker:
         {
-            ::printf(" Cue Marker \"%s\"", (me.Data.size() > 2) ? msc::TextToUTF8((const char *) me.Data.data() + 2, me.Data.size() - 2).c_str() : "");
+            ::fprintf(Output, " Cue Marker \"%s\"", (me.Data.size() > 2) ? msc::TextToUTF8((const char *) me.Data.data() + 2, me.Data.size() - 2).c_str() : "");
             break;
         }
 
         case midi::MetaDataType::DeviceName:
         {
-            ::printf(" Device Name \"%s\"", (me.Data.size() > 2) ? msc::TextToUTF8((const char *) me.Data.data() + 2, me.Data.size() - 2).c_str() : "");
+            ::fprintf(Output, " Device Name \"%s\"", (me.Data.size() > 2) ? msc::TextToUTF8((const char *) me.Data.data() + 2, me.Data.size() - 2).c_str() : "");
             break;
         }
 
         case midi::MetaDataType::ChannelPrefix:
         {
-            ::printf(" Channel Prefix");
+            ::fprintf(Output, " Channel Prefix");
             break;
         }
 
         case midi::MetaDataType::MIDIPort:
         {
-            ::printf(" Set MIDI Port %d", me.Data[2]);
+            ::fprintf(Output, " Set MIDI Port %d", me.Data[2]);
             break;
         }
 
         case midi::MetaDataType::EndOfTrack:
         {
-            ::printf(" End of Track");
+            ::fprintf(Output, " End of Track");
             break;
         }
 
@@ -96,19 +97,19 @@ static void ProcessMetaData(const midi::event_t & me) noexcept
         {
             const uint32_t Tempo = ((uint32_t) me.Data[2] << 16) | ((uint32_t) me.Data[3] << 8) | (uint32_t) me.Data[4];
 
-            ::printf(" Set Tempo (%d μs/quarter note, %d bpm)", Tempo, (int) ((60 * 1000 * 1000) / Tempo));
+            ::fprintf(Output, " Set Tempo (%d μs/quarter note, %d bpm)", Tempo, (int) ((60 * 1000 * 1000) / Tempo));
             break;
         }
 
         case midi::MetaDataType::SMPTEOffset:
         {
-            ::printf(" Set SMPTE Offset");
+            ::fprintf(Output, " Set SMPTE Offset");
             break;
         }
 
         case midi::MetaDataType::TimeSignature:
         {
-            ::printf(" Time Signature %d/%d, %d ticks per beat, %d 32nd notes per MIDI quarter note", me.Data[2], 1 << me.Data[3], me.Data[4], me.Data[5]);
+            ::fprintf(Output, " Time Signature %d/%d, %d ticks per beat, %d 32nd notes per MIDI quarter note", me.Data[2], 1 << me.Data[3], me.Data[4], me.Data[5]);
             break;
         }
 
@@ -156,13 +157,13 @@ static void ProcessMetaData(const midi::event_t & me) noexcept
                 "A#", "B#", "C#", "D#", "E#", "F#", "G#",   // 7 sharps
             };
 
-            ::printf(" Key Signature %s %s", (me.Data[3] == 0) ? MajorScales[49 + (((char) me.Data[2]) * 7)] : MinorScales[49 + (((char) me.Data[2]) * 7)], (me.Data[3] == 0) ? "major" : "minor");
+            ::fprintf(Output, " Key Signature %s %s", (me.Data[3] == 0) ? MajorScales[49 + (((char) me.Data[2]) * 7)] : MinorScales[49 + (((char) me.Data[2]) * 7)], (me.Data[3] == 0) ? "major" : "minor");
             break;
         }
 
         case midi::MetaDataType::SequencerSpecific:
         {
-            ::printf(" Sequencer Specific (%d bytes)", (int) me.Data.size() - 2);
+            ::fprintf(Output, " Sequencer Specific (%d bytes)", (int) me.Data.size() - 2);
             break;
         }
 
@@ -174,19 +175,19 @@ static void ProcessMetaData(const midi::event_t & me) noexcept
 /// <summary>
 /// Processes a SysEx message.
 /// </summary>
-static void ProcessSysEx(const midi::event_t & me) noexcept
+static void ProcessSysEx(const midi::event_t & me)
 {
-    sysex_t SysEx(me.Data);
+    static thread_local sysex_cache_t Cache;
 
-    SysEx.Identify();
+    const sysex_t & SysEx = Cache.Identify(me.Data);
 
-    ::printf(" \"%s\", \"%s\"", SysEx.Manufacturer.c_str(), SysEx.Description.c_str());
+    ::fprintf(Output, " \"%s\", \"%s\"", SysEx.Manufacturer.c_str(), SysEx.Description.c_str());
 }
 
 /// <summary>
 /// Processes MIDI events.
 /// </summary>
-static uint32_t ProcessEvent(const midi::event_t & event, uint32_t eventTimeInMS, uint32_t time, size_t index) noexcept
+static uint32_t ProcessEvent(const midi::event_t & event, uint32_t eventTimeInMS, uint32_t time, size_t index)
 {
     // Output the header.
     {
@@ -207,13 +208,13 @@ static uint32_t ProcessEvent(const midi::event_t & event, uint32_t eventTimeInMS
             Display1[0] = Display2[0] = Display3[0] = '\0';
 
         if (event.Type != midi::event_t::event_type_t::Extended)
-            ::printf("%8d %-14s %-10s  %-8s  (%2d) ", (int) index, Display1, Display2, Display3, event.ChannelNumber + 1);
+            ::fprintf(Output, "%8d %-14s %-10s  %-8s  (%2d) ", (int) index, Display1, Display2, Display3, event.ChannelNumber + 1);
         else
-            ::printf("%8d %-14s %-10s  %-8s       ", (int) index, Display1, Display2, Display3);
+            ::fprintf(Output, "%8d %-14s %-10s  %-8s       ", (int) index, Display1, Display2, Display3);
     }
 
     if (event.Type != midi::event_t::event_type_t::Extended)
-        ::printf(" %02X", (event.Type + 8) << 4);
+        ::fprintf(Output, " %02X", (event.Type + 8) << 4);
 
     const int ByteCount = 16;
 
@@ -222,61 +223,61 @@ static uint32_t ProcessEvent(const midi::event_t & event, uint32_t eventTimeInMS
     for (const auto & d : event.Data)
     {
         if (i++ < ByteCount)
-            ::printf(" %02X", d);
+            ::fprintf(Output, " %02X", d);
         else
         {
-            ::printf(" ..");
+            ::fprintf(Output, " ..");
             break;
         }
     }
 
     if (event.Type == midi::event_t::event_type_t::Extended)
-        ::printf("   ");
+        ::fprintf(Output, "   ");
 
-    ::printf("%*.s", std::max(0, (ByteCount - (int) event.Data.size()) * 3), "");
+    ::fprintf(Output, "%*.s", std::max(0, (ByteCount - (int) event.Data.size()) * 3), "");
 
-    ::putchar(' ');
+    ::fputc(' ', Output);
 
     switch (event.Type)
     {
         case midi::event_t::event_type_t::NoteOff:
         {
-            ::printf("Note Off                      Note %3d, Velocity %3d", event.Data[0], event.Data[1]);
+            ::fprintf(Output, "Note Off                      Note %3d, Velocity %3d", event.Data[0], event.Data[1]);
             break;
         }
 
         case midi::event_t::event_type_t::NoteOn:
         {
-            ::printf("Note On                       Note %3d, Velocity %3d", event.Data[0], event.Data[1]);
+            ::fprintf(Output, "Note On                       Note %3d, Velocity %3d", event.Data[0], event.Data[1]);
             break;
         }
 
         case midi::event_t::event_type_t::KeyPressure:
         {
-            ::printf("Key Pressure                  A0");
+            ::fprintf(Output, "Key Pressure                  A0");
             break;
         }
 
         case midi::event_t::event_type_t::ControlChange:
         {
-            ::printf("Control Change %3d            %s", event.Data[0], DescribeControlChange(event.Data[0], event.Data[1]).c_str()); break;
+            ::fprintf(Output, "Control Change %3d            %s", event.Data[0], DescribeControlChange(event.Data[0], event.Data[1]).c_str()); break;
         }
 
         case midi::event_t::event_type_t::ProgramChange:
         {
-            ::printf("Program Change %3d            \"%s\"", event.Data[0], Instruments[event.Data[0]]); break;
+            ::fprintf(Output, "Program Change %3d            \"%s\"", event.Data[0], Instruments[event.Data[0]]); break;
             break;
         }
 
         case midi::event_t::event_type_t::ChannelPressure:
         {
-            ::printf("Channel Pressure              D0");
+            ::fprintf(Output, "Channel Pressure              D0");
             break;
         }
 
         case midi::event_t::event_type_t::PitchBendChange:
         {
-            ::printf("Pitch Bend Change             %d", 8192 - ((int) (event.Data[1] & 0x7F) << 7) | (event.Data[0] & 0x7F));
+            ::fprintf(Output, "Pitch Bend Change             %d", (((int) (event.Data[1] & 0x7F) << 7) | (event.Data[0] & 0x7F)) - 8192);
             break;
         }
 
@@ -284,31 +285,31 @@ static uint32_t ProcessEvent(const midi::event_t & event, uint32_t eventTimeInMS
         {
             switch (event.Data[0])
             {
-                case midi::SysEx:                ::printf("SysEx                        "); ProcessSysEx(event); break;
+                case midi::SysEx:                ::fprintf(Output, "SysEx                        "); ProcessSysEx(event); break;
 
-                case midi::MIDITimeCodeQtrFrame: ::printf("MIDI Time Code Qtr Frame     "); break;
-                case midi::SongPositionPointer:  ::printf("Song PositionPointer         "); break;
-                case midi::SongSelect:           ::printf("Song Select                  "); break;
+                case midi::MIDITimeCodeQtrFrame: ::fprintf(Output, "MIDI Time Code Qtr Frame     "); break;
+                case midi::SongPositionPointer:  ::fprintf(Output, "Song PositionPointer         "); break;
+                case midi::SongSelect:           ::fprintf(Output, "Song Select                  "); break;
 
-                case midi::TuneRequest:          ::printf("Tune Request                 "); break;
-                case midi::SysExEnd:             ::printf("SysEx End                    "); break;
-                case midi::TimingClock:          ::printf("Timing Clock                 "); break;
+                case midi::TuneRequest:          ::fprintf(Output, "Tune Request                 "); break;
+                case midi::SysExEnd:             ::fprintf(Output, "SysEx End                    "); break;
+                case midi::TimingClock:          ::fprintf(Output, "Timing Clock                 "); break;
 
-                case midi::Start:                ::printf("Start                        "); break;
-                case midi::Continue:             ::printf("Continue                     "); break;
-                case midi::Stop:                 ::printf("Stop                         "); break;
+                case midi::Start:                ::fprintf(Output, "Start                        "); break;
+                case midi::Continue:             ::fprintf(Output, "Continue                     "); break;
+                case midi::Stop:                 ::fprintf(Output, "Stop                         "); break;
 
-                case midi::ActiveSensing:        ::printf("Active Sensing               "); break;
+                case midi::ActiveSensing:        ::fprintf(Output, "Active Sensing               "); break;
                 case midi::MetaData:             ProcessMetaData(event); break;
 
-                default:                        ::printf("Unknown event type %02X      ", event.Data[0]); break;
+                default:                        ::fprintf(Output, "Unknown event type %02X      ", event.Data[0]); break;
             }
 
             break;
         }
     }
 
-    ::putchar('\n');
+    ::fputc('\n', Output);
 
     return event.Time;
 }
@@ -328,8 +329,8 @@ void ProcessTracks(const midi::container_t & container)
         uint32_t Duration = container.GetDuration(SubsongIndex, false);
         uint32_t DurationInMS = container.GetDuration(SubsongIndex, true);
 
-        ::printf("\nTrack %2d: %d channels, %8d ticks, %8.2fs\n", TrackIndex + 1, ChannelCount, Duration, (float) DurationInMS / 1000.0f);
-        ::puts("Index    | Ticks        | Time    | Time     | Ch | Data");
+        ::fprintf(Output, "\nTrack %2d: %d channels, %8d ticks, %8.2fs\n", TrackIndex + 1, ChannelCount, Duration, (float) DurationInMS / 1000.0f);
+        ::fputs("Index    | Ticks        | Time    | Time     | Ch | Data\n", Output);
 
         uint32_t Time = std::numeric_limits<uint32_t>::max();
         size_t i = 0;
@@ -1,17 +1,40 @@
 
-/** $VER: main.cpp (2026.05.03) P. Stuer **/
+/** $VER: main.cpp (2026.10.19) P. Stuer **/
 
 #include "pch.h"
 
-void ExamineFile(const fs::path & filePath, const std::map<std::string, std::string> & args);
+#include "MIDIContainer.h"
 
-static void ProcessDirectory(const fs::path & directoryPath);
-static void ProcessFile(const fs::path & filePath);
+#include "Output.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+/// <summary>
+/// Represents the result of dumping a file.
+/// </summary>
+struct file_result_t
+{
+    bool IsProcessed;
+    midi::FileFormat FileFormat;
+    uint64_t Size;          // in bytes
+    double Duration;        // in s
+};
+
+midi::FileFormat ExamineFile(const fs::path & filePath, const std::map<std::string, std::string> & args);
+
+static void ProcessDirectory(const fs::path & directoryPath, std::vector<fs::path> & filePaths);
+static void ProcessFiles(const std::vector<fs::path> & filePaths, size_t jobCount);
+static file_result_t ProcessFile(const fs::path & filePath);
+static void PrintSummary(const std::vector<file_result_t> & results, double duration, size_t jobCount);
 
 const std::vector<fs::path> Filters = { ".mmd", ".mid", ".g36", ".rmi", ".mxmf", ".xmf", ".mmf", ".tst" };
 
 std::map<std::string, std::string> Arguments;
 
+thread_local FILE * Output = stdout;
+
 int main(int argc, const char ** argv)
 {
     ::printf("\xEF\xBB\xBF"); // UTF-8 BOM
@@ -29,9 +52,22 @@ int main(int argc, const char ** argv)
         {
             if (::_stricmp(argv[i], "-stream") == 0)
                 Arguments["AsStream"] = "";
+            else
+            if (::_stricmp(argv[i], "-verbose") == 0)
+                Arguments["Verbose"] = "";
+            else
+            if (::_strnicmp(argv[i], "-j", 2) == 0)
+            {
+                // -j N or -jN: Number of worker threads. 0 uses one thread per logical processor.
+                if (argv[i][2] != '\0')
+                    Arguments["Jobs"] = argv[i] + 2;
+                else
+                if (i + 1 < argc)
+                    Arguments["Jobs"] = argv[++i];
+            }
         }
-
-        Arguments["midifile"] = argv[i];
+        else
+            Arguments["midifile"] = argv[i];
     }
 
     if (!::fs::exists(Arguments["midifile"]))
@@ -43,10 +79,24 @@ int main(int argc, const char ** argv)
 
     fs::path Path = fs::canonical(Arguments["midifile"]);
 
+    std::vector<fs::path> FilePaths;
+
     if (fs::is_directory(Path))
-        ProcessDirectory(Path);
+        ProcessDirectory(Path, FilePaths);
     else
-        ProcessFile(Path);
+        FilePaths.push_back(Path);
+
+    size_t JobCount = 1;
+
+    if (Arguments.contains("Jobs"))
+    {
+        JobCount = (size_t) ::strtoul(Arguments["Jobs"].c_str(), nullptr, 10);
+
+        if (JobCount == 0)
+            JobCount = (std::max)(std::thread::hardware_concurrency(), 1u);
+    }
+
+    ProcessFiles(FilePaths, JobCount);
 
     return 0;
 }
@@ -66,9 +116,9 @@ static bool IsOneOf(const fs::path & item, const std::vector<fs::path> & list) n
 }
 
 /// <summary>
-///
+/// Adds the files in the directory and its subdirectories that have a supported extension to the list.
 /// </summary>
-static void ProcessDirectory(const fs::path & directoryPath)
+static void ProcessDirectory(const fs::path & directoryPath, std::vector<fs::path> & filePaths)
 {
     ::printf("\"%s\"\n", directoryPath.string().c_str());
 
@@ -76,21 +126,93 @@ static void ProcessDirectory(const fs::path & directoryPath)
     {
         if (Entry.is_directory())
         {
-            ProcessDirectory(Entry.path());
+            ProcessDirectory(Entry.path(), filePaths);
         }
         else
         if (IsOneOf(Entry.path().extension(), Filters))
         {
-            ProcessFile(Entry.path());
+            filePaths.push_back(Entry.path());
         }
     }
 }
 
 /// <summary>
-///
+/// Dumps the files using the specified number of threads and prints a summary.
+/// </summary>
+static void ProcessFiles(const std::vector<fs::path> & filePaths, size_t jobCount)
+{
+    std::vector<file_result_t> Results(filePaths.size());
+
+    std::atomic<size_t> Next = 0;
+
+    auto Worker = [&]()
+    {
+        for (size_t i = Next++; i < filePaths.size(); i = Next++)
+        {
+            try
+            {
+                Results[i] = ProcessFile(filePaths[i]);
+            }
+            catch (std::exception & e)
+            {
+                ::fprintf(stderr, "Failed to process \"%s\": %s\n", filePaths[i].string().c_str(), e.what());
+            }
+        }
+    };
+
+    const auto StartTime = std::chrono::steady_clock::now();
+
+    jobCount = (std::min)(jobCount, filePaths.size());
+
+    std::vector<std::thread> Threads;
+
+    for (size_t i = 1; i < jobCount; ++i)
+        Threads.emplace_back(Worker);
+
+    Worker();
+
+    for (auto & Thread : Threads)
+        Thread.join();
+
+    const double Duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count();
+
+    PrintSummary(Results, Duration, (std::max)(jobCount, (size_t) 1));
+}
+
+/// <summary>
+/// Redirects the output of the calling thread to a file and closes it, also when dumping the file throws.
+/// </summary>
+class output_file_t
+{
+public:
+    output_file_t(FILE * fp) noexcept : _fp(fp)
+    {
+        Output = _fp;
+    }
+
+    output_file_t(const output_file_t &) = delete;
+    output_file_t & operator=(const output_file_t &) = delete;
+
+    ~output_file_t() noexcept
+    {
+        Output = stdout;
+
+        ::fclose(_fp);
+    }
+
+private:
+    FILE * _fp;
+};
+
+/// <summary>
+/// Dumps a file to a .log file next to it. The dump is written to a buffered file of the calling thread so that files can be processed in parallel.
 /// </summary>
-static void ProcessFile(const fs::path & filePath)
+static file_result_t ProcessFile(const fs::path & filePath)
 {
+    file_result_t Result = { };
+
+    Result.FileFormat = midi::FileFormat::Unknown;
+
     fs::path FilePath = filePath;
 
     FilePath.replace_extension(".log");
@@ -99,21 +221,76 @@ static void ProcessFile(const fs::path & filePath)
 
     FILE * fp = nullptr;
 
-    if ((::freopen_s(&fp, FilePath.string().c_str(), "w", stdout) != 0) || (fp == nullptr))
-        return;
+    if ((::fopen_s(&fp, FilePath.string().c_str(), "w") != 0) || (fp == nullptr))
+        return Result;
 
-    ::printf("\xEF\xBB\xBF"); // UTF-8 BOM
+    (void) ::setvbuf(fp, nullptr, _IOFBF, 64 * 1024);
+
+    const auto StartTime = std::chrono::steady_clock::now();
+
+    {
+        output_file_t OutputFile(fp);
+
+        ::fprintf(Output, "\xEF\xBB\xBF"); // UTF-8 BOM
+
+        Result.Size = (uint64_t) fs::file_size(filePath);
+
+        ::fprintf(Output, "\n\"%s\", %" PRIu64 " bytes\n", filePath.string().c_str(), Result.Size);
+
+        Result.FileFormat = ExamineFile(filePath, Arguments);
+    }
+
+    Result.Duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count();
+    Result.IsProcessed = true;
+
+    return Result;
+}
+
+/// <summary>
+/// Prints the throughput and the time spent per file format.
+/// </summary>
+static void PrintSummary(const std::vector<file_result_t> & results, double duration, size_t jobCount)
+{
+    static const char * FormatNames[] = { "SMF", "RMI", "XMI", "XFM", "MDS", "HMP", "HMI", "MUS", "LDS", "GMF", "RCP", "XMF", "MMF", "MMD", "SYX", "TST" };
 
-    auto FileSize = fs::file_size(filePath);
+    struct format_stats_t
+    {
+        size_t Count;
+        uint64_t Size;
+        double Duration;
+    };
 
-    ::printf("\n\"%s\", %" PRIu64 " bytes\n", filePath.string().c_str(), (uint64_t) FileSize);
+    std::map<int, format_stats_t> Formats;
 
-    ExamineFile(filePath, Arguments);
+    size_t FileCount = 0;
+    uint64_t Size = 0;
 
-    ::fflush(fp);
+    for (const auto & Result : results)
+    {
+        if (!Result.IsProcessed)
+            continue;
 
-    ::fclose(fp);
+        ++FileCount;
+        Size += Result.Size;
 
-    if ((::freopen_s(&fp, "CON", "w", stdout) != 0) || (fp == nullptr))
-        return;
+        auto & Stats = Formats[(int) Result.FileFormat];
+
+        ++Stats.Count;
+        Stats.Size += Result.Size;
+        Stats.Duration += Result.Duration;
+    }
+
+    const double Seconds = (std::max)(duration, 1e-9);
+
+    ::printf("\n%zu of %zu files, %" PRIu64 " bytes in %.2f s using %zu threads: %.1f files/s, %.2f MB/s\n",
+        FileCount, results.size(), Size, duration, jobCount, (double) FileCount / Seconds, (double) Size / Seconds / (1024. * 1024.));
+
+    ::printf("\nFormat     Files          Bytes   Time (s)   Avg (ms)\n");
+
+    for (const auto & [Format, Stats] : Formats)
+    {
+        const char * Name = ((Format >= 0) && ((size_t) Format < _countof(FormatNames))) ? FormatNames[Format] : "Unknown";
+
+        ::printf("%-7s %8zu %14" PRIu64 " %10.2f %10.3f\n", Name, Stats.Count, Stats.Size, Stats.Duration, Stats.Duration * 1000. / (double) Stats.Count);
+    }
 }
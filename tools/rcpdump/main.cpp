@@ -1,14 +1,15 @@
 
-/** $VER: main.cpp (2025.03.21) P. Stuer **/
+/** $VER: main.cpp (2026.10.19) P. Stuer **/
 
 #include "pch.h"
 
-static void ProcessDirectory(const WCHAR * directoryPath, const WCHAR * searchPattern);
-static void ProcessFile(const WCHAR * filePath, uint64_t fileSize);
+static void ProcessDirectory(const fs::path & directoryPath, const std::wstring & searchPattern);
+static void ProcessFile(const fs::path & filePath, uint64_t fileSize);
+static bool MatchesPattern(const wchar_t * name, const wchar_t * pattern) noexcept;
 
 int rcpmain(int argc, wchar_t * argv[]);
 
-const WCHAR * Filters[] = { L".rcp", L".r36", L".g18", L".g36", L".cm6", L".gsd" };
+const wchar_t * Filters[] = { L".rcp", L".r36", L".g18", L".g36", L".cm6", L".gsd" };
 
 int wmain(int argc, wchar_t * argv[])
 {
@@ -17,108 +18,95 @@ int wmain(int argc, wchar_t * argv[])
 
     ::printf("\xEF\xBB\xBF"); // UTF-8 BOM
 
-    if (!::PathFileExistsW(argv[1]))
-    {
-        ::printf("Failed to access \"%s\": path does not exist.\n", msc::WideToUTF8(argv[1]).c_str());
-        return -1;
-    }
+    std::error_code ec;
 
-    WCHAR DirectoryPath[MAX_PATH];
+    const fs::path Path(argv[1]);
 
-    if (::GetFullPathNameW(argv[1], _countof(DirectoryPath), DirectoryPath, nullptr) == 0)
+    if (!fs::is_directory(Path, ec))
     {
-        ::printf("Failed to expand \"%s\": Error %u.\n", msc::WideToUTF8(argv[1]).c_str(), (uint32_t) ::GetLastError());
-        return -1;
-    }
+        // The last path component can be a search pattern, e.g. "*.rcp".
+        const fs::path DirectoryPath = fs::absolute(Path, ec).parent_path();
 
-    if (!::PathIsDirectoryW(argv[1]))
-    {
-        ::PathCchRemoveFileSpec(DirectoryPath, _countof(DirectoryPath));
+        if (!fs::exists(DirectoryPath, ec))
+        {
+            ::printf("Failed to access \"%s\": path does not exist.\n", msc::WideToUTF8(argv[1]).c_str());
+            return -1;
+        }
 
-        ProcessDirectory(DirectoryPath, ::PathFindFileNameW(argv[1]));
+        ProcessDirectory(DirectoryPath, Path.filename().wstring());
     }
     else
-        ProcessDirectory(DirectoryPath, L"*.*");
+        ProcessDirectory(fs::absolute(Path, ec), L"*");
 
     return 0;
 }
 
-static void ProcessDirectory(const WCHAR * directoryPath, const WCHAR * searchPattern)
+/// <summary>
+/// Processes the files in a directory that match the search pattern and the matching subdirectories, in name order.
+/// </summary>
+static void ProcessDirectory(const fs::path & directoryPath, const std::wstring & searchPattern)
 {
-    ::printf("\"%s\"\n", msc::WideToUTF8(directoryPath).c_str());
-
-    WCHAR PathName[MAX_PATH];
-
-    if (!SUCCEEDED(::PathCchCombineEx(PathName, _countof(PathName), directoryPath, searchPattern, PATHCCH_ALLOW_LONG_PATHS)))
-        return;
+    ::printf("\"%s\"\n", msc::WideToUTF8(directoryPath.wstring()).c_str());
 
-    WIN32_FIND_DATA fd = {};
+    std::vector<fs::directory_entry> Entries;
 
-    HANDLE hFind = ::FindFirstFileW(PathName, &fd);
+    std::error_code ec;
 
-    if (hFind == INVALID_HANDLE_VALUE)
-        return;
-
-    BOOL Success = TRUE;
-
-    if (::wcscmp(fd.cFileName, L".") == 0)
+    for (const auto & Entry : fs::directory_iterator(directoryPath, fs::directory_options::skip_permission_denied, ec))
     {
-        Success = ::FindNextFileW(hFind, &fd);
-
-        if (Success && ::wcscmp(fd.cFileName, L"..") == 0)
-            Success = ::FindNextFileW(hFind, &fd);
+        if (MatchesPattern(Entry.path().filename().wstring().c_str(), searchPattern.c_str()))
+            Entries.push_back(Entry);
     }
 
-    while (Success)
-    {
-        if (SUCCEEDED(::PathCchCombineEx(PathName, _countof(PathName), directoryPath, fd.cFileName, PATHCCH_ALLOW_LONG_PATHS)))
-        {
-            if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
-                ProcessDirectory(PathName, searchPattern);
-            else
-            {
-                uint64_t FileSize = (((uint64_t) fd.nFileSizeHigh) << 32) + fd.nFileSizeLow;
-
-                ProcessFile(PathName, FileSize);
-            }
-        }
+    std::sort(Entries.begin(), Entries.end());
 
-        Success = ::FindNextFileW(hFind, &fd);
+    for (const auto & Entry : Entries)
+    {
+        if (Entry.is_directory(ec))
+            ProcessDirectory(Entry.path(), searchPattern);
+        else
+            ProcessFile(Entry.path(), Entry.file_size(ec));
     }
-
-    ::FindClose(hFind);
 }
 
-static void ProcessFile(const WCHAR * filePath, uint64_t fileSize)
+/// <summary>
+/// Converts a file with a supported file extension to a MIDI file in the current directory.
+/// </summary>
+static void ProcessFile(const fs::path & filePath, uint64_t fileSize)
 {
-    ::printf("\n\"%s\", %" PRIu64 " bytes\n", msc::WideToUTF8(filePath).c_str(), fileSize);
-
-    const WCHAR * FileExtension;
+    ::printf("\n\"%s\", %" PRIu64 " bytes\n", msc::WideToUTF8(filePath.wstring()).c_str(), fileSize);
 
-    HRESULT hr = ::PathCchFindExtension(filePath, ::wcslen(filePath) + 1, &FileExtension);
+    const std::wstring FileExtension = filePath.extension().wstring();
 
-    if (SUCCEEDED(hr))
+    for (const auto & Filter : Filters)
     {
-        for (const auto & Filter : Filters)
+        if (::_wcsicmp(FileExtension.c_str(), Filter) == 0)
         {
-            if (::_wcsicmp(FileExtension, Filter) == 0)
-            {
-                WCHAR DstFilePath[MAX_PATH];
+            const std::wstring SrcFilePath = filePath.wstring();
+            const std::wstring DstFileName = fs::path(filePath).replace_extension(L".mid").filename().wstring();
 
-                ::wcscpy_s(DstFilePath, _countof(DstFilePath), filePath);
+            const wchar_t * argv[] = { L"rcp2mid.exe", /*L"-KeepMutedChannels",*/ SrcFilePath.c_str(), DstFileName.c_str() };
 
-                ::PathCchRenameExtension(DstFilePath, _countof(DstFilePath), L"mid");
+            rcpmain(_countof(argv), (wchar_t **) argv);
 
-                const WCHAR * DstFileName = ::PathFindFileNameW(DstFilePath);
+            break;
+        }
+    }
+}
+
+/// <summary>
+/// Matches a file name against a search pattern with '*' and '?' wildcards, ignoring case.
+/// </summary>
+static bool MatchesPattern(const wchar_t * name, const wchar_t * pattern) noexcept
+{
+    if (*pattern == L'\0')
+        return (*name == L'\0');
 
-                {
-                    const wchar_t * argv[] = { L"rcp2mid.exe", /*L"-KeepMutedChannels",*/ filePath, DstFileName /* L"DEADBEEF.mid" */ };
+    if (*pattern == L'*')
+        return MatchesPattern(name, pattern + 1) || ((*name != L'\0') && MatchesPattern(name + 1, pattern));
 
-                    rcpmain(_countof(argv), (wchar_t **) argv);
-                }
+    if ((*name == L'\0') || ((*pattern != L'?') && (std::towlower((wint_t) *pattern) != std::towlower((wint_t) *name))))
+        return false;
 
-                break;
-            }
-        }
-    }
+    return MatchesPattern(name + 1, pattern + 1);
 }
@@ -1,12 +1,15 @@
 
-/** $VER: pch.h (2025.09.06) P. Stuer **/
+/** $VER: pch.h (2026.10.19) P. Stuer **/
 
 #pragma once
 
+#ifdef _MSC_VER
 #include <CppCoreCheck/Warnings.h>
 
 #pragma warning(disable: 4100 4625 4626 4710 4711 4738 5045 ALL_CPPCORECHECK_WARNINGS)
+#endif
 
+#ifdef _WIN32
 #include <SDKDDKVer.h>
 
 #define NOMINMAX
@@ -14,13 +17,15 @@
 #include <winsock2.h>
 #include <windows.h>
 #include <wincodec.h>
-#include <pathcch.h>
-#include <shlwapi.h>
+
+#include <strsafe.h>
+#else
+#include <Compat.h>
+#endif
 
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
-#include <strsafe.h>
 #include <string.h>
 #include <inttypes.h>
 
@@ -29,7 +34,13 @@
 #pragma warning(default: 4242)
 #include <cmath>
 #include <cassert>
+#include <cwctype>
+#include <filesystem>
+#if __has_include(<format>)
 #include <format>
+#else
+#include <Format.h>
+#endif
 #include <fstream>
 #include <functional>
 #include <iostream>
@@ -41,9 +52,6 @@
 
 #include <libmsc.h>
 
-#pragma comment(lib, "pathcch")
-#pragma comment(lib, "shlwapi")
-
 #ifndef Assert
 #if defined(DEBUG) || defined(_DEBUG)
 #define Assert(b) do {if (!(b)) { ::OutputDebugStringA("Assert: " #b "\n");}} while(0)
@@ -55,7 +63,7 @@
 #define TOSTRING_IMPL(x) #x
 #define TOSTRING(x) TOSTRING_IMPL(x)
 
-#ifndef THIS_HINSTANCE
+#if defined(_WIN32) && !defined(THIS_HINSTANCE)
 EXTERN_C IMAGE_DOS_HEADER __ImageBase;
 #define THIS_HINSTANCE ((HINSTANCE) &__ImageBase)
 #endif
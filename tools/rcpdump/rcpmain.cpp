@@ -1,10 +1,10 @@
 
-/** $VER: rcpmain.cpp (2025.09.06) P. Stuer **/
+/** $VER: rcpmain.cpp (2026.10.19) P. Stuer **/
 
 #include "pch.h"
 
 #include "MIDIProcessor.h"
-#include "RCP\RCP.h"
+#include "RCP/RCP.h"
 
 using namespace rcp;
 
@@ -38,7 +38,9 @@ int rcpmain(int argc, wchar_t * argv[])
 
     converter_t RCPConverter;
 
-    converter_options_t & Options = RCPConverter._Options;
+    rcp_options_t & Options = RCPConverter._Options;
+
+    Options.ExpandLoops = true;
 
     int argbase = 1;
 
@@ -51,21 +53,21 @@ int rcpmain(int argc, wchar_t * argv[])
 
                 if (argbase < argc)
                 {
-                    Options._RCPLoopCount = (uint16_t) ::wcstoul(argv[argbase], nullptr, 0);
+                    Options.MaxLoopExpansions = (uint16_t) ::wcstoul(argv[argbase], nullptr, 0);
 
-                    if (Options._RCPLoopCount == 0)
-                        Options._RCPLoopCount = 2;
+                    if (Options.MaxLoopExpansions == 0)
+                        Options.MaxLoopExpansions = 2;
                 }
             }
             else
             if (!::_wcsicmp(argv[argbase] + 1, L"NoLoopExtension"))
-                Options._ExtendLoops = true;
+                Options.ExpandLoops = false;
             else
             if (!::_wcsicmp(argv[argbase] + 1, L"WolfteamLoop"))
-                Options._WolfteamLoopMode = true;
+                Options.WolfteamLoopMode = true;
             else
             if (!::_wcsicmp(argv[argbase] + 1, L"KeepMutedChannels"))
-                Options._KeepMutedChannels = true;
+                Options.IgnoreMutedTracks = false;
             else
                 break;
 
@@ -93,7 +95,7 @@ int rcpmain(int argc, wchar_t * argv[])
 
     RCPConverter.SetFilePath(FilePath);
 
-    ::printf("\n%s, \"%S\"\n", TimeText, FilePath.c_str());
+    ::printf("\n%s, \"%s\"\n", TimeText, msc::WideToUTF8(FilePath).c_str());
 
     buffer_t SrcData;
 
@@ -138,7 +140,7 @@ int rcpmain(int argc, wchar_t * argv[])
                     }
                     catch (std::runtime_error & e)
                     {
-                        std::string Text(msc::FormatText("Reference file \"%s\" not found: ", msc::WideToUTF8(RefFilePath).c_str()));
+                        std::string Text(msc::FormatText("Reference file \"%s\" not found: ", msc::WideToUTF8(RefFilePath.wstring()).c_str()));
 
                         throw std::runtime_error(Text + e.what());
                     }